@@ -0,0 +1,776 @@
+#ifdef __x86_64__
+typedef __m128 lane4;
+typedef __m128 lane4_mask;
+
+static inline lane4 lane4_load(float *p)                          { return _mm_loadu_ps(p); }
+static inline void lane4_store(float *p, lane4 a)                 { _mm_storeu_ps(p, a); }
+static inline lane4 lane4_set(float a)                            { return _mm_set1_ps(a); }
+static inline lane4 lane4_add(lane4 a, lane4 b)                   { return _mm_add_ps(a, b); }
+static inline lane4 lane4_sub(lane4 a, lane4 b)                   { return _mm_sub_ps(a, b); }
+static inline lane4 lane4_mul(lane4 a, lane4 b)                   { return _mm_mul_ps(a, b); }
+static inline lane4 lane4_div(lane4 a, lane4 b)                   { return _mm_div_ps(a, b); }
+static inline lane4 lane4_min(lane4 a, lane4 b)                   { return _mm_min_ps(a, b); }
+static inline lane4 lane4_max(lane4 a, lane4 b)                   { return _mm_max_ps(a, b); }
+static inline lane4 lane4_sqrt(lane4 a)                           { return _mm_sqrt_ps(a); }
+static inline lane4_mask lane4_lt(lane4 a, lane4 b)               { return _mm_cmplt_ps(a, b); }
+static inline lane4_mask lane4_le(lane4 a, lane4 b)               { return _mm_cmple_ps(a, b); }
+static inline lane4_mask lane4_gt(lane4 a, lane4 b)               { return _mm_cmpgt_ps(a, b); }
+static inline lane4_mask lane4_and(lane4_mask a, lane4_mask b)    { return _mm_and_ps(a, b); }
+static inline lane4_mask lane4_and_not(lane4_mask a, lane4_mask b){ return _mm_andnot_ps(b, a); }
+static inline lane4 lane4_select(lane4_mask m, lane4 a, lane4 b)  { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+#elif __arm64__
+typedef float32x4_t lane4;
+typedef uint32x4_t lane4_mask;
+
+static inline lane4 lane4_load(float *p)                          { return vld1q_f32(p); }
+static inline void lane4_store(float *p, lane4 a)                 { vst1q_f32(p, a); }
+static inline lane4 lane4_set(float a)                            { return vdupq_n_f32(a); }
+static inline lane4 lane4_add(lane4 a, lane4 b)                   { return vaddq_f32(a, b); }
+static inline lane4 lane4_sub(lane4 a, lane4 b)                   { return vsubq_f32(a, b); }
+static inline lane4 lane4_mul(lane4 a, lane4 b)                   { return vmulq_f32(a, b); }
+static inline lane4 lane4_div(lane4 a, lane4 b)                   { return vdivq_f32(a, b); }
+static inline lane4 lane4_min(lane4 a, lane4 b)                   { return vminq_f32(a, b); }
+static inline lane4 lane4_max(lane4 a, lane4 b)                   { return vmaxq_f32(a, b); }
+static inline lane4 lane4_sqrt(lane4 a)                           { return vsqrtq_f32(a); }
+static inline lane4_mask lane4_lt(lane4 a, lane4 b)               { return vcltq_f32(a, b); }
+static inline lane4_mask lane4_le(lane4 a, lane4 b)               { return vcleq_f32(a, b); }
+static inline lane4_mask lane4_gt(lane4 a, lane4 b)               { return vcgtq_f32(a, b); }
+static inline lane4_mask lane4_and(lane4_mask a, lane4_mask b)    { return vandq_u32(a, b); }
+static inline lane4_mask lane4_and_not(lane4_mask a, lane4_mask b){ return vbicq_u32(a, b); }
+static inline lane4 lane4_select(lane4_mask m, lane4 a, lane4 b)  { return vbslq_f32(m, a, b); }
+#else
+typedef struct { float v[4]; } lane4;
+typedef struct { bool v[4]; } lane4_mask;
+
+#define LANE4_MAP(expr) for (int i = 0; i < 4; ++i) { r.v[i] = (expr); } return r;
+static inline lane4 lane4_load(float *p)                          { lane4 r; LANE4_MAP(p[i]) }
+static inline void lane4_store(float *p, lane4 a)                 { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+static inline lane4 lane4_set(float a)                            { lane4 r; LANE4_MAP(a) }
+static inline lane4 lane4_add(lane4 a, lane4 b)                   { lane4 r; LANE4_MAP(a.v[i] + b.v[i]) }
+static inline lane4 lane4_sub(lane4 a, lane4 b)                   { lane4 r; LANE4_MAP(a.v[i] - b.v[i]) }
+static inline lane4 lane4_mul(lane4 a, lane4 b)                   { lane4 r; LANE4_MAP(a.v[i] * b.v[i]) }
+static inline lane4 lane4_div(lane4 a, lane4 b)                   { lane4 r; LANE4_MAP(a.v[i] / b.v[i]) }
+static inline lane4 lane4_min(lane4 a, lane4 b)                   { lane4 r; LANE4_MAP(a.v[i] < b.v[i] ? a.v[i] : b.v[i]) }
+static inline lane4 lane4_max(lane4 a, lane4 b)                   { lane4 r; LANE4_MAP(a.v[i] > b.v[i] ? a.v[i] : b.v[i]) }
+static inline lane4 lane4_sqrt(lane4 a)                           { lane4 r; LANE4_MAP(sqrtf(a.v[i])) }
+static inline lane4_mask lane4_lt(lane4 a, lane4 b)               { lane4_mask r; LANE4_MAP(a.v[i] < b.v[i]) }
+static inline lane4_mask lane4_le(lane4 a, lane4 b)               { lane4_mask r; LANE4_MAP(a.v[i] <= b.v[i]) }
+static inline lane4_mask lane4_gt(lane4 a, lane4 b)               { lane4_mask r; LANE4_MAP(a.v[i] > b.v[i]) }
+static inline lane4_mask lane4_and(lane4_mask a, lane4_mask b)    { lane4_mask r; LANE4_MAP(a.v[i] && b.v[i]) }
+static inline lane4_mask lane4_and_not(lane4_mask a, lane4_mask b){ lane4_mask r; LANE4_MAP(a.v[i] && !b.v[i]) }
+static inline lane4 lane4_select(lane4_mask m, lane4 a, lane4 b)  { lane4 r; LANE4_MAP(m.v[i] ? a.v[i] : b.v[i]) }
+#undef LANE4_MAP
+#endif
+
+#define ANIMATION_BATCH_FLOAT_COUNT 18
+
+static inline lane4 lane4_ease_out_circ(lane4 t)
+{
+    lane4 u = lane4_sub(t, lane4_set(1.0f));
+    return lane4_sqrt(lane4_sub(lane4_set(1.0f), lane4_mul(u, u)));
+}
+
+static inline lane4 lane4_ease_in_out_cubic(lane4 t)
+{
+    lane4 v = lane4_sub(lane4_set(2.0f), lane4_mul(lane4_set(2.0f), t));
+    return lane4_select(lane4_lt(t, lane4_set(0.5f)),
+                        lane4_mul(lane4_set(4.0f), lane4_mul(t, lane4_mul(t, t))),
+                        lane4_sub(lane4_set(1.0f), lane4_mul(lane4_set(0.5f), lane4_mul(v, lane4_mul(v, v)))));
+}
+
+static inline lane4 lane4_power(lane4 t, int n)
+{
+    lane4 result = t;
+    for (int i = 1; i < n; ++i) result = lane4_mul(result, t);
+    return result;
+}
+
+//
+// NOTE: The polynomial and circular easings are evaluated four lanes at a
+// time; the sine and exponential ones have no vector form here and are left to
+// easing_evaluate by the caller.
+//
+
+static bool lane4_ease(int easing, lane4 t, lane4 *result)
+{
+    lane4 one  = lane4_set(1.0f);
+    lane4 half = lane4_set(0.5f);
+    lane4 u    = lane4_sub(one, t);
+    lane4 v    = lane4_sub(lane4_set(2.0f), lane4_mul(lane4_set(2.0f), t));
+    lane4_mask is_first_half = lane4_lt(t, half);
+
+    int power = 0;
+    switch (easing) {
+    case ease_in_quad_type:     case ease_out_quad_type:     case ease_in_out_quad_type:     power = 2; break;
+    case ease_in_cubic_type:    case ease_out_cubic_type:    case ease_in_out_cubic_type:    power = 3; break;
+    case ease_in_quart_type:    case ease_out_quart_type:    case ease_in_out_quart_type:    power = 4; break;
+    case ease_in_quint_type:    case ease_out_quint_type:    case ease_in_out_quint_type:    power = 5; break;
+    }
+
+    switch (easing) {
+    case ease_in_quad_type:
+    case ease_in_cubic_type:
+    case ease_in_quart_type:
+    case ease_in_quint_type: {
+        *result = lane4_power(t, power);
+    } break;
+    case ease_out_quad_type:
+    case ease_out_cubic_type:
+    case ease_out_quart_type:
+    case ease_out_quint_type: {
+        *result = lane4_sub(one, lane4_power(u, power));
+    } break;
+    case ease_in_out_quad_type:
+    case ease_in_out_cubic_type:
+    case ease_in_out_quart_type:
+    case ease_in_out_quint_type: {
+        *result = lane4_select(is_first_half,
+                               lane4_mul(lane4_set((float)(1 << (power - 1))), lane4_power(t, power)),
+                               lane4_sub(one, lane4_mul(half, lane4_power(v, power))));
+    } break;
+    case ease_in_circ_type: {
+        *result = lane4_sub(one, lane4_sqrt(lane4_sub(one, lane4_mul(t, t))));
+    } break;
+    case ease_out_circ_type: {
+        *result = lane4_sqrt(lane4_sub(one, lane4_mul(u, u)));
+    } break;
+    case ease_in_out_circ_type: {
+        lane4 w = lane4_mul(lane4_set(2.0f), t);
+        *result = lane4_select(is_first_half,
+                               lane4_mul(half, lane4_sub(one, lane4_sqrt(lane4_sub(one, lane4_mul(w, w))))),
+                               lane4_mul(half, lane4_add(lane4_sqrt(lane4_sub(one, lane4_mul(v, v))), one)));
+    } break;
+    default: {
+        return false;
+    } break;
+    }
+
+    return true;
+}
+
+static inline float animation_distance(float dx, float dy)
+{
+    return sqrtf(dx * dx + dy * dy);
+}
+
+static enum animation_operation animation_operation_type(struct animation_rect *start, struct animation_rect *end)
+{
+    float position_change = animation_distance(end->x - start->x, end->y - start->y);
+    float size_change = fabsf(end->w - start->w) + fabsf(end->h - start->h);
+
+    if (size_change > position_change * 2.0f) {
+        return ANIMATION_OPERATION_RESIZE;
+    } else if (position_change > size_change * 2.0f) {
+        return ANIMATION_OPERATION_TRANSLATE;
+    } else {
+        return ANIMATION_OPERATION_MIXED;
+    }
+}
+
+static float animation_size_ratio(struct animation_rect *start, struct animation_rect *end)
+{
+    float start_area = start->w * start->h;
+    float end_area = end->w * end->h;
+    float max_area = fmaxf(start_area, end_area);
+    return max_area > 0.0f ? fabsf(end_area - start_area) / max_area : 0.0f;
+}
+
+static void animation_plan_set_anchor(struct animation_plan *plan, enum animation_anchor anchor, float x, float y)
+{
+    plan->resize_anchor = anchor;
+    plan->anchor_x = x;
+    plan->anchor_y = y;
+}
+
+static void animation_plan_set_corner(struct animation_plan *plan, int corner)
+{
+    struct animation_rect *s = &plan->start;
+
+    switch (corner) {
+    case ANIMATION_ANCHOR_TOP_LEFT:     animation_plan_set_anchor(plan, corner, s->x,        s->y);        break;
+    case ANIMATION_ANCHOR_TOP_RIGHT:    animation_plan_set_anchor(plan, corner, s->x + s->w, s->y);        break;
+    case ANIMATION_ANCHOR_BOTTOM_LEFT:  animation_plan_set_anchor(plan, corner, s->x,        s->y + s->h); break;
+    case ANIMATION_ANCHOR_BOTTOM_RIGHT: animation_plan_set_anchor(plan, corner, s->x + s->w, s->y + s->h); break;
+    }
+}
+
+//
+// NOTE: Picks the point of the start frame that should appear to stay in place.
+// Edges that end up where they started are preferred, corners before single
+// edges; without one the choice falls back to the split of the parent node and
+// to the kind of change.
+//
+
+static void animation_plan_anchor(struct animation_plan *plan, struct animation_planner *planner, struct animation_placement *placement)
+{
+    struct animation_rect *s = &plan->start;
+    struct animation_rect *e = &plan->end;
+
+    if (planner->force_edge & ANIMATION_EDGE_TOP) {
+        plan->common_edges = ANIMATION_EDGE_TOP;
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_LEFT, s->x + s->w / 2.0f, s->y);
+        return;
+    }
+
+    if (planner->force_edge & ANIMATION_EDGE_BOTTOM) {
+        plan->common_edges = ANIMATION_EDGE_BOTTOM;
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_BOTTOM_LEFT, s->x + s->w / 2.0f, s->y + s->h);
+        return;
+    }
+
+    if (planner->force_edge & ANIMATION_EDGE_LEFT) {
+        plan->common_edges = ANIMATION_EDGE_LEFT;
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_LEFT, s->x, s->y + s->h / 2.0f);
+        return;
+    }
+
+    if (planner->force_edge & ANIMATION_EDGE_RIGHT) {
+        plan->common_edges = ANIMATION_EDGE_RIGHT;
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_RIGHT, s->x + s->w, s->y + s->h / 2.0f);
+        return;
+    }
+
+    if (planner->override_stacked_top && placement->is_stacked_top) {
+        animation_plan_set_corner(plan, planner->stacked_top_anchor);
+        return;
+    }
+
+    if (planner->override_stacked_bottom && placement->is_stacked_bottom) {
+        animation_plan_set_corner(plan, planner->stacked_bottom_anchor);
+        return;
+    }
+
+    float threshold = planner->edge_threshold;
+    if (fabsf(s->y - e->y) <= threshold)                             plan->common_edges |= ANIMATION_EDGE_TOP;
+    if (fabsf((s->y + s->h) - (e->y + e->h)) <= threshold)           plan->common_edges |= ANIMATION_EDGE_BOTTOM;
+    if (fabsf(s->x - e->x) <= threshold)                             plan->common_edges |= ANIMATION_EDGE_LEFT;
+    if (fabsf((s->x + s->w) - (e->x + e->w)) <= threshold)           plan->common_edges |= ANIMATION_EDGE_RIGHT;
+
+    uint32_t edges = plan->common_edges;
+    if ((edges & ANIMATION_EDGE_TOP) && (edges & ANIMATION_EDGE_LEFT)) {
+        animation_plan_set_corner(plan, ANIMATION_ANCHOR_TOP_LEFT);
+    } else if ((edges & ANIMATION_EDGE_TOP) && (edges & ANIMATION_EDGE_RIGHT)) {
+        animation_plan_set_corner(plan, ANIMATION_ANCHOR_TOP_RIGHT);
+    } else if ((edges & ANIMATION_EDGE_BOTTOM) && (edges & ANIMATION_EDGE_LEFT)) {
+        animation_plan_set_corner(plan, ANIMATION_ANCHOR_BOTTOM_LEFT);
+    } else if ((edges & ANIMATION_EDGE_BOTTOM) && (edges & ANIMATION_EDGE_RIGHT)) {
+        animation_plan_set_corner(plan, ANIMATION_ANCHOR_BOTTOM_RIGHT);
+    } else if (edges & ANIMATION_EDGE_BOTTOM) {
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_BOTTOM_LEFT, s->x + s->w / 2.0f, s->y + s->h);
+    } else if (edges & ANIMATION_EDGE_TOP) {
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_LEFT, s->x + s->w / 2.0f, s->y);
+    } else if (edges & ANIMATION_EDGE_LEFT) {
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_LEFT, s->x, s->y + s->h / 2.0f);
+    } else if (edges & ANIMATION_EDGE_RIGHT) {
+        animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_RIGHT, s->x + s->w, s->y + s->h / 2.0f);
+    } else {
+        plan->use_split_fallback = true;
+
+        if (plan->operation == ANIMATION_OPERATION_TRANSLATE) {
+            animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_LEFT, s->x + s->w / 2.0f, s->y + s->h / 2.0f);
+        } else if (plan->operation == ANIMATION_OPERATION_RESIZE && placement->parent_split == SPLIT_Y) {
+            animation_plan_set_corner(plan, s->y < e->y ? ANIMATION_ANCHOR_TOP_LEFT : ANIMATION_ANCHOR_BOTTOM_LEFT);
+        } else if (plan->operation == ANIMATION_OPERATION_RESIZE && placement->parent_split == SPLIT_X) {
+            animation_plan_set_corner(plan, s->x < e->x ? ANIMATION_ANCHOR_TOP_LEFT : ANIMATION_ANCHOR_TOP_RIGHT);
+        } else if (plan->operation == ANIMATION_OPERATION_RESIZE && placement->parent_split != SPLIT_NONE) {
+            animation_plan_set_anchor(plan, ANIMATION_ANCHOR_TOP_LEFT, s->x + s->w / 2.0f, s->y + s->h / 2.0f);
+        } else {
+            float width_change = fabsf(e->w - s->w);
+            float height_change = fabsf(e->h - s->h);
+
+            if (height_change > width_change * 2.0f) {
+                animation_plan_set_corner(plan, fabsf(s->y - e->y) < 5.0f ? ANIMATION_ANCHOR_TOP_LEFT : ANIMATION_ANCHOR_BOTTOM_LEFT);
+            } else if (width_change > height_change * 2.0f) {
+                animation_plan_set_corner(plan, fabsf(s->x - e->x) < 5.0f ? ANIMATION_ANCHOR_TOP_LEFT : ANIMATION_ANCHOR_TOP_RIGHT);
+            } else {
+                animation_plan_set_corner(plan, ANIMATION_ANCHOR_TOP_LEFT);
+            }
+        }
+    }
+}
+
+static uint32_t animation_screen_edges(struct animation_rect *frame, struct animation_rect *screen, float threshold)
+{
+    if (screen->w <= 0.0f || screen->h <= 0.0f) return 0;
+
+    uint32_t edges = 0;
+    if (frame->y - screen->y <= threshold)                                 edges |= ANIMATION_EDGE_TOP;
+    if ((screen->y + screen->h) - (frame->y + frame->h) <= threshold)      edges |= ANIMATION_EDGE_BOTTOM;
+    if (frame->x - screen->x <= threshold)                                 edges |= ANIMATION_EDGE_LEFT;
+    if ((screen->x + screen->w) - (frame->x + frame->w) <= threshold)      edges |= ANIMATION_EDGE_RIGHT;
+    return edges;
+}
+
+void animation_plan_create(struct animation_plan *plan, struct animation_planner *planner, struct animation_rect start, struct animation_rect end, struct animation_placement *placement)
+{
+    memset(plan, 0, sizeof(struct animation_plan));
+
+    plan->start            = start;
+    plan->end              = end;
+    plan->bounds           = placement->bounds;
+    plan->parent_split     = placement->parent_split;
+    plan->alpha            = placement->alpha;
+    plan->operation        = animation_operation_type(&start, &end);
+    plan->crosses_monitors = animation_distance(end.x - start.x, end.y - start.y) > ANIMATION_MONITOR_DISTANCE;
+    plan->size_ratio       = animation_size_ratio(&start, &end);
+    plan->screen_edges     = animation_screen_edges(&end, &placement->screen, planner->edge_threshold);
+
+    animation_plan_anchor(plan, planner, placement);
+
+    plan->is_two_phase = planner->is_two_phase_enabled && placement->window_count >= 2 && plan->size_ratio > planner->fade_threshold;
+    plan->slide = plan->is_two_phase ? planner->slide_ratio : 0.0f;
+
+    if (planner->is_fade_enabled && plan->size_ratio > planner->fade_threshold) {
+        plan->fade_intensity = planner->fade_intensity;
+    }
+}
+
+//
+// NOTE: Windows whose size changes a lot fade out over the first part of the
+// animation, stay faded in the middle and fade back in towards the end.
+//
+
+float animation_plan_opacity(struct animation_plan *plan, float t)
+{
+    float intensity = plan->fade_intensity;
+    float curve;
+
+    if (intensity == 0.0f) {
+        curve = 1.0f;
+    } else if (t < ANIMATION_FADE_OUT_END) {
+        curve = 1.0f - (t / ANIMATION_FADE_OUT_END) * intensity;
+    } else if (t > ANIMATION_FADE_IN_START) {
+        curve = (1.0f - intensity) + ((t - ANIMATION_FADE_IN_START) / (1.0f - ANIMATION_FADE_IN_START)) * intensity;
+    } else {
+        curve = 1.0f - intensity;
+    }
+
+    return plan->alpha * curve;
+}
+
+static const char *animation_quality_tier_str[] =
+{
+#define ANIMATION_QUALITY_TIER_ENTRY(value) [ANIMATION_QUALITY_##value] = #value,
+    ANIMATION_QUALITY_TIER_LIST
+#undef ANIMATION_QUALITY_TIER_ENTRY
+};
+
+void animation_quality_for_tier(struct animation_quality *quality, struct animation_quality *config, int tier)
+{
+    *quality = *config;
+
+    if (tier >= ANIMATION_QUALITY_no_blur) {
+        quality->is_blur_enabled = false;
+    }
+
+    if (tier >= ANIMATION_QUALITY_reduced) {
+        quality->is_shadows_enabled = false;
+        quality->is_reduced_resolution = true;
+    }
+
+    if (tier >= ANIMATION_QUALITY_simplified) {
+        quality->is_simplified_easing = true;
+        quality->is_two_phase_enabled = false;
+    }
+
+    if (tier >= ANIMATION_QUALITY_fast) {
+        quality->is_fast_mode = true;
+    }
+
+    if (quality->is_fast_mode) {
+        quality->is_blur_enabled = false;
+        quality->is_shadows_enabled = false;
+        quality->is_reduced_resolution = true;
+        quality->is_simplified_easing = true;
+    }
+}
+
+void animation_governor_init(struct animation_governor *governor)
+{
+    memset(governor, 0, sizeof(struct animation_governor));
+}
+
+void animation_governor_record_frame(struct animation_governor *governor, float frame_ms, float budget_ms)
+{
+    if (budget_ms <= 0.0f) return;
+
+    float load = frame_ms / budget_ms;
+    float missed = load > 1.0f ? 1.0f : 0.0f;
+
+    if (governor->frame_count == 0) {
+        governor->frame_load = load;
+        governor->missed_ratio = missed;
+    } else {
+        governor->frame_load += (load - governor->frame_load) * ANIMATION_GOVERNOR_FRAME_SMOOTHING;
+        governor->missed_ratio += (missed - governor->missed_ratio) * ANIMATION_GOVERNOR_FRAME_SMOOTHING;
+    }
+
+    ++governor->frame_count;
+}
+
+void animation_governor_record_prep(struct animation_governor *governor, float prep_ms)
+{
+    governor->prep_ms = prep_ms;
+}
+
+static int animation_governor_window_tier(int window_count)
+{
+    int tier = ANIMATION_QUALITY_full;
+    for (int limit = ANIMATION_GOVERNOR_WINDOW_STEP; window_count > limit && tier < ANIMATION_QUALITY_fast; limit *= 2) {
+        ++tier;
+    }
+    return tier;
+}
+
+//
+// NOTE: Frames measured before the tier last changed say nothing about the
+// current one, so they are dropped whenever it does, and the frame load is
+// only looked at once enough frames have been measured at the new tier.
+//
+
+int animation_governor_update(struct animation_governor *governor, int window_count)
+{
+    bool has_frames = governor->frame_count >= ANIMATION_GOVERNOR_MIN_FRAMES;
+
+    bool is_slow = governor->prep_ms > ANIMATION_GOVERNOR_PREP_HIGH_MS ||
+                   (has_frames && (governor->frame_load > ANIMATION_GOVERNOR_LOAD_HIGH ||
+                                   governor->missed_ratio > ANIMATION_GOVERNOR_MISSED_HIGH));
+
+    bool is_calm = governor->prep_ms < ANIMATION_GOVERNOR_PREP_LOW_MS &&
+                   has_frames &&
+                   governor->frame_load < ANIMATION_GOVERNOR_LOAD_LOW &&
+                   governor->missed_ratio < ANIMATION_GOVERNOR_MISSED_LOW;
+
+    int load_tier = governor->load_tier;
+    if (is_slow) {
+        governor->calm_count = 0;
+        if (load_tier < ANIMATION_QUALITY_fast) ++load_tier;
+    } else if (is_calm) {
+        if (++governor->calm_count >= ANIMATION_GOVERNOR_CALM_FLUSHES && load_tier > ANIMATION_QUALITY_full) {
+            governor->calm_count = 0;
+            --load_tier;
+        }
+    } else {
+        governor->calm_count = 0;
+    }
+
+    if (load_tier > governor->load_tier) ++governor->step_down_count;
+    if (load_tier < governor->load_tier) ++governor->step_up_count;
+
+    if (load_tier != governor->load_tier) {
+        governor->load_tier = load_tier;
+        governor->frame_count = 0;
+        governor->frame_load = 0.0f;
+        governor->missed_ratio = 0.0f;
+        governor->prep_ms = 0.0f;
+    }
+
+    governor->window_tier = animation_governor_window_tier(window_count);
+    governor->tier = max(governor->load_tier, governor->window_tier);
+    return governor->tier;
+}
+
+void animation_governor_serialize(FILE *rsp, struct animation_governor *governor, struct animation_quality *quality, bool is_enabled)
+{
+    fprintf(rsp,
+            "{\n"
+            "\t\"enabled\":%s,\n"
+            "\t\"tier\":\"%s\",\n"
+            "\t\"load_tier\":\"%s\",\n"
+            "\t\"window_tier\":\"%s\",\n"
+            "\t\"frame_load\":%.4f,\n"
+            "\t\"missed_ratio\":%.4f,\n"
+            "\t\"prep_ms\":%.4f,\n"
+            "\t\"step_downs\":%llu,\n"
+            "\t\"step_ups\":%llu,\n"
+            "\t\"blur\":%s,\n"
+            "\t\"shadows\":%s,\n"
+            "\t\"reduced_resolution\":%s,\n"
+            "\t\"simplified_easing\":%s,\n"
+            "\t\"two_phase\":%s,\n"
+            "\t\"fast_mode\":%s\n"
+            "}",
+            is_enabled ? "true" : "false",
+            animation_quality_tier_str[governor->tier],
+            animation_quality_tier_str[governor->load_tier],
+            animation_quality_tier_str[governor->window_tier],
+            governor->frame_load,
+            governor->missed_ratio,
+            governor->prep_ms,
+            (unsigned long long) governor->step_down_count,
+            (unsigned long long) governor->step_up_count,
+            quality->is_blur_enabled ? "true" : "false",
+            quality->is_shadows_enabled ? "true" : "false",
+            quality->is_reduced_resolution ? "true" : "false",
+            quality->is_simplified_easing ? "true" : "false",
+            quality->is_two_phase_enabled ? "true" : "false",
+            quality->is_fast_mode ? "true" : "false");
+}
+
+void animation_batch_init(struct animation_batch *batch)
+{
+    memset(batch, 0, sizeof(struct animation_batch));
+}
+
+void animation_batch_destroy(struct animation_batch *batch)
+{
+    free(batch->memory);
+    free(batch->easing);
+    free(batch->crosses_monitors);
+    memset(batch, 0, sizeof(struct animation_batch));
+}
+
+//
+// NOTE: Sizes the batch for count lanes and clears every lane, including the
+// padding up to the next multiple of ANIMATION_LANE_COUNT, which evaluates to
+// an empty animation so that the kernel never needs a scalar tail.
+//
+
+void animation_batch_reset(struct animation_batch *batch, int count)
+{
+    int padded_count = (count + ANIMATION_LANE_COUNT - 1) & ~(ANIMATION_LANE_COUNT - 1);
+
+    if (padded_count > batch->capacity) {
+        int capacity = batch->capacity ? batch->capacity : ANIMATION_LANE_COUNT;
+        while (capacity < padded_count) capacity *= 2;
+
+        free(batch->memory);
+        free(batch->easing);
+        free(batch->crosses_monitors);
+
+        batch->memory           = malloc(sizeof(float) * capacity * ANIMATION_BATCH_FLOAT_COUNT);
+        batch->easing           = malloc(sizeof(int) * capacity);
+        batch->crosses_monitors = malloc(sizeof(bool) * capacity);
+        batch->capacity         = capacity;
+
+        float **array_list[ANIMATION_BATCH_FLOAT_COUNT] = {
+            &batch->start_x, &batch->start_y, &batch->start_w, &batch->start_h,
+            &batch->end_x, &batch->end_y, &batch->end_w, &batch->end_h,
+            &batch->min_x, &batch->min_y, &batch->max_x, &batch->max_y,
+            &batch->slide, &batch->t,
+            &batch->x, &batch->y, &batch->w, &batch->h
+        };
+
+        for (int i = 0; i < ANIMATION_BATCH_FLOAT_COUNT; ++i) {
+            *array_list[i] = batch->memory + i * capacity;
+        }
+    }
+
+    batch->count = count;
+
+    struct animation_lane empty = {0};
+    for (int i = 0; i < padded_count; ++i) {
+        animation_batch_set(batch, i, &empty);
+    }
+}
+
+void animation_batch_set(struct animation_batch *batch, int index, struct animation_lane *lane)
+{
+    batch->start_x[index] = lane->start.x;
+    batch->start_y[index] = lane->start.y;
+    batch->start_w[index] = lane->start.w;
+    batch->start_h[index] = lane->start.h;
+    batch->end_x[index]   = lane->end.x;
+    batch->end_y[index]   = lane->end.y;
+    batch->end_w[index]   = lane->end.w;
+    batch->end_h[index]   = lane->end.h;
+
+    if (lane->bounds.w > 0.0f && lane->bounds.h > 0.0f) {
+        batch->min_x[index] = lane->bounds.x;
+        batch->min_y[index] = lane->bounds.y;
+        batch->max_x[index] = lane->bounds.x + lane->bounds.w;
+        batch->max_y[index] = lane->bounds.y + lane->bounds.h;
+    } else {
+        batch->min_x[index] = -INFINITY;
+        batch->min_y[index] = -INFINITY;
+        batch->max_x[index] =  INFINITY;
+        batch->max_y[index] =  INFINITY;
+    }
+
+    batch->slide[index]            = lane->is_two_phase ? fmaxf(lane->slide, 1e-6f) : 0.0f;
+    batch->t[index]                = 0.0f;
+    batch->easing[index]           = lane->easing;
+    batch->crosses_monitors[index] = lane->crosses_monitors;
+}
+
+void animation_batch_set_plan(struct animation_batch *batch, int index, struct animation_plan *plan, int easing)
+{
+    struct animation_lane lane = {
+        .start            = plan->start,
+        .end              = plan->end,
+        .bounds           = plan->bounds,
+        .slide            = plan->slide,
+        .easing           = easing,
+        .is_two_phase     = plan->is_two_phase,
+        .crosses_monitors = plan->crosses_monitors
+    };
+    animation_batch_set(batch, index, &lane);
+}
+
+//
+// NOTE: Lanes that cross monitors follow a sine curve between the start and
+// end position for the middle of the animation. They are rare enough to be
+// patched up one at a time after the kernel has run.
+//
+
+static void animation_batch_apply_monitor_crossing(struct animation_batch *batch, bool is_linear)
+{
+    for (int i = 0; i < batch->count; ++i) {
+        if (!batch->crosses_monitors[i]) continue;
+
+        float t = batch->t[i];
+        float mt;
+
+        if (batch->slide[i] > 0.0f) {
+            if (t <= 0.2f || t >= 0.8f) continue;
+            mt = ease_in_out_sine(t);
+        } else {
+            mt = ease_in_out_sine(is_linear ? t : easing_evaluate(batch->easing[i], t));
+        }
+
+        batch->x[i] = lerp(batch->start_x[i], mt, batch->end_x[i]);
+        batch->y[i] = lerp(batch->start_y[i], mt, batch->end_y[i]);
+    }
+}
+
+//
+// NOTE: Computes the frame of every lane at the progress stored in t. The
+// origin moves linearly between the start and the end frame; keeping the
+// anchor fixed reduces to exactly that, so the anchor itself is not needed
+// on the frame path. Two-phase lanes slide at their start size before they
+// resize in place, and every lane is kept within its bounds.
+//
+
+void animation_batch_evaluate(struct animation_batch *batch, bool is_linear)
+{
+    lane4 zero       = lane4_set(0.0f);
+    lane4 one        = lane4_set(1.0f);
+    lane4 epsilon    = lane4_set(1e-6f);
+    lane4 min_width  = lane4_set(ANIMATION_MIN_WIDTH);
+    lane4 min_height = lane4_set(ANIMATION_MIN_HEIGHT);
+
+    for (int i = 0; i < batch->count; i += ANIMATION_LANE_COUNT) {
+        lane4 t = lane4_load(batch->t + i);
+        lane4 mt = t;
+
+        if (!is_linear) {
+            int *easing = batch->easing + i;
+            bool is_uniform = easing[0] == easing[1] && easing[0] == easing[2] && easing[0] == easing[3];
+
+            if (!is_uniform || !lane4_ease(easing[0], t, &mt)) {
+                float scalar[ANIMATION_LANE_COUNT];
+                for (int j = 0; j < ANIMATION_LANE_COUNT; ++j) {
+                    scalar[j] = easing_evaluate(easing[j], batch->t[i+j]);
+                }
+                mt = lane4_load(scalar);
+            }
+        }
+
+        lane4 slide = lane4_load(batch->slide + i);
+        lane4_mask is_two_phase = lane4_gt(slide, zero);
+        lane4_mask is_sliding   = lane4_and(is_two_phase, lane4_le(t, slide));
+        lane4_mask is_resizing  = lane4_and_not(is_two_phase, is_sliding);
+
+        lane4 slide_t  = lane4_min(lane4_div(t, lane4_max(slide, epsilon)), one);
+        lane4 resize_t = lane4_min(lane4_max(lane4_div(lane4_sub(t, slide), lane4_max(lane4_sub(one, slide), epsilon)), zero), one);
+        lane4 p = lane4_select(is_two_phase, lane4_select(is_sliding, lane4_ease_out_circ(slide_t), lane4_ease_in_out_cubic(resize_t)), mt);
+
+        lane4 start_x = lane4_load(batch->start_x + i);
+        lane4 start_y = lane4_load(batch->start_y + i);
+        lane4 start_w = lane4_load(batch->start_w + i);
+        lane4 start_h = lane4_load(batch->start_h + i);
+        lane4 end_x   = lane4_load(batch->end_x + i);
+        lane4 end_y   = lane4_load(batch->end_y + i);
+
+        lane4 from_x = lane4_select(is_resizing, end_x, start_x);
+        lane4 from_y = lane4_select(is_resizing, end_y, start_y);
+        lane4 to_w   = lane4_select(is_sliding, start_w, lane4_load(batch->end_w + i));
+        lane4 to_h   = lane4_select(is_sliding, start_h, lane4_load(batch->end_h + i));
+
+        lane4 x = lane4_add(from_x, lane4_mul(lane4_sub(end_x, from_x), p));
+        lane4 y = lane4_add(from_y, lane4_mul(lane4_sub(end_y, from_y), p));
+        lane4 w = lane4_max(lane4_add(start_w, lane4_mul(lane4_sub(to_w, start_w), p)), min_width);
+        lane4 h = lane4_max(lane4_add(start_h, lane4_mul(lane4_sub(to_h, start_h), p)), min_height);
+
+        x = lane4_min(lane4_max(x, lane4_load(batch->min_x + i)), lane4_sub(lane4_load(batch->max_x + i), w));
+        y = lane4_min(lane4_max(y, lane4_load(batch->min_y + i)), lane4_sub(lane4_load(batch->max_y + i), h));
+
+        lane4_store(batch->x + i, x);
+        lane4_store(batch->y + i, y);
+        lane4_store(batch->w + i, w);
+        lane4_store(batch->h + i, h);
+    }
+
+    animation_batch_apply_monitor_crossing(batch, is_linear);
+}
+
+//
+// NOTE: The same computation one lane at a time, using the scalar easing
+// functions. It is the reference that the kernel is benchmarked and checked
+// against.
+//
+
+void animation_batch_evaluate_scalar(struct animation_batch *batch, bool is_linear)
+{
+    for (int i = 0; i < batch->count; ++i) {
+        float t = batch->t[i];
+        float slide = batch->slide[i];
+        float from_x = batch->start_x[i];
+        float from_y = batch->start_y[i];
+        float to_w = batch->end_w[i];
+        float to_h = batch->end_h[i];
+        float p;
+
+        if (slide > 0.0f) {
+            if (t <= slide) {
+                p = ease_out_circ(fminf(t / slide, 1.0f));
+                to_w = batch->start_w[i];
+                to_h = batch->start_h[i];
+            } else {
+                p = ease_in_out_cubic(fminf(fmaxf((t - slide) / fmaxf(1.0f - slide, 1e-6f), 0.0f), 1.0f));
+                from_x = batch->end_x[i];
+                from_y = batch->end_y[i];
+            }
+        } else {
+            p = is_linear ? t : easing_evaluate(batch->easing[i], t);
+        }
+
+        float x = from_x + (batch->end_x[i] - from_x) * p;
+        float y = from_y + (batch->end_y[i] - from_y) * p;
+        float w = fmaxf(batch->start_w[i] + (to_w - batch->start_w[i]) * p, ANIMATION_MIN_WIDTH);
+        float h = fmaxf(batch->start_h[i] + (to_h - batch->start_h[i]) * p, ANIMATION_MIN_HEIGHT);
+
+        batch->x[i] = fminf(fmaxf(x, batch->min_x[i]), batch->max_x[i] - w);
+        batch->y[i] = fminf(fmaxf(y, batch->min_y[i]), batch->max_y[i] - h);
+        batch->w[i] = w;
+        batch->h[i] = h;
+    }
+
+    animation_batch_apply_monitor_crossing(batch, is_linear);
+}
+
+//
+// NOTE: Sends the frame of one lane to the backend. The proxy is moved to the
+// origin of the frame and scaled from its own size to the size of the frame,
+// which is CGAffineTransformConcat of the translation and the scale. The alpha
+// is left alone when the plan says that the window is fully transparent.
+//
+
+void animation_batch_emit(struct animation_batch *batch, int index, uint32_t id, float proxy_w, float proxy_h, struct animation_plan *plan, struct animation_backend *backend)
+{
+    float sx = proxy_w / batch->w[index];
+    float sy = proxy_h / batch->h[index];
+
+    struct animation_transform transform = {
+        .a  = sx,
+        .b  = 0.0f,
+        .c  = 0.0f,
+        .d  = sy,
+        .tx = -batch->x[index] * sx,
+        .ty = -batch->y[index] * sy
+    };
+    backend->set_transform(backend->context, id, &transform);
+
+    float alpha = animation_plan_opacity(plan, batch->t[index]);
+    if (alpha != 0.0f) backend->set_alpha(backend->context, id, alpha);
+}
@@ -0,0 +1,252 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+//
+// NOTE: The planner and the frame kernel of the window animations. A plan is
+// made once when an animation starts and describes everything that follows
+// from where it starts and ends. The state that the kernel reads on every frame
+// is stored as a structure of arrays, one lane per animation, so that a frame
+// can be computed for four animations at a time using SSE on x86_64 and NEON on
+// arm64. Like the layout core it depends only on the C standard library,
+// misc/easing.h and layout.h, so it can be tested and benchmarked on its own.
+//
+
+#define ANIMATION_LANE_COUNT 4
+#define ANIMATION_MIN_WIDTH  100.0f
+#define ANIMATION_MIN_HEIGHT 50.0f
+
+#define ANIMATION_MONITOR_DISTANCE 1000.0f
+#define ANIMATION_FADE_OUT_END     0.3f
+#define ANIMATION_FADE_IN_START    0.7f
+
+struct animation_rect
+{
+    float x;
+    float y;
+    float w;
+    float h;
+};
+
+enum animation_operation
+{
+    ANIMATION_OPERATION_RESIZE,
+    ANIMATION_OPERATION_TRANSLATE,
+    ANIMATION_OPERATION_MIXED
+};
+
+enum animation_anchor
+{
+    ANIMATION_ANCHOR_TOP_LEFT,
+    ANIMATION_ANCHOR_TOP_RIGHT,
+    ANIMATION_ANCHOR_BOTTOM_LEFT,
+    ANIMATION_ANCHOR_BOTTOM_RIGHT
+};
+
+enum animation_edge
+{
+    ANIMATION_EDGE_TOP    = 0x1,
+    ANIMATION_EDGE_BOTTOM = 0x2,
+    ANIMATION_EDGE_LEFT   = 0x4,
+    ANIMATION_EDGE_RIGHT  = 0x8
+};
+
+//
+// NOTE: The settings that plans are made with. A forced edge takes precedence
+// over everything else, followed by the anchors configured for the windows at
+// the top and the bottom of a stack.
+//
+
+struct animation_planner
+{
+    float edge_threshold;
+    uint32_t force_edge;
+    bool override_stacked_top;
+    bool override_stacked_bottom;
+    int stacked_top_anchor;
+    int stacked_bottom_anchor;
+    bool is_two_phase_enabled;
+    float slide_ratio;
+    bool is_fade_enabled;
+    float fade_threshold;
+    float fade_intensity;
+};
+
+//
+// NOTE: Where the window lives: the usable area of the display it ends up on,
+// which the screen edges are measured against, the bounds that its frames are
+// kept within, and its position in the tree.
+//
+
+struct animation_placement
+{
+    struct animation_rect screen;
+    struct animation_rect bounds;
+    enum window_node_split parent_split;
+    bool is_stacked_top;
+    bool is_stacked_bottom;
+    int window_count;
+    float alpha;
+};
+
+struct animation_plan
+{
+    struct animation_rect start;
+    struct animation_rect end;
+    struct animation_rect bounds;
+    float anchor_x;
+    float anchor_y;
+    enum animation_anchor resize_anchor;
+    enum animation_operation operation;
+    enum window_node_split parent_split;
+    uint32_t common_edges;
+    uint32_t screen_edges;
+    float size_ratio;
+    float slide;
+    float alpha;
+    float fade_intensity;
+    bool is_two_phase;
+    bool crosses_monitors;
+    bool use_split_fallback;
+};
+
+//
+// NOTE: A lane animates from start to end, and is kept within bounds unless
+// they are empty. A two-phase lane slides to the end position at its start
+// size until t reaches slide, and resizes to the end size for the rest of it.
+//
+
+struct animation_lane
+{
+    struct animation_rect start;
+    struct animation_rect end;
+    struct animation_rect bounds;
+    float slide;
+    int easing;
+    bool is_two_phase;
+    bool crosses_monitors;
+};
+
+struct animation_batch
+{
+    float *start_x, *start_y, *start_w, *start_h;
+    float *end_x, *end_y, *end_w, *end_h;
+    float *min_x, *min_y, *max_x, *max_y;
+    float *slide;
+    float *t;
+    float *x, *y, *w, *h;
+    int *easing;
+    bool *crosses_monitors;
+    float *memory;
+    int count;
+    int capacity;
+};
+
+//
+// NOTE: The settings that trade the quality of an animation for its speed, as
+// configured and as applied once the governor has stepped them down. Each tier
+// turns off one more group of them on top of the tiers below it.
+//
+
+#define ANIMATION_QUALITY_TIER_LIST \
+    ANIMATION_QUALITY_TIER_ENTRY(full) \
+    ANIMATION_QUALITY_TIER_ENTRY(no_blur) \
+    ANIMATION_QUALITY_TIER_ENTRY(reduced) \
+    ANIMATION_QUALITY_TIER_ENTRY(simplified) \
+    ANIMATION_QUALITY_TIER_ENTRY(fast)
+
+enum animation_quality_tier
+{
+#define ANIMATION_QUALITY_TIER_ENTRY(value) ANIMATION_QUALITY_##value,
+    ANIMATION_QUALITY_TIER_LIST
+#undef ANIMATION_QUALITY_TIER_ENTRY
+    ANIMATION_QUALITY_TIER_COUNT
+};
+
+struct animation_quality
+{
+    bool is_blur_enabled;
+    bool is_shadows_enabled;
+    bool is_reduced_resolution;
+    bool is_simplified_easing;
+    bool is_two_phase_enabled;
+    bool is_fast_mode;
+};
+
+#define ANIMATION_GOVERNOR_WINDOW_STEP     8
+#define ANIMATION_GOVERNOR_MIN_FRAMES      10
+#define ANIMATION_GOVERNOR_CALM_FLUSHES    3
+#define ANIMATION_GOVERNOR_FRAME_SMOOTHING 0.1f
+#define ANIMATION_GOVERNOR_LOAD_HIGH       0.8f
+#define ANIMATION_GOVERNOR_LOAD_LOW        0.4f
+#define ANIMATION_GOVERNOR_MISSED_HIGH     0.05f
+#define ANIMATION_GOVERNOR_MISSED_LOW      0.01f
+#define ANIMATION_GOVERNOR_PREP_HIGH_MS    50.0f
+#define ANIMATION_GOVERNOR_PREP_LOW_MS     20.0f
+
+//
+// NOTE: Picks the quality tier of each flush of animations. The tier is the
+// higher of two: one that follows from the number of windows in the flush,
+// stepping down once for every doubling past ANIMATION_GOVERNOR_WINDOW_STEP,
+// and one that follows from what was measured since it last changed. The
+// measured tier steps down as soon as frames take most of their budget, miss
+// their deadline, or the proxies take too long to prepare, and only steps back
+// up after ANIMATION_GOVERNOR_CALM_FLUSHES flushes in a row that had plenty of
+// headroom on all three. The thresholds for going down and coming back up are
+// far apart, so that the tier does not flip back and forth around one of them.
+//
+
+struct animation_governor
+{
+    int tier;
+    int load_tier;
+    int window_tier;
+    int calm_count;
+    int frame_count;
+    float frame_load;
+    float missed_ratio;
+    float prep_ms;
+    uint64_t step_down_count;
+    uint64_t step_up_count;
+};
+
+//
+// NOTE: What a frame sets on the proxy of an animation: the transform that maps
+// the proxy, which keeps the size it was captured at, onto the frame computed
+// by the kernel, and its alpha. The frames are handed to a backend, which is a
+// window server transaction in the window manager and a trace in the simulator.
+//
+
+struct animation_transform
+{
+    float a, b;
+    float c, d;
+    float tx, ty;
+};
+
+struct animation_backend
+{
+    void *context;
+    void (*set_transform)(void *context, uint32_t id, struct animation_transform *transform);
+    void (*set_alpha)(void *context, uint32_t id, float alpha);
+};
+
+void animation_plan_create(struct animation_plan *plan, struct animation_planner *planner, struct animation_rect start, struct animation_rect end, struct animation_placement *placement);
+float animation_plan_opacity(struct animation_plan *plan, float t);
+
+void animation_governor_init(struct animation_governor *governor);
+void animation_governor_record_frame(struct animation_governor *governor, float frame_ms, float budget_ms);
+void animation_governor_record_prep(struct animation_governor *governor, float prep_ms);
+int animation_governor_update(struct animation_governor *governor, int window_count);
+void animation_governor_serialize(FILE *rsp, struct animation_governor *governor, struct animation_quality *quality, bool is_enabled);
+void animation_quality_for_tier(struct animation_quality *quality, struct animation_quality *config, int tier);
+
+void animation_batch_init(struct animation_batch *batch);
+void animation_batch_destroy(struct animation_batch *batch);
+void animation_batch_reset(struct animation_batch *batch, int count);
+void animation_batch_set(struct animation_batch *batch, int index, struct animation_lane *lane);
+void animation_batch_set_plan(struct animation_batch *batch, int index, struct animation_plan *plan, int easing);
+void animation_batch_evaluate(struct animation_batch *batch, bool is_linear);
+void animation_batch_evaluate_scalar(struct animation_batch *batch, bool is_linear);
+void animation_batch_emit(struct animation_batch *batch, int index, uint32_t id, float proxy_w, float proxy_h, struct animation_plan *plan, struct animation_backend *backend);
+
+#endif
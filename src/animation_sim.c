@@ -0,0 +1,151 @@
+static inline uint64_t animation_sim_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void animation_trace_set_transform(void *context, uint32_t id, struct animation_transform *transform)
+{
+    struct animation_trace *trace = context;
+
+    if (trace->entry_count == trace->entry_capacity) {
+        trace->entry_capacity = trace->entry_capacity ? 2 * trace->entry_capacity : 64;
+        trace->entry_list = realloc(trace->entry_list, sizeof(struct animation_trace_entry) * trace->entry_capacity);
+    }
+
+    trace->entry_list[trace->entry_count++] = (struct animation_trace_entry) {
+        .frame     = trace->frame,
+        .id        = id,
+        .transform = *transform,
+        .alpha     = -1.0f
+    };
+}
+
+//
+// NOTE: The alpha of a proxy is always set right after its transform, so it
+// belongs to the last entry. An alpha of -1 means that it was left alone.
+//
+
+static void animation_trace_set_alpha(void *context, uint32_t id, float alpha)
+{
+    struct animation_trace *trace = context;
+
+    if (trace->entry_count > 0 && trace->entry_list[trace->entry_count-1].id == id) {
+        trace->entry_list[trace->entry_count-1].alpha = alpha;
+    }
+}
+
+void animation_sim_init(struct animation_sim *sim, float duration, float refresh_rate)
+{
+    memset(sim, 0, sizeof(struct animation_sim));
+    animation_batch_init(&sim->batch);
+    sim->duration = duration;
+    sim->refresh_rate = refresh_rate;
+}
+
+void animation_sim_destroy(struct animation_sim *sim)
+{
+    animation_batch_destroy(&sim->batch);
+    free(sim->plan_list);
+    free(sim->id_list);
+    free(sim->easing_list);
+    free(sim->trace.entry_list);
+    memset(sim, 0, sizeof(struct animation_sim));
+}
+
+void animation_sim_add(struct animation_sim *sim, uint32_t id, struct animation_plan *plan, int easing)
+{
+    if (sim->count == sim->capacity) {
+        sim->capacity = sim->capacity ? 2 * sim->capacity : 16;
+        sim->plan_list = realloc(sim->plan_list, sizeof(struct animation_plan) * sim->capacity);
+        sim->id_list = realloc(sim->id_list, sizeof(uint32_t) * sim->capacity);
+        sim->easing_list = realloc(sim->easing_list, sizeof(int) * sim->capacity);
+    }
+
+    sim->plan_list[sim->count] = *plan;
+    sim->id_list[sim->count] = id;
+    sim->easing_list[sim->count] = easing;
+    ++sim->count;
+}
+
+//
+// NOTE: Runs every animation from start to end, one frame per refresh of a
+// display at the refresh rate of the simulator, and returns the number of
+// frames. The trace of a previous run is discarded. The proxy of a window is
+// captured at the size that it starts at.
+//
+
+int animation_sim_run(struct animation_sim *sim)
+{
+    struct animation_backend backend = {
+        .context       = &sim->trace,
+        .set_transform = animation_trace_set_transform,
+        .set_alpha     = animation_trace_set_alpha
+    };
+
+    int total_frames = (int)(sim->duration * sim->refresh_rate + 0.5f);
+    if (total_frames < 2) total_frames = 2;
+
+    sim->trace.entry_count = 0;
+    sim->frame_count = 0;
+    sim->elapsed_ns = 0;
+    sim->elapsed_max_ns = 0;
+
+    animation_batch_reset(&sim->batch, sim->count);
+    for (int i = 0; i < sim->count; ++i) {
+        animation_batch_set_plan(&sim->batch, i, &sim->plan_list[i], sim->easing_list[i]);
+    }
+
+    for (int frame = 0; frame <= total_frames; ++frame) {
+        uint64_t begin = animation_sim_clock_ns();
+        float t = (float) frame / (float) total_frames;
+
+        for (int i = 0; i < sim->count; ++i) {
+            sim->batch.t[i] = t;
+        }
+
+        animation_batch_evaluate(&sim->batch, sim->is_linear);
+
+        sim->trace.frame = frame;
+        for (int i = 0; i < sim->count; ++i) {
+            struct animation_plan *plan = &sim->plan_list[i];
+            animation_batch_emit(&sim->batch, i, sim->id_list[i], plan->start.w, plan->start.h, plan, &backend);
+        }
+
+        uint64_t elapsed = animation_sim_clock_ns() - begin;
+        sim->elapsed_ns += elapsed;
+        if (elapsed > sim->elapsed_max_ns) sim->elapsed_max_ns = elapsed;
+        ++sim->frame_count;
+    }
+
+    return sim->frame_count;
+}
+
+struct animation_trace_entry *animation_sim_find(struct animation_sim *sim, int frame, uint32_t id)
+{
+    for (int i = 0; i < sim->trace.entry_count; ++i) {
+        struct animation_trace_entry *entry = &sim->trace.entry_list[i];
+        if (entry->frame == frame && entry->id == id) return entry;
+    }
+
+    return NULL;
+}
+
+//
+// NOTE: One line per entry, in the same layout as the golden traces of the
+// tests, so that a golden trace can be regenerated from a run.
+//
+
+void animation_sim_serialize(FILE *rsp, struct animation_sim *sim)
+{
+    for (int i = 0; i < sim->trace.entry_count; ++i) {
+        struct animation_trace_entry *entry = &sim->trace.entry_list[i];
+        fprintf(rsp, "    { %2d, %u, { %.4ff, %.4ff, %.4ff, %.4ff, %.4ff, %.4ff }, %.4ff },\n",
+                entry->frame, entry->id,
+                entry->transform.a, entry->transform.b,
+                entry->transform.c, entry->transform.d,
+                entry->transform.tx + 0.0f, entry->transform.ty + 0.0f,
+                entry->alpha);
+    }
+}
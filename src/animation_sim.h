@@ -0,0 +1,54 @@
+#ifndef ANIMATION_SIM_H
+#define ANIMATION_SIM_H
+
+//
+// NOTE: A headless stand-in for the window server that runs the animation
+// pipeline (plan, frame kernel and backend) without any windows. Every frame
+// is computed the way the display link callback computes it, and every
+// transform and alpha that would have been set in the transaction of the frame
+// is recorded in a trace instead. It depends only on the animation core, so
+// traces can be compared against golden traces, and the cost of a frame can be
+// benchmarked, on any platform.
+//
+
+struct animation_trace_entry
+{
+    int frame;
+    uint32_t id;
+    struct animation_transform transform;
+    float alpha;
+};
+
+struct animation_trace
+{
+    struct animation_trace_entry *entry_list;
+    int entry_count;
+    int entry_capacity;
+    int frame;
+};
+
+struct animation_sim
+{
+    struct animation_batch batch;
+    struct animation_plan *plan_list;
+    uint32_t *id_list;
+    int *easing_list;
+    int count;
+    int capacity;
+    float duration;
+    float refresh_rate;
+    bool is_linear;
+    struct animation_trace trace;
+    int frame_count;
+    uint64_t elapsed_ns;
+    uint64_t elapsed_max_ns;
+};
+
+void animation_sim_init(struct animation_sim *sim, float duration, float refresh_rate);
+void animation_sim_destroy(struct animation_sim *sim);
+void animation_sim_add(struct animation_sim *sim, uint32_t id, struct animation_plan *plan, int easing);
+int animation_sim_run(struct animation_sim *sim);
+struct animation_trace_entry *animation_sim_find(struct animation_sim *sim, int frame, uint32_t id);
+void animation_sim_serialize(FILE *rsp, struct animation_sim *sim);
+
+#endif
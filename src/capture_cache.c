@@ -0,0 +1,183 @@
+static TABLE_HASH_FUNC(hash_capture_cache)
+{
+    return *(uint32_t *) key;
+}
+
+static TABLE_COMPARE_FUNC(compare_capture_cache)
+{
+    return *(uint32_t *) key_a == *(uint32_t *) key_b;
+}
+
+void capture_cache_init(struct capture_cache *cache, uint64_t budget)
+{
+    memset(cache, 0, sizeof(struct capture_cache));
+    pthread_mutex_init(&cache->lock, NULL);
+    table_init(&cache->entries, 150, hash_capture_cache, compare_capture_cache);
+    cache->budget = budget;
+}
+
+static void capture_cache_unlink(struct capture_cache *cache, struct capture_cache_entry *entry)
+{
+    if (entry->prev) entry->prev->next = entry->next;
+    else             cache->head       = entry->next;
+
+    if (entry->next) entry->next->prev = entry->prev;
+    else             cache->tail       = entry->prev;
+
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+static void capture_cache_link_front(struct capture_cache *cache, struct capture_cache_entry *entry)
+{
+    entry->prev = NULL;
+    entry->next = cache->head;
+
+    if (cache->head) cache->head->prev = entry;
+    else             cache->tail       = entry;
+
+    cache->head = entry;
+}
+
+static void capture_cache_evict(struct capture_cache *cache, struct capture_cache_entry *entry)
+{
+    capture_cache_unlink(cache, entry);
+    table_remove(&cache->entries, &entry->wid);
+
+    cache->size -= entry->size;
+    --cache->count;
+
+    CFRelease(entry->image);
+    free(entry);
+}
+
+CGImageRef capture_cache_find(struct capture_cache *cache, uint32_t wid, uint32_t generation, float alpha, uint32_t width, uint32_t height)
+{
+    CGImageRef result = NULL;
+
+    pthread_mutex_lock(&cache->lock);
+    struct capture_cache_entry *entry = table_find(&cache->entries, &wid);
+
+    if (entry) {
+        float age = (float)(read_os_timer() - entry->timestamp) / (float) read_os_freq();
+
+        if (entry->generation == generation &&
+            entry->alpha      == alpha      &&
+            entry->width      == width      &&
+            entry->height     == height     &&
+            age < CAPTURE_CACHE_MAX_AGE) {
+            capture_cache_unlink(cache, entry);
+            capture_cache_link_front(cache, entry);
+            result = (CGImageRef) CFRetain(entry->image);
+        } else {
+            capture_cache_evict(cache, entry);
+        }
+    }
+
+    if (result) {
+        ++cache->hit_count;
+    } else {
+        ++cache->miss_count;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    return result;
+}
+
+void capture_cache_store(struct capture_cache *cache, uint32_t wid, uint32_t generation, float alpha, uint32_t width, uint32_t height, CGImageRef image)
+{
+    uint64_t size = (uint64_t) CGImageGetBytesPerRow(image) * (uint64_t) CGImageGetHeight(image);
+
+    pthread_mutex_lock(&cache->lock);
+    struct capture_cache_entry *existing = table_find(&cache->entries, &wid);
+    if (existing) capture_cache_evict(cache, existing);
+
+    if (size <= cache->budget) {
+        while (cache->tail && cache->size + size > cache->budget) {
+            capture_cache_evict(cache, cache->tail);
+            ++cache->evict_count;
+        }
+
+        struct capture_cache_entry *entry = malloc(sizeof(struct capture_cache_entry));
+        memset(entry, 0, sizeof(struct capture_cache_entry));
+
+        entry->wid        = wid;
+        entry->generation = generation;
+        entry->alpha      = alpha;
+        entry->width      = width;
+        entry->height     = height;
+        entry->timestamp  = read_os_timer();
+        entry->size       = size;
+        entry->image      = (CGImageRef) CFRetain(image);
+
+        table_add(&cache->entries, &entry->wid, entry);
+        capture_cache_link_front(cache, entry);
+
+        cache->size += size;
+        ++cache->count;
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void capture_cache_remove(struct capture_cache *cache, uint32_t wid)
+{
+    pthread_mutex_lock(&cache->lock);
+    struct capture_cache_entry *entry = table_find(&cache->entries, &wid);
+    if (entry) capture_cache_evict(cache, entry);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void capture_cache_destroy(struct capture_cache *cache)
+{
+    pthread_mutex_lock(&cache->lock);
+    while (cache->tail) capture_cache_evict(cache, cache->tail);
+    pthread_mutex_unlock(&cache->lock);
+
+    table_free(&cache->entries);
+    pthread_mutex_destroy(&cache->lock);
+}
+
+//
+// NOTE: Moving a window does not change its contents, but resizing it, changing
+// its title, or changing whether it is focused makes it draw something else.
+//
+
+void capture_cache_invalidate_for_signal(struct capture_cache *cache, enum signal_type type, void *context)
+{
+    switch (type) {
+    case SIGNAL_WINDOW_RESIZED:
+    case SIGNAL_WINDOW_TITLE_CHANGED:
+    case SIGNAL_WINDOW_FOCUSED:
+    case SIGNAL_WINDOW_MINIMIZED:
+    case SIGNAL_WINDOW_DEMINIMIZED: {
+        struct window *window = context;
+        ++window->content_generation;
+    } break;
+    case SIGNAL_WINDOW_DESTROYED: {
+        struct window *window = context;
+        capture_cache_remove(cache, window->id);
+    } break;
+    default: break;
+    }
+}
+
+void capture_cache_serialize(FILE *rsp, struct capture_cache *cache)
+{
+    pthread_mutex_lock(&cache->lock);
+    fprintf(rsp,
+            "{\n"
+            "\t\"hits\":%lld,\n"
+            "\t\"misses\":%lld,\n"
+            "\t\"evictions\":%lld,\n"
+            "\t\"entries\":%d,\n"
+            "\t\"size\":%lld,\n"
+            "\t\"budget\":%lld\n"
+            "}",
+            cache->hit_count,
+            cache->miss_count,
+            cache->evict_count,
+            cache->count,
+            cache->size,
+            cache->budget);
+    pthread_mutex_unlock(&cache->lock);
+}
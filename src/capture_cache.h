@@ -0,0 +1,56 @@
+#ifndef CAPTURE_CACHE_H
+#define CAPTURE_CACHE_H
+
+#define CAPTURE_CACHE_BUDGET  (64ULL << 20)
+#define CAPTURE_CACHE_MAX_AGE 1.0f
+
+//
+// NOTE: Images captured for animation proxies, keyed by window id and by the
+// content generation of the window at the time of capture. The generation is
+// bumped by the events that change what a window looks like, and an entry is
+// never used once it is older than CAPTURE_CACHE_MAX_AGE, which bounds how long
+// damage that is not reported through an event can go unnoticed. An entry also
+// remembers the size of the window it was captured from, and is not used for a
+// window that has since changed size without an event saying so. Entries are
+// kept on a list in the order they were last used, and the least recently used
+// ones are evicted once their total size exceeds the budget. Lookups happen on
+// the proxy workers, so every operation takes the lock of the cache.
+//
+
+struct capture_cache_entry
+{
+    uint32_t wid;
+    uint32_t generation;
+    float alpha;
+    uint32_t width;
+    uint32_t height;
+    uint64_t timestamp;
+    uint64_t size;
+    CGImageRef image;
+    struct capture_cache_entry *prev;
+    struct capture_cache_entry *next;
+};
+
+struct capture_cache
+{
+    pthread_mutex_t lock;
+    struct table entries;
+    struct capture_cache_entry *head;
+    struct capture_cache_entry *tail;
+    int count;
+    uint64_t size;
+    uint64_t budget;
+    uint64_t hit_count;
+    uint64_t miss_count;
+    uint64_t evict_count;
+};
+
+void capture_cache_init(struct capture_cache *cache, uint64_t budget);
+CGImageRef capture_cache_find(struct capture_cache *cache, uint32_t wid, uint32_t generation, float alpha, uint32_t width, uint32_t height);
+void capture_cache_store(struct capture_cache *cache, uint32_t wid, uint32_t generation, float alpha, uint32_t width, uint32_t height, CGImageRef image);
+void capture_cache_destroy(struct capture_cache *cache);
+void capture_cache_remove(struct capture_cache *cache, uint32_t wid);
+void capture_cache_invalidate_for_signal(struct capture_cache *cache, enum signal_type type, void *context);
+void capture_cache_serialize(FILE *rsp, struct capture_cache *cache);
+
+#endif
@@ -1,4 +1,5 @@
 extern struct event_loop g_event_loop;
+extern struct query_cache g_query_cache;
 extern int g_connection;
 
 #pragma clang diagnostic push
@@ -17,23 +18,17 @@ static DISPLAY_EVENT_HANDLER(display_handler)
 }
 #pragma clang diagnostic pop
 
-void display_serialize(FILE *rsp, uint32_t did, uint64_t flags)
+static void display_serialize_properties(struct serializer *s, uint32_t did, uint64_t flags)
 {
     TIME_FUNCTION;
 
-    if (flags == 0x0) flags |= ~flags;
-
-    bool did_output = false;
-    fprintf(rsp, "{\n");
+    serializer_begin_object(s, serializer_property_count(flags, display_property_val, array_count(display_property_val)));
 
     if (flags & DISPLAY_PROPERTY_ID) {
-        fprintf(rsp, "\t\"id\":%d", did);
-        did_output = true;
+        serializer_key(s, "id"); serializer_int(s, did);
     }
 
     if (flags & DISPLAY_PROPERTY_UUID) {
-        if (did_output) fprintf(rsp, ",\n");
-
         char *uuid = NULL;
         CFStringRef uuid_ref = display_uuid(did);
         if (uuid_ref) {
@@ -41,61 +36,54 @@ void display_serialize(FILE *rsp, uint32_t did, uint64_t flags)
             CFRelease(uuid_ref);
         }
 
-        fprintf(rsp, "\t\"uuid\":\"%s\"", uuid ? uuid : "<unknown>");
-        did_output = true;
+        serializer_key(s, "uuid"); serializer_string(s, uuid ? uuid : "<unknown>");
     }
 
     if (flags & DISPLAY_PROPERTY_INDEX) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"index\":%d", display_manager_display_id_arrangement(did));
-        did_output = true;
+        serializer_key(s, "index"); serializer_int(s, display_manager_display_id_arrangement(did));
     }
 
     if (flags & DISPLAY_PROPERTY_LABEL) {
-        if (did_output) fprintf(rsp, ",\n");
-
         struct display_label *display_label = display_manager_get_label_for_display(&g_display_manager, did);
-        fprintf(rsp, "\t\"label\":\"%s\"", display_label ? display_label->label : "");
-        did_output = true;
+        serializer_key(s, "label"); serializer_string(s, display_label ? display_label->label : "");
     }
 
     if (flags & DISPLAY_PROPERTY_FRAME) {
-        if (did_output) fprintf(rsp, ",\n");
-
         CGRect frame = CGDisplayBounds(did);
-        fprintf(rsp, "\t\"frame\":{\n\t\t\"x\":%.4f,\n\t\t\"y\":%.4f,\n\t\t\"w\":%.4f,\n\t\t\"h\":%.4f\n\t}", frame.origin.x, frame.origin.y, frame.size.width, frame.size.height);
-        did_output = true;
+        serializer_key(s, "frame"); serializer_frame(s, frame);
     }
 
     if (flags & DISPLAY_PROPERTY_SPACES) {
-        if (did_output) fprintf(rsp, ",\n");
-
         int count;
         uint64_t *space_list = display_space_list(did, &count);
 
-        fprintf(rsp, "\t\"spaces\":[");
+        serializer_key(s, "spaces");
+        serializer_begin_array(s, space_list ? count : 0);
         if (space_list) {
             int first_mci = space_manager_mission_control_index(space_list[0]);
             for (int i = 0; i < count; ++i) {
-                if (i < count - 1) {
-                    fprintf(rsp, "%d, ", first_mci + i);
-                } else {
-                    fprintf(rsp, "%d", first_mci + i);
-                }
+                serializer_int(s, first_mci + i);
             }
         }
-        fprintf(rsp, "]");
-        did_output = true;
+        serializer_end_array(s);
     }
 
     if (flags & DISPLAY_PROPERTY_HAS_FOCUS) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-focus\":%s", json_bool(did == g_display_manager.current_display_id));
+        serializer_key(s, "has-focus"); serializer_bool(s, did == g_display_manager.current_display_id);
     }
 
-    fprintf(rsp, "\n}");
+    serializer_end_object(s);
+}
+
+void display_serialize(struct serializer *s, uint32_t did, uint64_t flags)
+{
+    if (flags == 0x0) flags |= ~flags;
+
+    if (query_cache_emit(&g_query_cache, s, QUERY_CACHE_DOMAIN_DISPLAY, did, 0, flags)) return;
+
+    struct query_cache_capture capture;
+    display_serialize_properties(query_cache_begin(&capture, s, QUERY_CACHE_DOMAIN_DISPLAY, did, flags), did, flags);
+    query_cache_end(&g_query_cache, &capture, 0);
 }
 
 CFStringRef display_uuid(uint32_t did)
@@ -176,6 +164,24 @@ CGPoint display_center(uint32_t did)
     return (CGPoint) { bounds.origin.x + bounds.size.width/2, bounds.origin.y + bounds.size.height/2 };
 }
 
+float display_refresh_rate(uint32_t did)
+{
+    float refresh_rate = 0.0f;
+
+    CGDisplayModeRef mode = CGDisplayCopyDisplayMode(did);
+    if (mode) {
+        refresh_rate = CGDisplayModeGetRefreshRate(mode);
+        CGDisplayModeRelease(mode);
+    }
+
+    //
+    // NOTE: Built-in panels that are not driven at a fixed rate report a
+    // refresh rate of zero; they refresh at 60hz.
+    //
+
+    return refresh_rate > 0.0f ? refresh_rate : 60.0f;
+}
+
 uint64_t display_space_id(uint32_t did)
 {
     CFStringRef uuid = display_uuid(did);
@@ -34,11 +34,12 @@ static char *display_property_str[] =
 #undef DISPLAY_PROPERTY_ENTRY
 };
 
-void display_serialize(FILE *rsp, uint32_t did, uint64_t flags);
+void display_serialize(struct serializer *s, uint32_t did, uint64_t flags);
 CFStringRef display_uuid(uint32_t did);
 uint32_t display_id(CFStringRef uuid);
 CGRect display_bounds_constrained(uint32_t did, bool ignore_external_bar);
 CGPoint display_center(uint32_t did);
+float display_refresh_rate(uint32_t did);
 uint64_t display_space_id(uint32_t did);
 int display_space_count(uint32_t did);
 uint64_t *display_space_list(uint32_t did, int *count);
@@ -2,7 +2,16 @@ extern struct display_manager g_display_manager;
 extern struct window_manager g_window_manager;
 extern int g_connection;
 
-bool display_manager_query_displays(FILE *rsp, uint64_t flags)
+static bool display_manager_display_matches(struct query_predicate *where, uint32_t did)
+{
+    struct query_predicate_capture capture;
+    if (!query_predicate_begin(&capture)) return false;
+
+    display_serialize(&capture.s, did, where->flags);
+    return query_predicate_end(where, &capture);
+}
+
+bool display_manager_query_displays(struct serializer *s, uint64_t flags, struct query_predicate *where)
 {
     TIME_FUNCTION;
 
@@ -10,12 +19,19 @@ bool display_manager_query_displays(FILE *rsp, uint64_t flags)
     uint32_t *display_list = display_manager_active_display_list(&count);
     if (!display_list) return false;
 
-    fprintf(rsp, "[");
+    if (where) {
+        int match_count = 0;
+        for (int i = 0; i < count; ++i) {
+            if (display_manager_display_matches(where, display_list[i])) display_list[match_count++] = display_list[i];
+        }
+        count = match_count;
+    }
+
+    serializer_begin_array(s, count);
     for (int i = 0; i < count; ++i) {
-        display_serialize(rsp, display_list[i], flags);
-        fprintf(rsp, "%c", i < count - 1 ? ',' : ']');
+        display_serialize(s, display_list[i], flags);
     }
-    fprintf(rsp, "\n");
+    serializer_end_array(s);
 
     return true;
 }
@@ -273,14 +289,14 @@ uint32_t display_manager_find_closest_display_in_direction(uint32_t source_did,
     int best_distance = INT_MAX;
 
     struct area source_area = area_from_cgrect(CGDisplayBounds(source_did));
-    CGPoint source_area_max = area_max_point(source_area);
+    struct area_point source_area_max = area_max_point(source_area);
 
     for (int i = 0; i < display_count; ++i) {
         uint32_t did = display_list[i];
         if (did == source_did) continue;
 
         struct area target_area = area_from_cgrect(CGDisplayBounds(did));
-        CGPoint target_area_max = area_max_point(target_area);
+        struct area_point target_area_max = area_max_point(target_area);
 
         if (area_is_in_direction(&source_area, source_area_max, &target_area, target_area_max, direction)) {
             int distance = area_distance_in_direction(&source_area, source_area_max, &target_area, target_area_max, direction);
@@ -5,9 +5,12 @@ extern struct space_manager g_space_manager;
 extern struct window_manager g_window_manager;
 extern struct mouse_state g_mouse_state;
 extern enum mission_control_mode g_mission_control_mode;
+extern struct event_stream g_event_stream;
+extern struct query_cache g_query_cache;
 extern int g_connection;
 extern void *g_workspace_context;
 extern int g_layer_below_window_level;
+extern char g_layout_file[];
 void push_janky_update(uint32_t code, const void *payload, size_t size);
 void push_janky_flags(uint32_t wid,
                       bool floating,
@@ -66,6 +69,9 @@ static void window_did_receive_focus(struct window_manager *wm, struct mouse_sta
     wm->focused_window_psn = window->application->psn;
     ms->ffm_window_id = 0;
 
+    struct view *view = window_manager_find_managed_window(wm, window);
+    if (view) view_scroll_to_window(view, window->id);
+
     //struct view *view = window_manager_find_managed_window(&g_window_manager, window);
     //if (!view) return;
 
@@ -1237,6 +1243,13 @@ static EVENT_HANDLER(MOUSE_DOWN)
     struct window *window = window_manager_find_window_at_point(&g_window_manager, point);
     if (!window || window_check_flag(window, WINDOW_FULLSCREEN)) goto out;
 
+    //
+    // NOTE: is-grabbed follows g_mouse_state without any signal being sent,
+    // so cached query fragments are dropped whenever a window is grabbed or
+    // released.
+    //
+
+    query_cache_invalidate_all(&g_query_cache);
     g_mouse_state.window = window;
     g_mouse_state.window_frame = g_mouse_state.window->frame;
     g_mouse_state.down_location = point;
@@ -1385,6 +1398,7 @@ static EVENT_HANDLER(MOUSE_UP)
     }
     
 err:
+    query_cache_invalidate_all(&g_query_cache);
     g_mouse_state.window = NULL;
 res:
     g_mouse_state.current_action = MOUSE_MODE_NONE;
@@ -1401,6 +1415,7 @@ static EVENT_HANDLER(MOUSE_DRAGGED){
 
     if (!__sync_bool_compare_and_swap(&g_mouse_state.window->id_ptr, &g_mouse_state.window->id, &g_mouse_state.window->id)) {
         debug("%s: %d has been marked invalid by the system, ignoring event..\n", __FUNCTION__, g_mouse_state.window->id);
+        query_cache_invalidate_all(&g_query_cache);
         g_mouse_state.window = NULL;
         g_mouse_state.current_action = MOUSE_MODE_NONE;
         CFRelease(context);
@@ -1786,6 +1801,17 @@ static EVENT_HANDLER(SYSTEM_WOKE)
     event_signal_push(SIGNAL_SYSTEM_WOKE, NULL);
 }
 
+static EVENT_HANDLER(EVENT_STREAM_FLUSH)
+{
+    g_event_stream.flush_scheduled = false;
+}
+
+static EVENT_HANDLER(LAYOUT_SAVE)
+{
+    space_manager_save_layouts(&g_space_manager, g_layout_file);
+    if (param1) exit(EXIT_SUCCESS);
+}
+
 static EVENT_HANDLER(DAEMON_MESSAGE)
 {
     TIME_FUNCTION;
@@ -1843,6 +1869,7 @@ static void *event_loop_run(void *context)
             }
 
             event_signal_flush();
+            event_stream_flush();
             ts_reset();
 
             profile_end_and_print();
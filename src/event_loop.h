@@ -43,6 +43,8 @@
     EVENT_TYPE_ENTRY(MENU_BAR_HIDDEN_CHANGED) \
     EVENT_TYPE_ENTRY(DOCK_DID_CHANGE_PREF) \
     EVENT_TYPE_ENTRY(SYSTEM_WOKE) \
+    EVENT_TYPE_ENTRY(EVENT_STREAM_FLUSH) \
+    EVENT_TYPE_ENTRY(LAYOUT_SAVE) \
     EVENT_TYPE_ENTRY(DAEMON_MESSAGE)
 
 enum event_type
@@ -4,6 +4,8 @@ extern struct process_manager g_process_manager;
 extern struct display_manager g_display_manager;
 extern struct space_manager g_space_manager;
 extern struct window_manager g_window_manager;
+extern struct query_cache g_query_cache;
+extern struct capture_cache g_capture_cache;
 
 static bool event_signal_filter(struct event_signal *es, struct signal *signal)
 {
@@ -98,6 +100,10 @@ void event_signal_flush(void)
 
 void event_signal_push(enum signal_type type, void *context)
 {
+    query_cache_invalidate_for_signal(&g_query_cache, type, context);
+    capture_cache_invalidate_for_signal(&g_capture_cache, type, context);
+    event_stream_push(type, context);
+
     int signal_count = buf_len(g_signal_event[type]);
     if (!signal_count) return;
 
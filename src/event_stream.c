@@ -0,0 +1,341 @@
+extern struct event_stream g_event_stream;
+extern struct event_loop g_event_loop;
+extern struct display_manager g_display_manager;
+extern struct space_manager g_space_manager;
+
+struct event_stream_record
+{
+    FILE *file;
+    char *data;
+    size_t size;
+    struct serializer s;
+};
+
+static uint32_t event_stream_domain(enum signal_type type)
+{
+    switch (type) {
+    default: return 0;
+
+    case SIGNAL_WINDOW_CREATED:
+    case SIGNAL_WINDOW_DESTROYED:
+    case SIGNAL_WINDOW_FOCUSED:
+    case SIGNAL_WINDOW_MOVED:
+    case SIGNAL_WINDOW_RESIZED:
+    case SIGNAL_WINDOW_MINIMIZED:
+    case SIGNAL_WINDOW_DEMINIMIZED:
+    case SIGNAL_WINDOW_TITLE_CHANGED: return EVENT_STREAM_DOMAIN_WINDOWS;
+
+    case SIGNAL_SPACE_CREATED:
+    case SIGNAL_SPACE_DESTROYED:
+    case SIGNAL_SPACE_CHANGED: return EVENT_STREAM_DOMAIN_SPACES;
+
+    case SIGNAL_DISPLAY_ADDED:
+    case SIGNAL_DISPLAY_REMOVED:
+    case SIGNAL_DISPLAY_MOVED:
+    case SIGNAL_DISPLAY_RESIZED:
+    case SIGNAL_DISPLAY_CHANGED: return EVENT_STREAM_DOMAIN_DISPLAYS;
+    }
+}
+
+static bool event_stream_has_subscribers(uint32_t domain, enum serializer_format format)
+{
+    for (int i = 0; i < buf_len(g_event_stream.subscribers); ++i) {
+        struct event_stream_subscriber *subscriber = &g_event_stream.subscribers[i];
+        if ((subscriber->domains & domain) && subscriber->format == format) return true;
+    }
+
+    return false;
+}
+
+static bool event_stream_record_begin(struct event_stream_record *record, enum serializer_format format)
+{
+    record->data = NULL;
+    record->size = 0;
+    record->file = open_memstream(&record->data, &record->size);
+    if (!record->file) return false;
+
+    record->s = serializer_create(record->file, format);
+    return true;
+}
+
+static void event_stream_record_end(struct event_stream_record *record)
+{
+    serializer_end(&record->s);
+    fclose(record->file);
+}
+
+static bool event_stream_subscriber_append(struct event_stream_subscriber *subscriber, char *data, size_t size)
+{
+    if (subscriber->buffer_used + size > EVENT_STREAM_BUFFER_SIZE) return false;
+
+    memcpy(subscriber->buffer + subscriber->buffer_used, data, size);
+    subscriber->buffer_used += size;
+
+    return true;
+}
+
+//
+// NOTE: Records are only ever appended whole. When a subscriber is too slow to
+// keep up and its buffer is full, every following record is discarded until the
+// buffer has been drained, at which point a single resync record is queued.
+// The consumer is expected to re-query the state it mirrors when it sees it.
+//
+
+static void event_stream_enqueue(uint32_t domain, enum serializer_format format, char *data, size_t size)
+{
+    for (int i = 0; i < buf_len(g_event_stream.subscribers); ++i) {
+        struct event_stream_subscriber *subscriber = &g_event_stream.subscribers[i];
+
+        if (!(subscriber->domains & domain)) continue;
+        if (subscriber->format != format)     continue;
+        if (subscriber->needs_resync)         continue;
+
+        if (!event_stream_subscriber_append(subscriber, data, size)) {
+            debug("%s: subscriber %d is falling behind, discarding records until resync\n", __FUNCTION__, subscriber->sockfd);
+            subscriber->needs_resync = true;
+        }
+    }
+}
+
+static void event_stream_serialize_event(struct serializer *s, enum signal_type type, void *context)
+{
+    serializer_begin_object(s, 2);
+    serializer_key(s, "event"); serializer_string(s, signal_type_str[type]);
+
+    switch (type) {
+    default: break;
+
+    case SIGNAL_WINDOW_CREATED:
+    case SIGNAL_WINDOW_FOCUSED:
+    case SIGNAL_WINDOW_DEMINIMIZED:
+    case SIGNAL_WINDOW_TITLE_CHANGED: {
+        serializer_key(s, "window"); window_serialize(s, context, 0, NULL);
+    } break;
+    case SIGNAL_WINDOW_MOVED:
+    case SIGNAL_WINDOW_RESIZED: {
+        serializer_key(s, "window"); window_serialize(s, context, WINDOW_PROPERTY_ID | WINDOW_PROPERTY_FRAME, NULL);
+    } break;
+    case SIGNAL_WINDOW_MINIMIZED: {
+        serializer_key(s, "window"); window_serialize(s, context, WINDOW_PROPERTY_ID | WINDOW_PROPERTY_IS_MINIMIZED, NULL);
+    } break;
+    case SIGNAL_WINDOW_DESTROYED: {
+        struct window *window = context;
+        serializer_key(s, "id"); serializer_uint(s, window->id);
+    } break;
+    case SIGNAL_SPACE_CREATED:
+    case SIGNAL_SPACE_DESTROYED: {
+        uint64_t sid = (uint64_t)(uintptr_t) context;
+        serializer_key(s, "id"); serializer_uint(s, sid);
+    } break;
+    case SIGNAL_SPACE_CHANGED: {
+        struct view *view = space_manager_query_view(&g_space_manager, g_space_manager.current_space_id);
+        if (view) {
+            serializer_key(s, "space"); view_serialize(s, view, 0);
+        } else {
+            serializer_key(s, "id"); serializer_uint(s, g_space_manager.current_space_id);
+        }
+    } break;
+    case SIGNAL_DISPLAY_ADDED:
+    case SIGNAL_DISPLAY_MOVED:
+    case SIGNAL_DISPLAY_RESIZED: {
+        uint32_t did = (uint32_t)(uintptr_t) context;
+        serializer_key(s, "display"); display_serialize(s, did, 0);
+    } break;
+    case SIGNAL_DISPLAY_REMOVED: {
+        uint32_t did = (uint32_t)(uintptr_t) context;
+        serializer_key(s, "id"); serializer_uint(s, did);
+    } break;
+    case SIGNAL_DISPLAY_CHANGED: {
+        serializer_key(s, "display"); display_serialize(s, g_display_manager.current_display_id, 0);
+    } break;
+    }
+
+    serializer_end_object(s);
+}
+
+static void event_stream_serialize_layout(struct serializer *s, struct view *view)
+{
+    int window_count = 0;
+    for (struct window_node *node = window_node_find_first_leaf(view->root); node; node = window_node_find_next_leaf(node)) {
+        window_count += node->window_count;
+    }
+
+    serializer_begin_object(s, 3);
+    serializer_key(s, "event"); serializer_string(s, "layout_changed");
+    serializer_key(s, "space"); serializer_uint(s, view->sid);
+    serializer_key(s, "windows");
+    serializer_begin_array(s, window_count);
+
+    for (struct window_node *node = window_node_find_first_leaf(view->root); node; node = window_node_find_next_leaf(node)) {
+        CGRect frame = { { node->area.x, node->area.y }, { node->area.w, node->area.h } };
+
+        for (int i = 0; i < node->window_count; ++i) {
+            serializer_begin_object(s, 2);
+            serializer_key(s, "id");    serializer_uint(s, node->window_order[i]);
+            serializer_key(s, "frame"); serializer_frame(s, frame);
+            serializer_end_object(s);
+        }
+    }
+
+    serializer_end_array(s);
+    serializer_end_object(s);
+}
+
+void event_stream_serialize_snapshot(struct serializer *s, uint32_t domains)
+{
+    serializer_begin_object(s, 1 + __builtin_popcount(domains));
+    serializer_key(s, "event"); serializer_string(s, "snapshot");
+
+    if (domains & EVENT_STREAM_DOMAIN_WINDOWS) {
+        serializer_key(s, "windows");
+        window_manager_query_windows_for_displays(s, 0, NULL);
+    }
+
+    if (domains & EVENT_STREAM_DOMAIN_SPACES) {
+        serializer_key(s, "spaces");
+        if (!space_manager_query_spaces_for_displays(s, 0, NULL)) {
+            serializer_begin_array(s, 0);
+            serializer_end_array(s);
+        }
+    }
+
+    if (domains & EVENT_STREAM_DOMAIN_DISPLAYS) {
+        serializer_key(s, "displays");
+        if (!display_manager_query_displays(s, 0, NULL)) {
+            serializer_begin_array(s, 0);
+            serializer_end_array(s);
+        }
+    }
+
+    serializer_end_object(s);
+}
+
+bool event_stream_add_subscriber(int sockfd, uint32_t domains, enum serializer_format format)
+{
+    char *buffer = malloc(EVENT_STREAM_BUFFER_SIZE);
+    if (!buffer) return false;
+
+    //
+    // NOTE: The daemon must never block on a subscriber, and signal commands
+    // are spawned through fork+exec; they should not inherit the connection.
+    //
+
+    fcntl(sockfd, F_SETFL, O_NONBLOCK | fcntl(sockfd, F_GETFL));
+    fcntl(sockfd, F_SETFD, FD_CLOEXEC | fcntl(sockfd, F_GETFD));
+
+    struct event_stream_subscriber subscriber = {
+        .sockfd  = sockfd,
+        .domains = domains,
+        .format  = format,
+        .buffer  = buffer
+    };
+
+    buf_push(g_event_stream.subscribers, subscriber);
+    debug("%s: %d (domains: %x, format: %s)\n", __FUNCTION__, sockfd, domains, serializer_format_str[format]);
+
+    return true;
+}
+
+void event_stream_push(enum signal_type type, void *context)
+{
+    uint32_t domain = event_stream_domain(type);
+    if (!domain) return;
+
+    for (int format = 0; format < array_count(serializer_format_str); ++format) {
+        if (!event_stream_has_subscribers(domain, format)) continue;
+
+        struct event_stream_record record;
+        if (!event_stream_record_begin(&record, format)) continue;
+
+        event_stream_serialize_event(&record.s, type, context);
+        event_stream_record_end(&record);
+
+        event_stream_enqueue(domain, format, record.data, record.size);
+        free(record.data);
+    }
+}
+
+void event_stream_push_layout(struct view *view)
+{
+    if (!view->root) return;
+
+    for (int format = 0; format < array_count(serializer_format_str); ++format) {
+        if (!event_stream_has_subscribers(EVENT_STREAM_DOMAIN_SPACES, format)) continue;
+
+        struct event_stream_record record;
+        if (!event_stream_record_begin(&record, format)) continue;
+
+        event_stream_serialize_layout(&record.s, view);
+        event_stream_record_end(&record);
+
+        event_stream_enqueue(EVENT_STREAM_DOMAIN_SPACES, format, record.data, record.size);
+        free(record.data);
+    }
+}
+
+static void event_stream_queue_resync(struct event_stream_subscriber *subscriber)
+{
+    struct event_stream_record record;
+    if (!event_stream_record_begin(&record, subscriber->format)) return;
+
+    serializer_begin_object(&record.s, 1);
+    serializer_key(&record.s, "event"); serializer_string(&record.s, "resync");
+    serializer_end_object(&record.s);
+    event_stream_record_end(&record);
+
+    if (event_stream_subscriber_append(subscriber, record.data, record.size)) {
+        subscriber->needs_resync = false;
+    }
+
+    free(record.data);
+}
+
+static bool event_stream_subscriber_write(struct event_stream_subscriber *subscriber)
+{
+    if (subscriber->needs_resync && subscriber->buffer_used == 0) {
+        event_stream_queue_resync(subscriber);
+    }
+
+    if (subscriber->buffer_used == 0) return true;
+
+    ssize_t bytes_written = write(subscriber->sockfd, subscriber->buffer, subscriber->buffer_used);
+    if (bytes_written > 0) {
+        subscriber->buffer_used -= bytes_written;
+        memmove(subscriber->buffer, subscriber->buffer + bytes_written, subscriber->buffer_used);
+        subscriber->stalled_count = 0;
+        return true;
+    }
+
+    if (bytes_written == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return ++subscriber->stalled_count < EVENT_STREAM_MAX_STALLED;
+    }
+
+    return false;
+}
+
+void event_stream_flush(void)
+{
+    bool has_pending = false;
+
+    for (int i = 0; i < buf_len(g_event_stream.subscribers);) {
+        struct event_stream_subscriber *subscriber = &g_event_stream.subscribers[i];
+
+        if (!event_stream_subscriber_write(subscriber)) {
+            debug("%s: dropping subscriber %d\n", __FUNCTION__, subscriber->sockfd);
+            socket_close(subscriber->sockfd);
+            free(subscriber->buffer);
+            buf_del(g_event_stream.subscribers, i);
+            continue;
+        }
+
+        if (subscriber->buffer_used || subscriber->needs_resync) has_pending = true;
+        ++i;
+    }
+
+    if (has_pending && !g_event_stream.flush_scheduled) {
+        g_event_stream.flush_scheduled = true;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, EVENT_STREAM_RETRY_INTERVAL * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
+            event_loop_post(&g_event_loop, EVENT_STREAM_FLUSH, NULL, 0);
+        });
+    }
+}
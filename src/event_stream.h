@@ -0,0 +1,39 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#define EVENT_STREAM_BUFFER_SIZE      KILOBYTES(64)
+#define EVENT_STREAM_RETRY_INTERVAL   0.05f
+#define EVENT_STREAM_MAX_STALLED      100
+
+enum event_stream_domain
+{
+    EVENT_STREAM_DOMAIN_WINDOWS  = 0x1,
+    EVENT_STREAM_DOMAIN_SPACES   = 0x2,
+    EVENT_STREAM_DOMAIN_DISPLAYS = 0x4,
+    EVENT_STREAM_DOMAIN_ALL      = 0x7
+};
+
+struct event_stream_subscriber
+{
+    int sockfd;
+    uint32_t domains;
+    enum serializer_format format;
+    bool needs_resync;
+    int stalled_count;
+    int buffer_used;
+    char *buffer;
+};
+
+struct event_stream
+{
+    struct event_stream_subscriber *subscribers;
+    bool flush_scheduled;
+};
+
+void event_stream_serialize_snapshot(struct serializer *s, uint32_t domains);
+bool event_stream_add_subscriber(int sockfd, uint32_t domains, enum serializer_format format);
+void event_stream_push(enum signal_type type, void *context);
+void event_stream_push_layout(struct view *view);
+void event_stream_flush(void);
+
+#endif
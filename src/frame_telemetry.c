@@ -0,0 +1,156 @@
+//
+// NOTE: The time buckets are in microseconds and line up with the frame
+// intervals of 240, 120, 60 and 30Hz displays.
+//
+
+static const uint64_t frame_time_bounds[FRAME_HISTOGRAM_BUCKET_COUNT]   = { 250, 500, 1000, 2000, 4166, 8333, 16666, 33333, 66666, UINT64_MAX };
+static const uint64_t frame_missed_bounds[FRAME_HISTOGRAM_BUCKET_COUNT] = { 0, 1, 2, 3, 4, 6, 8, 16, 32, UINT64_MAX };
+
+static const char *frame_profile_flag_str[] =
+{
+    "frame_based",
+    "blur",
+    "shadows",
+    "two_phase",
+    "reduced_resolution",
+    "fast_mode"
+};
+
+void frame_histogram_add(struct frame_histogram *histogram, const uint64_t *bounds, uint64_t value)
+{
+    int bucket = 0;
+    while (bucket < FRAME_HISTOGRAM_BUCKET_COUNT - 1 && value > bounds[bucket]) ++bucket;
+
+    histogram->bucket[bucket] += 1;
+    histogram->count += 1;
+    histogram->sum += value;
+    if (value > histogram->max) histogram->max = value;
+}
+
+//
+// NOTE: Returns the upper bound of the bucket that the percentile falls in,
+// which is never reported above the largest value that was recorded.
+//
+
+uint64_t frame_histogram_percentile(struct frame_histogram *histogram, const uint64_t *bounds, float percentile)
+{
+    if (!histogram->count) return 0;
+
+    uint64_t rank = (uint64_t) ceilf(percentile * (float) histogram->count);
+    if (rank < 1) rank = 1;
+
+    uint64_t total = 0;
+    for (int i = 0; i < FRAME_HISTOGRAM_BUCKET_COUNT; ++i) {
+        total += histogram->bucket[i];
+        if (total >= rank) return bounds[i] < histogram->max ? bounds[i] : histogram->max;
+    }
+
+    return histogram->max;
+}
+
+void frame_telemetry_init(struct frame_telemetry *telemetry)
+{
+    memset(telemetry, 0, sizeof(struct frame_telemetry));
+    pthread_mutex_init(&telemetry->lock, NULL);
+}
+
+void frame_telemetry_record_frame(struct frame_telemetry *telemetry, struct frame_sample *sample)
+{
+    pthread_mutex_lock(&telemetry->lock);
+    struct frame_profile *profile = &telemetry->profile[sample->profile & (FRAME_PROFILE_COUNT - 1)];
+
+    profile->frame_count += 1;
+    frame_histogram_add(&profile->cpu, frame_time_bounds, sample->cpu_ns / 1000);
+    frame_histogram_add(&profile->commit, frame_time_bounds, sample->commit_ns / 1000);
+
+    if (sample->slack_ns < 0) {
+        profile->missed_frame_count += 1;
+        frame_histogram_add(&profile->late, frame_time_bounds, (uint64_t)(-sample->slack_ns) / 1000);
+    } else {
+        frame_histogram_add(&profile->slack, frame_time_bounds, (uint64_t) sample->slack_ns / 1000);
+    }
+    pthread_mutex_unlock(&telemetry->lock);
+}
+
+void frame_telemetry_record_animation(struct frame_telemetry *telemetry, uint32_t profile, uint64_t missed_frame_count)
+{
+    pthread_mutex_lock(&telemetry->lock);
+    struct frame_profile *entry = &telemetry->profile[profile & (FRAME_PROFILE_COUNT - 1)];
+    entry->animation_count += 1;
+    frame_histogram_add(&entry->missed_per_animation, frame_missed_bounds, missed_frame_count);
+    pthread_mutex_unlock(&telemetry->lock);
+}
+
+static void frame_histogram_serialize(FILE *rsp, char *name, struct frame_histogram *histogram, const uint64_t *bounds, bool last)
+{
+    fprintf(rsp,
+            "\t\t\"%s\":{\n"
+            "\t\t\t\"count\":%lld,\n"
+            "\t\t\t\"mean\":%.1f,\n"
+            "\t\t\t\"max\":%lld,\n"
+            "\t\t\t\"p50\":%lld,\n"
+            "\t\t\t\"p95\":%lld,\n"
+            "\t\t\t\"p99\":%lld,\n"
+            "\t\t\t\"buckets\":[",
+            name,
+            histogram->count,
+            histogram->count ? (double) histogram->sum / (double) histogram->count : 0.0,
+            histogram->max,
+            frame_histogram_percentile(histogram, bounds, 0.50f),
+            frame_histogram_percentile(histogram, bounds, 0.95f),
+            frame_histogram_percentile(histogram, bounds, 0.99f));
+
+    for (int i = 0; i < FRAME_HISTOGRAM_BUCKET_COUNT; ++i) {
+        fprintf(rsp, "%s%lld", i ? "," : "", histogram->bucket[i]);
+    }
+
+    fprintf(rsp, "]\n\t\t}%s\n", last ? "" : ",");
+}
+
+static void frame_bounds_serialize(FILE *rsp, char *name, const uint64_t *bounds)
+{
+    fprintf(rsp, "\t\"%s\":[", name);
+    for (int i = 0; i < FRAME_HISTOGRAM_BUCKET_COUNT - 1; ++i) {
+        fprintf(rsp, "%s%lld", i ? "," : "", bounds[i]);
+    }
+    fprintf(rsp, "],\n");
+}
+
+void frame_telemetry_serialize(FILE *rsp, struct frame_telemetry *telemetry)
+{
+    pthread_mutex_lock(&telemetry->lock);
+    fprintf(rsp, "{\n");
+    frame_bounds_serialize(rsp, "time_buckets_us", frame_time_bounds);
+    frame_bounds_serialize(rsp, "missed_buckets", frame_missed_bounds);
+    fprintf(rsp, "\t\"profiles\":[");
+
+    bool did_output = false;
+    for (int i = 0; i < FRAME_PROFILE_COUNT; ++i) {
+        struct frame_profile *profile = &telemetry->profile[i];
+        if (!profile->frame_count && !profile->animation_count) continue;
+
+        fprintf(rsp, "%s{\n", did_output ? "," : "");
+        for (int j = 0; j < (int) array_count(frame_profile_flag_str); ++j) {
+            fprintf(rsp, "\t\t\"%s\":%s,\n", frame_profile_flag_str[j], json_bool(i & (1 << j)));
+        }
+
+        fprintf(rsp,
+                "\t\t\"animations\":%lld,\n"
+                "\t\t\"frames\":%lld,\n"
+                "\t\t\"missed_frames\":%lld,\n",
+                profile->animation_count,
+                profile->frame_count,
+                profile->missed_frame_count);
+
+        frame_histogram_serialize(rsp, "cpu_us", &profile->cpu, frame_time_bounds, false);
+        frame_histogram_serialize(rsp, "commit_us", &profile->commit, frame_time_bounds, false);
+        frame_histogram_serialize(rsp, "slack_us", &profile->slack, frame_time_bounds, false);
+        frame_histogram_serialize(rsp, "late_us", &profile->late, frame_time_bounds, false);
+        frame_histogram_serialize(rsp, "missed_per_animation", &profile->missed_per_animation, frame_missed_bounds, true);
+        fprintf(rsp, "\t}");
+        did_output = true;
+    }
+
+    fprintf(rsp, "]\n}");
+    pthread_mutex_unlock(&telemetry->lock);
+}
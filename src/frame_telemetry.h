@@ -0,0 +1,70 @@
+#ifndef FRAME_TELEMETRY_H
+#define FRAME_TELEMETRY_H
+
+#define FRAME_HISTOGRAM_BUCKET_COUNT 10
+
+//
+// NOTE: Frame pacing statistics of the animations. Every frame that an
+// animation path draws is recorded with the time spent computing it, the time
+// spent committing its transaction, and how far ahead of or behind the deadline
+// of the frame it finished. Frames that finish after their deadline are counted
+// as missed, both per profile and per animation. Samples are grouped by the
+// profile of settings that were active, so that the cost of a setting can be
+// read by comparing profiles on the same machine. Frames are recorded from the
+// animation threads, so every operation takes the lock of the telemetry.
+//
+
+enum frame_profile_flag
+{
+    FRAME_PROFILE_FRAME_BASED        = 0x01,
+    FRAME_PROFILE_BLUR               = 0x02,
+    FRAME_PROFILE_SHADOWS            = 0x04,
+    FRAME_PROFILE_TWO_PHASE          = 0x08,
+    FRAME_PROFILE_REDUCED_RESOLUTION = 0x10,
+    FRAME_PROFILE_FAST_MODE          = 0x20,
+    FRAME_PROFILE_COUNT              = 0x40
+};
+
+struct frame_histogram
+{
+    uint64_t bucket[FRAME_HISTOGRAM_BUCKET_COUNT];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+};
+
+struct frame_sample
+{
+    uint32_t profile;
+    uint64_t cpu_ns;
+    uint64_t commit_ns;
+    int64_t slack_ns;
+};
+
+struct frame_profile
+{
+    uint64_t frame_count;
+    uint64_t missed_frame_count;
+    uint64_t animation_count;
+    struct frame_histogram cpu;
+    struct frame_histogram commit;
+    struct frame_histogram slack;
+    struct frame_histogram late;
+    struct frame_histogram missed_per_animation;
+};
+
+struct frame_telemetry
+{
+    pthread_mutex_t lock;
+    struct frame_profile profile[FRAME_PROFILE_COUNT];
+};
+
+void frame_histogram_add(struct frame_histogram *histogram, const uint64_t *bounds, uint64_t value);
+uint64_t frame_histogram_percentile(struct frame_histogram *histogram, const uint64_t *bounds, float percentile);
+
+void frame_telemetry_init(struct frame_telemetry *telemetry);
+void frame_telemetry_record_frame(struct frame_telemetry *telemetry, struct frame_sample *sample);
+void frame_telemetry_record_animation(struct frame_telemetry *telemetry, uint32_t profile, uint64_t missed_frame_count);
+void frame_telemetry_serialize(FILE *rsp, struct frame_telemetry *telemetry);
+
+#endif
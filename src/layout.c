@@ -0,0 +1,1289 @@
+static inline bool window_node_is_leaf(struct window_node *node)
+{
+    return node->left == NULL && node->right == NULL;
+}
+
+static inline bool window_node_is_occupied(struct window_node *node)
+{
+    return node->window_count != 0;
+}
+
+static inline bool window_node_is_intermediate(struct window_node *node)
+{
+    return node->parent != NULL;
+}
+
+static inline bool window_node_is_left_child(struct window_node *node)
+{
+    return node->parent && node->parent->left == node;
+}
+
+static inline bool window_node_is_right_child(struct window_node *node)
+{
+    return node->parent && node->parent->right == node;
+}
+
+//
+// NOTE: Nodes are allocated from a pool owned by the view, and only leaves
+// carry a window stack, which lives in a separate pool. Intermediate nodes
+// point their window_list and window_order at an empty stack so that reads
+// behave as they did when every node embedded both arrays.
+//
+
+static struct window_node_stack window_node_empty_stack;
+
+static inline void window_node_set_stack(struct window_node *node, struct window_node_stack *stack)
+{
+    node->stack = stack;
+
+    if (!stack) {
+        node->window_list  = window_node_empty_stack.inline_list;
+        node->window_order = window_node_empty_stack.inline_order;
+    } else if (stack->heap) {
+        node->window_list  = stack->heap;
+        node->window_order = stack->heap + stack->capacity;
+    } else {
+        node->window_list  = stack->inline_list;
+        node->window_order = stack->inline_order;
+    }
+}
+
+//
+// NOTE: A stack keeps its first few windows inline, which covers the vast
+// majority of leaves. Once it outgrows those slots, both lists move to a
+// single heap allocation that doubles in size as needed.
+//
+
+static void window_node_reserve(struct window_node *node, int count)
+{
+    struct window_node_stack *stack = node->stack;
+
+    int capacity = stack->heap ? stack->capacity : NODE_STACK_INLINE_COUNT;
+    if (count <= capacity) return;
+
+    while (capacity < count) capacity *= 2;
+
+    uint32_t *heap = malloc(sizeof(uint32_t) * capacity * 2);
+    memcpy(heap, node->window_list, sizeof(uint32_t) * node->window_count);
+    memcpy(heap + capacity, node->window_order, sizeof(uint32_t) * node->window_count);
+
+    free(stack->heap);
+    stack->heap = heap;
+    stack->capacity = capacity;
+
+    window_node_set_stack(node, stack);
+}
+
+void layout_pool_init(struct layout_pool *pool)
+{
+    object_pool_init(&pool->node_pool, sizeof(struct window_node), NODE_POOL_CHUNK_SIZE);
+    object_pool_init(&pool->stack_pool, sizeof(struct window_node_stack), NODE_POOL_CHUNK_SIZE);
+}
+
+void layout_pool_reset(struct layout_pool *pool)
+{
+    object_pool_reset(&pool->node_pool);
+    object_pool_reset(&pool->stack_pool);
+}
+
+void layout_pool_destroy(struct layout_pool *pool)
+{
+    object_pool_destroy(&pool->node_pool);
+    object_pool_destroy(&pool->stack_pool);
+}
+
+struct window_node *window_node_create(struct layout_pool *pool, bool is_leaf)
+{
+    struct window_node *node = object_pool_alloc(&pool->node_pool);
+    window_node_set_stack(node, is_leaf ? object_pool_alloc(&pool->stack_pool) : NULL);
+    return node;
+}
+
+void window_node_release(struct layout_pool *pool, struct window_node *node)
+{
+    if (node->stack) {
+        free(node->stack->heap);
+        object_pool_free(&pool->stack_pool, node->stack);
+    }
+
+    object_pool_free(&pool->node_pool, node);
+}
+
+void window_node_reset(struct window_node *node)
+{
+    struct window_node_stack *stack = node->stack;
+    memset(node, 0, sizeof(struct window_node));
+    window_node_set_stack(node, stack);
+}
+
+//
+// NOTE: Operations that modify the tree mark the nodes they touch, and every
+// ancestor of a marked node carries NODE_DIRTY_CHILD. An update only visits
+// marked subtrees and recomputes the areas of nodes marked NODE_DIRTY_LAYOUT,
+// and a flush only captures the leaves marked NODE_DIRTY_FRAME, which are
+// the leaves whose area or windows actually changed.
+//
+
+static inline void window_node_mark_ancestors(struct window_node *node)
+{
+    for (struct window_node *parent = node->parent; parent && !(parent->dirty & NODE_DIRTY_CHILD); parent = parent->parent) {
+        parent->dirty |= NODE_DIRTY_CHILD;
+    }
+}
+
+void window_node_mark_dirty(struct window_node *node, uint32_t dirty)
+{
+    node->dirty |= dirty;
+    window_node_mark_ancestors(node);
+}
+
+static inline void window_node_update_child_flag(struct window_node *node)
+{
+    if (!window_node_is_leaf(node) && (node->left->dirty || node->right->dirty)) {
+        node->dirty |= NODE_DIRTY_CHILD;
+    } else {
+        node->dirty &= ~NODE_DIRTY_CHILD;
+    }
+}
+
+static inline void window_node_track_area(struct window_node *node, struct area area)
+{
+    if (area.x != node->area.x || area.y != node->area.y || area.w != node->area.w || area.h != node->area.h) {
+        node->dirty |= window_node_is_leaf(node) ? NODE_DIRTY_FRAME : NODE_DIRTY_LAYOUT;
+    }
+}
+
+//
+// NOTE: The minimum size of a subtree is the smallest area that can hold the
+// minimum size of every leaf in it. A fence adds up the minimums of its two
+// children along the axis that it splits, and takes the larger of the two
+// across it. The result is cached on the node together with the gap that it
+// was computed for, and any change to the windows or the structure below a
+// node clears the cache on the path to the root, so a solve only descends into
+// the subtrees that changed since the last one.
+//
+
+void window_node_invalidate_min_size(struct window_node *node)
+{
+    for (; node && node->is_min_size_valid; node = node->parent) {
+        node->is_min_size_valid = false;
+    }
+}
+
+//
+// NOTE: When minimum widths are enforced, a window without a rule of its own is
+// NODE_DEFAULT_MIN_WIDTH wide at least, and counts as such in the sums of the
+// subtrees it is part of.
+//
+
+static inline uint32_t window_node_min_width(struct layout_config *config, uint32_t window_id)
+{
+    if (!config->min_width) return 0;
+
+    uint32_t min_width = config->min_width(config->context, window_id);
+    return min_width ? min_width : NODE_DEFAULT_MIN_WIDTH;
+}
+
+static inline uint32_t window_node_min_height(struct layout_config *config, uint32_t window_id)
+{
+    return config->min_height ? config->min_height(config->context, window_id) : 0;
+}
+
+static inline uint32_t min_size_add(uint32_t a, uint32_t b, int gap)
+{
+    return a && b ? a + b + gap : a + b;
+}
+
+static void window_node_update_min_size(struct layout_config *config, struct window_node *node)
+{
+    if (node->is_min_size_valid && node->min_size_gap == config->gap) return;
+
+    if (window_node_is_leaf(node)) {
+        uint32_t window_id = node->window_count ? node->window_order[0] : 0;
+        node->min_width  = window_id ? window_node_min_width(config, window_id)  : 0;
+        node->min_height = window_id ? window_node_min_height(config, window_id) : 0;
+    } else {
+        window_node_update_min_size(config, node->left);
+        window_node_update_min_size(config, node->right);
+
+        struct window_node *l = node->left;
+        struct window_node *r = node->right;
+
+        if (node->split == SPLIT_Y) {
+            node->min_width  = min_size_add(l->min_width, r->min_width, config->gap);
+            node->min_height = max(l->min_height, r->min_height);
+        } else if (node->split == SPLIT_X) {
+            node->min_width  = max(l->min_width, r->min_width);
+            node->min_height = min_size_add(l->min_height, r->min_height, config->gap);
+        } else {
+            node->min_width  = max(l->min_width, r->min_width);
+            node->min_height = max(l->min_height, r->min_height);
+        }
+    }
+
+    node->min_size_gap = config->gap;
+    node->is_min_size_valid = true;
+}
+
+static void window_node_clamp_ratio(struct layout_config *config, struct window_node *node)
+{
+    if (window_node_is_leaf(node)) return;
+
+    float extent = 0.0f;
+    uint32_t min_left  = 0;
+    uint32_t min_right = 0;
+
+    if (node->split == SPLIT_Y) {
+        extent    = node->area.w - config->gap;
+        min_left  = node->left->min_width;
+        min_right = node->right->min_width;
+    } else if (node->split == SPLIT_X) {
+        extent    = node->area.h - config->gap;
+        min_left  = node->left->min_height;
+        min_right = node->right->min_height;
+    }
+
+    if (extent > 0.0f && (min_left || min_right)) {
+        float ratio;
+
+        //
+        // NOTE: When both sides can not fit, the space is shared in proportion
+        // to what each side asks for, so neither side takes all of it.
+        //
+
+        if (min_left + min_right > extent) {
+            ratio = (float) min_left / (float) (min_left + min_right);
+        } else {
+            ratio = fminf(fmaxf(node->ratio, min_left / extent), 1.0f - min_right / extent);
+        }
+
+        ratio = fminf(fmaxf(ratio, 0.05f), 0.95f);
+        if (ratio != node->ratio) {
+            node->ratio = ratio;
+            window_node_mark_dirty(node, NODE_DIRTY_LAYOUT);
+        }
+    }
+
+    window_node_clamp_ratio(config, node->left);
+    window_node_clamp_ratio(config, node->right);
+}
+
+void layout_enforce_min_size(struct layout_config *config, struct window_node *root)
+{
+    if (!root) return;
+
+    window_node_update_min_size(config, root);
+    window_node_clamp_ratio(config, root);
+}
+
+static inline enum window_node_child window_node_get_child(struct layout_config *config, struct window_node *node)
+{
+    return node->child != CHILD_NONE ? node->child : config->child;
+}
+
+enum window_node_split window_node_get_split(struct layout_config *config, struct window_node *node)
+{
+    if (node->split != SPLIT_NONE) return node->split;
+    if (config->split_type != SPLIT_AUTO) return config->split_type;
+
+    return node->area.w >= node->area.h ? SPLIT_Y : SPLIT_X;
+}
+
+float window_node_get_ratio(struct layout_config *config, struct window_node *node)
+{
+    return in_range_ii(node->ratio, 0.1f, 0.9f) ? node->ratio : config->split_ratio;
+}
+
+void area_make_pair(enum window_node_split split, int gap, float ratio, struct area *parent_area, struct area *left_area, struct area *right_area)
+{
+    if (split == SPLIT_Y) {
+        *left_area  = *parent_area;
+        *right_area = *parent_area;
+
+        float left_width  = (parent_area->w - gap) * ratio;
+        float right_width = (parent_area->w - gap) * (1 - ratio);
+
+        left_area->w   = (int)left_width;
+        right_area->w  = (int)right_width;
+        right_area->x += (int)(left_width + 0.5f) + gap;
+    } else {
+        *left_area  = *parent_area;
+        *right_area = *parent_area;
+
+        float left_width  = (parent_area->h - gap) * ratio;
+        float right_width = (parent_area->h - gap) * (1 - ratio);
+
+        left_area->h   = (int)left_width;
+        right_area->h  = (int)right_width;
+        right_area->y += (int)(left_width + 0.5f) + gap;
+    }
+}
+
+static void area_make_pair_for_node(struct layout_config *config, struct window_node *node)
+{
+    enum window_node_split split = window_node_get_split(config, node);
+    float ratio = window_node_get_ratio(config, node);
+    int gap     = config->gap;
+
+    area_make_pair(split, gap, ratio, &node->area, &node->left->area, &node->right->area);
+
+    if (node->split != split) window_node_invalidate_min_size(node);
+    node->split = split;
+    node->ratio = ratio;
+}
+
+static void window_node_layout(struct layout_config *config, struct window_node *node)
+{
+    struct area left_area  = node->left->area;
+    struct area right_area = node->right->area;
+
+    area_make_pair_for_node(config, node);
+
+    window_node_track_area(node->left, left_area);
+    window_node_track_area(node->right, right_area);
+}
+
+void layout_update(struct layout_config *config, struct window_node *node)
+{
+    if (!window_node_is_leaf(node)) {
+        window_node_layout(config, node);
+        layout_update(config, node->left);
+        layout_update(config, node->right);
+    }
+
+    node->dirty &= ~NODE_DIRTY_LAYOUT;
+    window_node_update_child_flag(node);
+    if (node->dirty) window_node_mark_ancestors(node);
+}
+
+void layout_update_dirty(struct layout_config *config, struct window_node *node)
+{
+    if (!node->dirty) return;
+
+    if (!window_node_is_leaf(node)) {
+        if (node->dirty & NODE_DIRTY_LAYOUT) window_node_layout(config, node);
+        layout_update_dirty(config, node->left);
+        layout_update_dirty(config, node->right);
+    }
+
+    node->dirty &= ~NODE_DIRTY_LAYOUT;
+    window_node_update_child_flag(node);
+    if (node->dirty) window_node_mark_ancestors(node);
+}
+
+//
+// NOTE: The scrolling layout ignores the splits of the tree and places its
+// leaves side by side, in leaf order, as columns of a strip that starts at the
+// left edge of the root area. The root area is the viewport of the strip, and
+// every node that is not a leaf takes the area of the root, so that zooming a
+// window to its parent or to the root makes it fill the viewport.
+//
+
+static void layout_scroll_node(struct window_node *node, struct area *viewport, float column_width, int gap, float *x)
+{
+    struct area area = node->area;
+
+    if (window_node_is_leaf(node)) {
+        node->area = (struct area) { *x, viewport->y, column_width, viewport->h };
+        window_node_track_area(node, area);
+        *x += column_width + gap;
+    } else {
+        node->area = *viewport;
+        layout_scroll_node(node->left, viewport, column_width, gap, x);
+        layout_scroll_node(node->right, viewport, column_width, gap, x);
+    }
+
+    node->dirty &= ~NODE_DIRTY_LAYOUT;
+    window_node_update_child_flag(node);
+}
+
+//
+// NOTE: The offset is clamped so that the strip never scrolls past either of
+// its ends, and the clamped offset is returned to be stored by the caller.
+// A root that is a leaf keeps the whole viewport to itself.
+//
+
+float layout_update_scroll(struct layout_config *config, struct window_node *root, float offset)
+{
+    if (window_node_is_leaf(root)) {
+        root->dirty &= ~NODE_DIRTY_LAYOUT;
+        return 0.0f;
+    }
+
+    int column_count = 0;
+    for (struct window_node *node = window_node_find_first_leaf(root); node; node = window_node_find_next_leaf(node)) {
+        ++column_count;
+    }
+
+    struct area viewport = root->area;
+    float column_width = (int)(viewport.w * config->column_ratio);
+    float strip_width = column_count * column_width + (column_count - 1) * config->gap;
+    float max_offset = max(0.0f, strip_width - viewport.w);
+
+    if (offset > max_offset) offset = max_offset;
+    if (offset < 0.0f)       offset = 0.0f;
+
+    float x = viewport.x - offset;
+    layout_scroll_node(root->left, &viewport, column_width, config->gap, &x);
+    layout_scroll_node(root->right, &viewport, column_width, config->gap, &x);
+
+    root->dirty &= ~NODE_DIRTY_LAYOUT;
+    window_node_update_child_flag(root);
+    return offset;
+}
+
+void window_node_split(struct layout_pool *pool, struct layout_config *config, struct window_node *node, uint32_t window_id, struct window_node *zoom)
+{
+    struct window_node *left  = window_node_create(pool, false);
+    struct window_node *right = window_node_create(pool, false);
+
+    if (window_node_get_child(config, node) == CHILD_SECOND) {
+        window_node_set_stack(left, node->stack);
+        left->window_count = node->window_count;
+        left->zoom = zoom;
+
+        window_node_set_stack(right, object_pool_alloc(&pool->stack_pool));
+        right->window_list[0] = window_id;
+        right->window_order[0] = window_id;
+        right->window_count = 1;
+    } else {
+        window_node_set_stack(right, node->stack);
+        right->window_count = node->window_count;
+        right->zoom = zoom;
+
+        window_node_set_stack(left, object_pool_alloc(&pool->stack_pool));
+        left->window_list[0] = window_id;
+        left->window_order[0] = window_id;
+        left->window_count = 1;
+    }
+
+    left->parent  = node;
+    right->parent = node;
+
+    window_node_set_stack(node, NULL);
+    node->window_count = 0;
+    node->left  = left;
+    node->right = right;
+    node->zoom  = NULL;
+
+    area_make_pair_for_node(config, node);
+
+    left->dirty  = NODE_DIRTY_FRAME;
+    right->dirty = NODE_DIRTY_FRAME;
+    node->dirty &= ~NODE_DIRTY_FRAME;
+    window_node_mark_dirty(node, NODE_DIRTY_CHILD);
+    window_node_invalidate_min_size(node);
+}
+
+//
+// NOTE: Removes a leaf from the tree by letting its parent take over whatever
+// its sibling held, which is either a window stack or a pair of subtrees. The
+// leaf and its sibling are released, and the parent is returned. Zoom targets
+// and feedback windows refer to state outside of the layout, and are fixed up
+// by the caller.
+//
+
+struct window_node *window_node_collapse(struct layout_pool *pool, struct window_node *node)
+{
+    struct window_node *parent = node->parent;
+    struct window_node *child  = window_node_is_right_child(node)
+                               ? parent->left
+                               : parent->right;
+
+    window_node_set_stack(parent, child->stack);
+    parent->window_count = child->window_count;
+    child->stack = NULL;
+
+    window_node_mark_dirty(parent, window_node_is_leaf(child) ? NODE_DIRTY_FRAME : NODE_DIRTY_LAYOUT);
+    window_node_invalidate_min_size(parent);
+
+    parent->left  = NULL;
+    parent->right = NULL;
+
+    if (child->insert_dir) {
+        parent->feedback_window = child->feedback_window;
+        parent->insert_dir      = child->insert_dir;
+        parent->split           = child->split;
+        parent->child           = child->child;
+    }
+
+    if (!window_node_is_leaf(child)) {
+        parent->left          = child->left;
+        parent->left->parent  = parent;
+        parent->right         = child->right;
+        parent->right->parent = parent;
+    }
+
+    window_node_release(pool, child);
+    window_node_release(pool, node);
+
+    return parent;
+}
+
+//
+// NOTE: The minimums of a fence are summed along the axis that it splits, so
+// flipping the split of a node changes the minimum size of every node above it.
+//
+
+void window_node_toggle_split(struct window_node *node)
+{
+    node->split = node->split == SPLIT_Y ? SPLIT_X : SPLIT_Y;
+    window_node_invalidate_min_size(node);
+}
+
+void window_node_rotate(struct window_node *node, int degrees)
+{
+    if ((degrees ==  90 && node->split == SPLIT_Y) ||
+        (degrees == 270 && node->split == SPLIT_X) ||
+        (degrees == 180)) {
+        struct window_node *temp = node->left;
+        node->left  = node->right;
+        node->right = temp;
+        node->ratio = 1 - node->ratio;
+    }
+
+    if (degrees != 180) {
+        node->is_min_size_valid = false;
+
+        if (node->split == SPLIT_X) {
+            node->split = SPLIT_Y;
+        } else if (node->split == SPLIT_Y) {
+            node->split = SPLIT_X;
+        }
+    }
+
+    if (!window_node_is_leaf(node)) {
+        window_node_rotate(node->left, degrees);
+        window_node_rotate(node->right, degrees);
+    }
+}
+
+struct window_node *window_node_mirror(struct window_node *node, enum window_node_split axis)
+{
+    if (!window_node_is_leaf(node)) {
+        struct window_node *left = window_node_mirror(node->left, axis);
+        struct window_node *right = window_node_mirror(node->right, axis);
+
+        if (node->split == axis) {
+            node->left = right;
+            node->right = left;
+        }
+    }
+
+    return node;
+}
+
+void window_node_equalize(struct window_node *node, uint32_t axis_flag, float ratio)
+{
+    if (node->left)  window_node_equalize(node->left, axis_flag, ratio);
+    if (node->right) window_node_equalize(node->right, axis_flag, ratio);
+
+    if ((axis_flag & SPLIT_Y) && node->split == SPLIT_Y) {
+        node->ratio = ratio;
+    }
+
+    if ((axis_flag & SPLIT_X) && node->split == SPLIT_X) {
+        node->ratio = ratio;
+    }
+}
+
+static inline struct balance_node balance_node_add(struct balance_node a, struct balance_node b)
+{
+    return (struct balance_node) { a.y_count + b.y_count, a.x_count + b.x_count, };
+}
+
+struct balance_node window_node_balance(struct window_node *node, uint32_t axis_flag)
+{
+    if (window_node_is_leaf(node)) {
+        return (struct balance_node) {
+            node->parent ? node->parent->split == SPLIT_Y : 0,
+            node->parent ? node->parent->split == SPLIT_X : 0
+        };
+    }
+
+    struct balance_node left_leafs  = window_node_balance(node->left, axis_flag);
+    struct balance_node right_leafs = window_node_balance(node->right, axis_flag);
+    struct balance_node total_leafs = balance_node_add(left_leafs, right_leafs);
+
+    if (axis_flag & SPLIT_Y) {
+        if (node->split == SPLIT_Y) {
+            node->ratio = (float) left_leafs.y_count / total_leafs.y_count;
+            --total_leafs.y_count;
+        }
+    }
+
+    if (axis_flag & SPLIT_X) {
+        if (node->split == SPLIT_X) {
+            node->ratio = (float) left_leafs.x_count / total_leafs.x_count;
+            --total_leafs.x_count;
+        }
+    }
+
+    if (node->parent) {
+        total_leafs.y_count += node->parent->split == SPLIT_Y;
+        total_leafs.x_count += node->parent->split == SPLIT_X;
+    }
+
+    return total_leafs;
+}
+
+bool window_node_contains_window(struct window_node *node, uint32_t window_id)
+{
+    for (int i = 0; i < node->window_count; ++i) {
+        if (node->window_list[i] == window_id) return true;
+    }
+
+    return false;
+}
+
+int window_node_index_of_window(struct window_node *node, uint32_t window_id)
+{
+    for (int i = 0; i < node->window_count; ++i) {
+        if (node->window_list[i] == window_id) return i;
+    }
+
+    return 0;
+}
+
+//
+// NOTE: The nodes may belong to different views, and every stack has to be
+// returned to the pool it was allocated from, so the contents are swapped
+// rather than the stacks themselves.
+//
+
+void window_node_swap_window_list(struct window_node *a_node, struct window_node *b_node)
+{
+    int count = max(a_node->window_count, b_node->window_count);
+    window_node_reserve(a_node, count);
+    window_node_reserve(b_node, count);
+
+    for (int i = 0; i < count; ++i) {
+        uint32_t tmp_window_id = a_node->window_list[i];
+        a_node->window_list[i] = b_node->window_list[i];
+        b_node->window_list[i] = tmp_window_id;
+
+        uint32_t tmp_order_id = a_node->window_order[i];
+        a_node->window_order[i] = b_node->window_order[i];
+        b_node->window_order[i] = tmp_order_id;
+    }
+
+    int tmp_window_count = a_node->window_count;
+    a_node->window_count = b_node->window_count;
+    b_node->window_count = tmp_window_count;
+
+    window_node_mark_dirty(a_node, NODE_DIRTY_FRAME);
+    window_node_mark_dirty(b_node, NODE_DIRTY_FRAME);
+    window_node_invalidate_min_size(a_node);
+    window_node_invalidate_min_size(b_node);
+
+    a_node->zoom = NULL;
+    b_node->zoom = NULL;
+}
+
+struct window_node *window_node_find_first_leaf(struct window_node *root)
+{
+    struct window_node *node = root;
+    while (!window_node_is_leaf(node)) {
+        node = node->left;
+    }
+    return node;
+}
+
+struct window_node *window_node_find_last_leaf(struct window_node *root)
+{
+    struct window_node *node = root;
+    while (!window_node_is_leaf(node)) {
+        node = node->right;
+    }
+    return node;
+}
+
+struct window_node *window_node_find_prev_leaf(struct window_node *node)
+{
+    if (!node->parent) return NULL;
+
+    if (window_node_is_left_child(node)) {
+        return window_node_find_prev_leaf(node->parent);
+    }
+
+    if (window_node_is_leaf(node->parent->left)) {
+        return node->parent->left;
+    }
+
+    return window_node_find_last_leaf(node->parent->left->right);
+}
+
+struct window_node *window_node_find_next_leaf(struct window_node *node)
+{
+    if (!node->parent) return NULL;
+
+    if (window_node_is_right_child(node)) {
+        return window_node_find_next_leaf(node->parent);
+    }
+
+    if (window_node_is_leaf(node->parent->right)) {
+        return node->parent->right;
+    }
+
+    return window_node_find_first_leaf(node->parent->right->left);
+}
+
+struct window_node *window_node_fence(struct window_node *node, int dir)
+{
+    if (!node) return NULL;
+
+    for (struct window_node *parent = node->parent; parent; parent = parent->parent) {
+        if ((dir == DIR_NORTH && parent->split == SPLIT_X && parent->area.y < node->area.y) ||
+            (dir == DIR_WEST  && parent->split == SPLIT_Y && parent->area.x < node->area.x) ||
+            (dir == DIR_SOUTH && parent->split == SPLIT_X && (parent->area.y + parent->area.h) > (node->area.y + node->area.h)) ||
+            (dir == DIR_EAST  && parent->split == SPLIT_Y && (parent->area.x + parent->area.w) > (node->area.x + node->area.w))) {
+                return parent;
+        }
+    }
+
+    return NULL;
+}
+
+static inline struct area_point area_max_point(struct area area)
+{
+    return (struct area_point) { area.x + area.w - 1, area.y + area.h - 1 };
+}
+
+static inline bool area_is_in_direction(struct area *r1, struct area_point r1_max, struct area *r2, struct area_point r2_max, int direction)
+{
+    if (direction == DIR_NORTH && r1_max.y <= r2->y) return false;
+    if (direction == DIR_EAST  && r2_max.x <= r1->x) return false;
+    if (direction == DIR_SOUTH && r2_max.y <= r1->y) return false;
+    if (direction == DIR_WEST  && r1_max.x <= r2->x) return false;
+
+    if (direction == DIR_NORTH || direction == DIR_SOUTH) {
+        return ((r2_max.x >  r1->x && r2_max.x <= r1_max.x) ||
+                (r2->x    <  r1->x && r2_max.x >  r1_max.x) ||
+                (r2->x    >= r1->x && r2->x    <  r1_max.x));
+    }
+
+    if (direction == DIR_EAST || direction == DIR_WEST) {
+        return ((r2_max.y >  r1->y && r2_max.y <= r1_max.y) ||
+                (r2->y    <  r1->y && r2_max.y >  r1_max.y) ||
+                (r2->y    >= r1->y && r2->y    <  r1_max.y));
+    }
+
+    return false;
+}
+
+static inline int area_distance_in_direction(struct area *r1, struct area_point r1_max, struct area *r2, struct area_point r2_max, int direction)
+{
+    switch (direction) {
+    case DIR_NORTH: {
+        return r2_max.y > r1->y ? r2_max.y - r1->y : r1->y - r2_max.y;
+    } break;
+    case DIR_EAST: {
+        return r2->x < r1_max.x ? r1_max.x - r2->x : r2->x - r1_max.x;
+    } break;
+    case DIR_SOUTH: {
+        return r2->y < r1_max.y ? r1_max.y - r2->y : r2->y - r1_max.y;
+    } break;
+    case DIR_WEST: {
+        return r2_max.x > r1->x ? r2_max.x - r1->x : r1->x - r2_max.x;
+    } break;
+    }
+
+    return INT_MAX;
+}
+
+static inline int window_node_rank_in_list(uint32_t window_id, uint32_t *window_list, int window_count)
+{
+    for (int i = 0; i < window_count; ++i) {
+        if (window_list[i] == window_id) return i;
+    }
+
+    return INT_MAX;
+}
+
+//
+// NOTE: Ties between leaves at the same distance are broken by the position of
+// their top-most window in window_list, which is expected to be ordered from
+// front to back.
+//
+
+struct window_node *window_node_find_in_direction(struct window_node *root, struct window_node *source, int direction, uint32_t *window_list, int window_count)
+{
+    int best_distance = INT_MAX;
+    int best_rank = INT_MAX;
+    struct window_node *best_node = NULL;
+    struct area_point source_area_max = area_max_point(source->area);
+
+    for (struct window_node *target = window_node_find_first_leaf(root); target; target = window_node_find_next_leaf(target)) {
+        if (source == target) continue;
+
+        struct area_point target_area_max = area_max_point(target->area);
+        if (area_is_in_direction(&source->area, source_area_max, &target->area, target_area_max, direction)) {
+            int distance = area_distance_in_direction(&source->area, source_area_max, &target->area, target_area_max, direction);
+            int rank = window_node_rank_in_list(target->window_order[0], window_list, window_count);
+            if ((distance < best_distance) || (distance == best_distance && rank < best_rank)) {
+                best_node = target;
+                best_distance = distance;
+                best_rank = rank;
+            }
+        }
+    }
+
+    return best_node;
+}
+
+static inline int layout_index_slot(int direction)
+{
+    return (direction / 90) % 4;
+}
+
+static inline float layout_index_key(struct area *area, int direction)
+{
+    switch (direction) {
+    case DIR_NORTH: return area_max_point(*area).y;
+    case DIR_EAST:  return area->x;
+    case DIR_SOUTH: return area->y;
+    case DIR_WEST:  return area_max_point(*area).x;
+    }
+
+    return 0.0f;
+}
+
+static int layout_index_entry_compare(const void *a, const void *b)
+{
+    const struct layout_index_entry *a_entry = a;
+    const struct layout_index_entry *b_entry = b;
+
+    if (a_entry->key < b_entry->key) return -1;
+    if (a_entry->key > b_entry->key) return  1;
+
+    return a_entry->sequence - b_entry->sequence;
+}
+
+void layout_index_invalidate(struct layout_index *index)
+{
+    index->is_valid = false;
+}
+
+void layout_index_destroy(struct layout_index *index)
+{
+    for (int i = 0; i < 4; ++i) {
+        free(index->entry_list[i]);
+        index->entry_list[i] = NULL;
+    }
+
+    index->count = 0;
+    index->capacity = 0;
+    index->is_valid = false;
+}
+
+static void layout_index_rebuild(struct layout_index *index, struct window_node *root)
+{
+    index->count = 0;
+
+    for (struct window_node *node = window_node_find_first_leaf(root); node; node = window_node_find_next_leaf(node)) {
+        if (index->count == index->capacity) {
+            index->capacity = index->capacity ? index->capacity * 2 : 64;
+
+            for (int i = 0; i < 4; ++i) {
+                index->entry_list[i] = realloc(index->entry_list[i], sizeof(struct layout_index_entry) * index->capacity);
+            }
+        }
+
+        for (int i = 0, direction = DIR_EAST; i < 4; ++i, direction += 90) {
+            index->entry_list[layout_index_slot(direction)][index->count] = (struct layout_index_entry) {
+                .key      = layout_index_key(&node->area, direction),
+                .sequence = index->count,
+                .area     = node->area,
+                .node     = node
+            };
+        }
+
+        ++index->count;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        qsort(index->entry_list[i], index->count, sizeof(struct layout_index_entry), layout_index_entry_compare);
+    }
+
+    index->is_valid = true;
+}
+
+static inline int layout_index_lower_bound(struct layout_index_entry *entry_list, int count, float key)
+{
+    int lo = 0;
+    int hi = count;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+
+        if (entry_list[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+//
+// NOTE: Gives the same result as window_node_find_in_direction. The entries are
+// visited in order of increasing distance, starting at the edge of the source
+// that the direction measures from, and the search ends once the distance of
+// the next entry exceeds the best distance found. Ranks are only requested to
+// break ties, and remaining ties go to the leaf that comes first in the tree.
+//
+
+struct window_node *layout_index_find_in_direction(struct layout_index *index, struct window_node *root, struct window_node *source, int direction, int (*rank)(void *context, uint32_t window_id), void *context)
+{
+    if (!index->is_valid) layout_index_rebuild(index, root);
+
+    struct layout_index_entry *entry_list = index->entry_list[layout_index_slot(direction)];
+    struct area_point source_area_max = area_max_point(source->area);
+    float target = layout_index_key(&source->area, (direction + 180 - 1) % 360 + 1);
+
+    int best_distance = INT_MAX;
+    int best_rank = INT_MAX;
+    int best_sequence = INT_MAX;
+    struct layout_index_entry *best_entry = NULL;
+
+    int below = layout_index_lower_bound(entry_list, index->count, target) - 1;
+    int above = below + 1;
+
+    while (below >= 0 || above < index->count) {
+        struct layout_index_entry *entry;
+
+        if (below < 0) {
+            entry = &entry_list[above++];
+        } else if (above >= index->count) {
+            entry = &entry_list[below--];
+        } else if (target - entry_list[below].key <= entry_list[above].key - target) {
+            entry = &entry_list[below--];
+        } else {
+            entry = &entry_list[above++];
+        }
+
+        if ((int) fabsf(entry->key - target) > best_distance) break;
+        if (entry->node == source) continue;
+
+        struct area_point target_area_max = area_max_point(entry->area);
+        if (!area_is_in_direction(&source->area, source_area_max, &entry->area, target_area_max, direction)) continue;
+
+        int distance = area_distance_in_direction(&source->area, source_area_max, &entry->area, target_area_max, direction);
+        if (distance > best_distance) continue;
+
+        if (distance < best_distance) {
+            best_entry = entry;
+            best_distance = distance;
+            best_rank = -1;
+            best_sequence = entry->sequence;
+            continue;
+        }
+
+        if (best_rank == -1) best_rank = rank ? rank(context, best_entry->node->window_order[0]) : INT_MAX;
+        int entry_rank = rank ? rank(context, entry->node->window_order[0]) : INT_MAX;
+
+        if (entry_rank < best_rank || (entry_rank == best_rank && entry->sequence < best_sequence)) {
+            best_entry = entry;
+            best_rank = entry_rank;
+            best_sequence = entry->sequence;
+        }
+    }
+
+    return best_entry ? best_entry->node : NULL;
+}
+
+static inline struct layout_snapshot *layout_snapshot_retain(struct layout_snapshot *snapshot)
+{
+    ++snapshot->reference_count;
+    return snapshot;
+}
+
+void layout_snapshot_release(struct layout_snapshot *snapshot)
+{
+    if (--snapshot->reference_count > 0) return;
+
+    if (snapshot->left)  layout_snapshot_release(snapshot->left);
+    if (snapshot->right) layout_snapshot_release(snapshot->right);
+    free(snapshot);
+}
+
+static inline enum layout_snapshot_zoom layout_snapshot_zoom(struct window_node *node)
+{
+    if (!node->zoom) return SNAPSHOT_ZOOM_NONE;
+    return node->zoom == node->parent ? SNAPSHOT_ZOOM_PARENT : SNAPSHOT_ZOOM_ROOT;
+}
+
+static bool layout_snapshot_matches(struct layout_snapshot *snapshot, struct window_node *node, enum layout_snapshot_zoom zoom)
+{
+    return snapshot->window_count == node->window_count &&
+           snapshot->ratio == node->ratio &&
+           snapshot->split == node->split &&
+           snapshot->child == node->child &&
+           snapshot->zoom == zoom &&
+           memcmp(snapshot->window_list, node->window_list, sizeof(uint32_t) * node->window_count) == 0 &&
+           memcmp(snapshot->window_list + node->window_count, node->window_order, sizeof(uint32_t) * node->window_count) == 0;
+}
+
+//
+// NOTE: The live tree is compared against the previous snapshot position by
+// position. A node whose children are shared and whose own properties did not
+// change is shared as well, so the returned snapshot is the previous one if
+// nothing changed at all. The caller owns one reference to the result.
+//
+
+struct layout_snapshot *layout_snapshot_take(struct layout_snapshot *prev, struct window_node *node)
+{
+    struct layout_snapshot *left  = NULL;
+    struct layout_snapshot *right = NULL;
+
+    if (!window_node_is_leaf(node)) {
+        left  = layout_snapshot_take(prev ? prev->left  : NULL, node->left);
+        right = layout_snapshot_take(prev ? prev->right : NULL, node->right);
+    }
+
+    enum layout_snapshot_zoom zoom = layout_snapshot_zoom(node);
+
+    if (prev && prev->left == left && prev->right == right && layout_snapshot_matches(prev, node, zoom)) {
+        if (left)  layout_snapshot_release(left);
+        if (right) layout_snapshot_release(right);
+        return layout_snapshot_retain(prev);
+    }
+
+    struct layout_snapshot *snapshot = malloc(sizeof(struct layout_snapshot) + sizeof(uint32_t) * 2 * node->window_count);
+    snapshot->left            = left;
+    snapshot->right           = right;
+    snapshot->reference_count = 1;
+    snapshot->window_count    = node->window_count;
+    snapshot->ratio           = node->ratio;
+    snapshot->split           = node->split;
+    snapshot->child           = node->child;
+    snapshot->zoom            = zoom;
+    memcpy(snapshot->window_list, node->window_list, sizeof(uint32_t) * node->window_count);
+    memcpy(snapshot->window_list + node->window_count, node->window_order, sizeof(uint32_t) * node->window_count);
+
+    return snapshot;
+}
+
+static bool layout_snapshot_has_window(struct layout_snapshot *snapshot, bool (*is_valid)(void *context, uint32_t window_id), void *context)
+{
+    if (snapshot->left) {
+        return layout_snapshot_has_window(snapshot->left, is_valid, context) ||
+               layout_snapshot_has_window(snapshot->right, is_valid, context);
+    }
+
+    for (int i = 0; i < snapshot->window_count; ++i) {
+        if (is_valid(context, snapshot->window_list[i])) return true;
+    }
+
+    return false;
+}
+
+static struct window_node *layout_snapshot_build(struct layout_pool *pool, struct layout_snapshot *snapshot, struct window_node *parent, struct window_node **root, bool (*is_valid)(void *context, uint32_t window_id), void *context)
+{
+    //
+    // NOTE: A subtree without a single valid window is left out, and its
+    // sibling takes the place of their parent, as if the windows had been
+    // removed from the tree one at a time.
+    //
+
+    if (snapshot->left) {
+        bool has_left  = layout_snapshot_has_window(snapshot->left, is_valid, context);
+        bool has_right = layout_snapshot_has_window(snapshot->right, is_valid, context);
+
+        if (!has_left)  return layout_snapshot_build(pool, snapshot->right, parent, root, is_valid, context);
+        if (!has_right) return layout_snapshot_build(pool, snapshot->left, parent, root, is_valid, context);
+    }
+
+    struct window_node *node = window_node_create(pool, !snapshot->left);
+    if (!*root) *root = node;
+
+    node->parent = parent;
+    node->ratio  = snapshot->ratio;
+    node->split  = snapshot->split;
+    node->child  = snapshot->child;
+    node->zoom   = snapshot->zoom == SNAPSHOT_ZOOM_PARENT ? parent
+                 : snapshot->zoom == SNAPSHOT_ZOOM_ROOT   ? *root
+                 : NULL;
+
+    if (snapshot->left) {
+        node->left  = layout_snapshot_build(pool, snapshot->left, node, root, is_valid, context);
+        node->right = layout_snapshot_build(pool, snapshot->right, node, root, is_valid, context);
+    } else {
+        uint32_t *window_order = snapshot->window_list + snapshot->window_count;
+        window_node_reserve(node, snapshot->window_count);
+
+        for (int i = 0; i < snapshot->window_count; ++i) {
+            if (is_valid(context, snapshot->window_list[i])) node->window_list[node->window_count++] = snapshot->window_list[i];
+        }
+
+        for (int i = 0, j = 0; i < snapshot->window_count; ++i) {
+            if (is_valid(context, window_order[i])) node->window_order[j++] = window_order[i];
+        }
+    }
+
+    return node;
+}
+
+//
+// NOTE: Builds a new tree from a snapshot, keeping only the windows accepted
+// by is_valid. Returns NULL if the snapshot has no valid windows. The areas of
+// the new tree are not computed, that is left to the caller.
+//
+
+struct window_node *layout_snapshot_restore(struct layout_pool *pool, struct layout_snapshot *snapshot, bool (*is_valid)(void *context, uint32_t window_id), void *context)
+{
+    if (!layout_snapshot_has_window(snapshot, is_valid, context)) return NULL;
+
+    struct window_node *root = NULL;
+    layout_snapshot_build(pool, snapshot, NULL, &root, is_valid, context);
+    return root;
+}
+
+//
+// NOTE: The history is a bounded list of snapshots with a cursor at the one
+// that matches the current tree. Recording a tree that differs from it drops
+// the snapshots after the cursor, the same way an edit drops the redo list.
+//
+
+bool layout_history_record(struct layout_history *history, struct window_node *root)
+{
+    struct layout_snapshot *current = history->count ? history->entry_list[history->cursor] : NULL;
+    struct layout_snapshot *snapshot = layout_snapshot_take(current, root);
+
+    if (snapshot == current) {
+        layout_snapshot_release(snapshot);
+        return false;
+    }
+
+    while (history->count > history->cursor + 1) {
+        layout_snapshot_release(history->entry_list[--history->count]);
+    }
+
+    if (history->count == LAYOUT_HISTORY_SIZE) {
+        layout_snapshot_release(history->entry_list[0]);
+        memmove(history->entry_list, history->entry_list + 1, sizeof(struct layout_snapshot *) * --history->count);
+    }
+
+    history->cursor = history->count;
+    history->entry_list[history->count++] = snapshot;
+    return true;
+}
+
+struct layout_snapshot *layout_history_undo(struct layout_history *history)
+{
+    if (history->cursor == 0) return NULL;
+    return history->entry_list[--history->cursor];
+}
+
+struct layout_snapshot *layout_history_redo(struct layout_history *history)
+{
+    if (history->cursor + 1 >= history->count) return NULL;
+    return history->entry_list[++history->cursor];
+}
+
+void layout_history_clear(struct layout_history *history)
+{
+    while (history->count > 0) {
+        layout_snapshot_release(history->entry_list[--history->count]);
+    }
+
+    history->cursor = 0;
+}
+
+void layout_buffer_push(struct layout_buffer *buffer, const void *data, int size)
+{
+    if (buffer->length + size > buffer->capacity) {
+        buffer->capacity = max(2 * buffer->capacity, buffer->length + size);
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+
+    memcpy(buffer->data + buffer->length, data, size);
+    buffer->length += size;
+}
+
+//
+// NOTE: Snapshots are encoded in pre-order, each node as a fixed header that
+// is followed by the window list and the window order of a leaf. The encoding
+// uses the byte order of the machine, as it is only read back on the machine
+// that wrote it.
+//
+
+struct layout_snapshot_header
+{
+    uint8_t is_leaf;
+    uint8_t split;
+    uint8_t child;
+    uint8_t zoom;
+    float ratio;
+    uint32_t window_count;
+};
+
+void layout_snapshot_encode(struct layout_buffer *buffer, struct layout_snapshot *snapshot)
+{
+    struct layout_snapshot_header header = {
+        .is_leaf      = !snapshot->left,
+        .split        = snapshot->split,
+        .child        = snapshot->child,
+        .zoom         = snapshot->zoom,
+        .ratio        = snapshot->ratio,
+        .window_count = snapshot->window_count
+    };
+
+    layout_buffer_push(buffer, &header, sizeof(struct layout_snapshot_header));
+    layout_buffer_push(buffer, snapshot->window_list, sizeof(uint32_t) * 2 * snapshot->window_count);
+
+    if (snapshot->left) {
+        layout_snapshot_encode(buffer, snapshot->left);
+        layout_snapshot_encode(buffer, snapshot->right);
+    }
+}
+
+static struct layout_snapshot *layout_snapshot_decode_node(uint8_t **cursor, uint8_t *end, int depth)
+{
+    struct layout_snapshot_header header;
+
+    if (depth > LAYOUT_SNAPSHOT_MAX_DEPTH) return NULL;
+    if (end - *cursor < (long) sizeof(struct layout_snapshot_header)) return NULL;
+
+    memcpy(&header, *cursor, sizeof(struct layout_snapshot_header));
+    *cursor += sizeof(struct layout_snapshot_header);
+
+    if (header.split > SPLIT_AUTO || header.child > CHILD_FIRST || header.zoom > SNAPSHOT_ZOOM_ROOT) return NULL;
+    if (header.is_leaf ? header.window_count == 0 : header.window_count != 0) return NULL;
+    if ((uint64_t)(end - *cursor) < (uint64_t) sizeof(uint32_t) * 2 * header.window_count) return NULL;
+
+    struct layout_snapshot *snapshot = malloc(sizeof(struct layout_snapshot) + sizeof(uint32_t) * 2 * header.window_count);
+    snapshot->left            = NULL;
+    snapshot->right           = NULL;
+    snapshot->reference_count = 1;
+    snapshot->window_count    = header.window_count;
+    snapshot->ratio           = header.ratio;
+    snapshot->split           = header.split;
+    snapshot->child           = header.child;
+    snapshot->zoom            = header.zoom;
+    memcpy(snapshot->window_list, *cursor, sizeof(uint32_t) * 2 * header.window_count);
+    *cursor += sizeof(uint32_t) * 2 * header.window_count;
+
+    if (!header.is_leaf) {
+        snapshot->left  = layout_snapshot_decode_node(cursor, end, depth + 1);
+        snapshot->right = snapshot->left ? layout_snapshot_decode_node(cursor, end, depth + 1) : NULL;
+
+        if (!snapshot->right) {
+            layout_snapshot_release(snapshot);
+            return NULL;
+        }
+    }
+
+    return snapshot;
+}
+
+//
+// NOTE: Returns NULL if the data at the cursor is not a valid snapshot, in
+// which case the position of the cursor is unspecified.
+//
+
+struct layout_snapshot *layout_snapshot_decode(uint8_t **cursor, uint8_t *end)
+{
+    return layout_snapshot_decode_node(cursor, end, 0);
+}
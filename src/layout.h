@@ -0,0 +1,233 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+//
+// NOTE: The layout core owns the BSP tree and the geometry computed from it.
+// It depends only on the C standard library and misc/object_pool.h, so it can
+// be built and benchmarked without any of the Apple frameworks. Everything it
+// would otherwise look up in the window manager or the space manager is passed
+// in through a struct layout_config, and the result of a layout pass is the
+// area and the dirty flags of every node.
+//
+
+enum window_node_split
+{
+    SPLIT_NONE,
+    SPLIT_Y,
+    SPLIT_X,
+    SPLIT_AUTO
+};
+
+enum window_node_child
+{
+    CHILD_NONE,
+    CHILD_SECOND,
+    CHILD_FIRST,
+};
+
+struct area
+{
+    float x;
+    float y;
+    float w;
+    float h;
+};
+
+struct area_point
+{
+    float x;
+    float y;
+};
+
+struct balance_node
+{
+    int y_count;
+    int x_count;
+};
+
+enum window_node_dirty
+{
+    NODE_DIRTY_LAYOUT = 0x1,
+    NODE_DIRTY_FRAME  = 0x2,
+    NODE_DIRTY_CHILD  = 0x4
+};
+
+#define NODE_STACK_INLINE_COUNT 4
+#define NODE_POOL_CHUNK_SIZE    64
+#define NODE_DEFAULT_MIN_WIDTH  500
+
+struct window_node_stack
+{
+    uint32_t *heap;
+    int capacity;
+    uint32_t inline_list[NODE_STACK_INLINE_COUNT];
+    uint32_t inline_order[NODE_STACK_INLINE_COUNT];
+};
+
+struct CGContext;
+struct feedback_window
+{
+    uint32_t id;
+    struct CGContext *context;
+};
+
+struct window_node
+{
+    struct area area;
+    struct window_node *parent;
+    struct window_node *left;
+    struct window_node *right;
+    struct window_node *zoom;
+    struct window_node_stack *stack;
+    uint32_t *window_list;
+    uint32_t *window_order;
+    int window_count;
+    float ratio;
+    enum window_node_split split;
+    enum window_node_child child;
+    int insert_dir;
+    uint32_t dirty;
+    uint32_t min_width;
+    uint32_t min_height;
+    int min_size_gap;
+    bool is_min_size_valid;
+    bool is_offscreen;
+    struct feedback_window feedback_window;
+};
+
+struct layout_pool
+{
+    struct object_pool node_pool;
+    struct object_pool stack_pool;
+};
+
+//
+// NOTE: The leaves of a tree sorted by the edge that each direction measures
+// its distance to, so that a directional search can start at the closest edge
+// and stop as soon as the remaining leaves are further away than the best one.
+//
+
+struct layout_index_entry
+{
+    float key;
+    int sequence;
+    struct area area;
+    struct window_node *node;
+};
+
+struct layout_index
+{
+    struct layout_index_entry *entry_list[4];
+    int count;
+    int capacity;
+    bool is_valid;
+};
+
+//
+// NOTE: A snapshot is an immutable copy of the structure of a tree. Its nodes
+// are reference counted and shared between snapshots, so a snapshot taken
+// after a change only copies the nodes on the path from the changed nodes to
+// the root, and every untouched subtree is shared with the previous snapshot.
+//
+
+enum layout_snapshot_zoom
+{
+    SNAPSHOT_ZOOM_NONE,
+    SNAPSHOT_ZOOM_PARENT,
+    SNAPSHOT_ZOOM_ROOT
+};
+
+struct layout_snapshot
+{
+    struct layout_snapshot *left;
+    struct layout_snapshot *right;
+    int reference_count;
+    int window_count;
+    float ratio;
+    enum window_node_split split;
+    enum window_node_child child;
+    enum layout_snapshot_zoom zoom;
+    uint32_t window_list[];
+};
+
+#define LAYOUT_HISTORY_SIZE 32
+#define LAYOUT_SNAPSHOT_MAX_DEPTH 1024
+
+struct layout_history
+{
+    struct layout_snapshot *entry_list[LAYOUT_HISTORY_SIZE];
+    int count;
+    int cursor;
+};
+
+struct layout_buffer
+{
+    uint8_t *data;
+    int length;
+    int capacity;
+};
+
+struct layout_config
+{
+    enum window_node_split split_type;
+    enum window_node_child child;
+    float split_ratio;
+    float column_ratio;
+    int gap;
+    uint32_t (*min_width)(void *context, uint32_t window_id);
+    uint32_t (*min_height)(void *context, uint32_t window_id);
+    void *context;
+};
+
+void layout_pool_init(struct layout_pool *pool);
+void layout_pool_reset(struct layout_pool *pool);
+void layout_pool_destroy(struct layout_pool *pool);
+
+struct window_node *window_node_create(struct layout_pool *pool, bool is_leaf);
+void window_node_release(struct layout_pool *pool, struct window_node *node);
+void window_node_reset(struct window_node *node);
+void window_node_split(struct layout_pool *pool, struct layout_config *config, struct window_node *node, uint32_t window_id, struct window_node *zoom);
+struct window_node *window_node_collapse(struct layout_pool *pool, struct window_node *node);
+void window_node_mark_dirty(struct window_node *node, uint32_t dirty);
+
+void window_node_invalidate_min_size(struct window_node *node);
+void layout_enforce_min_size(struct layout_config *config, struct window_node *root);
+enum window_node_split window_node_get_split(struct layout_config *config, struct window_node *node);
+float window_node_get_ratio(struct layout_config *config, struct window_node *node);
+void area_make_pair(enum window_node_split split, int gap, float ratio, struct area *parent_area, struct area *left_area, struct area *right_area);
+void layout_update(struct layout_config *config, struct window_node *node);
+void layout_update_dirty(struct layout_config *config, struct window_node *node);
+float layout_update_scroll(struct layout_config *config, struct window_node *root, float offset);
+
+void window_node_toggle_split(struct window_node *node);
+void window_node_rotate(struct window_node *node, int degrees);
+struct window_node *window_node_mirror(struct window_node *node, enum window_node_split axis);
+void window_node_equalize(struct window_node *node, uint32_t axis_flag, float ratio);
+struct balance_node window_node_balance(struct window_node *node, uint32_t axis_flag);
+
+bool window_node_contains_window(struct window_node *node, uint32_t window_id);
+int window_node_index_of_window(struct window_node *node, uint32_t window_id);
+void window_node_swap_window_list(struct window_node *a_node, struct window_node *b_node);
+struct window_node *window_node_find_first_leaf(struct window_node *root);
+struct window_node *window_node_find_last_leaf(struct window_node *root);
+struct window_node *window_node_find_prev_leaf(struct window_node *node);
+struct window_node *window_node_find_next_leaf(struct window_node *node);
+struct window_node *window_node_fence(struct window_node *node, int dir);
+struct window_node *window_node_find_in_direction(struct window_node *root, struct window_node *source, int direction, uint32_t *window_list, int window_count);
+
+void layout_index_invalidate(struct layout_index *index);
+void layout_index_destroy(struct layout_index *index);
+void layout_snapshot_release(struct layout_snapshot *snapshot);
+struct layout_snapshot *layout_snapshot_take(struct layout_snapshot *prev, struct window_node *node);
+struct window_node *layout_snapshot_restore(struct layout_pool *pool, struct layout_snapshot *snapshot, bool (*is_valid)(void *context, uint32_t window_id), void *context);
+bool layout_history_record(struct layout_history *history, struct window_node *root);
+struct layout_snapshot *layout_history_undo(struct layout_history *history);
+struct layout_snapshot *layout_history_redo(struct layout_history *history);
+void layout_history_clear(struct layout_history *history);
+void layout_buffer_push(struct layout_buffer *buffer, const void *data, int size);
+void layout_snapshot_encode(struct layout_buffer *buffer, struct layout_snapshot *snapshot);
+struct layout_snapshot *layout_snapshot_decode(uint8_t **cursor, uint8_t *end);
+
+struct window_node *layout_index_find_in_direction(struct layout_index *index, struct window_node *root, struct window_node *source, int direction, int (*rank)(void *context, uint32_t window_id), void *context);
+
+#endif
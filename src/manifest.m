@@ -44,14 +44,18 @@
 #include "misc/extern.h"
 #include "misc/macros.h"
 #include "misc/memory_pool.h"
+#include "misc/object_pool.h"
 #include "misc/ts.h"
 //#include "misc/autorelease.h"
 #include "misc/notify.h"
 #include "misc/log.h"
+#include "misc/easing.h"
 #include "misc/helpers.h"
 #include "misc/timer.h"
 #include "misc/macho_dlsym.h"
 #include "misc/sbuffer.h"
+#include "misc/worker_pool.h"
+#include "misc/serializer.h"
 #define HASHTABLE_IMPLEMENTATION
 #include "misc/hashtable.h"
 #undef HASHTABLE_IMPLEMENTATION
@@ -60,10 +64,17 @@
 
 #include "osax/common.h"
 
+#include "layout.h"
+#include "animation.h"
 #include "view.h"
 #include "sa.h"
 #include "event_loop.h"
 #include "event_signal.h"
+#include "event_stream.h"
+#include "query_cache.h"
+#include "capture_cache.h"
+#include "frame_telemetry.h"
+#include "query_predicate.h"
 #include "workspace.h"
 #include "rule.h"
 #include "message.h"
@@ -81,12 +92,19 @@
 #include "mission_control.c"
 #include "event_loop.c"
 #include "event_signal.c"
+#include "event_stream.c"
+#include "query_cache.c"
+#include "capture_cache.c"
+#include "frame_telemetry.c"
+#include "query_predicate.c"
 #include "workspace.m"
 #include "rule.c"
 #include "space_indicator.h"
 #include "message.c"
 #include "display.c"
 #include "space.c"
+#include "layout.c"
+#include "animation.c"
 #include "view.c"
 #include "window.c"
 #include "process_manager.c"
@@ -7,6 +7,9 @@ static struct {
 extern struct event_loop g_event_loop;
 extern struct display_manager g_display_manager;
 extern struct space_manager g_space_manager;
+extern struct query_cache g_query_cache;
+extern struct capture_cache g_capture_cache;
+extern struct frame_telemetry g_frame_telemetry;
 extern struct window_manager g_window_manager;
 extern struct mouse_state g_mouse_state;
 extern enum mission_control_mode g_mission_control_mode;
@@ -19,6 +22,7 @@ extern bool g_verbose;
 #define DOMAIN_QUERY   "query"
 #define DOMAIN_RULE    "rule"
 #define DOMAIN_SIGNAL  "signal"
+#define DOMAIN_SUBSCRIBE "subscribe"
 
 /* --------------------------------DOMAIN CONFIG-------------------------------- */
 #define COMMAND_CONFIG_DEBUG_OUTPUT          "debug_output"
@@ -58,6 +62,8 @@ extern bool g_verbose;
 #define COMMAND_CONFIG_ANIMATION_STARTING_SIZE  "window_animation_starting_size"
 #define COMMAND_CONFIG_ANIMATION_FRAME_BASED    "window_animation_frame_based_enabled"
 #define COMMAND_CONFIG_ANIMATION_FRAME_RATE     "window_animation_frame_rate"
+#define COMMAND_CONFIG_ANIMATION_GOVERNOR       "window_animation_governor"
+#define COMMAND_CONFIG_ANIMATION_PROXY          "window_animation_proxy"
 #define COMMAND_CONFIG_SHADOW                "window_shadow"
 #define COMMAND_CONFIG_MENUBAR_OPACITY       "menubar_opacity"
 #define COMMAND_CONFIG_ACTIVE_WINDOW_OPACITY "active_window_opacity"
@@ -70,6 +76,7 @@ extern bool g_verbose;
 #define COMMAND_CONFIG_LAYOUT                "layout"
 #define COMMAND_CONFIG_WINDOW_GAP            "window_gap"
 #define COMMAND_CONFIG_SPLIT_RATIO           "split_ratio"
+#define COMMAND_CONFIG_SCROLL_COLUMN_WIDTH   "scroll_column_width"
 #define COMMAND_CONFIG_SPLIT_TYPE            "split_type"
 #define COMMAND_CONFIG_AUTO_BALANCE          "auto_balance"
 #define COMMAND_CONFIG_MOUSE_MOD             "mouse_modifier"
@@ -98,6 +105,7 @@ extern bool g_verbose;
 #define ARGUMENT_CONFIG_LAYOUT_BSP            "bsp"
 #define ARGUMENT_CONFIG_LAYOUT_STACK          "stack"
 #define ARGUMENT_CONFIG_LAYOUT_FLOAT          "float"
+#define ARGUMENT_CONFIG_LAYOUT_SCROLL         "scroll"
 #define ARGUMENT_CONFIG_SPLIT_TYPE_Y          "vertical"
 #define ARGUMENT_CONFIG_SPLIT_TYPE_X          "horizontal"
 #define ARGUMENT_CONFIG_SPLIT_TYPE_AUTO       "auto"
@@ -146,6 +154,8 @@ extern bool g_verbose;
 #define COMMAND_SPACE_TOGGLE   "--toggle"
 #define COMMAND_SPACE_LAYOUT   "--layout"
 #define COMMAND_SPACE_LABEL    "--label"
+#define COMMAND_SPACE_UNDO     "--undo"
+#define COMMAND_SPACE_REDO     "--redo"
 
 #define ARGUMENT_SPACE_ROTATE_90    "90"
 #define ARGUMENT_SPACE_ROTATE_180   "180"
@@ -160,6 +170,7 @@ extern bool g_verbose;
 #define ARGUMENT_SPACE_LAYOUT_BSP   "bsp"
 #define ARGUMENT_SPACE_LAYOUT_STACK "stack"
 #define ARGUMENT_SPACE_LAYOUT_FLT   "float"
+#define ARGUMENT_SPACE_LAYOUT_SCROLL "scroll"
 /* ----------------------------------------------------------------------------- */
 
 /* --------------------------------DOMAIN WINDOW-------------------------------- */
@@ -232,10 +243,19 @@ extern bool g_verbose;
 #define COMMAND_QUERY_MC       "--mc"
 #define COMMAND_QUERY_WIDGET   "--widget"
 #define COMMAND_QUERY_WIDGET_TEST "--widget-test"
+#define COMMAND_QUERY_ANIMATIONS "--animations"
 
 #define ARGUMENT_QUERY_DISPLAY "--display"
 #define ARGUMENT_QUERY_SPACE   "--space"
 #define ARGUMENT_QUERY_WINDOW  "--window"
+#define ARGUMENT_QUERY_FORMAT  "--format"
+#define ARGUMENT_QUERY_WHERE   "--where"
+/* ----------------------------------------------------------------------------- */
+
+/* --------------------------------DOMAIN SUBSCRIBE----------------------------- */
+#define COMMAND_SUBSCRIBE_DISPLAYS "--displays"
+#define COMMAND_SUBSCRIBE_SPACES   "--spaces"
+#define COMMAND_SUBSCRIBE_WINDOWS  "--windows"
 /* ----------------------------------------------------------------------------- */
 
 /* --------------------------------DOMAIN RULE---------------------------------- */
@@ -261,6 +281,7 @@ extern bool g_verbose;
 #define ARGUMENT_RULE_KEY_LABEL         "label"
 #define ARGUMENT_RULE_KEY_SCRATCHPAD    "scratchpad"
 #define ARGUMENT_RULE_KEY_MIN_WIDTH     "min_width"
+#define ARGUMENT_RULE_KEY_MIN_HEIGHT    "min_height"
 #define ARGUMENT_RULE_VALUE_SPACE '^'
 #define ARGUMENT_RULE_VALUE_GRID  "%d:%d:%d:%d:%d:%d"
 /* ----------------------------------------------------------------------------- */
@@ -700,6 +721,87 @@ static struct properties parse_properties(FILE *rsp, struct token token, uint64_
     return result;
 }
 
+struct query_options
+{
+    enum serializer_format format;
+    char *where;
+    bool did_error;
+};
+
+static bool parse_format(FILE *rsp, struct token value, enum serializer_format *format)
+{
+    for (int i = 0; i < array_count(serializer_format_str); ++i) {
+        if (token_equals(value, serializer_format_str[i])) {
+            *format = i;
+            return true;
+        }
+    }
+
+    daemon_fail(rsp, "value '%.*s' is not a valid option for '%s'\n", value.length, value.text, ARGUMENT_QUERY_FORMAT);
+    return false;
+}
+
+static struct query_options parse_query_options(FILE *rsp, char **message)
+{
+    struct query_options result = { .format = SERIALIZER_FORMAT_JSON, .where = NULL, .did_error = false };
+
+    for (;;) {
+        char *cursor = *message;
+        struct token token = get_token(&cursor);
+
+        if (token_equals(token, ARGUMENT_QUERY_FORMAT)) {
+            *message = cursor;
+
+            if (!parse_format(rsp, get_token(message), &result.format)) {
+                result.did_error = true;
+                break;
+            }
+        } else if (token_equals(token, ARGUMENT_QUERY_WHERE)) {
+            *message = cursor;
+            struct token value = get_token(message);
+
+            if (!token_is_valid(value)) {
+                daemon_fail(rsp, "missing expression for '%s'\n", ARGUMENT_QUERY_WHERE);
+                result.did_error = true;
+                break;
+            }
+
+            result.where = value.text;
+        } else {
+            break;
+        }
+    }
+
+    return result;
+}
+
+//
+// NOTE: The predicate is compiled right before the query that uses it, after any
+// selector has been parsed, so that every path that compiles it also destroys it.
+//
+
+static struct query_predicate *parse_query_where(FILE *rsp, struct query_options *options, struct query_predicate *predicate, char **property_str, uint64_t *property_val, int property_count)
+{
+    predicate->node_count = 0;
+    if (!options->where) return NULL;
+
+    if (!query_predicate_parse(predicate, options->where, property_str, property_val, property_count)) {
+        daemon_fail(rsp, "%s", predicate->error);
+        options->did_error = true;
+        return NULL;
+    }
+
+    return predicate;
+}
+
+static bool query_where_is_unsupported(FILE *rsp, struct query_options *options)
+{
+    if (!options->where) return false;
+
+    daemon_fail(rsp, "option '%s' can only be used when querying a list\n", ARGUMENT_QUERY_WHERE);
+    return true;
+}
+
 struct selector
 {
     struct token token;
@@ -1598,6 +1700,28 @@ static void handle_domain_config(FILE *rsp, struct token domain, char *message)
             } else {
                 daemon_fail(rsp, "unknown value '%.*s' given to command '%.*s' for domain '%.*s'\n", value.length, value.text, command.length, command.text, domain.length, domain.text);
             }
+        } else if (token_equals(command, COMMAND_CONFIG_ANIMATION_GOVERNOR)) {
+            struct token value = get_token(&message);
+            if (!token_is_valid(value)) {
+                fprintf(rsp, "%s\n", bool_str[g_window_manager.window_animation_governor_enabled]);
+            } else if (token_equals(value, ARGUMENT_COMMON_VAL_OFF)) {
+                g_window_manager.window_animation_governor_enabled = false;
+            } else if (token_equals(value, ARGUMENT_COMMON_VAL_ON)) {
+                g_window_manager.window_animation_governor_enabled = true;
+            } else {
+                daemon_fail(rsp, "unknown value '%.*s' given to command '%.*s' for domain '%.*s'\n", value.length, value.text, command.length, command.text, domain.length, domain.text);
+            }
+        } else if (token_equals(command, COMMAND_CONFIG_ANIMATION_PROXY)) {
+            struct token value = get_token(&message);
+            if (!token_is_valid(value)) {
+                fprintf(rsp, "%s\n", bool_str[g_window_manager.window_animation_proxy_enabled]);
+            } else if (token_equals(value, ARGUMENT_COMMON_VAL_OFF)) {
+                g_window_manager.window_animation_proxy_enabled = false;
+            } else if (token_equals(value, ARGUMENT_COMMON_VAL_ON)) {
+                g_window_manager.window_animation_proxy_enabled = true;
+            } else {
+                daemon_fail(rsp, "unknown value '%.*s' given to command '%.*s' for domain '%.*s'\n", value.length, value.text, command.length, command.text, domain.length, domain.text);
+            }
         } else if (token_equals(command, COMMAND_CONFIG_ANIMATION_STARTING_SIZE)) {
             struct token_value value = token_to_value(get_token(&message));
             if (value.type == TOKEN_TYPE_INVALID) {
@@ -1818,6 +1942,15 @@ static void handle_domain_config(FILE *rsp, struct token domain, char *message)
                     } else {
                         daemon_fail(rsp, "cannot set layout for a macOS fullscreen space!\n");
                     }
+                } else if (token_equals(value, ARGUMENT_CONFIG_LAYOUT_SCROLL)) {
+                    if (space_is_user(sel_sid)) {
+                        view_set_flag(view, VIEW_LAYOUT);
+                        view->layout = VIEW_SCROLL;
+                        view_clear(view);
+                        window_manager_validate_and_check_for_windows_on_space(&g_space_manager, &g_window_manager, sel_sid);
+                    } else {
+                        daemon_fail(rsp, "cannot set layout for a macOS fullscreen space!\n");
+                    }
                 } else if (token_equals(value, ARGUMENT_CONFIG_LAYOUT_FLOAT)) {
                     if (space_is_user(sel_sid)) {
                         view_set_flag(view, VIEW_LAYOUT);
@@ -1836,6 +1969,8 @@ static void handle_domain_config(FILE *rsp, struct token domain, char *message)
                     space_manager_set_layout_for_all_spaces(&g_space_manager, VIEW_BSP);
                 } else if (token_equals(value, ARGUMENT_CONFIG_LAYOUT_STACK)) {
                     space_manager_set_layout_for_all_spaces(&g_space_manager, VIEW_STACK);
+                } else if (token_equals(value, ARGUMENT_CONFIG_LAYOUT_SCROLL)) {
+                    space_manager_set_layout_for_all_spaces(&g_space_manager, VIEW_SCROLL);
                 } else if (token_equals(value, ARGUMENT_CONFIG_LAYOUT_FLOAT)) {
                     space_manager_set_layout_for_all_spaces(&g_space_manager, VIEW_FLOAT);
                 } else {
@@ -1851,6 +1986,15 @@ static void handle_domain_config(FILE *rsp, struct token domain, char *message)
             } else {
                 daemon_fail(rsp, "unknown value '%.*s' given to command '%.*s' for domain '%.*s'\n", value.token.length, value.token.text, command.length, command.text, domain.length, domain.text);
             }
+        } else if (token_equals(command, COMMAND_CONFIG_SCROLL_COLUMN_WIDTH)) {
+            struct token_value value = token_to_value(get_token(&message));
+            if (value.type == TOKEN_TYPE_INVALID) {
+                fprintf(rsp, "%.4f\n", g_space_manager.scroll_column_width);
+            } else if (value.type == TOKEN_TYPE_FLOAT && in_range_ii(value.float_value, 0.1f, 1.0f)) {
+                space_manager_set_scroll_column_width(&g_space_manager, value.float_value);
+            } else {
+                daemon_fail(rsp, "unknown value '%.*s' given to command '%.*s' for domain '%.*s'\n", value.token.length, value.token.text, command.length, command.text, domain.length, domain.text);
+            }
         } else if (token_equals(command, COMMAND_CONFIG_SPLIT_TYPE)) {
             struct token value = get_token(&message);
             if (sel_sid) {
@@ -2355,6 +2499,14 @@ static void handle_domain_space(FILE *rsp, struct token domain, char *message)
             } else {
                 daemon_fail(rsp, "unknown value '%.*s' given to command '%.*s' for domain '%.*s'\n", value.length, value.text, command.length, command.text, domain.length, domain.text);
             }
+        } else if (token_equals(command, COMMAND_SPACE_UNDO)) {
+            if (!space_manager_undo_space(&g_space_manager, acting_sid)) {
+                daemon_fail(rsp, "cannot undo, the selected space has no earlier layout.\n");
+            }
+        } else if (token_equals(command, COMMAND_SPACE_REDO)) {
+            if (!space_manager_redo_space(&g_space_manager, acting_sid)) {
+                daemon_fail(rsp, "cannot redo, the selected space has no later layout.\n");
+            }
         } else if (token_equals(command, COMMAND_SPACE_PADDING)) {
             int t, b, l, r;
             char type[MAXLEN];
@@ -2411,6 +2563,12 @@ static void handle_domain_space(FILE *rsp, struct token domain, char *message)
                 } else {
                     daemon_fail(rsp, "cannot set layout for a macOS fullscreen space!\n");
                 }
+            } else if (token_equals(value, ARGUMENT_SPACE_LAYOUT_SCROLL)) {
+                if (space_is_user(acting_sid)) {
+                    space_manager_set_layout_for_space(&g_space_manager, acting_sid, VIEW_SCROLL);
+                } else {
+                    daemon_fail(rsp, "cannot set layout for a macOS fullscreen space!\n");
+                }
             } else if (token_equals(value, ARGUMENT_SPACE_LAYOUT_FLT)) {
                 if (space_is_user(acting_sid)) {
                     space_manager_set_layout_for_space(&g_space_manager, acting_sid, VIEW_FLOAT);
@@ -2593,8 +2751,6 @@ static void handle_domain_window(FILE *rsp, struct token domain, char *message)
                 enum window_op_error result = window_manager_stack_window(&g_space_manager, &g_window_manager, acting_window, selector.window);
                 if (result == WINDOW_OP_ERROR_INVALID_SRC_NODE) {
                     daemon_fail(rsp, "the acting window is not managed.\n");
-                } else if (result == WINDOW_OP_ERROR_MAX_STACK) {
-                    daemon_fail(rsp, "cannot stack window, max capacity of %d reached.\n", NODE_MAX_WINDOW_COUNT);
                 } else if (result == WINDOW_OP_ERROR_SAME_WINDOW) {
                     daemon_fail(rsp, "cannot stack a window onto itself.\n");
                 }
@@ -3196,6 +3352,10 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
 
     struct token command = get_token(&message);
     if (token_equals(command, COMMAND_QUERY_DISPLAYS)) {
+        struct query_options options = parse_query_options(rsp, &message);
+        if (options.did_error) return;
+
+        struct serializer s = serializer_create(rsp, options.format);
         struct properties properties = parse_properties(rsp, get_token(&message), display_property_val, display_property_str, array_count(display_property_str));
         if (properties.did_error) return;
 
@@ -3212,8 +3372,10 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
-            display_serialize(rsp, acting_did, properties.flags);
-            fprintf(rsp, "\n");
+            if (query_where_is_unsupported(rsp, &options)) return;
+
+            display_serialize(&s, acting_did, properties.flags);
+            serializer_end(&s);
         } else if (token_equals(option, ARGUMENT_QUERY_SPACE)) {
             uint64_t acting_sid = space_manager_active_space();
             struct selector selector = parse_space_selector(rsp, &message, acting_sid, true);
@@ -3226,8 +3388,10 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
-            display_serialize(rsp, space_display_id(acting_sid), properties.flags);
-            fprintf(rsp, "\n");
+            if (query_where_is_unsupported(rsp, &options)) return;
+
+            display_serialize(&s, space_display_id(acting_sid), properties.flags);
+            serializer_end(&s);
         } else if (token_equals(option, ARGUMENT_QUERY_WINDOW)) {
             struct window *acting_window = window_manager_focused_window(&g_window_manager);
             struct selector selector = parse_window_selector(rsp, &message, acting_window, true);
@@ -3240,18 +3404,32 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
+            if (query_where_is_unsupported(rsp, &options)) return;
+
             if (acting_window) {
-                display_serialize(rsp, window_display_id(acting_window->id), properties.flags);
-                fprintf(rsp, "\n");
+                display_serialize(&s, window_display_id(acting_window->id), properties.flags);
+                serializer_end(&s);
             } else {
                 daemon_fail(rsp, "could not find window to retrieve display details.\n");
             }
         } else if (token_is_valid(option)) {
             daemon_fail(rsp, "unknown option '%.*s' given to command '%.*s' for domain '%.*s'\n", option.length, option.text, command.length, command.text, domain.length, domain.text);
         } else {
-            display_manager_query_displays(rsp, properties.flags);
+            struct query_predicate predicate;
+            struct query_predicate *where = parse_query_where(rsp, &options, &predicate, display_property_str, display_property_val, array_count(display_property_str));
+            if (options.did_error) return;
+
+            if (display_manager_query_displays(&s, properties.flags, where)) {
+                serializer_end(&s);
+            }
+
+            query_predicate_destroy(&predicate);
         }
     } else if (token_equals(command, COMMAND_QUERY_SPACES)) {
+        struct query_options options = parse_query_options(rsp, &message);
+        if (options.did_error) return;
+
+        struct serializer s = serializer_create(rsp, options.format);
         struct properties properties = parse_properties(rsp, get_token(&message), space_property_val, space_property_str, array_count(space_property_str));
         if (properties.did_error) return;
 
@@ -3268,9 +3446,17 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
-            if (!space_manager_query_spaces_for_display(rsp, acting_did, properties.flags)) {
+            struct query_predicate predicate;
+            struct query_predicate *where = parse_query_where(rsp, &options, &predicate, space_property_str, space_property_val, array_count(space_property_str));
+            if (options.did_error) return;
+
+            if (space_manager_query_spaces_for_display(&s, acting_did, properties.flags, where)) {
+                serializer_end(&s);
+            } else {
                 daemon_fail(rsp, "could not retrieve spaces for display.\n");
             }
+
+            query_predicate_destroy(&predicate);
         } else if (token_equals(option, ARGUMENT_QUERY_SPACE)) {
             uint64_t acting_sid = space_manager_active_space();
             struct selector selector = parse_space_selector(rsp, &message, acting_sid, true);
@@ -3283,7 +3469,11 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
-            if (!space_manager_query_space(rsp, acting_sid, properties.flags)) {
+            if (query_where_is_unsupported(rsp, &options)) return;
+
+            if (space_manager_query_space(&s, acting_sid, properties.flags)) {
+                serializer_end(&s);
+            } else {
                 daemon_fail(rsp, "could not retrieve space details.\n");
             }
         } else if (token_equals(option, ARGUMENT_QUERY_WINDOW)) {
@@ -3299,16 +3489,38 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
             }
 
             if (acting_window) {
-                space_manager_query_spaces_for_window(rsp, acting_window, properties.flags);
+                struct query_predicate predicate;
+                struct query_predicate *where = parse_query_where(rsp, &options, &predicate, space_property_str, space_property_val, array_count(space_property_str));
+                if (options.did_error) return;
+
+                if (space_manager_query_spaces_for_window(&s, acting_window, properties.flags, where)) {
+                    serializer_end(&s);
+                }
+
+                query_predicate_destroy(&predicate);
             } else {
                 daemon_fail(rsp, "could not find window to retrieve space details.\n");
             }
         } else if (token_is_valid(option)) {
             daemon_fail(rsp, "unknown option '%.*s' given to command '%.*s' for domain '%.*s'\n", option.length, option.text, command.length, command.text, domain.length, domain.text);
-        } else if (!space_manager_query_spaces_for_displays(rsp, properties.flags)) {
-            daemon_fail(rsp, "could not retrieve spaces for displays.\n");
+        } else {
+            struct query_predicate predicate;
+            struct query_predicate *where = parse_query_where(rsp, &options, &predicate, space_property_str, space_property_val, array_count(space_property_str));
+            if (options.did_error) return;
+
+            if (space_manager_query_spaces_for_displays(&s, properties.flags, where)) {
+                serializer_end(&s);
+            } else {
+                daemon_fail(rsp, "could not retrieve spaces for displays.\n");
+            }
+
+            query_predicate_destroy(&predicate);
         }
     } else if (token_equals(command, COMMAND_QUERY_WINDOWS)) {
+        struct query_options options = parse_query_options(rsp, &message);
+        if (options.did_error) return;
+
+        struct serializer s = serializer_create(rsp, options.format);
         struct properties properties = parse_properties(rsp, get_token(&message), window_property_val, window_property_str, array_count(window_property_str));
         if (properties.did_error) return;
 
@@ -3325,7 +3537,14 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
-            window_manager_query_windows_for_display(rsp, acting_did, properties.flags);
+            struct query_predicate predicate;
+            struct query_predicate *where = parse_query_where(rsp, &options, &predicate, window_property_str, window_property_val, array_count(window_property_str));
+            if (options.did_error) return;
+
+            window_manager_query_windows_for_display(&s, acting_did, properties.flags, where);
+            serializer_end(&s);
+
+            query_predicate_destroy(&predicate);
         } else if (token_equals(option, ARGUMENT_QUERY_SPACE)) {
             uint64_t acting_sid = space_manager_active_space();
             struct selector selector = parse_space_selector(rsp, &message, acting_sid, true);
@@ -3338,7 +3557,14 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
-            window_manager_query_windows_for_spaces(rsp, &acting_sid, 1, properties.flags);
+            struct query_predicate predicate;
+            struct query_predicate *where = parse_query_where(rsp, &options, &predicate, window_property_str, window_property_val, array_count(window_property_str));
+            if (options.did_error) return;
+
+            window_manager_query_windows_for_spaces(&s, &acting_sid, 1, properties.flags, where);
+            serializer_end(&s);
+
+            query_predicate_destroy(&predicate);
         } else if (token_equals(option, ARGUMENT_QUERY_WINDOW)) {
             struct window *acting_window = window_manager_focused_window(&g_window_manager);
             struct selector selector = parse_window_selector(rsp, &message, acting_window, true);
@@ -3351,17 +3577,37 @@ static void handle_domain_query(FILE *rsp, struct token domain, char *message)
                 }
             }
 
+            if (query_where_is_unsupported(rsp, &options)) return;
+
             if (acting_window) {
-                window_serialize(rsp, acting_window, properties.flags);
-                fprintf(rsp, "\n");
+                window_serialize(&s, acting_window, properties.flags, NULL);
+                serializer_end(&s);
             } else {
                 daemon_fail(rsp, "could not retrieve window details.\n");
             }
         } else if (token_is_valid(option)) {
             daemon_fail(rsp, "unknown option '%.*s' given to command '%.*s' for domain '%.*s'\n", option.length, option.text, command.length, command.text, domain.length, domain.text);
         } else {
-            window_manager_query_windows_for_displays(rsp, properties.flags);
+            struct query_predicate predicate;
+            struct query_predicate *where = parse_query_where(rsp, &options, &predicate, window_property_str, window_property_val, array_count(window_property_str));
+            if (options.did_error) return;
+
+            window_manager_query_windows_for_displays(&s, properties.flags, where);
+            serializer_end(&s);
+
+            query_predicate_destroy(&predicate);
         }
+    } else if (token_equals(command, COMMAND_QUERY_ANIMATIONS)) {
+        fprintf(rsp, "{\n\"capture_cache\":");
+        capture_cache_serialize(rsp, &g_capture_cache);
+        fprintf(rsp, ",\n\"frames\":");
+        frame_telemetry_serialize(rsp, &g_frame_telemetry);
+        fprintf(rsp, ",\n\"governor\":");
+        pthread_mutex_lock(&g_window_manager.window_animations_lock);
+        animation_governor_serialize(rsp, &g_window_manager.animation_governor, &g_window_manager.animation_quality, g_window_manager.window_animation_governor_enabled);
+        pthread_mutex_unlock(&g_window_manager.window_animations_lock);
+        fprintf(rsp, ",\n\"moves\":{\n\t\"applied\":%lld,\n\t\"skipped\":%lld\n}", g_window_manager.frame_apply_count, g_window_manager.frame_skip_count);
+        fprintf(rsp, "\n}\n");
     } else if (token_equals(command, COMMAND_QUERY_MC)) {
         extern const char *mission_control_mode_str[];
         fprintf(rsp, "\"%s\"\n", mission_control_mode_str[g_mission_control_mode]);
@@ -3596,6 +3842,17 @@ static bool parse_rule(FILE *rsp, char **message, struct rule *rule, struct toke
                 daemon_fail(rsp, "invalid value '%s' for key '%s'\n", value, key);
                 did_parse = false;
             }
+        } else if (string_equals(key, ARGUMENT_RULE_KEY_MIN_HEIGHT)) {
+            if (exclusion) unsupported_exclusion = key;
+
+            uint32_t val = strtoul(value, NULL, 10);
+            if (val > 0) {
+                rule->effects.min_height = val;
+                rule_effects_set_flag(&rule->effects, RULE_EFFECTS_MIN_HEIGHT);
+            } else {
+                daemon_fail(rsp, "invalid value '%s' for key '%s'\n", value, key);
+                did_parse = false;
+            }
         } else {
             daemon_fail(rsp, "unknown key '%s'\n", key);
             did_parse = false;
@@ -3788,9 +4045,58 @@ static void handle_domain_signal(FILE *rsp, struct token domain, char *message)
     }
 }
 
+static void handle_domain_subscribe(FILE *rsp, struct token domain, char *message)
+{
+    TIME_FUNCTION;
+
+    uint32_t domains = 0;
+    enum serializer_format format = SERIALIZER_FORMAT_JSON;
+
+    for (struct token command = get_token(&message); token_is_valid(command); command = get_token(&message)) {
+        if (token_equals(command, COMMAND_SUBSCRIBE_DISPLAYS)) {
+            domains |= EVENT_STREAM_DOMAIN_DISPLAYS;
+        } else if (token_equals(command, COMMAND_SUBSCRIBE_SPACES)) {
+            domains |= EVENT_STREAM_DOMAIN_SPACES;
+        } else if (token_equals(command, COMMAND_SUBSCRIBE_WINDOWS)) {
+            domains |= EVENT_STREAM_DOMAIN_WINDOWS;
+        } else if (token_equals(command, ARGUMENT_QUERY_FORMAT)) {
+            if (!parse_format(rsp, get_token(&message), &format)) return;
+        } else {
+            daemon_fail(rsp, "unknown command '%.*s' for domain '%.*s'\n", command.length, command.text, domain.length, domain.text);
+            return;
+        }
+    }
+
+    if (!domains) domains = EVENT_STREAM_DOMAIN_ALL;
+
+    //
+    // NOTE: The subscriber starts out with a complete snapshot of the domains it
+    // subscribed to, written synchronously like a regular query response. The
+    // connection is then kept open and handed over to the event stream, which
+    // appends incremental records as events are processed.
+    //
+
+    struct serializer s = serializer_create(rsp, format);
+    event_stream_serialize_snapshot(&s, domains);
+    serializer_end(&s);
+    fflush(rsp);
+
+    int sockfd = dup(fileno(rsp));
+    if (sockfd == -1) return;
+
+    if (!event_stream_add_subscriber(sockfd, domains, format)) {
+        socket_close(sockfd);
+    }
+}
+
 void handle_message(FILE *rsp, char *message)
 {
     struct token domain = get_token(&message);
+
+    if (!token_equals(domain, DOMAIN_QUERY) && !token_equals(domain, DOMAIN_SUBSCRIBE)) {
+        query_cache_invalidate_all(&g_query_cache);
+    }
+
     if (token_equals(domain, DOMAIN_CONFIG)) {
         handle_domain_config(rsp, domain, message);
     } else if (token_equals(domain, DOMAIN_DISPLAY)) {
@@ -3805,6 +4111,8 @@ void handle_message(FILE *rsp, char *message)
         handle_domain_rule(rsp, domain, message);
     } else if (token_equals(domain, DOMAIN_SIGNAL)) {
         handle_domain_signal(rsp, domain, message);
+    } else if (token_equals(domain, DOMAIN_SUBSCRIBE)) {
+        handle_domain_subscribe(rsp, domain, message);
     } else {
         daemon_fail(rsp, "unknown domain '%.*s'\n", domain.length, domain.text);
     }
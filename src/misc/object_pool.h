@@ -0,0 +1,98 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+//
+// NOTE: Fixed-size objects are carved out of chunks that are never moved, so
+// pointers handed out stay valid until the object is freed or the pool is
+// reset. Freed objects are threaded onto an intrusive free-list, and a reset
+// rewinds to the first chunk so that the chunks can be reused without going
+// through malloc again.
+//
+
+struct object_pool_chunk
+{
+    struct object_pool_chunk *next;
+    uint64_t memory[];
+};
+
+struct object_pool
+{
+    struct object_pool_chunk *chunks;
+    struct object_pool_chunk *cursor;
+    void *free_list;
+    uint32_t object_size;
+    uint32_t chunk_capacity;
+    uint32_t used;
+    uint32_t count;
+};
+
+void object_pool_init(struct object_pool *pool, uint32_t object_size, uint32_t chunk_capacity)
+{
+    memset(pool, 0, sizeof(struct object_pool));
+    pool->object_size = (object_size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+    pool->chunk_capacity = chunk_capacity;
+}
+
+void *object_pool_alloc(struct object_pool *pool)
+{
+    void *object = pool->free_list;
+
+    if (object) {
+        pool->free_list = *(void **) object;
+    } else {
+        if (!pool->cursor || pool->used == pool->chunk_capacity) {
+            struct object_pool_chunk *chunk = pool->cursor ? pool->cursor->next : pool->chunks;
+
+            if (!chunk) {
+                chunk = malloc(sizeof(struct object_pool_chunk) + (uint64_t) pool->object_size * pool->chunk_capacity);
+                chunk->next = NULL;
+
+                if (pool->cursor) {
+                    pool->cursor->next = chunk;
+                } else {
+                    pool->chunks = chunk;
+                }
+            }
+
+            pool->cursor = chunk;
+            pool->used = 0;
+        }
+
+        object = (char *) pool->cursor->memory + (uint64_t) pool->object_size * pool->used++;
+    }
+
+    ++pool->count;
+    memset(object, 0, pool->object_size);
+    return object;
+}
+
+void object_pool_free(struct object_pool *pool, void *object)
+{
+    *(void **) object = pool->free_list;
+    pool->free_list = object;
+    --pool->count;
+}
+
+void object_pool_reset(struct object_pool *pool)
+{
+    pool->cursor = NULL;
+    pool->free_list = NULL;
+    pool->used = 0;
+    pool->count = 0;
+}
+
+void object_pool_destroy(struct object_pool *pool)
+{
+    struct object_pool_chunk *chunk = pool->chunks;
+
+    while (chunk) {
+        struct object_pool_chunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    pool->chunks = NULL;
+    object_pool_reset(pool);
+}
+
+#endif
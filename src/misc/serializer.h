@@ -0,0 +1,331 @@
+#ifndef SERIALIZER_H
+#define SERIALIZER_H
+
+//
+// NOTE: A small emitter used by the query system that writes either the
+// regular json output, or the same document encoded as msgpack. The json
+// formatting matches what the serializers used to print by hand, so that
+// existing consumers see byte-identical output. msgpack needs element
+// counts up-front, which is why objects and arrays take a count when they
+// are opened; json ignores it.
+//
+
+#define SERIALIZER_FORMAT_LIST \
+    SERIALIZER_FORMAT_ENTRY("json",    SERIALIZER_FORMAT_JSON) \
+    SERIALIZER_FORMAT_ENTRY("msgpack", SERIALIZER_FORMAT_MSGPACK)
+
+enum serializer_format
+{
+#define SERIALIZER_FORMAT_ENTRY(n, f) f,
+    SERIALIZER_FORMAT_LIST
+#undef SERIALIZER_FORMAT_ENTRY
+};
+
+static char *serializer_format_str[] =
+{
+#define SERIALIZER_FORMAT_ENTRY(n, f) n,
+    SERIALIZER_FORMAT_LIST
+#undef SERIALIZER_FORMAT_ENTRY
+};
+
+#define SERIALIZER_MAX_DEPTH 8
+
+struct serializer
+{
+    FILE *rsp;
+    enum serializer_format format;
+    int indent;
+    int depth;
+    bool is_array[SERIALIZER_MAX_DEPTH];
+    bool did_output[SERIALIZER_MAX_DEPTH];
+};
+
+static inline void msgpack_write_u8(FILE *rsp, uint8_t value)
+{
+    fputc(value, rsp);
+}
+
+static inline void msgpack_write_u16(FILE *rsp, uint16_t value)
+{
+    value = __builtin_bswap16(value);
+    fwrite(&value, sizeof(value), 1, rsp);
+}
+
+static inline void msgpack_write_u32(FILE *rsp, uint32_t value)
+{
+    value = __builtin_bswap32(value);
+    fwrite(&value, sizeof(value), 1, rsp);
+}
+
+static inline void msgpack_write_u64(FILE *rsp, uint64_t value)
+{
+    value = __builtin_bswap64(value);
+    fwrite(&value, sizeof(value), 1, rsp);
+}
+
+static inline void msgpack_write_header(FILE *rsp, uint8_t fix, uint8_t fix_max, uint8_t op16, uint8_t op32, uint32_t count)
+{
+    if (count <= fix_max) {
+        msgpack_write_u8(rsp, fix | count);
+    } else if (count <= UINT16_MAX) {
+        msgpack_write_u8(rsp, op16);
+        msgpack_write_u16(rsp, count);
+    } else {
+        msgpack_write_u8(rsp, op32);
+        msgpack_write_u32(rsp, count);
+    }
+}
+
+static inline void msgpack_write_map(FILE *rsp, uint32_t count)
+{
+    msgpack_write_header(rsp, 0x80, 0x0f, 0xde, 0xdf, count);
+}
+
+static inline void msgpack_write_array(FILE *rsp, uint32_t count)
+{
+    msgpack_write_header(rsp, 0x90, 0x0f, 0xdc, 0xdd, count);
+}
+
+static inline void msgpack_write_str(FILE *rsp, const char *str)
+{
+    uint32_t length = (uint32_t) strlen(str);
+
+    if (length <= 0x1f) {
+        msgpack_write_u8(rsp, 0xa0 | length);
+    } else if (length <= UINT8_MAX) {
+        msgpack_write_u8(rsp, 0xd9);
+        msgpack_write_u8(rsp, length);
+    } else {
+        msgpack_write_header(rsp, 0, 0, 0xda, 0xdb, length);
+    }
+
+    fwrite(str, length, 1, rsp);
+}
+
+static inline void msgpack_write_uint(FILE *rsp, uint64_t value)
+{
+    if (value <= 0x7f) {
+        msgpack_write_u8(rsp, value);
+    } else if (value <= UINT8_MAX) {
+        msgpack_write_u8(rsp, 0xcc);
+        msgpack_write_u8(rsp, value);
+    } else if (value <= UINT16_MAX) {
+        msgpack_write_u8(rsp, 0xcd);
+        msgpack_write_u16(rsp, value);
+    } else if (value <= UINT32_MAX) {
+        msgpack_write_u8(rsp, 0xce);
+        msgpack_write_u32(rsp, value);
+    } else {
+        msgpack_write_u8(rsp, 0xcf);
+        msgpack_write_u64(rsp, value);
+    }
+}
+
+static inline void msgpack_write_int(FILE *rsp, int64_t value)
+{
+    if (value >= 0) {
+        msgpack_write_uint(rsp, value);
+    } else if (value >= -32) {
+        msgpack_write_u8(rsp, (uint8_t)(int8_t) value);
+    } else if (value >= INT8_MIN) {
+        msgpack_write_u8(rsp, 0xd0);
+        msgpack_write_u8(rsp, (uint8_t)(int8_t) value);
+    } else if (value >= INT16_MIN) {
+        msgpack_write_u8(rsp, 0xd1);
+        msgpack_write_u16(rsp, (uint16_t)(int16_t) value);
+    } else if (value >= INT32_MIN) {
+        msgpack_write_u8(rsp, 0xd2);
+        msgpack_write_u32(rsp, (uint32_t)(int32_t) value);
+    } else {
+        msgpack_write_u8(rsp, 0xd3);
+        msgpack_write_u64(rsp, (uint64_t) value);
+    }
+}
+
+static inline void msgpack_write_float(FILE *rsp, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    msgpack_write_u8(rsp, 0xca);
+    msgpack_write_u32(rsp, bits);
+}
+
+static inline void msgpack_write_bool(FILE *rsp, bool value)
+{
+    msgpack_write_u8(rsp, value ? 0xc3 : 0xc2);
+}
+
+static inline struct serializer serializer_create(FILE *rsp, enum serializer_format format)
+{
+    return (struct serializer) { .rsp = rsp, .format = format };
+}
+
+static inline int serializer_property_count(uint64_t flags, uint64_t *property_val, int property_count)
+{
+    int result = 0;
+
+    for (int i = 0; i < property_count; ++i) {
+        if (flags & property_val[i]) ++result;
+    }
+
+    return result;
+}
+
+static inline void serializer__push(struct serializer *s, bool is_array)
+{
+    assert(s->depth+1 < SERIALIZER_MAX_DEPTH);
+
+    ++s->depth;
+    s->is_array[s->depth] = is_array;
+    s->did_output[s->depth] = false;
+}
+
+static inline void serializer__value(struct serializer *s)
+{
+    if (!s->is_array[s->depth]) return;
+
+    if (s->did_output[s->depth] && s->format == SERIALIZER_FORMAT_JSON) {
+        fprintf(s->rsp, s->indent ? ", " : ",");
+    }
+
+    s->did_output[s->depth] = true;
+}
+
+static inline void serializer_key(struct serializer *s, char *key)
+{
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_str(s->rsp, key);
+    } else {
+        if (s->did_output[s->depth]) fprintf(s->rsp, ",\n");
+        fprintf(s->rsp, "%.*s\"%s\":", s->indent, "\t\t\t\t\t\t\t\t", key);
+    }
+
+    s->did_output[s->depth] = true;
+}
+
+static inline void serializer_begin_object(struct serializer *s, int count)
+{
+    serializer__value(s);
+    serializer__push(s, false);
+
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_map(s->rsp, count);
+    } else {
+        fprintf(s->rsp, "{\n");
+    }
+
+    ++s->indent;
+}
+
+static inline void serializer_end_object(struct serializer *s)
+{
+    --s->indent;
+    --s->depth;
+
+    if (s->format == SERIALIZER_FORMAT_JSON) {
+        fprintf(s->rsp, "\n%.*s}", s->indent, "\t\t\t\t\t\t\t\t");
+    }
+}
+
+static inline void serializer_begin_array(struct serializer *s, int count)
+{
+    serializer__value(s);
+    serializer__push(s, true);
+
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_array(s->rsp, count);
+    } else {
+        fprintf(s->rsp, "[");
+    }
+}
+
+static inline void serializer_end_array(struct serializer *s)
+{
+    --s->depth;
+
+    if (s->format == SERIALIZER_FORMAT_JSON) {
+        fprintf(s->rsp, "]");
+    }
+}
+
+static inline void serializer_end(struct serializer *s)
+{
+    if (s->format == SERIALIZER_FORMAT_JSON) {
+        fprintf(s->rsp, "\n");
+    }
+}
+
+static inline void serializer_int(struct serializer *s, int64_t value)
+{
+    serializer__value(s);
+
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_int(s->rsp, value);
+    } else {
+        fprintf(s->rsp, "%lld", (long long) value);
+    }
+}
+
+static inline void serializer_uint(struct serializer *s, uint64_t value)
+{
+    serializer__value(s);
+
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_uint(s->rsp, value);
+    } else {
+        fprintf(s->rsp, "%llu", (unsigned long long) value);
+    }
+}
+
+static inline void serializer_float(struct serializer *s, double value, int precision)
+{
+    serializer__value(s);
+
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_float(s->rsp, (float) value);
+    } else {
+        fprintf(s->rsp, "%.*f", precision, value);
+    }
+}
+
+static inline void serializer_bool(struct serializer *s, bool value)
+{
+    serializer__value(s);
+
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_bool(s->rsp, value);
+    } else {
+        fprintf(s->rsp, "%s", json_bool(value));
+    }
+}
+
+static inline void serializer_string(struct serializer *s, const char *value)
+{
+    serializer__value(s);
+
+    if (s->format == SERIALIZER_FORMAT_MSGPACK) {
+        msgpack_write_str(s->rsp, value);
+    } else {
+        char *escaped_value = ts_string_escape((char *) value);
+        fprintf(s->rsp, "\"%s\"", escaped_value ? escaped_value : value);
+    }
+}
+
+static inline void serializer_raw(struct serializer *s, char *data, size_t size)
+{
+    serializer__value(s);
+    fwrite(data, 1, size, s->rsp);
+}
+
+static inline void serializer_frame(struct serializer *s, CGRect frame)
+{
+    serializer_begin_object(s, 4);
+    serializer_key(s, "x"); serializer_float(s, frame.origin.x, 4);
+    serializer_key(s, "y"); serializer_float(s, frame.origin.y, 4);
+    serializer_key(s, "w"); serializer_float(s, frame.size.width, 4);
+    serializer_key(s, "h"); serializer_float(s, frame.size.height, 4);
+    serializer_end_object(s);
+}
+
+#endif
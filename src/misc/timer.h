@@ -133,6 +133,24 @@ static void END_TIME_BLOCK(void *context)
     anchor->label = tb->label;
 }
 
+//
+// NOTE: Adds time that was measured elsewhere, such as on a worker thread, to
+// an anchor of its own. It is not subtracted from the enclosing block, since
+// it did not necessarily run on the thread that is being profiled.
+//
+
+static void RECORD_TIME_BLOCK(const char *label, uint32_t anchor_index, uint64_t elapsed_ns)
+{
+    uint64_t elapsed = (uint64_t)((double)elapsed_ns * (double)read_cpu_freq() / 1000000000.0);
+
+    struct profile_anchor *anchor = g_profiler.anchors + anchor_index;
+    anchor->tsc_elapsed_exclusive += elapsed;
+    anchor->tsc_elapsed_inclusive += elapsed;
+    ++anchor->hit_count;
+
+    anchor->label = label;
+}
+
 #define TIME_FUNCTION \
     __attribute((cleanup(END_TIME_BLOCK))) struct time_block tb_##__FUNCTION__;\
     BEGIN_TIME_BLOCK(&tb_##__FUNCTION__, __FUNCTION__, __COUNTER__ + 1)
@@ -146,11 +164,14 @@ do {\
     TIME_BLOCK(label);\
     c \
 } while (0)
+#define TIME_RECORD(label, elapsed_ns) RECORD_TIME_BLOCK(#label, __COUNTER__ + 1, elapsed_ns)
+
 #define PROFILER_END_TRANSLATION_UNIT _Static_assert(__COUNTER__ < array_count(g_profiler.anchors), "Number of profile points exceeds size of profiler::anchors array!");
 #else
 #define TIME_FUNCTION
 #define TIME_BLOCK(label)
 #define TIME_BODY(label, c) c
+#define TIME_RECORD(label, elapsed_ns)
 #define PROFILER_END_TRANSLATION_UNIT
 #endif
 #else
@@ -159,6 +180,7 @@ do {\
 #define TIME_FUNCTION
 #define TIME_BLOCK(label)
 #define TIME_BODY(label, c) c
+#define TIME_RECORD(label, elapsed_ns)
 #define PROFILER_END_TRANSLATION_UNIT
 #endif
 
@@ -0,0 +1,155 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+//
+// NOTE: A fixed set of threads that drain a shared queue of tasks. A batch is
+// submitted with worker_pool_run, which also has the calling thread claim
+// tasks from the queue and only returns once every task in the batch is done,
+// so the task list can live on the stack of the caller. Only one thread may
+// submit batches to a pool. The time spent in every task is recorded in the
+// task itself and in the totals of the pool.
+//
+
+struct worker_task
+{
+    void *(*proc)(void *data);
+    void *data;
+    uint64_t elapsed_ns;
+};
+
+struct worker_pool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t has_work;
+    pthread_cond_t is_done;
+    pthread_t *thread_list;
+    int thread_count;
+    struct worker_task *task_list;
+    int task_count;
+    int next_task;
+    int pending_count;
+    bool is_stopping;
+    uint64_t completed_count;
+    uint64_t elapsed_total_ns;
+    uint64_t elapsed_max_ns;
+};
+
+static inline uint64_t worker_pool_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static inline void worker_task_run(struct worker_task *task)
+{
+    uint64_t begin = worker_pool_clock_ns();
+    task->proc(task->data);
+    task->elapsed_ns = worker_pool_clock_ns() - begin;
+}
+
+//
+// NOTE: Claims tasks until the queue is empty. Called with the lock held, and
+// returns with the lock held.
+//
+
+static inline void worker_pool_drain(struct worker_pool *pool)
+{
+    while (pool->next_task < pool->task_count) {
+        struct worker_task *task = &pool->task_list[pool->next_task++];
+
+        pthread_mutex_unlock(&pool->lock);
+        worker_task_run(task);
+        pthread_mutex_lock(&pool->lock);
+
+        if (--pool->pending_count == 0) {
+            pthread_cond_broadcast(&pool->is_done);
+        }
+    }
+}
+
+static void *worker_pool_thread_proc(void *data)
+{
+    struct worker_pool *pool = data;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->is_stopping) {
+        if (pool->next_task < pool->task_count) {
+            worker_pool_drain(pool);
+        } else {
+            pthread_cond_wait(&pool->has_work, &pool->lock);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+static inline int worker_pool_core_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+}
+
+void worker_pool_init(struct worker_pool *pool, int thread_count)
+{
+    memset(pool, 0, sizeof(struct worker_pool));
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->has_work, NULL);
+    pthread_cond_init(&pool->is_done, NULL);
+
+    pool->thread_list = malloc(sizeof(pthread_t) * (thread_count > 0 ? thread_count : 1));
+    for (int i = 0; i < thread_count; ++i) {
+        if (pthread_create(&pool->thread_list[pool->thread_count], NULL, &worker_pool_thread_proc, pool) == 0) {
+            ++pool->thread_count;
+        }
+    }
+}
+
+void worker_pool_run(struct worker_pool *pool, struct worker_task *task_list, int task_count)
+{
+    if (task_count <= 0) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task_list     = task_list;
+    pool->task_count    = task_count;
+    pool->next_task     = 0;
+    pool->pending_count = task_count;
+    pthread_cond_broadcast(&pool->has_work);
+
+    worker_pool_drain(pool);
+    while (pool->pending_count > 0) {
+        pthread_cond_wait(&pool->is_done, &pool->lock);
+    }
+
+    pool->task_list  = NULL;
+    pool->task_count = 0;
+    pool->next_task  = 0;
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < task_count; ++i) {
+        pool->completed_count  += 1;
+        pool->elapsed_total_ns += task_list[i].elapsed_ns;
+        if (task_list[i].elapsed_ns > pool->elapsed_max_ns) pool->elapsed_max_ns = task_list[i].elapsed_ns;
+    }
+}
+
+void worker_pool_destroy(struct worker_pool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->is_stopping = true;
+    pthread_cond_broadcast(&pool->has_work);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count; ++i) {
+        pthread_join(pool->thread_list[i], NULL);
+    }
+
+    free(pool->thread_list);
+    pthread_cond_destroy(&pool->has_work);
+    pthread_cond_destroy(&pool->is_done);
+    pthread_mutex_destroy(&pool->lock);
+    memset(pool, 0, sizeof(struct worker_pool));
+}
+
+#endif
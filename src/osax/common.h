@@ -1,7 +1,7 @@
 #ifndef SA_COMMON_H
 #define SA_COMMON_H
 
-#define OSAX_VERSION                "2.1.22"
+#define OSAX_VERSION                "2.1.23"
 
 #define OSAX_ATTRIB_DOCK_SPACES     0x01
 #define OSAX_ATTRIB_DPPM            0x02
@@ -44,6 +44,7 @@ enum sa_opcode
     SA_OPCODE_WINDOW_ORDER_IN       = 0x14,
     SA_OPCODE_WINDOW_LIST_TO_SPACE  = 0x15,
     SA_OPCODE_WINDOW_TO_SPACE       = 0x16,
+    SA_OPCODE_WINDOW_SCALE_FORCED_BATCH = 0x18,
 };
 
 #endif
@@ -865,6 +865,69 @@ static void do_window_scale_forced(char *message)
     }
 }
 
+//
+// NOTE: Computes the transform that a forced scale request puts a window in.
+// Shared by the single request, which may add it to a transaction, and by the
+// batch, which adds the transforms of every window to one transaction.
+//
+
+static bool window_scale_forced_transform(uint32_t wid, int mode, float dx, float dy, float dw, float dh, float clip_x, float clip_y, float clip_w, float clip_h, CGAffineTransform *transform)
+{
+    CGRect frame = {};
+    SLSGetWindowBounds(SLSMainConnectionID(), wid, &frame);
+    CGAffineTransform original_transform = CGAffineTransformMakeTranslation(-(frame.origin.x), -(frame.origin.y));
+
+    float effective_x = dx;
+    float effective_y = dy;
+    float effective_w = dw;
+    float effective_h = dh;
+
+    if (clip_w > 0 && clip_h > 0) {
+        // Intersect target rectangle with clipping rectangle
+        effective_x = fmaxf(dx, clip_x);
+        effective_y = fmaxf(dy, clip_y);
+        effective_w = fmaxf(0, fminf(dx + dw, clip_x + clip_w) - effective_x);
+        effective_h = fmaxf(0, fminf(dy + dh, clip_y + clip_h) - effective_y);
+    }
+
+    switch (mode) {
+        case 0: // create_pip - scale window and position it with optional clipping
+        {
+            int target_width  = effective_w;
+            int target_height = target_width / (frame.size.width/frame.size.height);
+            if (target_width <= 0 || target_height <= 0) return false;
+
+            float x_scale = frame.size.width/target_width;
+            float y_scale = frame.size.height/target_height;
+
+            CGAffineTransform scale = CGAffineTransformConcat(CGAffineTransformIdentity, CGAffineTransformMakeScale(x_scale, y_scale));
+            *transform = CGAffineTransformTranslate(scale, -(effective_x), -(effective_y));
+            return true;
+        }
+
+        case 1: // move_pip - update position FORCED (no transform check) with optional clipping
+        {
+            CGAffineTransform current_transform;
+            SLSGetWindowTransform(SLSMainConnectionID(), wid, &current_transform);
+
+            // Keep the scale the window is currently drawn at
+            CGAffineTransform scale = CGAffineTransformConcat(CGAffineTransformIdentity, CGAffineTransformMakeScale(current_transform.a, current_transform.d));
+            *transform = CGAffineTransformTranslate(scale, -(effective_x), -(effective_y));
+            return true;
+        }
+
+        case 2: // restore_pip - reset to original transform
+        {
+            *transform = original_transform;
+            return true;
+        }
+
+        default:
+            NSLog(@"🎯 FORCED unknown mode: %d", mode);
+            return false;
+    }
+}
+
 static void do_window_scale_forced_with_transaction(char *message)
 {
     uint32_t wid;
@@ -875,13 +938,6 @@ static void do_window_scale_forced_with_transaction(char *message)
     uint64_t transaction_ptr;
     unpack(transaction_ptr);
     CFTypeRef transaction = (CFTypeRef)transaction_ptr;
-    
-    CGRect frame = {};
-    SLSGetWindowBounds(SLSMainConnectionID(), wid, &frame);
-    CGAffineTransform original_transform = CGAffineTransformMakeTranslation(-(frame.origin.x), -(frame.origin.y));
-
-    CGAffineTransform current_transform;
-    SLSGetWindowTransform(SLSMainConnectionID(), wid, &current_transform);
 
     // Unpack the operation mode and coordinates
     int mode;
@@ -899,122 +955,58 @@ static void do_window_scale_forced_with_transaction(char *message)
     unpack(clip_y);
     unpack(clip_w);
     unpack(clip_h);
-    
-    bool should_clip = (clip_w > 0 && clip_h > 0);
-    
-    NSLog(@"🎯 FORCED+TX mode=%d pos=(%.1f,%.1f) size=(%.1fx%.1f) clip=(%.1f,%.1f,%.1fx%.1f) should_clip=%s tx=%p", 
-          mode, dx, dy, dw, dh, clip_x, clip_y, clip_w, clip_h, should_clip ? "YES" : "NO", transaction);
 
-    switch (mode) {
-        case 0: // create_pip - scale window and position it with optional clipping
-        {
-            // Apply clipping if specified
-            float effective_x = dx;
-            float effective_y = dy;
-            float effective_w = dw;
-            float effective_h = dh;
-            
-            if (should_clip) {
-                // Intersect target rectangle with clipping rectangle
-                float target_right = dx + dw;
-                float target_bottom = dy + dh;
-                float clip_right = clip_x + clip_w;
-                float clip_bottom = clip_y + clip_h;
-                
-                effective_x = fmaxf(dx, clip_x);
-                effective_y = fmaxf(dy, clip_y);
-                effective_w = fmaxf(0, fminf(target_right, clip_right) - effective_x);
-                effective_h = fmaxf(0, fminf(target_bottom, clip_bottom) - effective_y);
-                
-                NSLog(@"🎯 FORCED+TX create_pip CLIPPING: original=(%.1f,%.1f,%.1fx%.1f) clipped=(%.1f,%.1f,%.1fx%.1f)", 
-                      dx, dy, dw, dh, effective_x, effective_y, effective_w, effective_h);
-            }
-            
-            int target_width  = effective_w;
-            int target_height = target_width / (frame.size.width/frame.size.height);
+    CGAffineTransform transform;
+    if (!window_scale_forced_transform(wid, mode, dx, dy, dw, dh, clip_x, clip_y, clip_w, clip_h, &transform)) return;
 
-            float x_scale = frame.size.width/target_width;
-            float y_scale = frame.size.height/target_height;
+    // Use transaction if provided, otherwise fall back to direct call
+    if (transaction) {
+        SLSTransactionSetWindowTransform(transaction, wid, transform);
+    } else {
+        SLSSetWindowTransform(SLSMainConnectionID(), wid, transform);
+    }
+}
 
-            CGFloat transformed_x = -(effective_x);
-            CGFloat transformed_y = -(effective_y);
-            
-            CGAffineTransform scale = CGAffineTransformConcat(CGAffineTransformIdentity, CGAffineTransformMakeScale(x_scale, y_scale));
-            CGAffineTransform transform = CGAffineTransformTranslate(scale, transformed_x, transformed_y);
-            
-            // Use transaction if provided, otherwise fall back to direct call
-            if (transaction) {
-                SLSTransactionSetWindowTransform(transaction, wid, transform);
-                NSLog(@"🎯 FORCED+TX create_pip: Added transform to transaction");
-            } else {
-                SLSSetWindowTransform(SLSMainConnectionID(), wid, transform);
-                NSLog(@"🎯 FORCED+TX create_pip: Applied transform directly");
-            }
-            break;
-        }
-        
-        case 1: // move_pip - update position FORCED (no transform check) with optional clipping
-        {
-            // Apply clipping if specified
-            float effective_x = dx;
-            float effective_y = dy;
-            float effective_w = dw;
-            float effective_h = dh;
-            
-            if (should_clip) {
-                // Intersect target rectangle with clipping rectangle
-                float target_right = dx + dw;
-                float target_bottom = dy + dh;
-                float clip_right = clip_x + clip_w;
-                float clip_bottom = clip_y + clip_h;
-                
-                effective_x = fmaxf(dx, clip_x);
-                effective_y = fmaxf(dy, clip_y);
-                effective_w = fmaxf(0, fminf(target_right, clip_right) - effective_x);
-                effective_h = fmaxf(0, fminf(target_bottom, clip_bottom) - effective_y);
-            }
+//
+// NOTE: Every window of one animation frame, applied in a single transaction
+// that is created and committed here, in the process that owns it. An alpha
+// below zero leaves the system alpha of the window as it is.
+//
 
-            // Extract current scale from transform (or use defaults if not scaled)
-            float current_x_scale = current_transform.a;
-            float current_y_scale = current_transform.d;
-            
-            // Calculate new translation using scale and clipped coordinates
-            CGFloat new_transformed_x = -(effective_x);
-            CGFloat new_transformed_y = -(effective_y);
-            
-            CGAffineTransform scale = CGAffineTransformConcat(CGAffineTransformIdentity, CGAffineTransformMakeScale(current_x_scale, current_y_scale));
-            CGAffineTransform transform = CGAffineTransformTranslate(scale, new_transformed_x, new_transformed_y);
-            
-            // Use transaction if provided, otherwise fall back to direct call
-            if (transaction) {
-                SLSTransactionSetWindowTransform(transaction, wid, transform);
-                NSLog(@"🎯 FORCED+TX move_pip: Added transform to transaction");
-            } else {
-                SLSSetWindowTransform(SLSMainConnectionID(), wid, transform);
-                NSLog(@"🎯 FORCED+TX move_pip: Applied transform directly");
-            }
-            break;
+static void do_window_scale_forced_batch(char *message)
+{
+    int count = 0;
+    unpack(count);
+    if (!count) return;
+
+    CFTypeRef transaction = SLSTransactionCreate(SLSMainConnectionID());
+    for (int i = 0; i < count; ++i) {
+        uint32_t wid;
+        unpack(wid);
+
+        int mode;
+        unpack(mode);
+
+        float dx, dy, dw, dh, alpha;
+        unpack(dx);
+        unpack(dy);
+        unpack(dw);
+        unpack(dh);
+        unpack(alpha);
+
+        if (!wid) continue;
+
+        CGAffineTransform transform;
+        if (window_scale_forced_transform(wid, mode, dx, dy, dw, dh, 0, 0, 0, 0, &transform)) {
+            SLSTransactionSetWindowTransform(transaction, wid, transform);
         }
-        
-        case 2: // restore_pip - reset to original transform
-        {
-            NSLog(@"🎯 FORCED+TX restore_pip: resetting to original transform");
-            
-            // Use transaction if provided, otherwise fall back to direct call
-            if (transaction) {
-                SLSTransactionSetWindowTransform(transaction, wid, original_transform);
-                NSLog(@"🎯 FORCED+TX restore_pip: Added restore to transaction");
-            } else {
-                SLSSetWindowTransform(SLSMainConnectionID(), wid, original_transform);
-                NSLog(@"🎯 FORCED+TX restore_pip: Applied restore directly");
-            }
-            break;
+
+        if (alpha >= 0.0f) {
+            SLSTransactionSetWindowSystemAlpha(transaction, wid, alpha);
         }
-        
-        default:
-            NSLog(@"🎯 FORCED+TX unknown mode: %d", mode);
-            break;
     }
+    SLSTransactionCommit(transaction, 0);
+    CFRelease(transaction);
 }
 
 static void do_window_animate_frame(char *message)
@@ -1463,6 +1455,9 @@ static void handle_message(int sockfd, char *message)
     case SA_OPCODE_WINDOW_SCALE_FORCED_TX: {
         do_window_scale_forced_with_transaction(message);
     } break;
+    case SA_OPCODE_WINDOW_SCALE_FORCED_BATCH: {
+        do_window_scale_forced_batch(message);
+    } break;
     case SA_OPCODE_WINDOW_ANIMATE_FRAME: {
         do_window_animate_frame(message);
     } break;
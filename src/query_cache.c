@@ -0,0 +1,155 @@
+static TABLE_HASH_FUNC(hash_query_cache)
+{
+    struct query_cache_key *k = key;
+    uint64_t h = k->id * 0x9e3779b97f4a7c15ULL;
+    h ^= k->flags + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= ((uint64_t)k->domain << 16) | ((uint64_t)k->format << 8) | k->indent;
+    return (unsigned long) h;
+}
+
+static TABLE_COMPARE_FUNC(compare_query_cache)
+{
+    struct query_cache_key *a = key_a;
+    struct query_cache_key *b = key_b;
+    return a->id     == b->id     &&
+           a->flags  == b->flags  &&
+           a->domain == b->domain &&
+           a->format == b->format &&
+           a->indent == b->indent;
+}
+
+static struct query_cache_key query_cache_key(struct serializer *s, enum query_cache_domain domain, uint64_t id, uint64_t flags)
+{
+    struct query_cache_key key;
+    memset(&key, 0, sizeof(key));
+
+    key.id     = id;
+    key.flags  = flags;
+    key.domain = domain;
+    key.format = s->format;
+    key.indent = s->indent;
+
+    return key;
+}
+
+static void query_cache_clear(struct query_cache *cache)
+{
+    struct query_cache_entry *entry;
+    table_for(entry, cache->entries, {
+        free(entry->data);
+        free(entry);
+    })
+
+    table_free(&cache->entries);
+    table_init(&cache->entries, 150, hash_query_cache, compare_query_cache);
+}
+
+void query_cache_init(struct query_cache *cache)
+{
+    table_init(&cache->entries, 150, hash_query_cache, compare_query_cache);
+    cache->epoch = 0;
+}
+
+void query_cache_invalidate_all(struct query_cache *cache)
+{
+    ++cache->epoch;
+}
+
+//
+// NOTE: Only the events that are known to affect nothing but the properties of
+// the window they are reported for bump the generation of that window. Every
+// other event may change properties that are derived from global state, such as
+// has-focus, is-visible, the list of windows on a space, or the index of a
+// space, and therefore bumps the epoch that every cached fragment is tagged with.
+// A move is only local to the window as long as it stays on the same space and
+// display; otherwise the window lists of the spaces and displays it moved
+// between have changed as well.
+//
+
+void query_cache_invalidate_for_signal(struct query_cache *cache, enum signal_type type, void *context)
+{
+    switch (type) {
+    case SIGNAL_WINDOW_MOVED: {
+        struct window *window = context;
+        ++window->generation;
+
+        uint64_t sid = window_space(window->id);
+        uint32_t did = window_display_id(window->id);
+
+        if (sid != window->query_sid || did != window->query_did) {
+            window->query_sid = sid;
+            window->query_did = did;
+            ++cache->epoch;
+        }
+    } break;
+    case SIGNAL_WINDOW_RESIZED:
+    case SIGNAL_WINDOW_TITLE_CHANGED: {
+        struct window *window = context;
+        ++window->generation;
+    } break;
+    default: {
+        ++cache->epoch;
+    } break;
+    }
+}
+
+bool query_cache_emit(struct query_cache *cache, struct serializer *s, enum query_cache_domain domain, uint64_t id, uint32_t generation, uint64_t flags)
+{
+    struct query_cache_key key = query_cache_key(s, domain, id, flags);
+    struct query_cache_entry *entry = table_find(&cache->entries, &key);
+    if (!entry) return false;
+
+    if (entry->generation != generation) return false;
+    if (entry->epoch      != cache->epoch) return false;
+
+    //
+    // NOTE: Some properties are read from the window server and can be changed
+    // by other processes without us receiving any notification, e.g. the level
+    // or opacity of a window. Fragments are therefore only trusted for a short
+    // amount of time, even if nothing we know of has invalidated them.
+    //
+
+    if (read_os_timer() - entry->timestamp > QUERY_CACHE_MAX_AGE * read_os_freq()) return false;
+
+    serializer_raw(s, entry->data, entry->size);
+    return true;
+}
+
+struct serializer *query_cache_begin(struct query_cache_capture *capture, struct serializer *s, enum query_cache_domain domain, uint64_t id, uint64_t flags)
+{
+    capture->key    = query_cache_key(s, domain, id, flags);
+    capture->parent = s;
+    capture->data   = NULL;
+    capture->size   = 0;
+    capture->file   = open_memstream(&capture->data, &capture->size);
+    if (!capture->file) return s;
+
+    capture->s = serializer_create(capture->file, s->format);
+    capture->s.indent = s->indent;
+
+    return &capture->s;
+}
+
+void query_cache_end(struct query_cache *cache, struct query_cache_capture *capture, uint32_t generation)
+{
+    if (!capture->file) return;
+
+    fclose(capture->file);
+    serializer_raw(capture->parent, capture->data, capture->size);
+
+    struct query_cache_entry *entry = table_find(&cache->entries, &capture->key);
+    if (entry) {
+        free(entry->data);
+    } else {
+        if (cache->entries.count >= QUERY_CACHE_MAX_ENTRIES) query_cache_clear(cache);
+
+        entry = malloc(sizeof(struct query_cache_entry));
+        table_add(&cache->entries, &capture->key, entry);
+    }
+
+    entry->generation = generation;
+    entry->epoch      = cache->epoch;
+    entry->timestamp  = read_os_timer();
+    entry->size       = capture->size;
+    entry->data       = capture->data;
+}
@@ -0,0 +1,55 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#define QUERY_CACHE_MAX_ENTRIES 4096
+#define QUERY_CACHE_MAX_AGE     2.0f
+
+enum query_cache_domain
+{
+    QUERY_CACHE_DOMAIN_WINDOW,
+    QUERY_CACHE_DOMAIN_SPACE,
+    QUERY_CACHE_DOMAIN_DISPLAY
+};
+
+struct query_cache_key
+{
+    uint64_t id;
+    uint64_t flags;
+    uint8_t domain;
+    uint8_t format;
+    uint8_t indent;
+};
+
+struct query_cache_entry
+{
+    uint32_t generation;
+    uint32_t epoch;
+    uint64_t timestamp;
+    size_t size;
+    char *data;
+};
+
+struct query_cache_capture
+{
+    struct query_cache_key key;
+    struct serializer *parent;
+    struct serializer s;
+    FILE *file;
+    char *data;
+    size_t size;
+};
+
+struct query_cache
+{
+    struct table entries;
+    uint32_t epoch;
+};
+
+void query_cache_init(struct query_cache *cache);
+void query_cache_invalidate_all(struct query_cache *cache);
+void query_cache_invalidate_for_signal(struct query_cache *cache, enum signal_type type, void *context);
+bool query_cache_emit(struct query_cache *cache, struct serializer *s, enum query_cache_domain domain, uint64_t id, uint32_t generation, uint64_t flags);
+struct serializer *query_cache_begin(struct query_cache_capture *capture, struct serializer *s, enum query_cache_domain domain, uint64_t id, uint64_t flags);
+void query_cache_end(struct query_cache *cache, struct query_cache_capture *capture, uint32_t generation);
+
+#endif
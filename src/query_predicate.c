@@ -0,0 +1,514 @@
+enum query_predicate_token_type
+{
+    QUERY_PREDICATE_TOKEN_END,
+    QUERY_PREDICATE_TOKEN_WORD,
+    QUERY_PREDICATE_TOKEN_STRING,
+    QUERY_PREDICATE_TOKEN_LPAREN,
+    QUERY_PREDICATE_TOKEN_RPAREN,
+    QUERY_PREDICATE_TOKEN_AND,
+    QUERY_PREDICATE_TOKEN_OR,
+    QUERY_PREDICATE_TOKEN_NOT,
+    QUERY_PREDICATE_TOKEN_COMPARE,
+    QUERY_PREDICATE_TOKEN_ERROR
+};
+
+struct query_predicate_token
+{
+    enum query_predicate_token_type type;
+    enum query_predicate_op op;
+    char *text;
+};
+
+struct query_predicate_parser
+{
+    struct query_predicate *predicate;
+    char **property_str;
+    uint64_t *property_val;
+    int property_count;
+    char *cursor;
+    struct query_predicate_token token;
+};
+
+static char *query_predicate_copy(char *text, int length)
+{
+    char *result = ts_alloc_unaligned(length + 1);
+    memcpy(result, text, length);
+    result[length] = '\0';
+    return result;
+}
+
+static inline bool query_predicate_is_word(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '+';
+}
+
+static void query_predicate_next_token(struct query_predicate_parser *parser)
+{
+    char *cursor = parser->cursor;
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == '\n') ++cursor;
+
+    struct query_predicate_token token = { .type = QUERY_PREDICATE_TOKEN_ERROR, .text = cursor };
+
+    if (*cursor == '\0') {
+        token.type = QUERY_PREDICATE_TOKEN_END;
+    } else if (*cursor == '(') {
+        token.type = QUERY_PREDICATE_TOKEN_LPAREN;
+        ++cursor;
+    } else if (*cursor == ')') {
+        token.type = QUERY_PREDICATE_TOKEN_RPAREN;
+        ++cursor;
+    } else if (cursor[0] == '&' && cursor[1] == '&') {
+        token.type = QUERY_PREDICATE_TOKEN_AND;
+        cursor += 2;
+    } else if (cursor[0] == '|' && cursor[1] == '|') {
+        token.type = QUERY_PREDICATE_TOKEN_OR;
+        cursor += 2;
+    } else if (cursor[0] == '=' && cursor[1] == '=') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_EQ;
+        cursor += 2;
+    } else if (cursor[0] == '!' && cursor[1] == '=') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_NE;
+        cursor += 2;
+    } else if (cursor[0] == '=' && cursor[1] == '~') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_MATCH;
+        cursor += 2;
+    } else if (cursor[0] == '!' && cursor[1] == '~') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_NOT_MATCH;
+        cursor += 2;
+    } else if (cursor[0] == '<' && cursor[1] == '=') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_LE;
+        cursor += 2;
+    } else if (cursor[0] == '>' && cursor[1] == '=') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_GE;
+        cursor += 2;
+    } else if (*cursor == '<') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_LT;
+        ++cursor;
+    } else if (*cursor == '>') {
+        token.type = QUERY_PREDICATE_TOKEN_COMPARE; token.op = QUERY_PREDICATE_GT;
+        ++cursor;
+    } else if (*cursor == '!') {
+        token.type = QUERY_PREDICATE_TOKEN_NOT;
+        ++cursor;
+    } else if (*cursor == '"' || *cursor == '\'') {
+        char quote = *cursor++;
+        char *string = ts_alloc_unaligned(strlen(cursor) + 1);
+        int length = 0;
+
+        while (*cursor && *cursor != quote) {
+            if (*cursor == '\\' && cursor[1]) ++cursor;
+            string[length++] = *cursor++;
+        }
+        string[length] = '\0';
+
+        if (*cursor == quote) {
+            token.type = QUERY_PREDICATE_TOKEN_STRING;
+            token.text = string;
+            ++cursor;
+        }
+    } else if (query_predicate_is_word(*cursor)) {
+        char *start = cursor;
+        while (query_predicate_is_word(*cursor)) ++cursor;
+
+        token.type = QUERY_PREDICATE_TOKEN_WORD;
+        token.text = query_predicate_copy(start, cursor - start);
+    }
+
+    parser->token = token;
+    parser->cursor = cursor;
+}
+
+static int query_predicate_node_create(struct query_predicate_parser *parser, enum query_predicate_op op)
+{
+    struct query_predicate *predicate = parser->predicate;
+
+    if (predicate->node_count >= QUERY_PREDICATE_MAX_NODES) {
+        snprintf(predicate->error, sizeof(predicate->error), "expression is too complex\n");
+        return -1;
+    }
+
+    int index = predicate->node_count++;
+    memset(&predicate->nodes[index], 0, sizeof(struct query_predicate_node));
+    predicate->nodes[index].op = op;
+    predicate->nodes[index].left = -1;
+    predicate->nodes[index].right = -1;
+
+    return index;
+}
+
+static bool query_predicate_parse_key(struct query_predicate_parser *parser, char *key)
+{
+    char *separator = strchr(key, '.');
+    int length = separator ? separator - key : (int) strlen(key);
+
+    for (int i = 0; i < parser->property_count; ++i) {
+        if ((int) strlen(parser->property_str[i]) == length && strncmp(parser->property_str[i], key, length) == 0) {
+            parser->predicate->flags |= parser->property_val[i];
+            return true;
+        }
+    }
+
+    snprintf(parser->predicate->error, sizeof(parser->predicate->error), "unknown property '%s' in expression\n", key);
+    return false;
+}
+
+static int query_predicate_parse_or(struct query_predicate_parser *parser);
+
+static int query_predicate_parse_comparison(struct query_predicate_parser *parser)
+{
+    struct query_predicate *predicate = parser->predicate;
+
+    if (parser->token.type != QUERY_PREDICATE_TOKEN_WORD) {
+        snprintf(predicate->error, sizeof(predicate->error), "expected property name at '%s'\n", parser->token.text);
+        return -1;
+    }
+
+    char *key = parser->token.text;
+    if (!query_predicate_parse_key(parser, key)) return -1;
+    query_predicate_next_token(parser);
+
+    if (parser->token.type != QUERY_PREDICATE_TOKEN_COMPARE) {
+        int index = query_predicate_node_create(parser, QUERY_PREDICATE_TRUTHY);
+        if (index != -1) predicate->nodes[index].key = key;
+        return index;
+    }
+
+    enum query_predicate_op op = parser->token.op;
+    query_predicate_next_token(parser);
+
+    if (parser->token.type != QUERY_PREDICATE_TOKEN_WORD && parser->token.type != QUERY_PREDICATE_TOKEN_STRING) {
+        snprintf(predicate->error, sizeof(predicate->error), "expected value for property '%s' at '%s'\n", key, parser->token.text);
+        return -1;
+    }
+
+    int index = query_predicate_node_create(parser, op);
+    if (index == -1) return -1;
+
+    struct query_predicate_node *node = &predicate->nodes[index];
+    node->key = key;
+    node->value = parser->token.text;
+
+    if (op == QUERY_PREDICATE_MATCH || op == QUERY_PREDICATE_NOT_MATCH) {
+        node->regex_valid = regcomp(&node->regex, node->value, REG_EXTENDED | REG_NOSUB) == 0;
+        if (!node->regex_valid) {
+            snprintf(predicate->error, sizeof(predicate->error), "invalid regex pattern '%s' for property '%s'\n", node->value, key);
+            return -1;
+        }
+    }
+
+    query_predicate_next_token(parser);
+    return index;
+}
+
+static int query_predicate_parse_unary(struct query_predicate_parser *parser)
+{
+    if (parser->token.type == QUERY_PREDICATE_TOKEN_NOT) {
+        query_predicate_next_token(parser);
+
+        int operand = query_predicate_parse_unary(parser);
+        if (operand == -1) return -1;
+
+        int index = query_predicate_node_create(parser, QUERY_PREDICATE_NOT);
+        if (index != -1) parser->predicate->nodes[index].left = operand;
+        return index;
+    }
+
+    if (parser->token.type == QUERY_PREDICATE_TOKEN_LPAREN) {
+        query_predicate_next_token(parser);
+
+        int index = query_predicate_parse_or(parser);
+        if (index == -1) return -1;
+
+        if (parser->token.type != QUERY_PREDICATE_TOKEN_RPAREN) {
+            snprintf(parser->predicate->error, sizeof(parser->predicate->error), "expected ')' at '%s'\n", parser->token.text);
+            return -1;
+        }
+
+        query_predicate_next_token(parser);
+        return index;
+    }
+
+    return query_predicate_parse_comparison(parser);
+}
+
+static int query_predicate_parse_binary(struct query_predicate_parser *parser, enum query_predicate_token_type type, enum query_predicate_op op, int (*parse_operand)(struct query_predicate_parser *))
+{
+    int left = parse_operand(parser);
+    if (left == -1) return -1;
+
+    while (parser->token.type == type) {
+        query_predicate_next_token(parser);
+
+        int right = parse_operand(parser);
+        if (right == -1) return -1;
+
+        int index = query_predicate_node_create(parser, op);
+        if (index == -1) return -1;
+
+        parser->predicate->nodes[index].left = left;
+        parser->predicate->nodes[index].right = right;
+        left = index;
+    }
+
+    return left;
+}
+
+static int query_predicate_parse_and(struct query_predicate_parser *parser)
+{
+    return query_predicate_parse_binary(parser, QUERY_PREDICATE_TOKEN_AND, QUERY_PREDICATE_AND, query_predicate_parse_unary);
+}
+
+static int query_predicate_parse_or(struct query_predicate_parser *parser)
+{
+    return query_predicate_parse_binary(parser, QUERY_PREDICATE_TOKEN_OR, QUERY_PREDICATE_OR, query_predicate_parse_and);
+}
+
+bool query_predicate_parse(struct query_predicate *predicate, char *expression, char **property_str, uint64_t *property_val, int property_count)
+{
+    predicate->flags = 0;
+    predicate->root = -1;
+    predicate->node_count = 0;
+    predicate->error[0] = '\0';
+
+    struct query_predicate_parser parser = {
+        .predicate      = predicate,
+        .property_str   = property_str,
+        .property_val   = property_val,
+        .property_count = property_count,
+        .cursor         = expression
+    };
+
+    query_predicate_next_token(&parser);
+    predicate->root = query_predicate_parse_or(&parser);
+
+    if (predicate->root != -1 && parser.token.type != QUERY_PREDICATE_TOKEN_END) {
+        snprintf(predicate->error, sizeof(predicate->error), "unexpected '%s' in expression\n", parser.token.text);
+        predicate->root = -1;
+    }
+
+    if (predicate->root == -1) {
+        query_predicate_destroy(predicate);
+        return false;
+    }
+
+    return true;
+}
+
+void query_predicate_destroy(struct query_predicate *predicate)
+{
+    for (int i = 0; i < predicate->node_count; ++i) {
+        if (predicate->nodes[i].regex_valid) regfree(&predicate->nodes[i].regex);
+    }
+
+    predicate->node_count = 0;
+}
+
+//
+// NOTE: Objects are tested against the predicate by serializing the properties
+// it references as msgpack, which goes through the query cache like any other
+// query, and decoding the top-level fields of the resulting map. Nested objects
+// are flattened using dotted keys, e.g. frame.w; arrays are not addressable.
+//
+
+static inline uint64_t query_msgpack_read(uint8_t **cursor, uint8_t *end, int size)
+{
+    uint64_t result = 0;
+    for (int i = 0; i < size && *cursor < end; ++i) result = (result << 8) | *(*cursor)++;
+    return result;
+}
+
+static bool query_msgpack_decode(uint8_t **cursor, uint8_t *end, char *key, struct query_field *fields, int *field_count);
+
+static bool query_msgpack_decode_map(uint8_t **cursor, uint8_t *end, char *prefix, int count, struct query_field *fields, int *field_count)
+{
+    for (int i = 0; i < count; ++i) {
+        if (*cursor >= end) return false;
+
+        uint8_t c = *(*cursor)++;
+        uint32_t length;
+
+        if ((c & 0xe0) == 0xa0) {
+            length = c & 0x1f;
+        } else if (c == 0xd9) {
+            length = query_msgpack_read(cursor, end, 1);
+        } else if (c == 0xda) {
+            length = query_msgpack_read(cursor, end, 2);
+        } else {
+            return false;
+        }
+
+        if (*cursor + length > end) return false;
+
+        char key[48];
+        if (prefix) {
+            snprintf(key, sizeof(key), "%s.%.*s", prefix, length, *cursor);
+        } else {
+            snprintf(key, sizeof(key), "%.*s", length, *cursor);
+        }
+        *cursor += length;
+
+        if (!query_msgpack_decode(cursor, end, key, fields, field_count)) return false;
+    }
+
+    return true;
+}
+
+static bool query_msgpack_decode(uint8_t **cursor, uint8_t *end, char *key, struct query_field *fields, int *field_count)
+{
+    if (*cursor >= end) return false;
+
+    struct query_field field = { .type = QUERY_FIELD_NUMBER };
+    uint8_t c = *(*cursor)++;
+
+    if (c <= 0x7f) {
+        field.number = c;
+    } else if (c >= 0xe0) {
+        field.number = (int8_t) c;
+    } else if (c >= 0xcc && c <= 0xcf) {
+        field.number = query_msgpack_read(cursor, end, 1 << (c - 0xcc));
+    } else if (c >= 0xd0 && c <= 0xd3) {
+        int size = 1 << (c - 0xd0);
+        uint64_t value = query_msgpack_read(cursor, end, size);
+        field.number = size == 1 ? (int8_t) value : size == 2 ? (int16_t) value : size == 4 ? (int32_t) value : (int64_t) value;
+    } else if (c == 0xca) {
+        uint32_t bits = query_msgpack_read(cursor, end, 4);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        field.number = value;
+        field.is_float32 = true;
+    } else if (c == 0xcb) {
+        uint64_t bits = query_msgpack_read(cursor, end, 8);
+        memcpy(&field.number, &bits, sizeof(field.number));
+    } else if (c == 0xc2 || c == 0xc3) {
+        field.type = QUERY_FIELD_BOOL;
+        field.boolean = c == 0xc3;
+    } else if ((c & 0xe0) == 0xa0 || c == 0xd9 || c == 0xda || c == 0xdb) {
+        uint32_t length = (c & 0xe0) == 0xa0 ? c & 0x1f : query_msgpack_read(cursor, end, 1 << (c - 0xd9));
+        if (*cursor + length > end) return false;
+
+        field.type = QUERY_FIELD_STRING;
+        field.string = query_predicate_copy((char *) *cursor, length);
+        *cursor += length;
+    } else if ((c & 0xf0) == 0x80 || c == 0xde || c == 0xdf) {
+        uint32_t count = (c & 0xf0) == 0x80 ? c & 0x0f : query_msgpack_read(cursor, end, c == 0xde ? 2 : 4);
+        return query_msgpack_decode_map(cursor, end, key, count, fields, field_count);
+    } else if ((c & 0xf0) == 0x90 || c == 0xdc || c == 0xdd) {
+        uint32_t count = (c & 0xf0) == 0x90 ? c & 0x0f : query_msgpack_read(cursor, end, c == 0xdc ? 2 : 4);
+        for (int i = 0; i < count; ++i) {
+            int ignored = QUERY_PREDICATE_MAX_FIELDS;
+            if (!query_msgpack_decode(cursor, end, key, fields, &ignored)) return false;
+        }
+        return true;
+    } else if (c == 0xc0) {
+        return true;
+    } else {
+        return false;
+    }
+
+    if (!key || *field_count >= QUERY_PREDICATE_MAX_FIELDS) return true;
+
+    snprintf(field.key, sizeof(field.key), "%s", key);
+    fields[(*field_count)++] = field;
+
+    return true;
+}
+
+static struct query_field *query_field_find(struct query_field *fields, int field_count, char *key)
+{
+    for (int i = 0; i < field_count; ++i) {
+        if (string_equals(fields[i].key, key)) return &fields[i];
+    }
+
+    return NULL;
+}
+
+static bool query_field_compare(struct query_predicate_node *node, struct query_field *field)
+{
+    if (node->op == QUERY_PREDICATE_TRUTHY) {
+        switch (field->type) {
+        case QUERY_FIELD_BOOL:   return field->boolean;
+        case QUERY_FIELD_NUMBER: return field->number != 0;
+        case QUERY_FIELD_STRING: return field->string[0] != '\0';
+        }
+    }
+
+    if (node->op == QUERY_PREDICATE_MATCH || node->op == QUERY_PREDICATE_NOT_MATCH) {
+        if (field->type != QUERY_FIELD_STRING) return false;
+
+        bool match = regex_match(node->regex_valid, &node->regex, field->string) == REGEX_MATCH_YES;
+        return node->op == QUERY_PREDICATE_MATCH ? match : !match;
+    }
+
+    int order;
+
+    if (field->type == QUERY_FIELD_STRING) {
+        order = strcmp(field->string, node->value);
+    } else if (field->type == QUERY_FIELD_BOOL) {
+        if (!string_equals(node->value, "true") && !string_equals(node->value, "false")) return false;
+        order = field->boolean == string_equals(node->value, "true") ? 0 : 1;
+    } else {
+        char *end;
+        double value = strtod(node->value, &end);
+        if (end == node->value || *end != '\0') return false;
+
+        //
+        // NOTE: Floats are serialized with single precision, so the value that
+        // is compared against them is rounded the same way; otherwise 0.9 would
+        // never equal an opacity of 0.9.
+        //
+
+        if (field->is_float32) value = (float) value;
+        order = field->number < value ? -1 : field->number > value ? 1 : 0;
+    }
+
+    switch (node->op) {
+    default:                   return false;
+    case QUERY_PREDICATE_EQ:   return order == 0;
+    case QUERY_PREDICATE_NE:   return order != 0;
+    case QUERY_PREDICATE_LT:   return field->type == QUERY_FIELD_NUMBER && order <  0;
+    case QUERY_PREDICATE_LE:   return field->type == QUERY_FIELD_NUMBER && order <= 0;
+    case QUERY_PREDICATE_GT:   return field->type == QUERY_FIELD_NUMBER && order >  0;
+    case QUERY_PREDICATE_GE:   return field->type == QUERY_FIELD_NUMBER && order >= 0;
+    }
+}
+
+static bool query_predicate_eval(struct query_predicate *predicate, int index, struct query_field *fields, int field_count)
+{
+    struct query_predicate_node *node = &predicate->nodes[index];
+
+    switch (node->op) {
+    case QUERY_PREDICATE_AND: return query_predicate_eval(predicate, node->left, fields, field_count) && query_predicate_eval(predicate, node->right, fields, field_count);
+    case QUERY_PREDICATE_OR:  return query_predicate_eval(predicate, node->left, fields, field_count) || query_predicate_eval(predicate, node->right, fields, field_count);
+    case QUERY_PREDICATE_NOT: return !query_predicate_eval(predicate, node->left, fields, field_count);
+    default: {
+        struct query_field *field = query_field_find(fields, field_count, node->key);
+        return field ? query_field_compare(node, field) : false;
+    } break;
+    }
+}
+
+bool query_predicate_begin(struct query_predicate_capture *capture)
+{
+    capture->data = NULL;
+    capture->size = 0;
+    capture->file = open_memstream(&capture->data, &capture->size);
+    if (!capture->file) return false;
+
+    capture->s = serializer_create(capture->file, SERIALIZER_FORMAT_MSGPACK);
+    return true;
+}
+
+bool query_predicate_end(struct query_predicate *predicate, struct query_predicate_capture *capture)
+{
+    fclose(capture->file);
+
+    struct query_field fields[QUERY_PREDICATE_MAX_FIELDS];
+    int field_count = 0;
+
+    uint8_t *cursor = (uint8_t *) capture->data;
+    bool result = query_msgpack_decode(&cursor, cursor + capture->size, NULL, fields, &field_count) &&
+                  query_predicate_eval(predicate, predicate->root, fields, field_count);
+
+    free(capture->data);
+    return result;
+}
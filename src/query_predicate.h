@@ -0,0 +1,73 @@
+#ifndef QUERY_PREDICATE_H
+#define QUERY_PREDICATE_H
+
+#define QUERY_PREDICATE_MAX_NODES  64
+#define QUERY_PREDICATE_MAX_FIELDS 64
+
+enum query_predicate_op
+{
+    QUERY_PREDICATE_AND,
+    QUERY_PREDICATE_OR,
+    QUERY_PREDICATE_NOT,
+    QUERY_PREDICATE_TRUTHY,
+    QUERY_PREDICATE_EQ,
+    QUERY_PREDICATE_NE,
+    QUERY_PREDICATE_MATCH,
+    QUERY_PREDICATE_NOT_MATCH,
+    QUERY_PREDICATE_LT,
+    QUERY_PREDICATE_LE,
+    QUERY_PREDICATE_GT,
+    QUERY_PREDICATE_GE
+};
+
+struct query_predicate_node
+{
+    enum query_predicate_op op;
+    int left;
+    int right;
+    char *key;
+    char *value;
+    bool regex_valid;
+    regex_t regex;
+};
+
+struct query_predicate
+{
+    uint64_t flags;
+    int root;
+    int node_count;
+    struct query_predicate_node nodes[QUERY_PREDICATE_MAX_NODES];
+    char error[256];
+};
+
+enum query_field_type
+{
+    QUERY_FIELD_NUMBER,
+    QUERY_FIELD_BOOL,
+    QUERY_FIELD_STRING
+};
+
+struct query_field
+{
+    char key[48];
+    enum query_field_type type;
+    double number;
+    bool is_float32;
+    bool boolean;
+    char *string;
+};
+
+struct query_predicate_capture
+{
+    struct serializer s;
+    FILE *file;
+    char *data;
+    size_t size;
+};
+
+bool query_predicate_parse(struct query_predicate *predicate, char *expression, char **property_str, uint64_t *property_val, int property_count);
+void query_predicate_destroy(struct query_predicate *predicate);
+bool query_predicate_begin(struct query_predicate_capture *capture);
+bool query_predicate_end(struct query_predicate *predicate, struct query_predicate_capture *capture);
+
+#endif
@@ -35,6 +35,7 @@ void rule_serialize(FILE *rsp, struct rule *rule, int index)
             "\t\"grid\":\"%d:%d:%d:%d:%d:%d\",\n"
             "\t\"scratchpad\":\"%s\",\n"
             "\t\"min_width\":%d,\n"
+            "\t\"min_height\":%d,\n"
             "\t\"one-shot\":%s,\n"
             "\t\"flags\":\"0x%08x\"\n"
             "}",
@@ -58,6 +59,7 @@ void rule_serialize(FILE *rsp, struct rule *rule, int index)
             rule->effects.grid[4], rule->effects.grid[5],
             rule->effects.scratchpad ? rule->effects.scratchpad : "",
             rule->effects.min_width ? rule->effects.min_width : 0,
+            rule->effects.min_height ? rule->effects.min_height : 0,
             json_bool(rule_check_flag(rule, RULE_ONE_SHOT)),
             (uint32_t)(rule->effects.flags << 16) | (uint32_t)rule->flags);
 }
@@ -97,6 +99,11 @@ void rule_combine_effects(struct rule_effects *effects, struct rule_effects *res
     rule_effects_set_flag(result, RULE_EFFECTS_MIN_WIDTH);
 }
 
+    if (rule_effects_check_flag(effects, RULE_EFFECTS_MIN_HEIGHT)) {
+        result->min_height = effects->min_height;
+        rule_effects_set_flag(result, RULE_EFFECTS_MIN_HEIGHT);
+    }
+
     if (effects->scratchpad) {
         if (result->scratchpad) free(result->scratchpad);
         result->scratchpad = string_copy(effects->scratchpad);
@@ -25,6 +25,7 @@ enum rule_effects_flag
     RULE_OPACITY            = 0x02,
     RULE_LAYER              = 0x04,
     RULE_EFFECTS_MIN_WIDTH  = 0x08,
+    RULE_EFFECTS_MIN_HEIGHT = 0x10,
 };
 
 struct rule_effects
@@ -41,6 +42,7 @@ struct rule_effects
     char *scratchpad;
     uint16_t flags;
     uint32_t min_width;
+    uint32_t min_height;
 };
 
 struct rule
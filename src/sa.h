@@ -4,6 +4,14 @@
 #include <stdint.h>
 typedef const void* CFTypeRef;
 
+struct window_scale
+{
+    uint32_t wid;
+    int mode;
+    float x, y, w, h;
+    float alpha;
+};
+
 extern unsigned char __src_osax_payload[];
 extern unsigned int __src_osax_payload_len;
 extern unsigned char __src_osax_loader[];
@@ -28,6 +36,7 @@ bool scripting_addition_scale_window_custom(uint32_t wid, float x, float y, floa
 bool scripting_addition_scale_window_custom_mode(uint32_t wid, int mode, float x, float y, float w, float h);
 bool scripting_addition_scale_window_forced_mode(uint32_t wid, int mode, float x, float y, float w, float h);
 bool scripting_addition_scale_window_forced_mode_with_transaction(uint32_t wid, CFTypeRef transaction, int mode, float x, float y, float w, float h);
+bool scripting_addition_scale_window_list_forced(struct window_scale *scale_list, int scale_count);
 bool scripting_addition_create_pip(uint32_t wid, float x, float y, float w, float h);
 bool scripting_addition_move_pip(uint32_t wid, float x, float y);
 bool scripting_addition_restore_pip(uint32_t wid);
@@ -38,8 +47,8 @@ bool scripting_addition_animate_window_frame(uint32_t wid,
                                             float src_x, float src_y, float src_w, float src_h,
                                             float dst_x, float dst_y, float dst_w, float dst_h,
                                             float progress, int anchor_point);
-bool scripting_addition_swap_window_proxy_in(struct window_animation *animation_list, int animation_count);
-bool scripting_addition_swap_window_proxy_out(struct window_animation *animation_list, int animation_count);
+bool scripting_addition_swap_window_proxy_in(struct window_animation **animation_list, int animation_count);
+bool scripting_addition_swap_window_proxy_out(struct window_animation **animation_list, int animation_count);
 bool scripting_addition_order_window(uint32_t a_wid, int order, uint32_t b_wid);
 bool scripting_addition_order_window_in(uint32_t *window_list, int window_count);
 bool scripting_addition_move_window_list_to_space(uint64_t sid, uint32_t *window_list, int window_count);
@@ -596,6 +596,38 @@ bool scripting_addition_scale_window_forced_mode_with_transaction(uint32_t wid,
     return sa_payload_send(SA_OPCODE_WINDOW_SCALE_FORCED_TX);
 }
 
+//
+// NOTE: Sends the scale requests of one animation frame as a single message,
+// which the payload applies in one transaction. A frame with more windows than
+// fit in the buffer of a message is split across as many messages as needed.
+//
+
+#define SA_WINDOW_SCALE_BATCH_MAX ((int)((0x1000 - sizeof(int16_t) - 1 - sizeof(int)) / (sizeof(uint32_t) + sizeof(int) + 5 * sizeof(float))))
+
+bool scripting_addition_scale_window_list_forced(struct window_scale *scale_list, int scale_count)
+{
+    bool result = true;
+
+    for (int offset = 0; offset < scale_count; offset += SA_WINDOW_SCALE_BATCH_MAX) {
+        int count = min(scale_count - offset, SA_WINDOW_SCALE_BATCH_MAX);
+
+        sa_payload_init();
+        pack(count);
+        for (int i = offset; i < offset + count; ++i) {
+            pack(scale_list[i].wid);
+            pack(scale_list[i].mode);
+            pack(scale_list[i].x);
+            pack(scale_list[i].y);
+            pack(scale_list[i].w);
+            pack(scale_list[i].h);
+            pack(scale_list[i].alpha);
+        }
+        result &= sa_payload_send(SA_OPCODE_WINDOW_SCALE_FORCED_BATCH);
+    }
+
+    return result;
+}
+
 bool scripting_addition_create_pip(uint32_t wid, float x, float y, float w, float h)
 {
     return scripting_addition_scale_window_custom_mode(wid, 0, x, y, w, h);
@@ -641,34 +673,24 @@ bool scripting_addition_animate_window_frame(uint32_t wid,
     return sa_payload_send(SA_OPCODE_WINDOW_ANIMATE_FRAME);
 }
 
-bool scripting_addition_swap_window_proxy_in(struct window_animation *animation_list, int animation_count)
+bool scripting_addition_swap_window_proxy_in(struct window_animation **animation_list, int animation_count)
 {
-    uint32_t dummy_wid = 0;
     sa_payload_init();
     pack(animation_count);
     for (int i = 0; i < animation_count; ++i) {
-        if (__atomic_load_n(&animation_list[i].skip, __ATOMIC_RELAXED)) {
-            pack(dummy_wid);
-        } else {
-            pack(animation_list[i].wid);
-            pack(animation_list[i].proxy.id);
-        }
+        pack(animation_list[i]->wid);
+        pack(animation_list[i]->proxy.id);
     }
     return sa_payload_send(SA_OPCODE_WINDOW_SWAP_PROXY_IN);
 }
 
-bool scripting_addition_swap_window_proxy_out(struct window_animation *animation_list, int animation_count)
+bool scripting_addition_swap_window_proxy_out(struct window_animation **animation_list, int animation_count)
 {
-    uint32_t dummy_wid = 0;
     sa_payload_init();
     pack(animation_count);
     for (int i = 0; i < animation_count; ++i) {
-        if (__atomic_load_n(&animation_list[i].skip, __ATOMIC_RELAXED)) {
-            pack(dummy_wid);
-        } else {
-            pack(animation_list[i].wid);
-            pack(animation_list[i].proxy.id);
-        }
+        pack(animation_list[i]->wid);
+        pack(animation_list[i]->proxy.id);
     }
     return sa_payload_send(SA_OPCODE_WINDOW_SWAP_PROXY_OUT);
 }
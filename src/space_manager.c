@@ -136,19 +136,47 @@ bool space_manager_has_hidden_floating_windows_on_space(struct space_manager *sm
            buf_len(view->hidden_floaters) > 0;
 }
 
-bool space_manager_query_space(FILE *rsp, uint64_t sid, uint64_t flags)
+static bool space_manager_view_matches(struct query_predicate *where, struct view *view)
+{
+    struct query_predicate_capture capture;
+    if (!query_predicate_begin(&capture)) return false;
+
+    view_serialize(&capture.s, view, where->flags);
+    return query_predicate_end(where, &capture);
+}
+
+static void space_manager_serialize_spaces(struct serializer *s, uint64_t *space_list, int space_count, uint64_t flags, struct query_predicate *where)
+{
+    int view_count = 0;
+    struct view **view_list = ts_alloc_list(struct view *, space_count);
+
+    for (int i = 0; i < space_count; ++i) {
+        struct view *view = space_manager_query_view(&g_space_manager, space_list[i]);
+        if (!view) continue;
+
+        if (where && !space_manager_view_matches(where, view)) continue;
+        view_list[view_count++] = view;
+    }
+
+    serializer_begin_array(s, view_count);
+    for (int i = 0; i < view_count; ++i) {
+        view_serialize(s, view_list[i], flags);
+    }
+    serializer_end_array(s);
+}
+
+bool space_manager_query_space(struct serializer *s, uint64_t sid, uint64_t flags)
 {
     TIME_FUNCTION;
 
     struct view *view = space_manager_query_view(&g_space_manager, sid);
     if (!view) return false;
 
-    view_serialize(rsp, view, flags);
-    fprintf(rsp, "\n");
+    view_serialize(s, view, flags);
     return true;
 }
 
-bool space_manager_query_spaces_for_window(FILE *rsp, struct window *window, uint64_t flags)
+bool space_manager_query_spaces_for_window(struct serializer *s, struct window *window, uint64_t flags, struct query_predicate *where)
 {
     TIME_FUNCTION;
 
@@ -156,20 +184,11 @@ bool space_manager_query_spaces_for_window(FILE *rsp, struct window *window, uin
     uint64_t *space_list = window_space_list(window->id, &space_count);
     if (!space_list) return false;
 
-    fprintf(rsp, "[");
-    for (int i = 0; i < space_count; ++i) {
-        struct view *view = space_manager_query_view(&g_space_manager, space_list[i]);
-        if (!view) continue;
-
-        view_serialize(rsp, view, flags);
-        fprintf(rsp, "%c", i < space_count - 1 ? ',' : ']');
-    }
-    fprintf(rsp, "\n");
-
+    space_manager_serialize_spaces(s, space_list, space_count, flags, where);
     return true;
 }
 
-bool space_manager_query_spaces_for_display(FILE *rsp, uint32_t did, uint64_t flags)
+bool space_manager_query_spaces_for_display(struct serializer *s, uint32_t did, uint64_t flags, struct query_predicate *where)
 {
     TIME_FUNCTION;
 
@@ -177,20 +196,11 @@ bool space_manager_query_spaces_for_display(FILE *rsp, uint32_t did, uint64_t fl
     uint64_t *space_list = display_space_list(did, &space_count);
     if (!space_list) return false;
 
-    fprintf(rsp, "[");
-    for (int i = 0; i < space_count; ++i) {
-        struct view *view = space_manager_query_view(&g_space_manager, space_list[i]);
-        if (!view) continue;
-
-        view_serialize(rsp, view, flags);
-        fprintf(rsp, "%c", i < space_count - 1 ? ',' : ']');
-    }
-    fprintf(rsp, "\n");
-
+    space_manager_serialize_spaces(s, space_list, space_count, flags, where);
     return true;
 }
 
-bool space_manager_query_spaces_for_displays(FILE *rsp, uint64_t flags)
+bool space_manager_query_spaces_for_displays(struct serializer *s, uint64_t flags, struct query_predicate *where)
 {
     TIME_FUNCTION;
 
@@ -198,24 +208,25 @@ bool space_manager_query_spaces_for_displays(FILE *rsp, uint64_t flags)
     uint32_t *display_list = display_manager_active_display_list(&display_count);
     if (!display_list) return false;
 
-    fprintf(rsp, "[");
-    for (int i = 0; i < display_count; ++i) {
-        int space_count;
-        uint64_t *space_list = display_space_list(display_list[i], &space_count);
-        if (!space_list) continue;
-
-        for (int j = 0; j < space_count; ++j) {
-            struct view *view = space_manager_query_view(&g_space_manager, space_list[j]);
-            if (!view) continue;
-
-            view_serialize(rsp, view, flags);
-            if (j < space_count - 1) fprintf(rsp, ",");
-        }
+    int space_count = 0;
+    uint64_t *space_list = NULL;
 
-        fprintf(rsp, "%c", i < display_count - 1 ? ',' : ']');
+    for (int i = 0; i < display_count; ++i) {
+        int count;
+        uint64_t *list = display_space_list(display_list[i], &count);
+        if (!list) continue;
+
+        //
+        // NOTE(koekeishiya): display_space_list(..) uses a linear allocator,
+        // and so we only need to track the beginning of the first list along
+        // with the total number of spaces that have been allocated.
+        //
+
+        if (!space_list) space_list = list;
+        space_count += count;
     }
-    fprintf(rsp, "\n");
 
+    space_manager_serialize_spaces(s, space_list, space_count, flags, where);
     return true;
 }
 
@@ -260,7 +271,9 @@ void space_manager_untile_window(struct view *view, struct window *window)
     struct window_node *node = view_remove_window_node(view, window);
     if (!node) return;
 
-    if (space_is_visible(view->sid)) {
+    if (view->layout == VIEW_SCROLL) {
+        view_flush(view);
+    } else if (space_is_visible(view->sid)) {
         window_node_flush(node);
     } else {
         view_set_flag(view, VIEW_IS_DIRTY);
@@ -442,6 +455,17 @@ void space_manager_set_window_gap_for_all_spaces(struct space_manager *sm, int w
     })
 }
 
+void space_manager_set_scroll_column_width(struct space_manager *sm, float scroll_column_width)
+{
+    sm->scroll_column_width = scroll_column_width;
+    table_for (struct view *view, sm->view, {
+        if (view->layout == VIEW_SCROLL) {
+            view_update(view);
+            view_flush(view);
+        }
+    })
+}
+
 void space_manager_set_top_padding_for_all_spaces(struct space_manager *sm, int top_padding)
 {
     sm->top_padding = top_padding;
@@ -579,7 +603,7 @@ bool space_manager_equalize_space(struct space_manager *sm, uint64_t sid, uint32
     struct view *view = space_manager_find_view(sm, sid);
     if (view->layout != VIEW_BSP) return false;
 
-    window_node_equalize(view->root, axis_flag);
+    window_node_equalize(view->root, axis_flag, g_space_manager.split_ratio);
     view_update(view);
     view_flush(view);
 
@@ -598,6 +622,265 @@ bool space_manager_balance_space(struct space_manager *sm, uint64_t sid, uint32_
     return true;
 }
 
+//
+// NOTE: The layout file starts with a header of three 32-bit words: magic,
+// version and the number of entries. Each entry is the length of the uuid of
+// a space, the uuid without a terminator, the layout and the insertion point
+// of the view and an encoded snapshot of its tree. Window ids only stay valid for as long as
+// the window server session lasts, which is why the file is kept in /tmp.
+//
+
+#define LAYOUT_FILE_MAGIC   0x544c4259
+#define LAYOUT_FILE_VERSION 1
+
+static void space_manager_encode_layout(struct layout_buffer *buffer, char *uuid, uint32_t layout, uint32_t insertion_point, struct layout_snapshot *snapshot)
+{
+    uint32_t uuid_length = strlen(uuid);
+    layout_buffer_push(buffer, &uuid_length, sizeof(uint32_t));
+    layout_buffer_push(buffer, uuid, uuid_length);
+    layout_buffer_push(buffer, &layout, sizeof(uint32_t));
+    layout_buffer_push(buffer, &insertion_point, sizeof(uint32_t));
+    layout_snapshot_encode(buffer, snapshot);
+}
+
+//
+// NOTE: The layout file lives at a predictable path in /tmp, so another user
+// could plant a file there before the daemon starts. It is only loaded when it
+// is a regular file owned by the current user that nobody else can write to,
+// which holds for every file written by space_manager_save_layouts.
+//
+
+void space_manager_load_layouts(struct space_manager *sm, char *path)
+{
+    int fd = open(path, O_RDONLY | O_NOFOLLOW);
+    if (fd == -1) return;
+
+    struct stat info;
+    if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode) || info.st_uid != getuid() || (info.st_mode & (S_IWGRP | S_IWOTH))) {
+        debug("%s: ignoring '%s', not owned by this user or writable by others\n", __FUNCTION__, path);
+        close(fd);
+        return;
+    }
+
+    FILE *handle = fdopen(fd, "rb");
+    if (!handle) {
+        close(fd);
+        return;
+    }
+
+    fseek(handle, 0, SEEK_END);
+    long length = ftell(handle);
+    fseek(handle, 0, SEEK_SET);
+
+    uint8_t *data = length > 0 ? malloc(length) : NULL;
+    bool did_read = data && fread(data, length, 1, handle) == 1;
+    fclose(handle);
+
+    if (!did_read) goto out;
+
+    uint8_t *cursor = data;
+    uint8_t *end = data + length;
+    uint32_t header[3];
+
+    if (length < (long) sizeof(header)) goto out;
+    memcpy(header, cursor, sizeof(header));
+    cursor += sizeof(header);
+
+    if (header[0] != LAYOUT_FILE_MAGIC || header[1] != LAYOUT_FILE_VERSION) {
+        debug("%s: ignoring '%s', unknown format\n", __FUNCTION__, path);
+        goto out;
+    }
+
+    for (uint32_t i = 0; i < header[2]; ++i) {
+        uint32_t uuid_length, layout, insertion_point;
+
+        if (end - cursor < (long) sizeof(uint32_t)) break;
+        memcpy(&uuid_length, cursor, sizeof(uint32_t));
+        cursor += sizeof(uint32_t);
+
+        if (end - cursor < (long) uuid_length + 2 * (long) sizeof(uint32_t)) break;
+        char *uuid = malloc(uuid_length + 1);
+        memcpy(uuid, cursor, uuid_length);
+        uuid[uuid_length] = '\0';
+        cursor += uuid_length;
+
+        memcpy(&layout, cursor, sizeof(uint32_t));
+        cursor += sizeof(uint32_t);
+
+        memcpy(&insertion_point, cursor, sizeof(uint32_t));
+        cursor += sizeof(uint32_t);
+
+        struct layout_snapshot *snapshot = layout_snapshot_decode(&cursor, end);
+        if (!snapshot) {
+            free(uuid);
+            break;
+        }
+
+        buf_push(sm->saved_layouts, ((struct saved_layout) { uuid, layout, insertion_point, snapshot }));
+    }
+
+    debug("%s: restored %d layouts from '%s'\n", __FUNCTION__, buf_len(sm->saved_layouts), path);
+
+out:
+    free(data);
+}
+
+static bool space_manager_space_uuid_exists(char **uuid_list, char *uuid)
+{
+    for (int i = 0; i < buf_len(uuid_list); ++i) {
+        if (string_equals(uuid_list[i], uuid)) return true;
+    }
+
+    return false;
+}
+
+//
+// NOTE: Saved layouts whose space no longer exists can never be restored, and
+// are dropped so that the file does not keep growing. When the spaces can not
+// be listed at all, nothing is dropped.
+//
+
+static void space_manager_prune_saved_layouts(struct space_manager *sm)
+{
+    if (!buf_len(sm->saved_layouts)) return;
+
+    char **uuid_list = NULL;
+    int display_count = 0;
+    uint32_t *display_list = display_manager_active_display_list(&display_count);
+
+    for (int i = 0; i < display_count; ++i) {
+        int space_count = 0;
+        uint64_t *space_list = display_space_list(display_list[i], &space_count);
+
+        for (int j = 0; j < space_count; ++j) {
+            CFStringRef uuid_ref = SLSSpaceCopyName(g_connection, space_list[j]);
+            if (!uuid_ref) continue;
+
+            char *uuid = ts_cfstring_copy(uuid_ref);
+            if (uuid) buf_push(uuid_list, uuid);
+            CFRelease(uuid_ref);
+        }
+    }
+
+    if (buf_len(uuid_list)) {
+        for (int i = buf_len(sm->saved_layouts) - 1; i >= 0; --i) {
+            if (space_manager_space_uuid_exists(uuid_list, sm->saved_layouts[i].uuid)) continue;
+
+            debug("%s: dropping layout of space '%s' that no longer exists\n", __FUNCTION__, sm->saved_layouts[i].uuid);
+            space_manager_remove_saved_layout(sm, &sm->saved_layouts[i]);
+        }
+    }
+
+    buf_free(uuid_list);
+}
+
+//
+// NOTE: Saved layouts that have not been restored yet are written back as they
+// are, so that they survive until their space is tiled again. The file is only
+// rewritten when its contents change, and it is replaced atomically.
+//
+
+bool space_manager_save_layouts(struct space_manager *sm, char *path)
+{
+    space_manager_prune_saved_layouts(sm);
+
+    uint32_t header[3] = { LAYOUT_FILE_MAGIC, LAYOUT_FILE_VERSION, 0 };
+    struct layout_buffer buffer = {0};
+    layout_buffer_push(&buffer, header, sizeof(header));
+
+    table_for (struct view *view, sm->view, {
+        struct layout_snapshot *snapshot = view_snapshot(view);
+        char *uuid = view->uuid ? ts_cfstring_copy(view->uuid) : NULL;
+
+        if (snapshot && uuid) {
+            space_manager_encode_layout(&buffer, uuid, view->layout, view->insertion_point, snapshot);
+            ++header[2];
+        }
+
+        if (snapshot) layout_snapshot_release(snapshot);
+    })
+
+    for (int i = 0; i < buf_len(sm->saved_layouts); ++i) {
+        struct saved_layout *saved_layout = &sm->saved_layouts[i];
+        space_manager_encode_layout(&buffer, saved_layout->uuid, saved_layout->layout, saved_layout->insertion_point, saved_layout->snapshot);
+        ++header[2];
+    }
+
+    memcpy(buffer.data, header, sizeof(header));
+
+    if (buffer.length == sm->saved_layout_buffer.length && memcmp(buffer.data, sm->saved_layout_buffer.data, buffer.length) == 0) {
+        free(buffer.data);
+        return true;
+    }
+
+    //
+    // NOTE: The layout file lives in /tmp, which anyone can write to. The
+    // temporary file is given a unique name and created exclusively, so that
+    // a file or symlink planted by another user can never be written through.
+    //
+
+    char tmp_path[PATH_MAX];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path);
+
+    int fd = mkstemp(tmp_path);
+    FILE *handle = fd != -1 ? fdopen(fd, "wb") : NULL;
+    if (fd != -1 && !handle) close(fd);
+
+    bool result = handle && fwrite(buffer.data, buffer.length, 1, handle) == 1;
+    if (handle) result &= fclose(handle) == 0;
+    result = result && rename(tmp_path, path) == 0;
+
+    if (result) {
+        free(sm->saved_layout_buffer.data);
+        sm->saved_layout_buffer = buffer;
+    } else {
+        debug("%s: could not write '%s'\n", __FUNCTION__, path);
+        if (fd != -1) unlink(tmp_path);
+        free(buffer.data);
+    }
+
+    return result;
+}
+
+struct saved_layout *space_manager_find_saved_layout(struct space_manager *sm, struct view *view)
+{
+    if (!buf_len(sm->saved_layouts) || !view->uuid) return NULL;
+
+    char *uuid = ts_cfstring_copy(view->uuid);
+    if (!uuid) return NULL;
+
+    for (int i = 0; i < buf_len(sm->saved_layouts); ++i) {
+        if (string_equals(sm->saved_layouts[i].uuid, uuid)) {
+            return &sm->saved_layouts[i];
+        }
+    }
+
+    return NULL;
+}
+
+void space_manager_remove_saved_layout(struct space_manager *sm, struct saved_layout *saved_layout)
+{
+    free(saved_layout->uuid);
+    layout_snapshot_release(saved_layout->snapshot);
+    buf_del(sm->saved_layouts, saved_layout - sm->saved_layouts);
+}
+
+bool space_manager_undo_space(struct space_manager *sm, uint64_t sid)
+{
+    struct view *view = space_manager_find_view(sm, sid);
+    if (view->layout == VIEW_FLOAT) return false;
+
+    return view_undo(view);
+}
+
+bool space_manager_redo_space(struct space_manager *sm, uint64_t sid)
+{
+    struct view *view = space_manager_find_view(sm, sid);
+    if (view->layout == VIEW_FLOAT) return false;
+
+    return view_redo(view);
+}
+
 struct view *space_manager_tile_window_on_space_with_insertion_point(struct space_manager *sm, struct window *window, uint64_t sid, uint32_t insertion_point)
 {
     struct view *view = space_manager_find_view(sm, sid);
@@ -607,7 +890,9 @@ struct view *space_manager_tile_window_on_space_with_insertion_point(struct spac
     struct window_node *node = view_add_window_node_with_insertion_point(view, window, insertion_point);
     assert(node);
 
-    if (space_is_visible(view->sid)) {
+    if (view->layout == VIEW_SCROLL) {
+        view_flush(view);
+    } else if (space_is_visible(view->sid)) {
         window_node_flush(node);
     } else {
         view_set_flag(view, VIEW_IS_DIRTY);
@@ -628,16 +913,17 @@ void space_manager_toggle_window_split(struct space_manager *sm, struct window *
 
     struct window_node *node = view_find_window_node(view, window->id);
     if (node && window_node_is_intermediate(node)) {
-        node->parent->split = node->parent->split == SPLIT_Y ? SPLIT_X : SPLIT_Y;
+        window_node_toggle_split(node->parent);
 
         if (view->auto_balance != SPLIT_NONE) {
             window_node_balance(view->root, view->auto_balance);
             view_update(view);
             view_flush(view);
         } else {
-            window_node_update(view, node->parent);
+            window_node_mark_dirty(node->parent, NODE_DIRTY_LAYOUT);
+            window_node_update_dirty(view, node->parent);
             if (space_is_visible(view->sid)) {
-                window_node_flush(node->parent);
+                window_node_flush_dirty(node->parent);
             } else {
                 view_set_flag(view, VIEW_IS_DIRTY);
             }
@@ -1305,12 +1591,14 @@ void space_manager_begin(struct space_manager *sm)
 {
     sm->layout = VIEW_FLOAT;
     sm->split_ratio = 0.5f;
+    sm->scroll_column_width = 0.5f;
     sm->auto_balance = SPLIT_NONE;
     sm->split_type = SPLIT_AUTO;
     sm->window_placement = CHILD_SECOND;
     sm->window_insertion_point = INSERT_FOCUSED;
     sm->window_zoom_persist = true;
     sm->labels = NULL;
+    sm->saved_layouts = NULL;
     table_init(&sm->view, 23, hash_view, compare_view);
 
     int display_count;
@@ -7,6 +7,14 @@ struct space_label
     char *label;
 };
 
+struct saved_layout
+{
+    char *uuid;
+    uint32_t layout;
+    uint32_t insertion_point;
+    struct layout_snapshot *snapshot;
+};
+
 struct space_manager
 {
     struct table view;
@@ -20,12 +28,15 @@ struct space_manager
     int right_padding;
     int window_gap;
     float split_ratio;
+    float scroll_column_width;
     enum window_node_split split_type;
     enum window_node_child window_placement;
     enum window_insertion_point window_insertion_point;
     bool window_zoom_persist;
     uint32_t auto_balance;
     struct space_label *labels;
+    struct saved_layout *saved_layouts;
+    struct layout_buffer saved_layout_buffer;
 };
 
 enum space_op_error
@@ -43,10 +54,10 @@ enum space_op_error
     SPACE_OP_ERROR_SCRIPTING_ADDITION   = 10,
 };
 
-bool space_manager_query_space(FILE *rsp, uint64_t sid, uint64_t flags);
-bool space_manager_query_spaces_for_window(FILE *rsp, struct window *window, uint64_t flags);
-bool space_manager_query_spaces_for_display(FILE *rsp, uint32_t did, uint64_t flags);
-bool space_manager_query_spaces_for_displays(FILE *rsp, uint64_t flags);
+bool space_manager_query_space(struct serializer *s, uint64_t sid, uint64_t flags);
+bool space_manager_query_spaces_for_window(struct serializer *s, struct window *window, uint64_t flags, struct query_predicate *where);
+bool space_manager_query_spaces_for_display(struct serializer *s, uint32_t did, uint64_t flags, struct query_predicate *where);
+bool space_manager_query_spaces_for_displays(struct serializer *s, uint64_t flags, struct query_predicate *where);
 struct view *space_manager_query_view(struct space_manager *sm, uint64_t sid);
 struct view *space_manager_find_view(struct space_manager *sm, uint64_t sid);
 void space_manager_refresh_view(struct space_manager *sm, uint64_t sid);
@@ -57,6 +68,12 @@ struct view *space_manager_tile_window_on_space_with_insertion_point(struct spac
 struct view *space_manager_tile_window_on_space(struct space_manager *sm, struct window *window, uint64_t sid);
 bool space_manager_equalize_space(struct space_manager *sm, uint64_t sid, uint32_t axis_flag);
 bool space_manager_balance_space(struct space_manager *sm, uint64_t sid, uint32_t axis_flag);
+void space_manager_load_layouts(struct space_manager *sm, char *path);
+bool space_manager_save_layouts(struct space_manager *sm, char *path);
+struct saved_layout *space_manager_find_saved_layout(struct space_manager *sm, struct view *view);
+void space_manager_remove_saved_layout(struct space_manager *sm, struct saved_layout *saved_layout);
+bool space_manager_undo_space(struct space_manager *sm, uint64_t sid);
+bool space_manager_redo_space(struct space_manager *sm, uint64_t sid);
 void space_manager_toggle_window_split(struct space_manager *sm, struct window *window);
 
 int space_manager_mission_control_index(uint64_t sid);
@@ -78,6 +95,7 @@ void space_manager_toggle_mission_control(uint64_t sid);
 void space_manager_toggle_show_desktop(uint64_t sid);
 void space_manager_set_layout_for_all_spaces(struct space_manager *sm, enum view_type layout);
 void space_manager_set_window_gap_for_all_spaces(struct space_manager *sm, int window_gap);
+void space_manager_set_scroll_column_width(struct space_manager *sm, float scroll_column_width);
 void space_manager_set_top_padding_for_all_spaces(struct space_manager *sm, int top_padding);
 void space_manager_set_bottom_padding_for_all_spaces(struct space_manager *sm, int bottom_padding);
 void space_manager_set_left_padding_for_all_spaces(struct space_manager *sm, int left_padding);
@@ -2,6 +2,7 @@
     extern struct display_manager g_display_manager;
     extern struct space_manager g_space_manager;
     extern struct window_manager g_window_manager;
+    extern struct query_cache g_query_cache;
 
     #define INSERT_FEEDBACK_WIDTH 2
     #define INSERT_FEEDBACK_RADIUS 9
@@ -18,43 +19,16 @@
     //                  - [ ] add an option for "enforce min-width"  which automatically floats overflowing  windows
     //       [] Prevent/block resizing on mouse drag, not just mouse up
     // ---------------------------------------------------------------------------
-    static inline bool window_node_is_leaf(struct window_node *node)
+    static uint32_t view_window_min_width(void *context, uint32_t window_id)
     {
-        return node->left == NULL && node->right == NULL;
-    }
-    uint32_t subtree_min_width(struct window_node *node)
-    {
-        if (!node) return 0;
-        debug("subtree_min_width for node %p\n", node);
-        if (window_node_is_leaf(node)) {
-            struct window *w =
-                window_manager_find_window(&g_window_manager, node->window_order[0]);
-            return w && w->min_width ? w->min_width : 500.0f;
-        }
-
-        uint32_t l = subtree_min_width(node->left);
-        uint32_t r = subtree_min_width(node->right);
-        return l > r ? l : r;
+        struct window *window = window_manager_find_window(&g_window_manager, window_id);
+        return window ? window->min_width : 0;
     }
 
-    void enforce_min_width_recursive(struct window_node *node)
+    static uint32_t view_window_min_height(void *context, uint32_t window_id)
     {
-        if (!node || window_node_is_leaf(node))
-            return;
-        debug("enforcing min-width for node %p\n", node);
-        if (node->split == SPLIT_Y) {  // vertical fence ⇒ width constraint
-            uint32_t min_left  = subtree_min_width(node->left);
-            uint32_t min_right = subtree_min_width(node->right);
-
-            float pw = (float)node->area.w;
-            float lo = clampf_range((float)min_left  / pw, 0.05f, 0.95f);
-            float hi = clampf_range(1.0f - (float)min_right / pw, 0.05f, 0.95f);
-
-            node->ratio = clampf_range(node->ratio, lo, hi);
-        }
-
-        enforce_min_width_recursive(node->left);
-        enforce_min_width_recursive(node->right);
+        struct window *window = window_manager_find_window(&g_window_manager, window_id);
+        return window ? window->min_height : 0;
     }
 
     void insert_feedback_show(struct window_node *node)
@@ -175,233 +149,102 @@
         return (struct area) { rect.origin.x, rect.origin.y, rect.size.width, rect.size.height };
     }
 
-    static inline CGPoint area_max_point(struct area area)
-    {
-        return (CGPoint) { area.x + area.w - 1, area.y + area.h - 1 };
-    }
-
-    static inline enum window_node_child window_node_get_child(struct window_node *node)
-    {
-        return node->child != CHILD_NONE ? node->child : g_space_manager.window_placement;
-    }
-
-    static inline enum window_node_split window_node_get_split(struct view *view, struct window_node *node)
-    {
-        if (node->split != SPLIT_NONE) return node->split;
-
-        if (view->split_type != SPLIT_NONE) {
-            if (view->split_type != SPLIT_AUTO) {
-                return view->split_type;
-            }
-        } else if (g_space_manager.split_type != SPLIT_AUTO) {
-            return g_space_manager.split_type;
-        }
-
-        return node->area.w >= node->area.h ? SPLIT_Y : SPLIT_X;
-    }
-
-    static inline float window_node_get_ratio(struct window_node *node)
-    {
-        return in_range_ii(node->ratio, 0.1f, 0.9f) ? node->ratio : g_space_manager.split_ratio;
-    }
-
     static inline int window_node_get_gap(struct view *view)
     {
         return view_check_flag(view, VIEW_ENABLE_GAP) ? view->window_gap : 0;
     }
 
-    static void area_make_pair(enum window_node_split split, int gap, float ratio, struct area *parent_area, struct area *left_area, struct area *right_area)
-    {
-        if (split == SPLIT_Y) {
-            *left_area  = *parent_area;
-            *right_area = *parent_area;
-
-            float left_width  = (parent_area->w - gap) * ratio;
-            float right_width = (parent_area->w - gap) * (1 - ratio);
-
-            left_area->w   = (int)left_width;
-            right_area->w  = (int)right_width;
-            right_area->x += (int)(left_width + 0.5f) + gap;
-        } else {
-            *left_area  = *parent_area;
-            *right_area = *parent_area;
+    //
+    // NOTE: The layout core has no access to the space manager or the window
+    // manager, so the settings that apply to this view are resolved up front.
+    //
 
-            float left_width  = (parent_area->h - gap) * ratio;
-            float right_width = (parent_area->h - gap) * (1 - ratio);
-
-            left_area->h   = (int)left_width;
-            right_area->h  = (int)right_width;
-            right_area->y += (int)(left_width + 0.5f) + gap;
-        }
-        
-    }
-
-    static void area_make_pair_for_node(struct view *view, struct window_node *node)
+    static struct layout_config view_layout_config(struct view *view)
     {
-        enum window_node_split split = window_node_get_split(view, node);
-        float ratio = window_node_get_ratio(node);
-        int gap     = window_node_get_gap(view);
-
-        // Clamp ratio based on min_width for SPLIT_Y
-        if (split == SPLIT_Y) {
-            struct area *parent = &node->area;
-            float left_width  = (parent->w - gap) * ratio;
-            float right_width = (parent->w - gap) * (1 - ratio);
-
-            uint32_t min_left = node->left && node->left->window_count == 1 ?
-                window_manager_find_window(&g_window_manager, node->left->window_list[0])->min_width : 0;
-            uint32_t min_right = node->right && node->right->window_count == 1 ?
-                window_manager_find_window(&g_window_manager, node->right->window_list[0])->min_width : 0;
-
-            if (left_width < min_left || right_width < min_right) {
-                float min_ratio_left = (float)min_left / (parent->w - gap);
-                float min_ratio_right = 1.0f - (float)min_right / (parent->w - gap);
-
-                ratio = fmaxf(ratio, min_ratio_left);
-                ratio = fminf(ratio, min_ratio_right);
-
-                left_width  = (parent->w - gap) * ratio;
-                right_width = (parent->w - gap) * (1 - ratio);
-            }
-        }
-
-        area_make_pair(split, gap, ratio, &node->area, &node->left->area, &node->right->area);
-
-        node->split = split;
-        node->ratio = ratio;
+        return (struct layout_config) {
+            .split_type   = view->split_type != SPLIT_NONE ? view->split_type : g_space_manager.split_type,
+            .child        = view->layout == VIEW_SCROLL ? CHILD_SECOND : g_space_manager.window_placement,
+            .split_ratio  = g_space_manager.split_ratio,
+            .column_ratio = g_space_manager.scroll_column_width,
+            .gap          = window_node_get_gap(view),
+            .min_width    = view_window_min_width,
+            .min_height   = view_window_min_height
+        };
     }
 
-    static inline bool window_node_is_occupied(struct window_node *node)
+    static void view_split_window_node(struct view *view, struct window_node *node, struct window *window)
     {
-        return node->window_count != 0;
-    }
+        struct window_node *zoom = !g_space_manager.window_zoom_persist
+                                ? NULL
+                                : !node->zoom
+                                ? NULL
+                                : node->zoom == node->parent
+                                ? node
+                                : view->root;
 
-    static inline bool window_node_is_intermediate(struct window_node *node)
-    {
-        return node->parent != NULL;
-    }
+        //
+        // NOTE: The feedback window of a leaf is keyed by the first window in its
+        // stack, which is handed over to one of the children below.
+        //
 
-    static inline bool window_node_is_left_child(struct window_node *node)
-    {
-        return node->parent && node->parent->left == node;
-    }
+        insert_feedback_destroy(node);
 
-    static inline bool window_node_is_right_child(struct window_node *node)
-    {
-        return node->parent && node->parent->right == node;
+        struct layout_config config = view_layout_config(view);
+        window_node_split(&view->pool, &config, node, window->id, zoom);
+        layout_index_invalidate(&view->index);
     }
 
-    static void window_node_equalize(struct window_node *node, uint32_t axis_flag)
+    static void window_node_show_feedback(struct window_node *node, bool dirty_only)
     {
-        if (node->left)  window_node_equalize(node->left, axis_flag);
-        if (node->right) window_node_equalize(node->right, axis_flag);
+        if (dirty_only && !node->dirty) return;
 
-        if ((axis_flag & SPLIT_Y) && node->split == SPLIT_Y) {
-            node->ratio = g_space_manager.split_ratio;
-        }
-
-        if ((axis_flag & SPLIT_X) && node->split == SPLIT_X) {
-            node->ratio = g_space_manager.split_ratio;
+        if (window_node_is_leaf(node)) {
+            if (node->insert_dir && (!dirty_only || (node->dirty & NODE_DIRTY_FRAME))) insert_feedback_show(node);
+        } else {
+            window_node_show_feedback(node->left, dirty_only);
+            window_node_show_feedback(node->right, dirty_only);
         }
     }
 
-    static inline struct balance_node balance_node_add(struct balance_node a, struct balance_node b)
-    {
-        return (struct balance_node) { a.y_count + b.y_count, a.x_count + b.x_count, };
-    }
+    //
+    // NOTE: Every column of the scrolling layout depends on the columns before
+    // it, so that layout is always computed from the root of the view.
+    //
 
-    static struct balance_node window_node_balance(struct window_node *node, uint32_t axis_flag)
+    void window_node_update(struct view *view, struct window_node *node)
     {
-        if (window_node_is_leaf(node)) {
-            return (struct balance_node) {
-                node->parent ? node->parent->split == SPLIT_Y : 0,
-                node->parent ? node->parent->split == SPLIT_X : 0
-            };
-        }
+        struct layout_config config = view_layout_config(view);
 
-        struct balance_node left_leafs  = window_node_balance(node->left, axis_flag);
-        struct balance_node right_leafs = window_node_balance(node->right, axis_flag);
-        struct balance_node total_leafs = balance_node_add(left_leafs, right_leafs);
-
-        if (axis_flag & SPLIT_Y) {
-            if (node->split == SPLIT_Y) {
-                node->ratio = (float) left_leafs.y_count / total_leafs.y_count;
-                --total_leafs.y_count;
-            }
-        }
-
-        if (axis_flag & SPLIT_X) {
-            if (node->split == SPLIT_X) {
-                node->ratio = (float) left_leafs.x_count / total_leafs.x_count;
-                --total_leafs.x_count;
-            }
+        if (view->layout == VIEW_SCROLL) {
+            node = view->root;
+            view->scroll_offset = layout_update_scroll(&config, node, view->scroll_offset);
+        } else {
+            layout_update(&config, node);
         }
 
-        if (node->parent) {
-            total_leafs.y_count += node->parent->split == SPLIT_Y;
-            total_leafs.x_count += node->parent->split == SPLIT_X;
-        }
+        layout_index_invalidate(&view->index);
 
-        return total_leafs;
+        if (g_window_manager.insert_feedback.count) window_node_show_feedback(node, false);
     }
 
-    static void window_node_split(struct view *view, struct window_node *node, struct window *window)
+    void window_node_update_dirty(struct view *view, struct window_node *node)
     {
-        struct window_node *left = malloc(sizeof(struct window_node));
-        memset(left, 0, sizeof(struct window_node));
-
-        struct window_node *right = malloc(sizeof(struct window_node));
-        memset(right, 0, sizeof(struct window_node));
-
-        struct window_node *zoom = !g_space_manager.window_zoom_persist
-                                ? NULL
-                                : !node->zoom
-                                ? NULL
-                                : node->zoom == node->parent
-                                ? node
-                                : view->root;
-
-        if (window_node_get_child(node) == CHILD_SECOND) {
-            memcpy(left->window_list, node->window_list, sizeof(uint32_t) * node->window_count);
-            memcpy(left->window_order, node->window_order, sizeof(uint32_t) * node->window_count);
-            left->window_count = node->window_count;
-            left->zoom = zoom;
-
-            right->window_list[0] = window->id;
-            right->window_order[0] = window->id;
-            right->window_count = 1;
-        } else {
-            memcpy(right->window_list, node->window_list, sizeof(uint32_t) * node->window_count);
-            memcpy(right->window_order, node->window_order, sizeof(uint32_t) * node->window_count);
-            right->window_count = node->window_count;
-            right->zoom = zoom;
-
-            left->window_list[0] = window->id;
-            left->window_order[0] = window->id;
-            left->window_count = 1;
+        if (view->layout == VIEW_SCROLL) {
+            window_node_update(view, view->root);
+            return;
         }
 
-        left->parent  = node;
-        right->parent = node;
-
-        node->window_count = 0;
-        node->left  = left;
-        node->right = right;
-        node->zoom  = NULL;
+        struct layout_config config = view_layout_config(view);
+        layout_update_dirty(&config, node);
+        if (node->dirty) layout_index_invalidate(&view->index);
 
-        area_make_pair_for_node(view, node);
+        if (g_window_manager.insert_feedback.count) window_node_show_feedback(node, true);
     }
 
-    void window_node_update(struct view *view, struct window_node *node)
-    {
-        if (window_node_is_leaf(node)) {
-            if (node->insert_dir) insert_feedback_show(node);
-        } else {
-            area_make_pair_for_node(view, node);
-            window_node_update(view, node->left);
-            window_node_update(view, node->right);
-        }
-    }
+    //
+    // NOTE: The memory of the nodes is released in bulk by resetting the pools
+    // of the view, this only releases the resources that the nodes refer to.
+    //
 
     static void window_node_destroy(struct window_node *node)
     {
@@ -413,7 +256,7 @@
         }
 
         insert_feedback_destroy(node);
-        free(node);
+        if (node->stack) free(node->stack->heap);
     }
 
     static void window_node_clear_zoom(struct window_node *node)
@@ -426,171 +269,103 @@
         }
     }
 
-    void window_node_capture_windows(struct window_node *node, struct window_capture **window_list)
-    {
-        if (window_node_is_leaf(node)) {
-            for (int i = 0; i < node->window_count; ++i) {
-                struct window *window = window_manager_find_window(&g_window_manager, node->window_list[i]);
-                if (window) {
-                    struct area area = node->zoom ? node->zoom->area : node->area;
-                    ts_buf_push(*window_list, ((struct window_capture) { .window = window, .x = area.x, .y = area.y, .w = area.w, .h = area.h }));
-                }
-            }
-        } else {
-            window_node_capture_windows(node->left, window_list);
-            window_node_capture_windows(node->right, window_list);
-        }
-    }
-
-    void window_node_flush(struct window_node *node)
-    {
-        struct window_capture *window_list = NULL;
-        window_node_capture_windows(node, &window_list);
-        if (window_list) window_manager_animate_window_list(window_list, ts_buf_len(window_list));
-    }
-
-    bool window_node_contains_window(struct window_node *node, uint32_t window_id)
+    static void window_node_capture_leaf(struct window_node *node, struct window_capture **window_list)
     {
         for (int i = 0; i < node->window_count; ++i) {
-            if (node->window_list[i] == window_id) return true;
+            struct window *window = window_manager_find_window(&g_window_manager, node->window_list[i]);
+            if (window) {
+                struct area area = node->zoom ? node->zoom->area : node->area;
+                ts_buf_push(*window_list, ((struct window_capture) { .window = window, .x = area.x, .y = area.y, .w = area.w, .h = area.h }));
+            }
         }
 
-        return false;
+        node->dirty &= ~NODE_DIRTY_FRAME;
     }
 
-    int window_node_index_of_window(struct window_node *node, uint32_t window_id)
+    void window_node_capture_windows(struct window_node *node, struct window_capture **window_list)
     {
-        for (int i = 0; i < node->window_count; ++i) {
-            if (node->window_list[i] == window_id) return i;
+        if (window_node_is_leaf(node)) {
+            window_node_capture_leaf(node, window_list);
+        } else {
+            window_node_capture_windows(node->left, window_list);
+            window_node_capture_windows(node->right, window_list);
         }
 
-        return 0;
+        window_node_update_child_flag(node);
     }
 
-    void window_node_swap_window_list(struct window_node *a_node, struct window_node *b_node)
+    static void window_node_capture_dirty_windows(struct window_node *node, struct window_capture **window_list)
     {
-        uint32_t tmp_window_list[NODE_MAX_WINDOW_COUNT];
-        uint32_t tmp_window_order[NODE_MAX_WINDOW_COUNT];
-        uint32_t tmp_window_count;
-
-        memcpy(tmp_window_list, a_node->window_list, sizeof(uint32_t) * a_node->window_count);
-        memcpy(tmp_window_order, a_node->window_order, sizeof(uint32_t) * a_node->window_count);
-        tmp_window_count = a_node->window_count;
-
-        memcpy(a_node->window_list, b_node->window_list, sizeof(uint32_t) * b_node->window_count);
-        memcpy(a_node->window_order, b_node->window_order, sizeof(uint32_t) * b_node->window_count);
-        a_node->window_count = b_node->window_count;
-
-        memcpy(b_node->window_list, tmp_window_list, sizeof(uint32_t) * tmp_window_count);
-        memcpy(b_node->window_order, tmp_window_order, sizeof(uint32_t) * tmp_window_count);
-        b_node->window_count = tmp_window_count;
+        if (!node->dirty) return;
 
-        a_node->zoom = NULL;
-        b_node->zoom = NULL;
-    }
-
-    struct window_node *window_node_find_first_leaf(struct window_node *root)
-    {
-        struct window_node *node = root;
-        while (!window_node_is_leaf(node)) {
-            node = node->left;
+        if (window_node_is_leaf(node)) {
+            if (node->dirty & NODE_DIRTY_FRAME) window_node_capture_leaf(node, window_list);
+        } else {
+            window_node_capture_dirty_windows(node->left, window_list);
+            window_node_capture_dirty_windows(node->right, window_list);
         }
-        return node;
-    }
 
-    struct window_node *window_node_find_last_leaf(struct window_node *root)
-    {
-        struct window_node *node = root;
-        while (!window_node_is_leaf(node)) {
-            node = node->right;
-        }
-        return node;
+        window_node_update_child_flag(node);
     }
 
-    struct window_node *window_node_find_prev_leaf(struct window_node *node)
+    static inline bool area_intersects(struct area *a, struct area *b)
     {
-        if (!node->parent) return NULL;
-
-        if (window_node_is_left_child(node)) {
-            return window_node_find_prev_leaf(node->parent);
-        }
-
-        if (window_node_is_leaf(node->parent->left)) {
-            return node->parent->left;
-        }
-
-        return window_node_find_last_leaf(node->parent->left->right);
+        return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
     }
 
-    struct window_node *window_node_find_next_leaf(struct window_node *node)
+    //
+    // NOTE: A column of the scrolling layout that was last placed outside of
+    // the viewport, and that is still outside of it, is not moved. It keeps
+    // NODE_DIRTY_FRAME and is moved by the first flush that finds it inside
+    // the viewport, so a flush only moves the windows that can be seen.
+    //
+
+    static void window_node_capture_visible_windows(struct window_node *node, struct area *viewport, struct window_capture **window_list)
     {
-        if (!node->parent) return NULL;
+        if (!node->dirty) return;
 
-        if (window_node_is_right_child(node)) {
-            return window_node_find_next_leaf(node->parent);
-        }
+        if (window_node_is_leaf(node)) {
+            if (node->dirty & NODE_DIRTY_FRAME) {
+                struct area *area = node->zoom ? &node->zoom->area : &node->area;
+                bool is_offscreen = !area_intersects(area, viewport);
 
-        if (window_node_is_leaf(node->parent->right)) {
-            return node->parent->right;
+                if (!is_offscreen || !node->is_offscreen) {
+                    window_node_capture_leaf(node, window_list);
+                    node->is_offscreen = is_offscreen;
+                }
+            }
+        } else {
+            window_node_capture_visible_windows(node->left, viewport, window_list);
+            window_node_capture_visible_windows(node->right, viewport, window_list);
         }
 
-        return window_node_find_first_leaf(node->parent->right->left);
+        window_node_update_child_flag(node);
     }
 
-    void window_node_rotate(struct window_node *node, int degrees)
+    static void view_flush_windows(struct view *view)
     {
-        if ((degrees ==  90 && node->split == SPLIT_Y) ||
-            (degrees == 270 && node->split == SPLIT_X) ||
-            (degrees == 180)) {
-            struct window_node *temp = node->left;
-            node->left  = node->right;
-            node->right = temp;
-            node->ratio = 1 - node->ratio;
-        }
-
-        if (degrees != 180) {
-            if (node->split == SPLIT_X) {
-                node->split = SPLIT_Y;
-            } else if (node->split == SPLIT_Y) {
-                node->split = SPLIT_X;
-            }
+        if (view->layout != VIEW_SCROLL) {
+            window_node_flush_dirty(view->root);
+            return;
         }
 
-        if (!window_node_is_leaf(node)) {
-            window_node_rotate(node->left, degrees);
-            window_node_rotate(node->right, degrees);
-        }
+        struct window_capture *window_list = NULL;
+        window_node_capture_visible_windows(view->root, &view->root->area, &window_list);
+        if (window_list) window_manager_animate_window_list(window_list, ts_buf_len(window_list));
     }
 
-    struct window_node *window_node_mirror(struct window_node *node, enum window_node_split axis)
+    void window_node_flush(struct window_node *node)
     {
-        if (!window_node_is_leaf(node)) {
-            struct window_node *left = window_node_mirror(node->left, axis);
-            struct window_node *right = window_node_mirror(node->right, axis);
-
-            if (node->split == axis) {
-                node->left = right;
-                node->right = left;
-            }
-        }
-
-        return node;
+        struct window_capture *window_list = NULL;
+        window_node_capture_windows(node, &window_list);
+        if (window_list) window_manager_animate_window_list(window_list, ts_buf_len(window_list));
     }
 
-    struct window_node *window_node_fence(struct window_node *node, int dir)
+    void window_node_flush_dirty(struct window_node *node)
     {
-        if (!node) return NULL;
-
-        for (struct window_node *parent = node->parent; parent; parent = parent->parent) {
-            if ((dir == DIR_NORTH && parent->split == SPLIT_X && parent->area.y < node->area.y) ||
-                (dir == DIR_WEST  && parent->split == SPLIT_Y && parent->area.x < node->area.x) ||
-                (dir == DIR_SOUTH && parent->split == SPLIT_X && (parent->area.y + parent->area.h) > (node->area.y + node->area.h)) ||
-                (dir == DIR_EAST  && parent->split == SPLIT_Y && (parent->area.x + parent->area.w) > (node->area.x + node->area.w))) {
-                    return parent;
-            }
-        }
-
-        return NULL;
+        struct window_capture *window_list = NULL;
+        window_node_capture_dirty_windows(node, &window_list);
+        if (window_list) window_manager_animate_window_list(window_list, ts_buf_len(window_list));
     }
 
     struct window_node *view_find_min_depth_leaf_node(struct window_node *node)
@@ -609,75 +384,34 @@
         return NULL;
     }
 
-    static inline bool area_is_in_direction(struct area *r1, CGPoint r1_max, struct area *r2, CGPoint r2_max, int direction)
+    struct view_rank_context
     {
-        if (direction == DIR_NORTH && r1_max.y <= r2->y) return false;
-        if (direction == DIR_EAST  && r2_max.x <= r1->x) return false;
-        if (direction == DIR_SOUTH && r2_max.y <= r1->y) return false;
-        if (direction == DIR_WEST  && r1_max.x <= r2->x) return false;
-
-        if (direction == DIR_NORTH || direction == DIR_SOUTH) {
-            return ((r2_max.x >  r1->x && r2_max.x <= r1_max.x) ||
-                    (r2->x    <  r1->x && r2_max.x >  r1_max.x) ||
-                    (r2->x    >= r1->x && r2->x    <  r1_max.x));
-        }
-
-        if (direction == DIR_EAST || direction == DIR_WEST) {
-            return ((r2_max.y >  r1->y && r2_max.y <= r1_max.y) ||
-                    (r2->y    <  r1->y && r2_max.y >  r1_max.y) ||
-                    (r2->y    >= r1->y && r2->y    <  r1_max.y));
-        }
-
-        return false;
-    }
+        uint64_t sid;
+        uint32_t *window_list;
+        int window_count;
+    };
 
-    static inline int area_distance_in_direction(struct area *r1, CGPoint r1_max, struct area *r2, CGPoint r2_max, int direction)
+    static int view_window_rank(void *context, uint32_t window_id)
     {
-        switch (direction) {
-        case DIR_NORTH: {
-            return r2_max.y > r1->y ? r2_max.y - r1->y : r1->y - r2_max.y;
-        } break;
-        case DIR_EAST: {
-            return r2->x < r1_max.x ? r1_max.x - r2->x : r2->x - r1_max.x;
-        } break;
-        case DIR_SOUTH: {
-            return r2->y < r1_max.y ? r1_max.y - r2->y : r2->y - r1_max.y;
-        } break;
-        case DIR_WEST: {
-            return r2_max.x > r1->x ? r2_max.x - r1->x : r1->x - r2_max.x;
-        } break;
+        struct view_rank_context *rank_context = context;
+
+        if (!rank_context->window_list) {
+            rank_context->window_list = space_window_list(rank_context->sid, &rank_context->window_count, false);
+            if (!rank_context->window_list) return INT_MAX;
         }
 
-        return INT_MAX;
+        return window_manager_find_rank_of_window_in_list(window_id, rank_context->window_list, rank_context->window_count);
     }
 
+    //
+    // NOTE: The window list of the space is only needed to break ties between
+    // leaves at the same distance, so it is not fetched unless that happens.
+    //
+
     struct window_node *view_find_window_node_in_direction(struct view *view, struct window_node *source, int direction)
     {
-        int window_count;
-        uint32_t *window_list = space_window_list(view->sid, &window_count, false);
-        if (!window_list) return NULL;
-
-        int best_distance = INT_MAX;
-        int best_rank = INT_MAX;
-        struct window_node *best_node = NULL;
-        CGPoint source_area_max = area_max_point(source->area);
-
-        for (struct window_node *target = window_node_find_first_leaf(view->root); target; target = window_node_find_next_leaf(target)) {
-            if (source == target) continue;
-
-            CGPoint target_area_max = area_max_point(target->area);
-            if (area_is_in_direction(&source->area, source_area_max, &target->area, target_area_max, direction)) {
-                int distance = area_distance_in_direction(&source->area, source_area_max, &target->area, target_area_max, direction);
-                int rank = window_manager_find_rank_of_window_in_list(target->window_order[0], window_list, window_count);
-                if ((distance < best_distance) || (distance == best_distance && rank < best_rank)) {
-                    best_node = target;
-                    best_distance = distance;
-                    best_rank = rank;
-                }
-            }
-        }
-
-        return best_node;
+        struct view_rank_context context = { .sid = view->sid };
+        return layout_index_find_in_direction(&view->index, view->root, source, direction, view_window_rank, &context);
     }
 
     struct window_node *view_find_window_node(struct view *view, uint32_t window_id)
@@ -713,6 +447,7 @@
             assert(removed_entry);
             assert(removed_order);
             --node->window_count;
+            window_node_invalidate_min_size(node);
 
             if (view->insertion_point == window->id) {
                 view->insertion_point = node->window_order[0];
@@ -724,7 +459,7 @@
         if (node == view->root) {
             view->insertion_point = 0;
             insert_feedback_destroy(node);
-            memset(node, 0, sizeof(struct window_node));
+            window_node_reset(node);
             view_update(view);
             return NULL;
         }
@@ -734,49 +469,43 @@
                                 ? parent->left
                                 : parent->right;
 
-
-        memcpy(parent->window_list, child->window_list, sizeof(uint32_t) * child->window_count);
-        memcpy(parent->window_order, child->window_order, sizeof(uint32_t) * child->window_count);
-        parent->window_count = child->window_count;
-
-        parent->left      = NULL;
-        parent->right     = NULL;
-        parent->zoom      = !g_space_manager.window_zoom_persist
-                        ? NULL
-                        : !child->zoom
-                        ? NULL
-                        : child->zoom == parent
-                        ? parent->parent
-                        : view->root;
-
-        if (child->insert_dir) {
-            parent->feedback_window = child->feedback_window;
-            parent->insert_dir      = child->insert_dir;
-            parent->split           = child->split;
-            parent->child           = child->child;
-            insert_feedback_show(parent);
-        }
-
-        if (window_node_is_intermediate(child) && !window_node_is_leaf(child)) {
-            parent->left          = child->left;
-            parent->left->parent  = parent;
-            parent->left->zoom    = !g_space_manager.window_zoom_persist
+        struct window_node *zoom = !g_space_manager.window_zoom_persist
                                 ? NULL
-                                : !child->left->zoom
+                                : !child->zoom
                                 ? NULL
-                                : child->left->zoom == child
-                                ? parent
+                                : child->zoom == parent
+                                ? parent->parent
                                 : view->root;
 
-            parent->right         = child->right;
-            parent->right->parent = parent;
-            parent->right->zoom   = !g_space_manager.window_zoom_persist
-                                ? NULL
-                                : !child->right->zoom
-                                ? NULL
-                                : child->right->zoom == child
-                                ? parent
-                                : view->root;
+        struct window_node *left_zoom  = NULL;
+        struct window_node *right_zoom = NULL;
+        bool show_feedback = child->insert_dir;
+        bool is_leaf = window_node_is_leaf(child);
+
+        if (!is_leaf && g_space_manager.window_zoom_persist) {
+            left_zoom  = !child->left->zoom
+                       ? NULL
+                       : child->left->zoom == child
+                       ? parent
+                       : view->root;
+
+            right_zoom = !child->right->zoom
+                       ? NULL
+                       : child->right->zoom == child
+                       ? parent
+                       : view->root;
+        }
+
+        insert_feedback_destroy(node);
+        window_node_collapse(&view->pool, node);
+        layout_index_invalidate(&view->index);
+
+        parent->zoom = zoom;
+        if (show_feedback) insert_feedback_show(parent);
+
+        if (!is_leaf) {
+            parent->left->zoom  = left_zoom;
+            parent->right->zoom = right_zoom;
 
             if (!g_space_manager.window_zoom_persist) {
                 window_node_clear_zoom(parent);
@@ -785,9 +514,10 @@
             window_node_update(view, parent);
         }
 
-        insert_feedback_destroy(node);
-        free(child);
-        free(node);
+        if (view->layout == VIEW_SCROLL) {
+            if (is_leaf) window_node_update(view, view->root);
+            return view->root;
+        }
 
         if (view->auto_balance != SPLIT_NONE) {
             window_node_balance(view->root, view->auto_balance);
@@ -801,6 +531,9 @@
     void view_stack_window_node(struct window_node *node, struct window *window)
     {
         debug("🌈 view stack window node %u in node %p\n", window->id, node);
+        window_node_reserve(node, node->window_count + 1);
+        window_node_mark_dirty(node, NODE_DIRTY_FRAME);
+        window_node_invalidate_min_size(node);
         int insert_index = node->window_count;
 
         for (int i = 0; i < node->window_count; ++i) {
@@ -824,8 +557,8 @@
             //node->area.x -= 50;
             //node->area.w += 50;
             
-            uint8_t stack_index = 0;
-            for (uint8_t i = 0; i < node->window_count; ++i) {
+            int stack_index = 0;
+            for (int i = 0; i < node->window_count; ++i) {
                 if (node->window_order[i] == window->id) {
                     stack_index = i;
                     break;
@@ -855,6 +588,8 @@
             view->root->window_list[0] = window->id;
             view->root->window_order[0] = window->id;
             view->root->window_count = 1;
+            window_node_mark_dirty(view->root, NODE_DIRTY_FRAME);
+            window_node_invalidate_min_size(view->root);
             return view->root;
         } else if (view->layout == VIEW_BSP) {
             uint32_t prev_insertion_point = 0;
@@ -894,7 +629,7 @@
                 if (!leaf) leaf = view_find_min_depth_leaf_node(view->root);
             }
 
-            window_node_split(view, leaf, window);
+            view_split_window_node(view, leaf, window);
 
             if (view->auto_balance != SPLIT_NONE) {
                 window_node_balance(view->root, view->auto_balance);
@@ -906,6 +641,16 @@
         } else if (view->layout == VIEW_STACK) {
             view_stack_window_node(view->root, window);
             return view->root;
+        } else if (view->layout == VIEW_SCROLL) {
+            struct window_node *leaf = NULL;
+
+            if (insertion_point) leaf = view_find_window_node(view, insertion_point);
+            if (!leaf) leaf = view_find_window_node(view, g_window_manager.focused_window_id);
+            if (!leaf) leaf = window_node_find_last_leaf(view->root);
+
+            view_split_window_node(view, leaf, window);
+            window_node_update(view, view->root);
+            return view->root;
         }
 
         return NULL;
@@ -952,7 +697,7 @@
     {
         if (!view || !view->root) return false;
         
-        struct window_node *stack[64];
+        struct window_node **stack = ts_alloc_list(struct window_node *, view->pool.node_pool.count);
         int top = 0;
         stack[top++] = view->root;
         
@@ -975,9 +720,29 @@
         return false;
     }
 
+    //
+    // NOTE: view_flush is called whenever the tree has been modified, which may
+    // change the split-type, split-child, stack-index and zoom properties of any
+    // window in the view, so their cached query fragments must be invalidated.
+    //
+
+    static void view_invalidate_serialized(struct view *view)
+    {
+        ++view->generation;
+        if (!view->root) return;
+
+        for (struct window_node *node = window_node_find_first_leaf(view->root); node; node = window_node_find_next_leaf(node)) {
+            for (int i = 0; i < node->window_count; ++i) {
+                struct window *window = window_manager_find_window(&g_window_manager, node->window_order[i]);
+                if (window) ++window->generation;
+            }
+        }
+    }
+
     void view_flush(struct view *view)
     {
         debug("🐇🐇🐇🐇 flushing view %lld\n", view->sid);
+        view_invalidate_serialized(view);
         
         // Prevent BSP layout updates while windows are animating to avoid position conflicts
         if (view_has_animating_windows(view)) {
@@ -986,12 +751,27 @@
             return;
         }
         
+        // Clamp fence ratios so neither side can shrink past its minimum size
+        if (view->layout != VIEW_SCROLL) {
+            struct layout_config config = view_layout_config(view);
+            layout_enforce_min_size(&config, view->root);
+        }
+
+        if (view_check_flag(view, VIEW_IS_STALE)) {
+            view_clear_flag(view, VIEW_IS_STALE);
+            window_node_update(view, view->root);
+        } else {
+            window_node_update_dirty(view, view->root);
+        }
+
+        if (view->layout != VIEW_FLOAT && (window_node_is_occupied(view->root) || !window_node_is_leaf(view->root))) {
+            layout_history_record(&view->history, view->root);
+        }
+
         if (space_is_visible(view->sid)) {
-                // Clamp fence ratios so neither side can shrink past its min_width
-            enforce_min_width_recursive(view->root);
-            window_node_update(view,view->root);        
-            window_node_flush(view->root);
+            view_flush_windows(view);
             view_clear_flag(view, VIEW_IS_DIRTY);
+            event_stream_push_layout(view);
         } else {
             view_set_flag(view, VIEW_IS_DIRTY);
         }
@@ -999,129 +779,233 @@
         window_manager_sweep_stacks(view,  &g_window_manager);
     }
 
-    void view_serialize(FILE *rsp, struct view *view, uint64_t flags)
+    //
+    // NOTE: Scrolls the strip of a scrolling layout by the smallest amount that
+    // brings the column of the window fully into the viewport.
+    //
+
+    void view_scroll_to_window(struct view *view, uint32_t window_id)
     {
-        TIME_FUNCTION;
+        if (view->layout != VIEW_SCROLL) return;
 
-        if (flags == 0x0) flags |= ~flags;
+        struct window_node *node = view_find_window_node(view, window_id);
+        if (!node || node == view->root) return;
+
+        struct area *viewport = &view->root->area;
+        float offset = view->scroll_offset;
+
+        if (node->area.x < viewport->x) {
+            offset -= viewport->x - node->area.x;
+        } else if (node->area.x + node->area.w > viewport->x + viewport->w) {
+            offset += (node->area.x + node->area.w) - (viewport->x + viewport->w);
+        }
+
+        if (offset == view->scroll_offset) return;
+
+        debug("%s: view %lld scrolls from %.1f to %.1f\n", __FUNCTION__, view->sid, view->scroll_offset, offset);
+        view->scroll_offset = offset;
+        view_flush(view);
+    }
+
+    static bool view_window_is_managed(void *context, uint32_t window_id)
+    {
+        struct window *window = window_manager_find_window(&g_window_manager, window_id);
+        return window && window_manager_find_managed_window(&g_window_manager, window) == context;
+    }
+
+    static void view_discard_tree(struct view *view, struct window_node *node)
+    {
+        if (node->left)  view_discard_tree(view, node->left);
+        if (node->right) view_discard_tree(view, node->right);
+
+        insert_feedback_destroy(node);
+        window_node_release(&view->pool, node);
+    }
+
+    //
+    // NOTE: The leaves of the restored tree start out with the area of the leaf
+    // that currently holds the same stack, so the layout pass only marks the
+    // leaves that end up somewhere else and the flush leaves the others alone.
+    //
+
+    bool view_restore_tree(struct view *view, struct layout_snapshot *snapshot, bool (*is_valid)(void *context, uint32_t window_id), void *context)
+    {
+        struct window_node *root = layout_snapshot_restore(&view->pool, snapshot, is_valid, context);
+        if (!root) return false;
+
+        for (struct window_node *node = window_node_find_first_leaf(root); node; node = window_node_find_next_leaf(node)) {
+            struct window_node *leaf = view_find_window_node(view, node->window_order[0]);
+            if (leaf && leaf->window_count == node->window_count && memcmp(leaf->window_list, node->window_list, sizeof(uint32_t) * node->window_count) == 0) {
+                node->area = leaf->area;
+            }
+        }
+
+        if (window_node_is_leaf(root)) window_node_mark_dirty(root, NODE_DIRTY_FRAME);
+        root->area = view->root->area;
+
+        view_discard_tree(view, view->root);
+        view->root = root;
+        layout_index_invalidate(&view->index);
+
+        window_node_update(view, view->root);
+        return true;
+    }
+
+    //
+    // NOTE: Windows that were tiled after the snapshot was taken are inserted
+    // again once the tree has been restored.
+    //
+
+    static void view_restore_snapshot(struct view *view, struct layout_snapshot *snapshot)
+    {
+        int window_count = 0;
+        uint32_t *window_list = view_find_window_list(view, &window_count);
+
+        if (!view_restore_tree(view, snapshot, view_window_is_managed, view)) return;
+
+        for (int i = 0; i < window_count; ++i) {
+            if (view_find_window_node(view, window_list[i])) continue;
+
+            struct window *window = window_manager_find_window(&g_window_manager, window_list[i]);
+            if (window) view_add_window_node(view, window);
+        }
+
+        view_flush(view);
+    }
+
+    //
+    // NOTE: Returns a snapshot of the current tree that the caller owns one
+    // reference to, or NULL if the view does not manage any windows.
+    //
+
+    struct layout_snapshot *view_snapshot(struct view *view)
+    {
+        if (view->layout == VIEW_FLOAT || !view->root) return NULL;
+        if (window_node_is_leaf(view->root) && !window_node_is_occupied(view->root)) return NULL;
+
+        struct layout_snapshot *current = view->history.count ? view->history.entry_list[view->history.cursor] : NULL;
+        return layout_snapshot_take(current, view->root);
+    }
+
+    //
+    // NOTE: The current tree is recorded first, because not every change to the
+    // tree goes through view_flush, so that redo can return to it afterwards.
+    //
 
-        bool did_output = false;
-        fprintf(rsp, "{\n");
+    bool view_undo(struct view *view)
+    {
+        layout_history_record(&view->history, view->root);
+
+        struct layout_snapshot *snapshot = layout_history_undo(&view->history);
+        if (!snapshot) return false;
+
+        view_restore_snapshot(view, snapshot);
+        return true;
+    }
+
+    bool view_redo(struct view *view)
+    {
+        layout_history_record(&view->history, view->root);
+
+        struct layout_snapshot *snapshot = layout_history_redo(&view->history);
+        if (!snapshot) return false;
+
+        view_restore_snapshot(view, snapshot);
+        return true;
+    }
+
+    static void view_serialize_properties(struct serializer *s, struct view *view, uint64_t flags)
+    {
+        TIME_FUNCTION;
+
+        serializer_begin_object(s, serializer_property_count(flags, space_property_val, array_count(space_property_val)));
 
         if (flags & SPACE_PROPERTY_ID) {
-            fprintf(rsp, "\t\"id\":%lld", view->sid);
-            did_output = true;
+            serializer_key(s, "id"); serializer_uint(s, view->sid);
         }
 
         if (flags & SPACE_PROPERTY_UUID) {
-            if (did_output) fprintf(rsp, ",\n");
-
             char *uuid = ts_cfstring_copy(view->uuid);
-            fprintf(rsp, "\t\"uuid\":\"%s\"", uuid ? uuid : "<unknown>");
-            did_output = true;
+            serializer_key(s, "uuid"); serializer_string(s, uuid ? uuid : "<unknown>");
         }
 
         if (flags & SPACE_PROPERTY_INDEX) {
-            if (did_output) fprintf(rsp, ",\n");
-
-            fprintf(rsp, "\t\"index\":%d", space_manager_mission_control_index(view->sid));
-            did_output = true;
+            serializer_key(s, "index"); serializer_int(s, space_manager_mission_control_index(view->sid));
         }
 
         if (flags & SPACE_PROPERTY_LABEL) {
-            if (did_output) fprintf(rsp, ",\n");
-
             struct space_label *space_label = space_manager_get_label_for_space(&g_space_manager, view->sid);
-            fprintf(rsp, "\t\"label\":\"%s\"", space_label ? space_label->label : "");
-            did_output = true;
+            serializer_key(s, "label"); serializer_string(s, space_label ? space_label->label : "");
         }
 
         if (flags & SPACE_PROPERTY_TYPE) {
-            if (did_output) fprintf(rsp, ",\n");
-
-            fprintf(rsp, "\t\"type\":\"%s\"", view_type_str[view->layout]);
-            did_output = true;
+            serializer_key(s, "type"); serializer_string(s, view_type_str[view->layout]);
         }
 
         if (flags & SPACE_PROPERTY_DISPLAY) {
-            if (did_output) fprintf(rsp, ",\n");
-
-            fprintf(rsp, "\t\"display\":%d", display_manager_display_id_arrangement(space_display_id(view->sid)));
-            did_output = true;
+            serializer_key(s, "display"); serializer_int(s, display_manager_display_id_arrangement(space_display_id(view->sid)));
         }
 
         if (flags & SPACE_PROPERTY_WINDOWS) {
-            if (did_output) fprintf(rsp, ",\n");
-
             int window_count = 0;
             uint32_t *window_list = space_window_list(view->sid, &window_count, true);
 
-            fprintf(rsp, "\t\"windows\":[");
+            serializer_key(s, "windows");
+            serializer_begin_array(s, window_count);
             for (int i = 0; i < window_count; ++i) {
-                if (i < window_count - 1) {
-                    fprintf(rsp, "%d, ", window_list[i]);
-                } else {
-                    fprintf(rsp, "%d", window_list[i]);
-                }
+                serializer_int(s, window_list[i]);
             }
-            fprintf(rsp, "]");
-            did_output = true;
+            serializer_end_array(s);
         }
 
         if (flags & SPACE_PROPERTY_FIRST_WINDOW) {
-            if (did_output) fprintf(rsp, ",\n");
-
             struct window_node *first_leaf = window_node_find_first_leaf(view->root);
-            fprintf(rsp, "\t\"first-window\":%d", first_leaf ? first_leaf->window_order[0] : 0);
-            did_output = true;
+            serializer_key(s, "first-window"); serializer_int(s, first_leaf ? first_leaf->window_order[0] : 0);
         }
 
         if (flags & SPACE_PROPERTY_LAST_WINDOW) {
-            if (did_output) fprintf(rsp, ",\n");
-
             struct window_node *last_leaf = window_node_find_last_leaf(view->root);
-            fprintf(rsp, "\t\"last-window\":%d", last_leaf ? last_leaf->window_order[0] : 0);
-            did_output = true;
+            serializer_key(s, "last-window"); serializer_int(s, last_leaf ? last_leaf->window_order[0] : 0);
         }
 
         if (flags & SPACE_PROPERTY_HAS_FOCUS) {
-            if (did_output) fprintf(rsp, ",\n");
-
-            fprintf(rsp, "\t\"has-focus\":%s", json_bool(view->sid == g_space_manager.current_space_id));
-            did_output = true;
+            serializer_key(s, "has-focus"); serializer_bool(s, view->sid == g_space_manager.current_space_id);
         }
 
         if (flags & SPACE_PROPERTY_IS_VISIBLE) {
-            if (did_output) fprintf(rsp, ",\n");
-
-            fprintf(rsp, "\t\"is-visible\":%s", json_bool(space_is_visible(view->sid)));
-            did_output = true;
+            serializer_key(s, "is-visible"); serializer_bool(s, space_is_visible(view->sid));
         }
 
         if (flags & SPACE_PROPERTY_IS_FULLSCREEN) {
-            if (did_output) fprintf(rsp, ",\n");
-
-            fprintf(rsp, "\t\"is-native-fullscreen\":%s", json_bool(space_is_fullscreen(view->sid)));
+            serializer_key(s, "is-native-fullscreen"); serializer_bool(s, space_is_fullscreen(view->sid));
         }
-        /* --- is-float-toggled ------------------------------------------------- */
+
         if (flags & SPACE_PROPERTY_IS_FLOAT_TOGGLED) {
-            if (did_output) fprintf(rsp, ",\n");
-            fprintf(rsp, "\t\"is-float-toggled\":%s",
-                    json_bool(view_check_flag(view, VIEW_FLOAT_TOGGLED)));
-            did_output = true;
+            serializer_key(s, "is-float-toggled"); serializer_bool(s, view_check_flag(view, VIEW_FLOAT_TOGGLED));
         }
 
         if (flags & SPACE_PROPERTY_PADDING) {
-            if (did_output) fprintf(rsp, ",\n");
-            fprintf(rsp, "\t\"padding\":{\n");
-            fprintf(rsp, "\t\t\"top\":%.2f,\n", (float)view->top_padding);
-            fprintf(rsp, "\t\t\"bottom\":%.2f,\n", (float)view->bottom_padding);
-            fprintf(rsp, "\t\t\"left\":%.2f,\n", (float)view->left_padding);
-            fprintf(rsp, "\t\t\"right\":%.2f\n", (float)view->right_padding);
-            fprintf(rsp, "\t}");
-            did_output = true;
+            serializer_key(s, "padding");
+            serializer_begin_object(s, 4);
+            serializer_key(s, "top");    serializer_float(s, view->top_padding, 2);
+            serializer_key(s, "bottom"); serializer_float(s, view->bottom_padding, 2);
+            serializer_key(s, "left");   serializer_float(s, view->left_padding, 2);
+            serializer_key(s, "right");  serializer_float(s, view->right_padding, 2);
+            serializer_end_object(s);
         }
-        fprintf(rsp, "\n}");
+
+        serializer_end_object(s);
+    }
+
+    void view_serialize(struct serializer *s, struct view *view, uint64_t flags)
+    {
+        if (flags == 0x0) flags |= ~flags;
+
+        if (query_cache_emit(&g_query_cache, s, QUERY_CACHE_DOMAIN_SPACE, view->sid, view->generation, flags)) return;
+
+        struct query_cache_capture capture;
+        view_serialize_properties(query_cache_begin(&capture, s, QUERY_CACHE_DOMAIN_SPACE, view->sid, flags), view, flags);
+        query_cache_end(&g_query_cache, &capture, view->generation);
     }
 
     void view_update(struct view *view)
@@ -1132,11 +1016,13 @@
         if (view_has_animating_windows(view)) {
             debug("🎬 Blocking view_update for view %lld - windows are currently animating", view->sid);
             view_set_flag(view, VIEW_IS_DIRTY); // Mark as needing update later
+            view_set_flag(view, VIEW_IS_STALE);
             return;
         }
         
         uint32_t did = space_display_id(view->sid);
         CGRect frame = display_bounds_constrained(did, false);
+        struct area area = view->root->area;
         view->root->area = area_from_cgrect(frame);
 
         if (view_check_flag(view, VIEW_ENABLE_PADDING)) {
@@ -1146,7 +1032,9 @@
             view->root->area.h -= (view->top_padding + view->bottom_padding);
         }
 
+        window_node_track_area(view->root, area);
         window_node_update(view, view->root);
+        view_clear_flag(view, VIEW_IS_STALE);
         view_set_flag(view, VIEW_IS_VALID);
         view_set_flag(view, VIEW_IS_DIRTY);
         debug("sweeping at view_update\n");
@@ -1158,8 +1046,8 @@
         struct view *view = malloc(sizeof(struct view));
         memset(view, 0, sizeof(struct view));
 
-        view->root = malloc(sizeof(struct window_node));
-        memset(view->root, 0, sizeof(struct window_node));
+        layout_pool_init(&view->pool);
+        view->root = window_node_create(&view->pool, true);
 
         view->sid = sid;
         view->uuid = SLSSpaceCopyName(g_connection, sid);
@@ -1187,30 +1075,25 @@
     void view_destroy(struct view *view)
     {
         if (view->root) {
-            if (view->root->left)  window_node_destroy(view->root->left);
-            if (view->root->right) window_node_destroy(view->root->right);
-
-            for (int i = 0; i < view->root->window_count; ++i) {
-                window_manager_remove_managed_window(&g_window_manager, view->root->window_list[i]);
-            }
-
-            insert_feedback_destroy(view->root);
-            memset(view->root, 0, sizeof(struct window_node));
+            window_node_destroy(view->root);
+            view->root = NULL;
         }
+
+        layout_pool_destroy(&view->pool);
+        layout_index_destroy(&view->index);
+        layout_history_clear(&view->history);
     }
 
     void view_clear(struct view *view)
     {
         if (view->root) {
-            if (view->root->left)  window_node_destroy(view->root->left);
-            if (view->root->right) window_node_destroy(view->root->right);
+            window_node_destroy(view->root);
 
-            for (int i = 0; i < view->root->window_count; ++i) {
-                window_manager_remove_managed_window(&g_window_manager, view->root->window_list[i]);
-            }
+            layout_pool_reset(&view->pool);
+            layout_index_invalidate(&view->index);
+            view->root = window_node_create(&view->pool, true);
+            view->scroll_offset = 0.0f;
 
-            insert_feedback_destroy(view->root);
-            memset(view->root, 0, sizeof(struct window_node));
             view_update(view);
         }
     }
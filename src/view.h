@@ -4,15 +4,6 @@
 #define AX_ABS(a, b) (((a) - (b) < 0) ? (((a) - (b)) * -1) : ((a) - (b)))
 #define AX_DIFF(a, b) (AX_ABS(a, b) >= 1.5f)
 
-// Forward declare enum for use in window_animation struct
-enum window_node_split
-{
-    SPLIT_NONE,
-    SPLIT_Y,
-    SPLIT_X,
-    SPLIT_AUTO
-};
-
 #define SPACE_PROPERTY_LIST \
     SPACE_PROPERTY_ENTRY("id",                   SPACE_PROPERTY_ID,                 0x001) \
     SPACE_PROPERTY_ENTRY("uuid",                 SPACE_PROPERTY_UUID,               0x002) \
@@ -49,14 +40,6 @@ static char *space_property_str[] =
 #undef SPACE_PROPERTY_ENTRY
 };
 
-struct area
-{
-    float x;
-    float y;
-    float w;
-    float h;
-};
-
 struct window;
 struct window_capture
 {
@@ -82,39 +65,36 @@ struct window_animation
     float x, y, w, h;
     int cid;
     struct window_proxy proxy;
-    volatile bool skip;
-    // Two-phase animation support
-    float original_w, original_h;  // Original size for slide phase
-    bool is_two_phase;             // Whether this animation uses two-phase approach
-    int resize_anchor;             // 0=top-left, 1=top-right, 2=bottom-left, 3=bottom-right
-    // Positioning metadata for better anchor detection
-    bool is_stacked_top;           // True if this window is the top in a vertical stack
-    bool is_stacked_bottom;        // True if this window is the bottom in a vertical stack
-    bool is_side_by_side;          // True if windows are arranged horizontally
-    enum window_node_split parent_split; // The split type of the parent node
-    // Constraint-based edge relationships
-    struct {
-        bool preserve_top_edge;    // Keep top edge fixed during resize
-        bool preserve_bottom_edge; // Keep bottom edge fixed during resize
-        bool preserve_left_edge;   // Keep left edge fixed during resize
-        bool preserve_right_edge;  // Keep right edge fixed during resize
-    } edge_constraints;
-};
-
-struct window_animation_context
-{
-    int animation_connection;
-    int animation_easing;
-    float animation_duration;
-    uint64_t animation_clock;
-    struct window_animation *animation_list;
-    int animation_count;
-};
-
-struct balance_node
-{
-    int y_count;
-    int x_count;
+    uint32_t generation;
+    float alpha;
+    CGRect start;
+    uint64_t clock;
+    float duration;
+    int easing;
+    struct animation_plan plan;
+    uint32_t profile;
+    uint64_t missed_frame_count;
+};
+
+//
+// NOTE: Every proxy animation is driven by one engine that is created on first
+// use and kept for the lifetime of the daemon. It owns the connection that the
+// proxies belong to and the display link that advances them, and the link is
+// only running while there are animations in flight. Each animation keeps its
+// own clock, so animations that start at different times share the same link.
+// Proxies are captured on a pool with one thread per core, counting the thread
+// that submits them.
+//
+
+struct window_animation_engine
+{
+    int connection;
+    CVDisplayLinkRef link;
+    bool is_running;
+    struct window_animation **animation_list;
+    struct animation_batch batch;
+    bool is_batch_dirty;
+    struct worker_pool capture_pool;
 };
 
 enum window_insertion_point
@@ -131,13 +111,6 @@ static const char *window_insertion_point_str[] =
     "last"
 };
 
-enum window_node_child
-{
-    CHILD_NONE,
-    CHILD_SECOND,
-    CHILD_FIRST,
-};
-
 static const char *window_node_child_str[] =
 {
     "none",
@@ -160,36 +133,13 @@ static const char *auto_balance_str[] = {
     "on"
 };
 
-struct feedback_window
-{
-    uint32_t id;
-    CGContextRef context;
-};
-
-#define NODE_MAX_WINDOW_COUNT 32
-struct window_node
-{
-    struct area area;
-    struct window_node *parent;
-    struct window_node *left;
-    struct window_node *right;
-    struct window_node *zoom;
-    uint32_t window_list[NODE_MAX_WINDOW_COUNT];
-    uint32_t window_order[NODE_MAX_WINDOW_COUNT];
-    int window_count;
-    float ratio;
-    enum window_node_split split;
-    enum window_node_child child;
-    int insert_dir;
-    struct feedback_window feedback_window;
-};
-
 enum view_type
 {
     VIEW_DEFAULT,
     VIEW_BSP,
     VIEW_STACK,
-    VIEW_FLOAT
+    VIEW_FLOAT,
+    VIEW_SCROLL
 };
 
 static const char *view_type_str[] =
@@ -197,7 +147,8 @@ static const char *view_type_str[] =
     "default",
     "bsp",
     "stack",
-    "float"
+    "float",
+    "scroll"
 };
 
 enum view_flag
@@ -214,7 +165,8 @@ enum view_flag
     VIEW_IS_VALID       = 0x200,
     VIEW_IS_DIRTY       = 0x400,
     VIEW_SPLIT_TYPE     = 0x800,
-    VIEW_FLOAT_TOGGLED  = 0x1000
+    VIEW_FLOAT_TOGGLED  = 0x1000,
+    VIEW_IS_STALE       = 0x2000
 };
 
 struct view
@@ -233,6 +185,11 @@ struct view
     uint32_t *hidden_floaters;
     uint32_t auto_balance;
     uint64_t flags;
+    uint32_t generation;
+    float scroll_offset;
+    struct layout_pool pool;
+    struct layout_index index;
+    struct layout_history history;
 };
 
 #define view_check_flag(v, x) ((v)->flags  &  (x))
@@ -241,17 +198,10 @@ struct view
 
 void insert_feedback_show(struct window_node *node);
 void insert_feedback_destroy(struct window_node *node);
-void enforce_min_width_recursive(struct window_node *node);
-uint32_t subtree_min_width(struct window_node *node);
 void window_node_flush(struct window_node *node);
+void window_node_flush_dirty(struct window_node *node);
 void window_node_update(struct view *view, struct window_node *node);
-bool window_node_contains_window(struct window_node *node, uint32_t window_id);
-int window_node_index_of_window(struct window_node *node, uint32_t window_id);
-void window_node_swap_window_list(struct window_node *a_node, struct window_node *b_node);
-struct window_node *window_node_find_first_leaf(struct window_node *root);
-struct window_node *window_node_find_last_leaf(struct window_node *root);
-struct window_node *window_node_find_prev_leaf(struct window_node *node);
-struct window_node *window_node_find_next_leaf(struct window_node *node);
+void window_node_update_dirty(struct view *view, struct window_node *node);
 void window_node_capture_windows(struct window_node *node, struct window_capture **window_list);
 
 struct window_node *view_find_window_node_in_direction(struct view *view, struct window_node *source, int direction);
@@ -262,10 +212,15 @@ struct window_node *view_add_window_node(struct view *view, struct window *windo
 struct window_node *view_remove_window_node(struct view *view, struct window *window);
 uint32_t *view_find_window_list(struct view *view, int *window_count);
 
-void view_serialize(FILE *rsp, struct view *view, uint64_t flags);
+void view_serialize(struct serializer *s, struct view *view, uint64_t flags);
 bool view_is_invalid(struct view *view);
 bool view_is_dirty(struct view *view);
 void view_flush(struct view *view);
+void view_scroll_to_window(struct view *view, uint32_t window_id);
+bool view_restore_tree(struct view *view, struct layout_snapshot *snapshot, bool (*is_valid)(void *context, uint32_t window_id), void *context);
+struct layout_snapshot *view_snapshot(struct view *view);
+bool view_undo(struct view *view);
+bool view_redo(struct view *view);
 void view_update(struct view *view);
 struct view *view_create(uint64_t sid);
 void view_destroy(struct view *view);
@@ -1,4 +1,5 @@
 extern struct window_manager g_window_manager;
+extern struct query_cache g_query_cache;
 extern int g_layer_normal_window_level;
 extern int g_layer_below_window_level;
 extern int g_layer_above_window_level;
@@ -118,339 +119,309 @@ static inline const char *window_layer(int level)
     return "unknown";
 }
 
-void window_nonax_serialize(FILE *rsp, uint32_t wid, uint64_t flags)
+uint32_t window_query_plan(uint64_t flags, bool has_ax_reference)
 {
-    TIME_FUNCTION;
-
     if (flags == 0x0) flags |= ~flags;
 
-    int connection;
-    pid_t pid;
-    uint64_t sid;
-    int level;
-    int sub_level;
+    uint32_t fetch = 0;
 
-    if ((flags & WINDOW_PROPERTY_PID) ||
-        (flags & WINDOW_PROPERTY_APP)) {
-        SLSGetWindowOwner(g_connection, wid, &connection);
-        SLSConnectionGetPID(connection, &pid);
+    if (!has_ax_reference && ((flags & WINDOW_PROPERTY_PID) ||
+                              (flags & WINDOW_PROPERTY_APP))) {
+        fetch |= WINDOW_FETCH_OWNER;
     }
 
     if ((flags & WINDOW_PROPERTY_DISPLAY) ||
         (flags & WINDOW_PROPERTY_SPACE) ||
-        (flags & WINDOW_PROPERTY_IS_FULLSCREEN)) {
-        sid = window_space(wid);
+        (flags & WINDOW_PROPERTY_IS_VISIBLE) ||
+        (flags & WINDOW_PROPERTY_IS_STICKY) ||
+        (!has_ax_reference && (flags & WINDOW_PROPERTY_IS_FULLSCREEN))) {
+        fetch |= WINDOW_FETCH_SPACE;
     }
 
     if ((flags & WINDOW_PROPERTY_LEVEL) ||
-        (flags & WINDOW_PROPERTY_LAYER)) {
-        level = window_level(wid);
+        (flags & WINDOW_PROPERTY_LAYER) ||
+        (flags & WINDOW_PROPERTY_HAS_SHADOW) ||
+        (flags & WINDOW_PROPERTY_TAGS) ||
+        (!has_ax_reference && (flags & WINDOW_PROPERTY_ROOT_WINDOW))) {
+        fetch |= WINDOW_FETCH_ITERATOR;
     }
 
     if ((flags & WINDOW_PROPERTY_SUB_LEVEL) ||
         (flags & WINDOW_PROPERTY_SUB_LAYER)) {
-        sub_level = window_sub_level(wid);
+        fetch |= WINDOW_FETCH_SUB_LEVEL;
+    }
+
+    return fetch;
+}
+
+void window_prefetch_iterator(struct window_prefetch *prefetch_list, uint32_t *window_list, int window_count)
+{
+    TIME_FUNCTION;
+
+    if (!window_count) return;
+
+    bool iterator_has_level = workspace_is_macos_ventura() || workspace_is_macos_sonoma() || workspace_is_macos_sequoia();
+    CFArrayRef window_list_ref = cfarray_of_cfnumbers(window_list, sizeof(uint32_t), window_count, kCFNumberSInt32Type);
+
+    CFTypeRef query = SLSWindowQueryWindows(g_connection, window_list_ref, window_count);
+    if (!query) goto err2;
+
+    CFTypeRef iterator = SLSWindowQueryResultCopyWindows(query);
+    if (!iterator) goto err1;
+
+    for (int cursor = 0; SLSWindowIteratorAdvance(iterator); ++cursor) {
+        uint32_t wid = SLSWindowIteratorGetWindowID(iterator);
+
+        //
+        // NOTE: The iterator is expected to report windows in the order they were
+        // requested; only search the list if that assumption does not hold.
+        //
+
+        int index = cursor < window_count && window_list[cursor] == wid ? cursor : -1;
+        for (int i = 0; index == -1 && i < window_count; ++i) {
+            if (window_list[i] == wid) index = i;
+        }
+
+        if (index == -1) continue;
+
+        struct window_prefetch *prefetch = &prefetch_list[index];
+        prefetch->parent_wid = SLSWindowIteratorGetParentID(iterator);
+        prefetch->tags       = SLSWindowIteratorGetTags(iterator);
+        prefetch->level      = iterator_has_level ? SLSWindowIteratorGetLevel(iterator) : window_level(wid);
+        prefetch->fetched   |= WINDOW_FETCH_ITERATOR;
+    }
+
+    CFRelease(iterator);
+err1:
+    CFRelease(query);
+err2:
+    CFRelease(window_list_ref);
+}
+
+void window_prefetch_resolve(struct window_prefetch *prefetch, uint32_t wid, uint32_t fetch)
+{
+    fetch &= ~prefetch->fetched;
+
+    if (fetch & WINDOW_FETCH_OWNER) {
+        int connection = 0;
+        SLSGetWindowOwner(g_connection, wid, &connection);
+        SLSConnectionGetPID(connection, &prefetch->pid);
+    }
+
+    if (fetch & WINDOW_FETCH_SPACE) {
+        int count = 0;
+        uint64_t *space_list = window_space_list(wid, &count);
+
+        prefetch->sid = space_list && space_list[0] ? space_list[0] : window_display_space(wid);
+        prefetch->space_count = count;
+    }
+
+    if (fetch & WINDOW_FETCH_ITERATOR) {
+        window_prefetch_iterator(prefetch, &wid, 1);
+    }
+
+    if (fetch & WINDOW_FETCH_SUB_LEVEL) {
+        prefetch->sub_level = window_sub_level(wid);
     }
 
-    bool did_output = false;
-    fprintf(rsp, "{\n");
+    prefetch->fetched |= fetch;
+}
+
+void window_nonax_serialize(struct serializer *s, uint32_t wid, uint64_t flags, struct window_prefetch *prefetch)
+{
+    TIME_FUNCTION;
+
+    if (flags == 0x0) flags |= ~flags;
+
+    struct window_prefetch local_prefetch = {0};
+    if (!prefetch) prefetch = &local_prefetch;
+    window_prefetch_resolve(prefetch, wid, window_query_plan(flags, false));
+
+    pid_t pid = prefetch->pid;
+    uint64_t sid = prefetch->sid;
+    int level = prefetch->level;
+    int sub_level = prefetch->sub_level;
+
+    serializer_begin_object(s, serializer_property_count(flags, window_property_val, array_count(window_property_val)));
 
     if (flags & WINDOW_PROPERTY_ID) {
-        fprintf(rsp, "\t\"id\":%d", wid);
-        did_output = true;
+        serializer_key(s, "id"); serializer_int(s, wid);
     }
 
     if (flags & WINDOW_PROPERTY_PID) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"pid\":%d", pid);
-        did_output = true;
+        serializer_key(s, "pid"); serializer_int(s, pid);
     }
 
     if (flags & WINDOW_PROPERTY_APP) {
-        if (did_output) fprintf(rsp, ",\n");
-
         static char process_name[PROC_PIDPATHINFO_MAXSIZE];
         proc_name(pid, process_name, sizeof(process_name));
 
-        char *app = process_name;
-        char *escaped_app = ts_string_escape(app);
-
-        fprintf(rsp, "\t\"app\":\"%s\"", escaped_app ? escaped_app : app);
-        did_output = true;
+        serializer_key(s, "app"); serializer_string(s, process_name);
     }
 
     if (flags & WINDOW_PROPERTY_TITLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
         char *title = window_property_title_ts(wid);
-        char *escaped_title = ts_string_escape(title);
-
-        fprintf(rsp, "\t\"title\":\"%s\"", escaped_title ? escaped_title : title);
-        did_output = true;
+        serializer_key(s, "title"); serializer_string(s, title);
     }
 
     if (flags & WINDOW_PROPERTY_SCRATCHPAD) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"scratchpad\":\"%s\"", "");
-        did_output = true;
+        serializer_key(s, "scratchpad"); serializer_string(s, "");
     }
 
     if (flags & WINDOW_PROPERTY_FRAME) {
-        if (did_output) fprintf(rsp, ",\n");
-
         CGRect frame;
         SLSGetWindowBounds(g_connection, wid, &frame);
 
-        fprintf(rsp, "\t\"frame\":{\n\t\t\"x\":%.4f,\n\t\t\"y\":%.4f,\n\t\t\"w\":%.4f,\n\t\t\"h\":%.4f\n\t}", frame.origin.x, frame.origin.y, frame.size.width, frame.size.height);
-        did_output = true;
+        serializer_key(s, "frame"); serializer_frame(s, frame);
     }
 
     if (flags & WINDOW_PROPERTY_ROLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"role\":\"%s\"", "");
-        did_output = true;
+        serializer_key(s, "role"); serializer_string(s, "");
     }
 
     if (flags & WINDOW_PROPERTY_SUBROLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"subrole\":\"%s\"", "");
-        did_output = true;
+        serializer_key(s, "subrole"); serializer_string(s, "");
     }
 
     if (flags & WINDOW_PROPERTY_ROOT_WINDOW) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        uint32_t parent_wid = window_parent(wid);
-        fprintf(rsp, "\t\"root-window\":%s", json_bool(parent_wid == 0));
-        did_output = true;
+        serializer_key(s, "root-window"); serializer_bool(s, prefetch->parent_wid == 0);
     }
 
     if (flags & WINDOW_PROPERTY_DISPLAY) {
-        if (did_output) fprintf(rsp, ",\n");
-
         int display = display_manager_display_id_arrangement(space_display_id(sid));
-        fprintf(rsp, "\t\"display\":%d", display);
-        did_output = true;
+        serializer_key(s, "display"); serializer_int(s, display);
     }
 
     if (flags & WINDOW_PROPERTY_SPACE) {
-        if (did_output) fprintf(rsp, ",\n");
-
         int space = space_manager_mission_control_index(sid);
-        fprintf(rsp, "\t\"space\":%d", space);
-        did_output = true;
+        serializer_key(s, "space"); serializer_int(s, space);
     }
 
     if (flags & WINDOW_PROPERTY_LEVEL) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"level\":%d", level);
-        did_output = true;
+        serializer_key(s, "level"); serializer_int(s, level);
     }
 
     if (flags & WINDOW_PROPERTY_SUB_LEVEL) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"sub-level\":%d", sub_level);
-        did_output = true;
+        serializer_key(s, "sub-level"); serializer_int(s, sub_level);
     }
 
     if (flags & WINDOW_PROPERTY_LAYER) {
-        if (did_output) fprintf(rsp, ",\n");
-
         const char *layer = window_layer(level);
-        fprintf(rsp, "\t\"layer\":\"%s\"", layer);
-        did_output = true;
+        serializer_key(s, "layer"); serializer_string(s, layer);
     }
 
     if (flags & WINDOW_PROPERTY_SUB_LAYER) {
-        if (did_output) fprintf(rsp, ",\n");
-
         const char *sub_layer = window_layer(sub_level);
-        fprintf(rsp, "\t\"sub-layer\":\"%s\"", sub_layer);
-        did_output = true;
+        serializer_key(s, "sub-layer"); serializer_string(s, sub_layer);
     }
 
     if (flags & WINDOW_PROPERTY_OPACITY) {
-        if (did_output) fprintf(rsp, ",\n");
-
         float opacity = window_opacity(wid);
-        fprintf(rsp, "\t\"opacity\":%.4f", opacity);
-        did_output = true;
+        serializer_key(s, "opacity"); serializer_float(s, opacity, 4);
     }
 
     if (flags & WINDOW_PROPERTY_SPLIT_TYPE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"split-type\":\"%s\"", window_node_split_str[0]);
-        did_output = true;
+        serializer_key(s, "split-type"); serializer_string(s, window_node_split_str[0]);
     }
 
     if (flags & WINDOW_PROPERTY_SPLIT_CHILD) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"split-child\":\"%s\"", window_node_child_str[CHILD_NONE]);
-        did_output = true;
+        serializer_key(s, "split-child"); serializer_string(s, window_node_child_str[CHILD_NONE]);
     }
 
     if (flags & WINDOW_PROPERTY_STACK_INDEX) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"stack-index\":%d", 0);
-        did_output = true;
+        serializer_key(s, "stack-index"); serializer_int(s, 0);
     }
 
     if (flags & WINDOW_PROPERTY_CAN_MOVE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"can-move\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "can-move"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_CAN_RESIZE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"can-resize\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "can-resize"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_HAS_FOCUS) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-focus\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "has-focus"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_HAS_SHADOW) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-shadow\":%s", json_bool(window_shadow(wid)));
-        did_output = true;
+        serializer_key(s, "has-shadow"); serializer_bool(s, !(prefetch->tags & 0x8));
     }
 
     if (flags & WINDOW_PROPERTY_HAS_PARENT_ZOOM) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-parent-zoom\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "has-parent-zoom"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_HAS_FULLSCREEN_ZOOM) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-fullscreen-zoom\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "has-fullscreen-zoom"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_HAS_AX_REFERENCE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-ax-reference\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "has-ax-reference"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_IS_FULLSCREEN) {
-        if (did_output) fprintf(rsp, ",\n");
-
         bool is_fullscreen = space_is_fullscreen(sid);
-        fprintf(rsp, "\t\"is-native-fullscreen\":%s", json_bool(is_fullscreen));
-        did_output = true;
+        serializer_key(s, "is-native-fullscreen"); serializer_bool(s, is_fullscreen);
     }
 
     if (flags & WINDOW_PROPERTY_IS_VISIBLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-visible\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "is-visible"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_IS_MINIMIZED) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-minimized\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "is-minimized"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_IS_HIDDEN) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-hidden\":%s", json_bool(false));
-        did_output = true;
+        serializer_key(s, "is-hidden"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_IS_FLOATING) {
-        if (did_output) fprintf(rsp, ",\n");
+        serializer_key(s, "is-floating"); serializer_bool(s, false);
+    }
 
-        fprintf(rsp, "\t\"is-floating\":%s", json_bool(false));
-        did_output = true;
+    if (flags & WINDOW_PROPERTY_IS_SCRATCHED) {
+        serializer_key(s, "is-scratched"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_IS_STICKY) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        bool is_sticky = window_is_sticky(wid);
-        fprintf(rsp, "\t\"is-sticky\":%s", json_bool(is_sticky));
-        did_output = true;
+        serializer_key(s, "is-sticky"); serializer_bool(s, prefetch->space_count > 1);
     }
 
     if (flags & WINDOW_PROPERTY_IS_GRABBED) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-grabbed\":%s", json_bool(false));
+        serializer_key(s, "is-grabbed"); serializer_bool(s, false);
     }
 
     if (flags & WINDOW_PROPERTY_IS_PIP) {
-        if (did_output)
-        fprintf(rsp, ",\n");
         struct window *window = window_manager_find_window(&g_window_manager, wid);
         bool is_pip = window_is_pip(window);
-        fprintf(rsp, "\t\"is-pip\":%s", json_bool(is_pip));
-        did_output = true;
+        serializer_key(s, "is-pip"); serializer_bool(s, is_pip);
     }
 
     if (flags & WINDOW_PROPERTY_TAGS) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        uint64_t tags = window_tags(wid);
-        fprintf(rsp, "\t\"tags\":%llu", tags);
+        serializer_key(s, "tags"); serializer_uint(s, prefetch->tags);
     }
-    fprintf(rsp, "\n}");
+
+    serializer_end_object(s);
 }
 
-void window_serialize(FILE *rsp, struct window *window, uint64_t flags)
+static void window_serialize_properties(struct serializer *s, struct window *window, uint64_t flags, struct window_prefetch *prefetch)
 {
     TIME_FUNCTION;
 
-    if (flags == 0x0) flags |= ~flags;
+    struct window_prefetch local_prefetch = {0};
+    if (!prefetch) prefetch = &local_prefetch;
+    window_prefetch_resolve(prefetch, window->id, window_query_plan(flags, true));
 
-    uint64_t sid;
-    int level;
-    int sub_level;
+    uint64_t sid = prefetch->sid;
+    int level = prefetch->level;
+    int sub_level = prefetch->sub_level;
     struct view *view;
     struct window_node *node;
     bool is_minimized;
     bool is_sticky;
 
-    if ((flags & WINDOW_PROPERTY_DISPLAY) ||
-        (flags & WINDOW_PROPERTY_SPACE) ||
-        (flags & WINDOW_PROPERTY_IS_VISIBLE)) {
-        sid = window_space(window->id);
-    }
-
-    if ((flags & WINDOW_PROPERTY_LEVEL) ||
-        (flags & WINDOW_PROPERTY_LAYER)) {
-        level = window_level(window->id);
-    }
-
-    if ((flags & WINDOW_PROPERTY_SUB_LEVEL) ||
-        (flags & WINDOW_PROPERTY_SUB_LAYER)) {
-        sub_level = window_sub_level(window->id);
-    }
-
     if ((flags & WINDOW_PROPERTY_SPLIT_TYPE) ||
         (flags & WINDOW_PROPERTY_SPLIT_CHILD) ||
         (flags & WINDOW_PROPERTY_STACK_INDEX) ||
@@ -467,278 +438,184 @@ void window_serialize(FILE *rsp, struct window *window, uint64_t flags)
 
     if ((flags & WINDOW_PROPERTY_IS_VISIBLE) ||
         (flags & WINDOW_PROPERTY_IS_STICKY)) {
-        is_sticky = window_check_flag(window, WINDOW_STICKY) || window_is_sticky(window->id);
+        is_sticky = window_check_flag(window, WINDOW_STICKY) || prefetch->space_count > 1;
     }
 
-    bool did_output = false;
-    fprintf(rsp, "{\n");
+    serializer_begin_object(s, serializer_property_count(flags, window_property_val, array_count(window_property_val)));
 
     if (flags & WINDOW_PROPERTY_ID) {
-        fprintf(rsp, "\t\"id\":%d", window->id);
-        did_output = true;
+        serializer_key(s, "id"); serializer_int(s, window->id);
     }
 
     if (flags & WINDOW_PROPERTY_PID) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"pid\":%d", window->application->pid);
-        did_output = true;
+        serializer_key(s, "pid"); serializer_int(s, window->application->pid);
     }
 
     if (flags & WINDOW_PROPERTY_APP) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        char *app = window->application->name;
-        char *escaped_app = ts_string_escape(app);
-
-        fprintf(rsp, "\t\"app\":\"%s\"", escaped_app ? escaped_app : app);
-        did_output = true;
+        serializer_key(s, "app"); serializer_string(s, window->application->name);
     }
 
     if (flags & WINDOW_PROPERTY_TITLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
         char *title = window_title_ts(window);
-        char *escaped_title = ts_string_escape(title);
-
-        fprintf(rsp, "\t\"title\":\"%s\"", escaped_title ? escaped_title : title);
-        did_output = true;
+        serializer_key(s, "title"); serializer_string(s, title);
     }
 
     if (flags & WINDOW_PROPERTY_SCRATCHPAD) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"scratchpad\":\"%s\"", window->scratchpad ? window->scratchpad : "");
-        did_output = true;
+        serializer_key(s, "scratchpad"); serializer_string(s, window->scratchpad ? window->scratchpad : "");
     }
 
     if (flags & WINDOW_PROPERTY_FRAME) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"frame\":{\n\t\t\"x\":%.4f,\n\t\t\"y\":%.4f,\n\t\t\"w\":%.4f,\n\t\t\"h\":%.4f\n\t}", window->frame.origin.x, window->frame.origin.y, window->frame.size.width, window->frame.size.height);
-        did_output = true;
+        serializer_key(s, "frame"); serializer_frame(s, window->frame);
     }
 
     if (flags & WINDOW_PROPERTY_ROLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
         char *role = window_role_ts(window);
-        fprintf(rsp, "\t\"role\":\"%s\"", role);
-        did_output = true;
+        serializer_key(s, "role"); serializer_string(s, role);
     }
 
     if (flags & WINDOW_PROPERTY_SUBROLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
         char *subrole = window_subrole_ts(window);
-        fprintf(rsp, "\t\"subrole\":\"%s\"", subrole);
-        did_output = true;
+        serializer_key(s, "subrole"); serializer_string(s, subrole);
     }
 
     if (flags & WINDOW_PROPERTY_ROOT_WINDOW) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"root-window\":%s", json_bool(window->is_root));
-        did_output = true;
+        serializer_key(s, "root-window"); serializer_bool(s, window->is_root);
     }
 
     if (flags & WINDOW_PROPERTY_DISPLAY) {
-        if (did_output) fprintf(rsp, ",\n");
-
         int display = display_manager_display_id_arrangement(space_display_id(sid));
-        fprintf(rsp, "\t\"display\":%d", display);
-        did_output = true;
+        serializer_key(s, "display"); serializer_int(s, display);
     }
 
     if (flags & WINDOW_PROPERTY_SPACE) {
-        if (did_output) fprintf(rsp, ",\n");
-
         int space = space_manager_mission_control_index(sid);
-        fprintf(rsp, "\t\"space\":%d", space);
-        did_output = true;
+        serializer_key(s, "space"); serializer_int(s, space);
     }
 
     if (flags & WINDOW_PROPERTY_LEVEL) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"level\":%d", level);
-        did_output = true;
+        serializer_key(s, "level"); serializer_int(s, level);
     }
 
     if (flags & WINDOW_PROPERTY_SUB_LEVEL) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"sub-level\":%d", sub_level);
-        did_output = true;
+        serializer_key(s, "sub-level"); serializer_int(s, sub_level);
     }
 
     if (flags & WINDOW_PROPERTY_LAYER) {
-        if (did_output) fprintf(rsp, ",\n");
-
         const char *layer = window_layer(level);
-        fprintf(rsp, "\t\"layer\":\"%s\"", layer);
-        did_output = true;
+        serializer_key(s, "layer"); serializer_string(s, layer);
     }
 
     if (flags & WINDOW_PROPERTY_SUB_LAYER) {
-        if (did_output) fprintf(rsp, ",\n");
-
         const char *sub_layer = window_layer(sub_level);
-        fprintf(rsp, "\t\"sub-layer\":\"%s\"", sub_layer);
-        did_output = true;
+        serializer_key(s, "sub-layer"); serializer_string(s, sub_layer);
     }
 
     if (flags & WINDOW_PROPERTY_OPACITY) {
-        if (did_output) fprintf(rsp, ",\n");
-
         float opacity = window_opacity(window->id);
-        fprintf(rsp, "\t\"opacity\":%.4f", opacity);
-        did_output = true;
+        serializer_key(s, "opacity"); serializer_float(s, opacity, 4);
     }
 
     if (flags & WINDOW_PROPERTY_SPLIT_TYPE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"split-type\":\"%s\"", window_node_split_str[node && node->parent ? node->parent->split : 0]);
-        did_output = true;
+        serializer_key(s, "split-type"); serializer_string(s, window_node_split_str[node && node->parent ? node->parent->split : 0]);
     }
 
     if (flags & WINDOW_PROPERTY_SPLIT_CHILD) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"split-child\":\"%s\"", window_node_child_str[node ? window_node_is_left_child(node) ? CHILD_FIRST : CHILD_SECOND : CHILD_NONE]);
-        did_output = true;
+        serializer_key(s, "split-child"); serializer_string(s, window_node_child_str[node ? window_node_is_left_child(node) ? CHILD_FIRST : CHILD_SECOND : CHILD_NONE]);
     }
 
     if (flags & WINDOW_PROPERTY_STACK_INDEX) {
-        if (did_output) fprintf(rsp, ",\n");
-
         int stack_index = node && node->window_count > 1 ? window_node_index_of_window(node, window->id)+1 : 0;
-        fprintf(rsp, "\t\"stack-index\":%d", stack_index);
-        did_output = true;
+        serializer_key(s, "stack-index"); serializer_int(s, stack_index);
     }
 
     if (flags & WINDOW_PROPERTY_CAN_MOVE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"can-move\":%s", json_bool(window_can_move(window)));
-        did_output = true;
+        serializer_key(s, "can-move"); serializer_bool(s, window_can_move(window));
     }
 
     if (flags & WINDOW_PROPERTY_CAN_RESIZE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"can-resize\":%s", json_bool(window_can_resize(window)));
-        did_output = true;
+        serializer_key(s, "can-resize"); serializer_bool(s, window_can_resize(window));
     }
 
     if (flags & WINDOW_PROPERTY_HAS_FOCUS) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-focus\":%s", json_bool(window->id == g_window_manager.focused_window_id));
-        did_output = true;
+        serializer_key(s, "has-focus"); serializer_bool(s, window->id == g_window_manager.focused_window_id);
     }
 
     if (flags & WINDOW_PROPERTY_HAS_SHADOW) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-shadow\":%s", json_bool(window_shadow(window->id)));
-        did_output = true;
+        serializer_key(s, "has-shadow"); serializer_bool(s, !(prefetch->tags & 0x8));
     }
 
     if (flags & WINDOW_PROPERTY_HAS_PARENT_ZOOM) {
-        if (did_output) fprintf(rsp, ",\n");
-
         bool zoom_parent = node && node->zoom && node->zoom == node->parent;
-        fprintf(rsp, "\t\"has-parent-zoom\":%s", json_bool(zoom_parent));
-        did_output = true;
+        serializer_key(s, "has-parent-zoom"); serializer_bool(s, zoom_parent);
     }
 
     if (flags & WINDOW_PROPERTY_HAS_FULLSCREEN_ZOOM) {
-        if (did_output) fprintf(rsp, ",\n");
-
         bool zoom_fullscreen = node && node->zoom && node->zoom == view->root;
-        fprintf(rsp, "\t\"has-fullscreen-zoom\":%s", json_bool(zoom_fullscreen));
-        did_output = true;
+        serializer_key(s, "has-fullscreen-zoom"); serializer_bool(s, zoom_fullscreen);
     }
 
     if (flags & WINDOW_PROPERTY_HAS_AX_REFERENCE) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"has-ax-reference\":%s", json_bool(true));
-        did_output = true;
+        serializer_key(s, "has-ax-reference"); serializer_bool(s, true);
     }
 
     if (flags & WINDOW_PROPERTY_IS_FULLSCREEN) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-native-fullscreen\":%s", json_bool(window_check_flag(window, WINDOW_FULLSCREEN)));
-        did_output = true;
+        serializer_key(s, "is-native-fullscreen"); serializer_bool(s, window_check_flag(window, WINDOW_FULLSCREEN));
     }
 
     if (flags & WINDOW_PROPERTY_IS_VISIBLE) {
-        if (did_output) fprintf(rsp, ",\n");
-
         uint8_t ordered_in = 0;
         SLSWindowIsOrderedIn(g_connection, window->id, &ordered_in);
 
         bool visible = ordered_in && !is_minimized && !window->application->is_hidden && (is_sticky || space_is_visible(sid));
-        fprintf(rsp, "\t\"is-visible\":%s", json_bool(visible));
-        did_output = true;
+        serializer_key(s, "is-visible"); serializer_bool(s, visible);
     }
 
     if (flags & WINDOW_PROPERTY_IS_MINIMIZED) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-minimized\":%s", json_bool(is_minimized));
-        did_output = true;
+        serializer_key(s, "is-minimized"); serializer_bool(s, is_minimized);
     }
 
     if (flags & WINDOW_PROPERTY_IS_HIDDEN) {
-        if (did_output) fprintf(rsp, ",\n");
-
         bool is_hidden = window->application->is_hidden || window_check_flag(window, WINDOW_HIDDEN);
-        fprintf(rsp, "\t\"is-hidden\":%s", json_bool(is_hidden));
-        did_output = true;
+        serializer_key(s, "is-hidden"); serializer_bool(s, is_hidden);
     }
 
     if (flags & WINDOW_PROPERTY_IS_FLOATING) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-floating\":%s", json_bool(window_check_flag(window, WINDOW_FLOAT)));
-        did_output = true;
+        serializer_key(s, "is-floating"); serializer_bool(s, window_check_flag(window, WINDOW_FLOAT));
     }
 
     if (flags & WINDOW_PROPERTY_IS_SCRATCHED) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-scratched\":%s", json_bool(window_check_flag(window, WINDOW_SCRATCHED)));
-        did_output = true;
+        serializer_key(s, "is-scratched"); serializer_bool(s, window_check_flag(window, WINDOW_SCRATCHED));
     }
 
     if (flags & WINDOW_PROPERTY_IS_STICKY) {
-        if (did_output) fprintf(rsp, ",\n");
-
-        fprintf(rsp, "\t\"is-sticky\":%s", json_bool(is_sticky));
-        did_output = true;
+        serializer_key(s, "is-sticky"); serializer_bool(s, is_sticky);
     }
 
     if (flags & WINDOW_PROPERTY_IS_GRABBED) {
-        if (did_output) fprintf(rsp, ",\n");
-
         bool grabbed = window == g_mouse_state.window;
-        fprintf(rsp, "\t\"is-grabbed\":%s", json_bool(grabbed));
-        did_output = true;
+        serializer_key(s, "is-grabbed"); serializer_bool(s, grabbed);
     }
 
-    if (flags & WINDOW_PROPERTY_TAGS) {
-        if (did_output) fprintf(rsp, ",\n");
+    if (flags & WINDOW_PROPERTY_IS_PIP) {
+        serializer_key(s, "is-pip"); serializer_bool(s, window_is_pip(window));
+    }
 
-        uint64_t tags = window_tags(window->id);
-        fprintf(rsp, "\t\"tags\":%llu", tags);
+    if (flags & WINDOW_PROPERTY_TAGS) {
+        serializer_key(s, "tags"); serializer_uint(s, prefetch->tags);
     }
 
-    fprintf(rsp, "\n}");
+    serializer_end_object(s);
+}
+
+void window_serialize(struct serializer *s, struct window *window, uint64_t flags, struct window_prefetch *prefetch)
+{
+    if (flags == 0x0) flags |= ~flags;
+
+    if (query_cache_emit(&g_query_cache, s, QUERY_CACHE_DOMAIN_WINDOW, window->id, window->generation, flags)) return;
+
+    struct query_cache_capture capture;
+    window_serialize_properties(query_cache_begin(&capture, s, QUERY_CACHE_DOMAIN_WINDOW, window->id, flags), window, flags, prefetch);
+    query_cache_end(&g_query_cache, &capture, window->generation);
 }
 
 char *window_property_title_ts(uint32_t wid)
@@ -87,6 +87,33 @@ static char *window_property_str[] =
 #undef WINDOW_PROPERTY_ENTRY
 };
 
+//
+// NOTE: The properties of a window that have to be fetched from the window server
+// are grouped by the call that retrieves them. A query maps its property mask to
+// the set of fetches it needs, and fetches that can be answered for many windows
+// at once (the window query iterator) are performed in a single pass up-front.
+//
+
+enum window_fetch
+{
+    WINDOW_FETCH_OWNER     = 0x01,
+    WINDOW_FETCH_SPACE     = 0x02,
+    WINDOW_FETCH_ITERATOR  = 0x04,
+    WINDOW_FETCH_SUB_LEVEL = 0x08
+};
+
+struct window_prefetch
+{
+    uint32_t fetched;
+    pid_t pid;
+    uint64_t sid;
+    int space_count;
+    int level;
+    int sub_level;
+    uint32_t parent_wid;
+    uint64_t tags;
+};
+
 struct window_space_widget_data
 {
     int index;                  // Widget display order/position
@@ -105,6 +132,7 @@ struct window
     CFStringRef subrole;
     CFStringRef title;
     CGRect frame;
+    CGRect applied_frame;
     CGRect windowed_frame;
     
     // PIP frame information
@@ -126,9 +154,14 @@ struct window
     uint8_t rule_flags;
     uint32_t flags;
     uint32_t min_width;
+    uint32_t min_height;
     float opacity;
     int layer;
     char *scratchpad;
+    uint32_t generation;
+    uint32_t content_generation;
+    uint64_t query_sid;
+    uint32_t query_did;
 };
 
 enum window_flag
@@ -166,8 +199,11 @@ CFStringRef window_display_uuid(uint32_t wid);
 uint32_t window_display_id(uint32_t wid);
 uint64_t window_space(uint32_t wid);
 uint64_t *window_space_list(uint32_t wid, int *count);
-void window_unknown_serialize(FILE *rsp, uint32_t wid, uint64_t flags);
-void window_serialize(FILE *rsp, struct window *window, uint64_t flags);
+uint32_t window_query_plan(uint64_t flags, bool has_ax_reference);
+void window_prefetch_iterator(struct window_prefetch *prefetch_list, uint32_t *window_list, int window_count);
+void window_prefetch_resolve(struct window_prefetch *prefetch, uint32_t wid, uint32_t fetch);
+void window_nonax_serialize(struct serializer *s, uint32_t wid, uint64_t flags, struct window_prefetch *prefetch);
+void window_serialize(struct serializer *s, struct window *window, uint64_t flags, struct window_prefetch *prefetch);
 char *window_property_title_ts(uint32_t wid);
 char *window_title_ts(struct window *window);
 CFStringRef window_title(struct window *window);
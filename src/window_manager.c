@@ -7,6 +7,8 @@ extern void *g_workspace_context;
 extern struct process_manager g_process_manager;
 extern struct mouse_state g_mouse_state;
 extern double g_cv_host_clock_frequency;
+extern struct capture_cache g_capture_cache;
+extern struct frame_telemetry g_frame_telemetry;
 
 void push_janky_update(uint32_t code, const void *payload, size_t size) ;
 static TABLE_HASH_FUNC(hash_wm)
@@ -44,32 +46,72 @@ void window_manager_query_window_rules(FILE *rsp)
     fprintf(rsp, "]\n");
 }
 
-void window_manager_query_windows_for_spaces(FILE *rsp, uint64_t *space_list, int space_count, uint64_t flags)
+static bool window_manager_window_matches(struct query_predicate *where, uint32_t wid, struct window *window, struct window_prefetch *prefetch)
+{
+    struct query_predicate_capture capture;
+    if (!query_predicate_begin(&capture)) return false;
+
+    if (window) window_serialize(&capture.s, window, where->flags, prefetch); else window_nonax_serialize(&capture.s, wid, where->flags, prefetch);
+    return query_predicate_end(where, &capture);
+}
+
+void window_manager_query_windows_for_spaces(struct serializer *s, uint64_t *space_list, int space_count, uint64_t flags, struct query_predicate *where)
 {
     TIME_FUNCTION;
 
     int window_count = 0;
     uint32_t *window_list = space_window_list_for_connection(space_list, space_count, 0, &window_count, true);
 
-    fprintf(rsp, "[");
+    //
+    // NOTE: Fetches that can be answered for every window in a single pass are
+    // performed up-front; everything else is resolved per window, and only when
+    // the window is not served from the query cache.
+    //
+
+    struct window_prefetch *prefetch_list = ts_alloc_list(struct window_prefetch, window_count);
+    memset(prefetch_list, 0, sizeof(struct window_prefetch) * window_count);
+
+    uint64_t fetch_flags = where ? flags | where->flags : flags;
+    if ((window_query_plan(fetch_flags, true) | window_query_plan(fetch_flags, false)) & WINDOW_FETCH_ITERATOR) {
+        window_prefetch_iterator(prefetch_list, window_list, window_count);
+    }
+
+    //
+    // NOTE: The predicate is evaluated against only the properties it references,
+    // so windows that are filtered out never pay for the rest of the properties.
+    //
+
+    if (where) {
+        int match_count = 0;
+        for (int i = 0; i < window_count; ++i) {
+            struct window *window = window_manager_find_window(&g_window_manager, window_list[i]);
+            if (!window_manager_window_matches(where, window_list[i], window, &prefetch_list[i])) continue;
+
+            window_list[match_count] = window_list[i];
+            prefetch_list[match_count] = prefetch_list[i];
+            ++match_count;
+        }
+        window_count = match_count;
+    }
+
+    serializer_begin_array(s, window_count);
     for (int i = 0; i < window_count; ++i) {
         struct window *window = window_manager_find_window(&g_window_manager, window_list[i]);
-        if (window) window_serialize(rsp, window, flags); else window_nonax_serialize(rsp, window_list[i], flags);
-        if (i < window_count - 1) fprintf(rsp, ",");
+        if (window) window_serialize(s, window, flags, &prefetch_list[i]); else window_nonax_serialize(s, window_list[i], flags, &prefetch_list[i]);
     }
-    fprintf(rsp, "]\n");
+    serializer_end_array(s);
 }
 
-void window_manager_query_windows_for_display(FILE *rsp, uint32_t did, uint64_t flags)
+void window_manager_query_windows_for_display(struct serializer *s, uint32_t did, uint64_t flags, struct query_predicate *where)
 {
     TIME_FUNCTION;
 
     int space_count = 0;
     uint64_t *space_list = display_space_list(did, &space_count);
-    window_manager_query_windows_for_spaces(rsp, space_list, space_count, flags);
+    window_manager_query_windows_for_spaces(s, space_list, space_count, flags, where);
 }
 
-void window_manager_query_windows_for_displays(FILE *rsp, uint64_t flags)
+void window_manager_query_windows_for_displays(struct serializer *s, uint64_t flags, struct query_predicate *where)
 {
     TIME_FUNCTION;
 
@@ -94,7 +136,7 @@ void window_manager_query_windows_for_displays(FILE *rsp, uint64_t flags)
         space_count += count;
     }
 
-    window_manager_query_windows_for_spaces(rsp, space_list, space_count, flags);
+    window_manager_query_windows_for_spaces(s, space_list, space_count, flags, where);
 }
 
 bool window_manager_rule_matches_window(struct rule *rule, struct window *window, char *window_title, char *window_role, char *window_subrole)
@@ -178,6 +220,14 @@ void window_manager_apply_rule_effects_to_window(struct space_manager *sm, struc
     if (rule_effects_check_flag(effects, RULE_EFFECTS_MIN_WIDTH)) {
         window->min_width = effects->min_width;
     }
+    if (rule_effects_check_flag(effects, RULE_EFFECTS_MIN_HEIGHT)) {
+        window->min_height = effects->min_height;
+    }
+    if (rule_effects_check_flag(effects, RULE_EFFECTS_MIN_WIDTH) || rule_effects_check_flag(effects, RULE_EFFECTS_MIN_HEIGHT)) {
+        struct view *view = space_manager_find_view(sm, window_space(window->id));
+        struct window_node *node = view ? view_find_window_node(view, window->id) : NULL;
+        if (node) window_node_invalidate_min_size(node);
+    }
     if (effects->grid[0] != 0 && effects->grid[1] != 0) {
         window_manager_apply_grid(sm, wm, window, effects->grid[0], effects->grid[1], effects->grid[2], effects->grid[3], effects->grid[4], effects->grid[5]);
     }
@@ -345,10 +395,11 @@ enum window_op_error window_manager_adjust_window_ratio(struct window_manager *w
     } break;
     }
 
-    window_node_update(view, node->parent);
+    window_node_mark_dirty(node->parent, NODE_DIRTY_LAYOUT);
+    window_node_update_dirty(view, node->parent);
 
     if (space_is_visible(view->sid)) {
-        window_node_flush(node->parent);
+        window_node_flush_dirty(node->parent);
     } else {
         view_set_flag(view, VIEW_IS_DIRTY);
     }
@@ -421,7 +472,7 @@ enum window_op_error window_manager_auto_layout_window(struct window_manager *wm
             debug("[AUTO_LAYOUT] target ratio: %.2f\n, target_index:  %d", next_ratio, target_index);
 
             node->ratio = next_ratio;
-            view_update(view);
+            window_node_mark_dirty(node, NODE_DIRTY_LAYOUT);
             view_flush(view);
             return WINDOW_OP_ERROR_SUCCESS;
         } else {
@@ -516,14 +567,21 @@ enum window_op_error window_manager_resize_window_relative(struct window_manager
         if (y_fence) {
             float sr = y_fence->ratio + (float) dx / (float) y_fence->area.w;
             y_fence->ratio = clampf_range(sr, 0.1f, 0.9f);
+            window_node_mark_dirty(y_fence, NODE_DIRTY_LAYOUT);
         }
 
         if (x_fence) {
             float sr = x_fence->ratio + (float) dy / (float) x_fence->area.h;
             x_fence->ratio = clampf_range(sr, 0.1f, 0.9f);
+            window_node_mark_dirty(x_fence, NODE_DIRTY_LAYOUT);
         }
 
-        view_update(view);
+        //
+        // NOTE: The window may have been resized by the user, and has to be
+        // moved back into its node even if the ratio ended up being clamped.
+        //
+
+        window_node_mark_dirty(node, NODE_DIRTY_FRAME);
         view_flush(view);
     } else {
         if (direction == HANDLE_ABS) {
@@ -549,6 +607,7 @@ void window_manager_move_window(struct window *window, float x, float y)
 
     AXUIElementSetAttributeValue(window->ref, kAXPositionAttribute, position_ref);
     CFRelease(position_ref);
+    window->applied_frame.origin = position;
     
     struct view *view = window_manager_find_managed_window(&g_window_manager, window);
     if (view) {
@@ -575,11 +634,12 @@ void window_manager_resize_window(struct window *window, float width, float heig
 
     AXUIElementSetAttributeValue(window->ref, kAXSizeAttribute, size_ref);
     CFRelease(size_ref);
+    window->applied_frame.size = size;
 }
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wmissing-field-initializers"
-static inline void window_manager_notify_jankyborders(struct window_animation *animation_list, int animation_count, uint32_t event, bool skip, bool wait)
+static inline void window_manager_notify_jankyborders(struct window_animation **animation_list, int animation_count, uint32_t event, bool wait)
 {
     mach_port_t port;
     if (g_bs_port && bootstrap_look_up(g_bs_port, "git.felix.jbevent", &port) == KERN_SUCCESS) {
@@ -590,11 +650,9 @@ static inline void window_manager_notify_jankyborders(struct window_animation *a
             uint32_t real_wid[512];
         } data = { event, 0 };
 
-        for (int i = 0; i < animation_count; ++i) {
-            if (skip && __atomic_load_n(&animation_list[i].skip, __ATOMIC_RELAXED)) continue;
-
-            data.proxy_wid[data.count] = animation_list[i].proxy.id;
-            data.real_wid[data.count]  = animation_list[i].wid;
+        for (int i = 0; i < animation_count && i < 512; ++i) {
+            data.proxy_wid[data.count] = animation_list[i]->proxy.id;
+            data.real_wid[data.count]  = animation_list[i]->wid;
 
             ++data.count;
         }
@@ -617,25 +675,25 @@ static void window_manager_create_window_proxy(int animation_connection, float a
     SLSNewWindowWithOpaqueShapeAndContext(animation_connection, 2, frame_region, empty_region, 13|(1 << 18), &tags, 0, 0, 64, &proxy->id, NULL);
     
     // Apply shadow settings based on configuration
-    if (!g_window_manager.window_animation_shadows_enabled || g_window_manager.window_animation_fast_mode) {
+    if (!g_window_manager.animation_quality.is_shadows_enabled) {
         sls_window_disable_shadow(proxy->id);
     }
     
     SLSSetWindowOpacity(animation_connection, proxy->id, 0);
     
     // Use reduced resolution for performance if enabled
-    float resolution = (g_window_manager.window_animation_reduced_resolution || g_window_manager.window_animation_fast_mode) ? 1.0f : 2.0f;
+    float resolution = g_window_manager.animation_quality.is_reduced_resolution ? 1.0f : 2.0f;
     SLSSetWindowResolution(animation_connection, proxy->id, resolution);
     
     // Apply alpha only if opacity animations are enabled
-    float final_alpha = g_window_manager.window_animation_opacity_enabled && !g_window_manager.window_animation_fast_mode ? alpha : 1.0f;
+    float final_alpha = g_window_manager.window_animation_opacity_enabled && !g_window_manager.animation_quality.is_fast_mode ? alpha : 1.0f;
     SLSSetWindowAlpha(animation_connection, proxy->id, final_alpha);
     
     SLSSetWindowLevel(animation_connection, proxy->id, proxy->level);
     SLSSetWindowSubLevel(animation_connection, proxy->id, proxy->sub_level);
     
     // Apply blur effect if enabled and not in fast mode
-    if (g_window_manager.window_animation_blur_enabled && !g_window_manager.window_animation_fast_mode) {
+    if (g_window_manager.animation_quality.is_blur_enabled) {
         int blur_radius = (int)g_window_manager.window_animation_blur_radius;
         int blur_style = g_window_manager.window_animation_blur_style;
         SLSSetWindowBackgroundBlurRadiusStyle(animation_connection, proxy->id, blur_radius, blur_style);
@@ -676,9 +734,12 @@ static void *window_manager_build_window_proxy_thread_proc(void *data)
 
     float alpha = 1.0f;
     SLSGetWindowAlpha(animation->cid, animation->wid, &alpha);
+    animation->alpha = alpha;
     animation->proxy.level = window_level(animation->wid);
     animation->proxy.sub_level = window_sub_level(animation->wid);
     SLSGetWindowBounds(animation->cid, animation->wid, &animation->proxy.frame);
+    uint32_t capture_width  = (uint32_t) animation->proxy.frame.size.width;
+    uint32_t capture_height = (uint32_t) animation->proxy.frame.size.height;
     
     // Apply starting size multiplier if configured (for scaling animation effect)
     if (g_window_manager.window_animation_starting_size != 1.0f) {
@@ -703,927 +764,470 @@ static void *window_manager_build_window_proxy_thread_proc(void *data)
               size_multiplier, target_w, target_h, starting_w, starting_h);
     }
     
+    animation->start    = animation->proxy.frame;
     animation->proxy.tx = animation->proxy.frame.origin.x;
     animation->proxy.ty = animation->proxy.frame.origin.y;
     animation->proxy.tw = animation->proxy.frame.size.width;
     animation->proxy.th = animation->proxy.frame.size.height;
 
-    CFArrayRef image_array = SLSHWCaptureWindowList(animation->cid, &animation->wid, 1, (1 << 11) | (1 << 8));
-    if (image_array) {
-        animation->proxy.image = alpha == 1.0f
-                               ? (CGImageRef) CFRetain(CFArrayGetValueAtIndex(image_array, 0))
-                               : cgimage_restore_alpha((CGImageRef) CFArrayGetValueAtIndex(image_array, 0));
-        CFRelease(image_array);
-    } else {
-        animation->proxy.image = NULL;
+    animation->proxy.image = capture_cache_find(&g_capture_cache, animation->wid, animation->generation, alpha, capture_width, capture_height);
+    if (!animation->proxy.image) {
+        CFArrayRef image_array = SLSHWCaptureWindowList(animation->cid, &animation->wid, 1, (1 << 11) | (1 << 8));
+        if (image_array) {
+            animation->proxy.image = alpha == 1.0f
+                                   ? (CGImageRef) CFRetain(CFArrayGetValueAtIndex(image_array, 0))
+                                   : cgimage_restore_alpha((CGImageRef) CFArrayGetValueAtIndex(image_array, 0));
+            CFRelease(image_array);
+        }
+
+        if (animation->proxy.image) {
+            capture_cache_store(&g_capture_cache, animation->wid, animation->generation, alpha, capture_width, capture_height, animation->proxy.image);
+        }
     }
 
     window_manager_create_window_proxy(animation->cid, alpha, &animation->proxy);
     return NULL;
 }
 
-static inline float calculate_size_difference_ratio(float src_w, float src_h, float dst_w, float dst_h)
-{
-    float src_area = src_w * src_h;
-    float dst_area = dst_w * dst_h;
-    float area_diff = fabsf(dst_area - src_area);
-    float max_area = fmaxf(src_area, dst_area);
-    return max_area > 0.0f ? area_diff / max_area : 0.0f;
-}
-
-static inline float calculate_aspect_difference(float src_w, float src_h, float dst_w, float dst_h)
-{
-    float src_aspect = src_h > 0.0f ? src_w / src_h : 1.0f;
-    float dst_aspect = dst_h > 0.0f ? dst_w / dst_h : 1.0f;
-    return fabsf(dst_aspect - src_aspect) / fmaxf(src_aspect, dst_aspect);
-}
-
-// debug strucs
-typedef struct {
-    bool touches_top;
-    bool touches_bottom;
-    bool touches_left;
-    bool touches_right;
-    float distance_to_top;
-    float distance_to_bottom;
-    float distance_to_left;
-    float distance_to_right;
-    char position_desc[64];
-} screen_edge_info;
-
-// Tree position analysis structure
-typedef struct {
-    bool is_root;
-    bool is_leaf;
-    bool is_left_child;
-    bool is_right_child;
-    int depth;
-    int total_siblings;
-    int sibling_index;
-    enum window_node_split parent_split;
-    enum window_node_split node_split;
-    char tree_path[128];
-    char position_desc[64];
-} tree_position_info;
-
-// Analyze window's relationship to screen edges
-static screen_edge_info analyze_screen_edges(CGRect window_rect, uint32_t display_id, struct view *view) {
-    screen_edge_info info = {0};
-    
-    CGRect screen_bounds = display_bounds_constrained(display_id, false);
-    
-    // Factor in space padding when calculating effective screen bounds
-    CGRect effective_bounds = screen_bounds;
-    if (view) {
-        effective_bounds.origin.x += view->left_padding;
-        effective_bounds.origin.y += view->top_padding;
-        effective_bounds.size.width -= (view->left_padding + view->right_padding);
-        effective_bounds.size.height -= (view->top_padding + view->bottom_padding);
-    }
-    
-    // Use configured edge threshold
-    float edge_threshold = g_window_manager.window_animation_edge_threshold;
-    
-    // Calculate distances to effective edges (accounting for space padding)
-    info.distance_to_top = window_rect.origin.y - effective_bounds.origin.y;
-    info.distance_to_bottom = (effective_bounds.origin.y + effective_bounds.size.height) - (window_rect.origin.y + window_rect.size.height);
-    info.distance_to_left = window_rect.origin.x - effective_bounds.origin.x;
-    info.distance_to_right = (effective_bounds.origin.x + effective_bounds.size.width) - (window_rect.origin.x + window_rect.size.width);
-    
-    // Determine edge touches using threshold
-    info.touches_top = info.distance_to_top <= edge_threshold;
-    info.touches_bottom = info.distance_to_bottom <= edge_threshold;
-    info.touches_left = info.distance_to_left <= edge_threshold;
-    info.touches_right = info.distance_to_right <= edge_threshold;
-    
-    // Create position description
-    if (info.touches_top && info.touches_left) {
-        strcpy(info.position_desc, "screen-top-left");
-    } else if (info.touches_top && info.touches_right) {
-        strcpy(info.position_desc, "screen-top-right");
-    } else if (info.touches_bottom && info.touches_left) {
-        strcpy(info.position_desc, "screen-bottom-left");
-    } else if (info.touches_bottom && info.touches_right) {
-        strcpy(info.position_desc, "screen-bottom-right");
-    } else if (info.touches_top) {
-        strcpy(info.position_desc, "screen-top");
-    } else if (info.touches_bottom) {
-        strcpy(info.position_desc, "screen-bottom");
-    } else if (info.touches_left) {
-        strcpy(info.position_desc, "screen-left");
-    } else if (info.touches_right) {
-        strcpy(info.position_desc, "screen-right");
-    } else {
-        strcpy(info.position_desc, "screen-center");
-    }
-    
-    return info;
+static inline struct animation_rect window_manager_animation_rect(CGRect frame)
+{
+    return (struct animation_rect) { frame.origin.x, frame.origin.y, frame.size.width, frame.size.height };
 }
 
-// Analyze window's position in BSP tree
-static tree_position_info analyze_tree_position(struct window *window) {
-    tree_position_info info = {0};
-    strcpy(info.tree_path, "unknown");
-    strcpy(info.position_desc, "unknown");
-    
-    if (!window) return info;
-    
+static void window_manager_animation_planner(struct animation_planner *planner)
+{
+    memset(planner, 0, sizeof(struct animation_planner));
+
+    if (g_window_manager.window_animation_force_top_anchor)    planner->force_edge |= ANIMATION_EDGE_TOP;
+    if (g_window_manager.window_animation_force_bottom_anchor) planner->force_edge |= ANIMATION_EDGE_BOTTOM;
+    if (g_window_manager.window_animation_force_left_anchor)   planner->force_edge |= ANIMATION_EDGE_LEFT;
+    if (g_window_manager.window_animation_force_right_anchor)  planner->force_edge |= ANIMATION_EDGE_RIGHT;
+
+    planner->edge_threshold          = g_window_manager.window_animation_edge_threshold;
+    planner->override_stacked_top    = g_window_manager.window_animation_override_stacked_top;
+    planner->override_stacked_bottom = g_window_manager.window_animation_override_stacked_bottom;
+    planner->stacked_top_anchor      = g_window_manager.window_animation_stacked_top_anchor;
+    planner->stacked_bottom_anchor   = g_window_manager.window_animation_stacked_bottom_anchor;
+    planner->is_two_phase_enabled    = g_window_manager.animation_quality.is_two_phase_enabled;
+    planner->slide_ratio             = g_window_manager.window_animation_slide_ratio;
+    planner->is_fade_enabled         = g_window_manager.window_animation_fade_enabled;
+    planner->fade_threshold          = g_window_manager.window_animation_fade_threshold;
+    planner->fade_intensity          = g_window_manager.window_animation_fade_intensity;
+}
+
+//
+// NOTE: Looks up the display that a window ends up on and its position in the
+// tree of its space. This is the only part of planning an animation that reads
+// the state of the window manager.
+//
+
+static void window_manager_animation_placement(struct window *window, CGRect frame, int window_count, float alpha, struct animation_placement *placement)
+{
+    memset(placement, 0, sizeof(struct animation_placement));
+    placement->parent_split = SPLIT_NONE;
+    placement->window_count = window_count;
+    placement->alpha        = alpha;
+
+    uint32_t did = display_manager_point_display_id(CGPointMake(frame.origin.x + frame.size.width / 2.0f, frame.origin.y + frame.size.height / 2.0f));
+    placement->bounds = window_manager_animation_rect(display_bounds_constrained(did ? did : window_display_id(window->id), false));
+    placement->screen = placement->bounds;
+
     struct view *view = window_manager_find_managed_window(&g_window_manager, window);
-    if (!view) {
-        strcpy(info.position_desc, "floating");
-        return info;
-    }
-    
+    if (!view || !view->root) return;
+
+    placement->screen.x += view->left_padding;
+    placement->screen.y += view->top_padding;
+    placement->screen.w -= view->left_padding + view->right_padding;
+    placement->screen.h -= view->top_padding + view->bottom_padding;
+
     struct window_node *node = view_find_window_node(view, window->id);
-    if (!node) {
-        strcpy(info.position_desc, "not-in-tree");
-        return info;
-    }
-    
-    // Analyze node properties
-    info.is_leaf = (!node->left && !node->right);
-    info.is_root = (!node->parent);
-    info.node_split = node->split;
-    
-    // Count siblings and find index
-    if (node->parent) {
-        info.is_left_child = (node->parent->left == node);
-        info.is_right_child = (node->parent->right == node);
-        info.parent_split = node->parent->split;
-        info.total_siblings = 2; // BSP tree always has 2 children
-        info.sibling_index = info.is_left_child ? 0 : 1;
-    }
-    
-    // Calculate depth and build path
-    struct window_node *current = node;
-    info.depth = 0;
-    char path[128] = "";
-    
-    while (current->parent) {
-        char direction = (current->parent->left == current) ? 'L' : 'R';
-        char split_char = (current->parent->split == SPLIT_X) ? 'X' : 'Y';
-        
-        char segment[8];
-        snprintf(segment, sizeof(segment), "%c%c", split_char, direction);
-        
-        if (strlen(path) > 0) {
-            char temp[128];
-            strcpy(temp, path);
-            snprintf(path, sizeof(path), "%s.%s", segment, temp);
-        } else {
-            strcpy(path, segment);
-        }
-        
-        current = current->parent;
-        info.depth++;
-    }
-    
-    strcpy(info.tree_path, strlen(path) > 0 ? path : "root");
-    
-    // Create position description
-    if (info.is_root) {
-        strcpy(info.position_desc, "tree-root");
-    } else if (info.is_leaf) {
-        if (info.parent_split == SPLIT_X) {
-            strcpy(info.position_desc, info.is_left_child ? "leaf-left-of-vsplit" : "leaf-right-of-vsplit");
-        } else {
-            strcpy(info.position_desc, info.is_left_child ? "leaf-above-hsplit" : "leaf-below-hsplit");
-        }
-    } else {
-        if (info.node_split == SPLIT_X) {
-            strcpy(info.position_desc, "internal-vsplit");
-        } else {
-            strcpy(info.position_desc, "internal-hsplit");
-        }
+    if (!node || !node->parent) return;
+
+    placement->parent_split = node->parent->split;
+    if (node->parent->split == SPLIT_Y) {
+        placement->is_stacked_top    = node->parent->left == node;
+        placement->is_stacked_bottom = node->parent->right == node;
     }
-    
-    return info;
 }
 
-// Analyze window positioning within BSP tree structure
-static inline void analyze_window_position(struct window *window, struct window_animation *animation)
+static void window_manager_plan_window_animation(struct animation_plan *plan, struct window *window, CGRect start, CGRect end, int window_count, float alpha)
 {
-    // Initialize positioning metadata
-    animation->is_stacked_top = false;
-    animation->is_stacked_bottom = false;
-    animation->is_side_by_side = false;
-    animation->parent_split = SPLIT_NONE;
-    
-    if (!window) {
-        debug("%s: No window provided", __FUNCTION__);
-        return;
-    }
-    
-    // Get the current space and view
-    uint64_t sid = window_space(window->id);
-    struct view *view = space_manager_find_view(&g_space_manager, sid);
-    if (!view || !view->root) {
-        debug("%s: No view or root found for window %d", __FUNCTION__, window->id);
-        return;
-    }
-    
-    // Find the window node in the BSP tree
-    struct window_node *node = view_find_window_node(view, window->id);
-    if (!node || !node->parent) {
-        debug("%s: No node or parent found for window %d", __FUNCTION__, window->id);
-        return;
-    }
-    
-    struct window_node *parent = node->parent;
-    animation->parent_split = parent->split;
-    
-    debug("%s: Window %d - parent split: %d, node is %s child", 
-          __FUNCTION__, window->id, parent->split, 
-          (parent->left == node) ? "left" : "right");
-    
-    if (parent->split == SPLIT_Y) {
-        // Vertical split - windows are stacked
-        animation->is_side_by_side = false;
-        
-        // Determine if this is the top or bottom window
-        if (parent->left == node) {
-            // This node is the left child in a vertical split = top window
-            animation->is_stacked_top = true;
-            animation->is_stacked_bottom = false;
-            debug("%s: Window %d identified as TOP window in vertical stack", __FUNCTION__, window->id);
-        } else if (parent->right == node) {
-            // This node is the right child in a vertical split = bottom window
-            animation->is_stacked_top = false;
-            animation->is_stacked_bottom = true;
-            debug("%s: Window %d identified as BOTTOM window in vertical stack", __FUNCTION__, window->id);
-        }
-    } else if (parent->split == SPLIT_X) {
-        // Horizontal split - windows are side by side
-        animation->is_side_by_side = true;
-        animation->is_stacked_top = false;
-        animation->is_stacked_bottom = false;
-        debug("%s: Window %d identified as side-by-side layout", __FUNCTION__, window->id);
-    }
-}
-
-// ============================================================================
-// CENTRALIZED SPLIT-AWARE COMMON-EDGE ANCHORING SYSTEM
-// ============================================================================
-// This is the single source of truth for all anchoring logic in animations.
-// It replaces all previous anchor calculation methods with a unified approach.
-// todo: [] identify edge cases / issues with current logic
-// [] poc using scale + transactions
-// todo: [] determine final logic + streamline
-// todo: [] cleanup
-
-typedef enum {
-    WINDOW_OPERATION_RESIZE,
-    WINDOW_OPERATION_TRANSLATE,
-    WINDOW_OPERATION_MIXED
-} window_operation_type;
-
-typedef struct {
-    bool has_common_top;
-    bool has_common_bottom;
-    bool has_common_left;
-    bool has_common_right;
-    float anchor_x, anchor_y; // Fixed anchor point in absolute coordinates
-    window_operation_type operation_type;
-    bool use_split_fallback;
-    bool crosses_monitors;
-    
-    // Legacy compatibility
-    int legacy_resize_anchor; // 0=top-left, 1=top-right, 2=bottom-left, 3=bottom-right
-} unified_anchor_info;
-
-// Detect the primary type of window operation
-static window_operation_type detect_operation_type(CGRect start_rect, CGRect end_rect) {
-    float position_change = sqrtf(powf(end_rect.origin.x - start_rect.origin.x, 2) + 
-                                  powf(end_rect.origin.y - start_rect.origin.y, 2));
-    float size_change = fabs(end_rect.size.width - start_rect.size.width) + 
-                        fabs(end_rect.size.height - start_rect.size.height);
-    
-    if (size_change > position_change * 2.0f) {
-        return WINDOW_OPERATION_RESIZE;
-    } else if (position_change > size_change * 2.0f) {
-        return WINDOW_OPERATION_TRANSLATE;
-    } else {
-        return WINDOW_OPERATION_MIXED;
-    }
+    struct animation_planner planner;
+    struct animation_placement placement;
+
+    window_manager_animation_planner(&planner);
+    window_manager_animation_placement(window, end, window_count, alpha, &placement);
+    animation_plan_create(plan, &planner, window_manager_animation_rect(start), window_manager_animation_rect(end), &placement);
+
+    debug("%s: window %d anchor(%.1f,%.1f)=%d edges(%x) screen(%x) split:%d op:%d two-phase:%d fade:%.2f monitor:%d\n",
+          __FUNCTION__, window->id, plan->anchor_x, plan->anchor_y, plan->resize_anchor, plan->common_edges, plan->screen_edges,
+          plan->parent_split, plan->operation, plan->is_two_phase, plan->fade_intensity, plan->crosses_monitors);
 }
 
-// Check if transition crosses monitor boundaries
-static bool detect_monitor_crossing(CGRect start_rect, CGRect end_rect) {
-    float distance = sqrtf(powf(end_rect.origin.x - start_rect.origin.x, 2) + 
-                          powf(end_rect.origin.y - start_rect.origin.y, 2));
-    return distance > 1000.0f; // Configurable threshold for monitor boundary detection
+//
+// NOTE: Picks the quality of a flush of animations: the configured settings,
+// stepped down to the tier that the governor chooses for the flush unless it
+// is disabled. Animations that are already running pick up the new quality on
+// their next frame. Called with the animation lock held.
+//
+
+void window_manager_update_animation_quality(struct window_manager *wm, int window_count)
+{
+    struct animation_quality config = {
+        .is_blur_enabled       = wm->window_animation_blur_enabled,
+        .is_shadows_enabled    = wm->window_animation_shadows_enabled,
+        .is_reduced_resolution = wm->window_animation_reduced_resolution,
+        .is_simplified_easing  = wm->window_animation_simplified_easing,
+        .is_two_phase_enabled  = wm->window_animation_two_phase_enabled,
+        .is_fast_mode          = wm->window_animation_fast_mode
+    };
+
+    int tier = wm->window_animation_governor_enabled ? animation_governor_update(&wm->animation_governor, window_count) : ANIMATION_QUALITY_full;
+    animation_quality_for_tier(&wm->animation_quality, &config, tier);
 }
 
-// todo: actually centralise all the logic
-// MAIN CENTRALIZED ANCHORING FUNCTION
-// This is the single function that calculates anchor information for all animations
-static unified_anchor_info calculate_unified_anchor(CGRect start_rect, CGRect end_rect, 
-                                                   enum window_node_split parent_split, 
-                                                   float edge_threshold,
-                                                   struct window_animation *animation) {
-    unified_anchor_info anchor = {0};
-    
-    // Detect operation characteristics
-    anchor.operation_type = detect_operation_type(start_rect, end_rect);
-    anchor.crosses_monitors = detect_monitor_crossing(start_rect, end_rect);
-    
-    // Check for force overrides from configuration (highest priority)
-    if (g_window_manager.window_animation_force_top_anchor) {
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width / 2.0f;
-        anchor.anchor_y = start_rect.origin.y;
-        anchor.has_common_top = true;
-        anchor.legacy_resize_anchor = 0;
-        return anchor;
-    }
-    if (g_window_manager.window_animation_force_bottom_anchor) {
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width / 2.0f;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height;
-        anchor.has_common_bottom = true;
-        anchor.legacy_resize_anchor = 2;
-        return anchor;
-    }
-    if (g_window_manager.window_animation_force_left_anchor) {
-        anchor.anchor_x = start_rect.origin.x;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height / 2.0f;
-        anchor.has_common_left = true;
-        anchor.legacy_resize_anchor = 0;
-        return anchor;
-    }
-    if (g_window_manager.window_animation_force_right_anchor) {
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height / 2.0f;
-        anchor.has_common_right = true;
-        anchor.legacy_resize_anchor = 1;
-        return anchor;
-    }
-    
-    // Check for stacked window overrides
-    if (animation && g_window_manager.window_animation_override_stacked_top && animation->is_stacked_top) {
-        anchor.legacy_resize_anchor = g_window_manager.window_animation_stacked_top_anchor;
-        switch (anchor.legacy_resize_anchor) {
-            case 0: anchor.anchor_x = start_rect.origin.x; anchor.anchor_y = start_rect.origin.y; break;
-            case 1: anchor.anchor_x = start_rect.origin.x + start_rect.size.width; anchor.anchor_y = start_rect.origin.y; break;
-            case 2: anchor.anchor_x = start_rect.origin.x; anchor.anchor_y = start_rect.origin.y + start_rect.size.height; break;
-            case 3: anchor.anchor_x = start_rect.origin.x + start_rect.size.width; anchor.anchor_y = start_rect.origin.y + start_rect.size.height; break;
-        }
-        return anchor;
-    }
-    if (animation && g_window_manager.window_animation_override_stacked_bottom && animation->is_stacked_bottom) {
-        anchor.legacy_resize_anchor = g_window_manager.window_animation_stacked_bottom_anchor;
-        switch (anchor.legacy_resize_anchor) {
-            case 0: anchor.anchor_x = start_rect.origin.x; anchor.anchor_y = start_rect.origin.y; break;
-            case 1: anchor.anchor_x = start_rect.origin.x + start_rect.size.width; anchor.anchor_y = start_rect.origin.y; break;
-            case 2: anchor.anchor_x = start_rect.origin.x; anchor.anchor_y = start_rect.origin.y + start_rect.size.height; break;
-            case 3: anchor.anchor_x = start_rect.origin.x + start_rect.size.width; anchor.anchor_y = start_rect.origin.y + start_rect.size.height; break;
-        }
-        return anchor;
-    }
-    
-    // Check for common edges within threshold (core anchoring logic)
-    anchor.has_common_top = fabs(start_rect.origin.y - end_rect.origin.y) <= edge_threshold;
-    anchor.has_common_bottom = fabs((start_rect.origin.y + start_rect.size.height) - (end_rect.origin.y + end_rect.size.height)) <= edge_threshold;
-    anchor.has_common_left = fabs(start_rect.origin.x - end_rect.origin.x) <= edge_threshold;
-    anchor.has_common_right = fabs((start_rect.origin.x + start_rect.size.width) - (end_rect.origin.x + end_rect.size.width)) <= edge_threshold;
-    
-    // NEW PRIORITY SYSTEM: Prioritize stationary edges over everything else
-    // If any edge is stationary, that should be the primary anchor consideration
-    
-    // Count stationary edges for priority ranking
-    //int stationary_edge_count = 0;
-    //if (anchor.has_common_top) stationary_edge_count++;
-    //if (anchor.has_common_bottom) stationary_edge_count++;
-    //if (anchor.has_common_left) stationary_edge_count++;
-    //if (anchor.has_common_right) stationary_edge_count++;
-    
-    // HIGHEST PRIORITY: Multiple stationary edges (corners)
-    if (anchor.has_common_top && anchor.has_common_left) {
-        anchor.anchor_x = start_rect.origin.x;
-        anchor.anchor_y = start_rect.origin.y;
-        anchor.legacy_resize_anchor = 0;
-    } else if (anchor.has_common_top && anchor.has_common_right) {
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width;
-        anchor.anchor_y = start_rect.origin.y;
-        anchor.legacy_resize_anchor = 1;
-    } else if (anchor.has_common_bottom && anchor.has_common_left) {
-        anchor.anchor_x = start_rect.origin.x;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height;
-        anchor.legacy_resize_anchor = 2;
-    } else if (anchor.has_common_bottom && anchor.has_common_right) {
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height;
-        anchor.legacy_resize_anchor = 3;
-    } 
-    // SECOND PRIORITY: Single stationary edges - these should take precedence over fallback logic
-    // Order of priority: Bottom > Top > Left > Right (most stable to least stable)
-    else if (anchor.has_common_bottom) {
-        // Bottom edge is stationary - anchor there (highest single-edge priority)
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width / 2.0f;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height;
-        anchor.legacy_resize_anchor = 2;
-        debug("🔗 Prioritizing stationary BOTTOM edge for anchoring");
-    } else if (anchor.has_common_top) {
-        // Top edge is stationary - anchor there  
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width / 2.0f;
-        anchor.anchor_y = start_rect.origin.y;
-        anchor.legacy_resize_anchor = 0;
-        debug("🔗 Prioritizing stationary TOP edge for anchoring");
-    } else if (anchor.has_common_left) {
-        // Left edge is stationary - anchor there
-        anchor.anchor_x = start_rect.origin.x;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height / 2.0f;
-        anchor.legacy_resize_anchor = 0;
-        debug("🔗 Prioritizing stationary LEFT edge for anchoring");
-    } else if (anchor.has_common_right) {
-        // Right edge is stationary - anchor there
-        anchor.anchor_x = start_rect.origin.x + start_rect.size.width;
-        anchor.anchor_y = start_rect.origin.y + start_rect.size.height / 2.0f;
-        anchor.legacy_resize_anchor = 1;
-        debug("🔗 Prioritizing stationary RIGHT edge for anchoring");
-    } else {
-        // No common edges - use split-aware fallback with operation type consideration
-        anchor.use_split_fallback = true;
-        
-        if (anchor.operation_type == WINDOW_OPERATION_TRANSLATE) {
-            // For pure translations, use center anchoring to maintain shape
-            anchor.anchor_x = start_rect.origin.x + start_rect.size.width / 2.0f;
-            anchor.anchor_y = start_rect.origin.y + start_rect.size.height / 2.0f;
-            anchor.legacy_resize_anchor = 0;
-        } else if (anchor.operation_type == WINDOW_OPERATION_RESIZE && parent_split != SPLIT_NONE) {
-            // For resizes, use split-aware anchoring
-            switch (parent_split) {
-                case SPLIT_Y: // Horizontal split - prefer top/bottom edges
-                    if (start_rect.origin.y < end_rect.origin.y) {
-                        // Growing/moving down - anchor to top
-                        anchor.anchor_x = start_rect.origin.x;
-                        anchor.anchor_y = start_rect.origin.y;
-                        anchor.legacy_resize_anchor = 0;
-                    } else {
-                        // Growing/moving up - anchor to bottom
-                        anchor.anchor_x = start_rect.origin.x;
-                        anchor.anchor_y = start_rect.origin.y + start_rect.size.height;
-                        anchor.legacy_resize_anchor = 2;
-                    }
-                    break;
-                case SPLIT_X: // Vertical split - prefer left/right edges
-                    if (start_rect.origin.x < end_rect.origin.x) {
-                        // Growing/moving right - anchor to left
-                        anchor.anchor_x = start_rect.origin.x;
-                        anchor.anchor_y = start_rect.origin.y;
-                        anchor.legacy_resize_anchor = 0;
-                    } else {
-                        // Growing/moving left - anchor to right
-                        anchor.anchor_x = start_rect.origin.x + start_rect.size.width;
-                        anchor.anchor_y = start_rect.origin.y;
-                        anchor.legacy_resize_anchor = 1;
-                    }
-                    break;
-                default:
-                    // Single window or unknown - anchor to center
-                    anchor.anchor_x = start_rect.origin.x + start_rect.size.width / 2.0f;
-                    anchor.anchor_y = start_rect.origin.y + start_rect.size.height / 2.0f;
-                    anchor.legacy_resize_anchor = 0;
-                    break;
-            }
+//
+// NOTE: The settings that frames are recorded under in the frame telemetry, so
+// that the cost of each of them can be compared on the same machine.
+//
+
+static uint32_t window_manager_frame_profile(bool is_frame_based, bool is_two_phase)
+{
+    uint32_t profile = 0;
+    if (is_frame_based)                                        profile |= FRAME_PROFILE_FRAME_BASED;
+    if (is_two_phase)                                          profile |= FRAME_PROFILE_TWO_PHASE;
+    if (g_window_manager.animation_quality.is_blur_enabled)       profile |= FRAME_PROFILE_BLUR;
+    if (g_window_manager.animation_quality.is_shadows_enabled)    profile |= FRAME_PROFILE_SHADOWS;
+    if (g_window_manager.animation_quality.is_reduced_resolution) profile |= FRAME_PROFILE_REDUCED_RESOLUTION;
+    if (g_window_manager.animation_quality.is_fast_mode)          profile |= FRAME_PROFILE_FAST_MODE;
+    return profile;
+}
+
+static inline int64_t window_manager_host_time_ns(int64_t host_time)
+{
+    return (int64_t)((double) host_time * 1000000000.0 / g_cv_host_clock_frequency);
+}
+
+static inline uint64_t window_manager_commit_transaction(CFTypeRef transaction)
+{
+    uint64_t begin = mach_absolute_time();
+    SLSTransactionCommit(transaction, 0);
+    return mach_absolute_time() - begin;
+}
+
+//
+// NOTE: Finished animations are marked with a clock of UINT64_MAX by the frame
+// that completes them, and are swapped out together while the rest of them
+// keep running on the link. Called with the animation lock held.
+//
+
+static void window_manager_finish_animations(struct window_animation_engine *engine)
+{
+    struct window_animation **finished_list = NULL;
+    for (int i = 0; i < buf_len(engine->animation_list);) {
+        if (engine->animation_list[i]->clock == UINT64_MAX) {
+            buf_push(finished_list, engine->animation_list[i]);
+            buf_del(engine->animation_list, i);
+            engine->is_batch_dirty = true;
         } else {
-            // Mixed operation or fallback - use traditional logic
-            float height_change = fabs(end_rect.size.height - start_rect.size.height);
-            float width_change = fabs(end_rect.size.width - start_rect.size.width);
-            
-            if (height_change > width_change * 2.0f) {
-                // Primarily height change
-                if (fabs(start_rect.origin.y - end_rect.origin.y) < 5.0f) {
-                    anchor.anchor_x = start_rect.origin.x;
-                    anchor.anchor_y = start_rect.origin.y;
-                    anchor.legacy_resize_anchor = 0;
-                } else {
-                    anchor.anchor_x = start_rect.origin.x;
-                    anchor.anchor_y = start_rect.origin.y + start_rect.size.height;
-                    anchor.legacy_resize_anchor = 2;
-                }
-            } else if (width_change > height_change * 2.0f) {
-                // Primarily width change
-                if (fabs(start_rect.origin.x - end_rect.origin.x) < 5.0f) {
-                    anchor.anchor_x = start_rect.origin.x;
-                    anchor.anchor_y = start_rect.origin.y;
-                    anchor.legacy_resize_anchor = 0;
-                } else {
-                    anchor.anchor_x = start_rect.origin.x + start_rect.size.width;
-                    anchor.anchor_y = start_rect.origin.y;
-                    anchor.legacy_resize_anchor = 1;
-                }
-            } else {
-                // Default to top-left
-                anchor.anchor_x = start_rect.origin.x;
-                anchor.anchor_y = start_rect.origin.y;
-                anchor.legacy_resize_anchor = 0;
-            }
+            ++i;
         }
     }
-    
-    return anchor;
-}
 
-// Interpolate with centralized anchor system
-static CGRect interpolate_with_unified_anchor(CGRect start_rect, CGRect end_rect, unified_anchor_info anchor, 
-                                            float progress, CGRect container_bounds, 
-                                            float min_width, float min_height) {
-    CGRect result;
-    
-    // Calculate target position relative to anchor
-    float start_anchor_offset_x = anchor.anchor_x - start_rect.origin.x;
-    float start_anchor_offset_y = anchor.anchor_y - start_rect.origin.y;
-    float end_anchor_offset_x = anchor.anchor_x - end_rect.origin.x;
-    float end_anchor_offset_y = anchor.anchor_y - end_rect.origin.y;
-    
-    // Interpolate size with minimum constraints
-    result.size.width = fmaxf(min_width, start_rect.size.width + (end_rect.size.width - start_rect.size.width) * progress);
-    result.size.height = fmaxf(min_height, start_rect.size.height + (end_rect.size.height - start_rect.size.height) * progress);
-    
-    // Interpolate anchor offset and calculate position
-    float current_anchor_offset_x = start_anchor_offset_x + (end_anchor_offset_x - start_anchor_offset_x) * progress;
-    float current_anchor_offset_y = start_anchor_offset_y + (end_anchor_offset_y - start_anchor_offset_y) * progress;
-    
-    result.origin.x = anchor.anchor_x - current_anchor_offset_x;
-    result.origin.y = anchor.anchor_y - current_anchor_offset_y;
-    
-    // Apply container bounds constraints if provided
-    if (!CGRectIsEmpty(container_bounds)) {
-        if (result.origin.x < container_bounds.origin.x) {
-            result.origin.x = container_bounds.origin.x;
-        }
-        if (result.origin.y < container_bounds.origin.y) {
-            result.origin.y = container_bounds.origin.y;
-        }
-        if (result.origin.x + result.size.width > container_bounds.origin.x + container_bounds.size.width) {
-            result.origin.x = container_bounds.origin.x + container_bounds.size.width - result.size.width;
-        }
-        if (result.origin.y + result.size.height > container_bounds.origin.y + container_bounds.size.height) {
-            result.origin.y = container_bounds.origin.y + container_bounds.size.height - result.size.height;
-        }
+    SLSDisableUpdate(engine->connection);
+    window_manager_notify_jankyborders(finished_list, buf_len(finished_list), 1326, true);
+    scripting_addition_swap_window_proxy_out(finished_list, buf_len(finished_list));
+    for (int i = 0; i < buf_len(finished_list); ++i) {
+        frame_telemetry_record_animation(&g_frame_telemetry, finished_list[i]->profile, finished_list[i]->missed_frame_count);
+        table_remove(&g_window_manager.window_animations_table, &finished_list[i]->wid);
+        window_manager_destroy_window_proxy(engine->connection, &finished_list[i]->proxy);
+        free(finished_list[i]);
+    }
+    SLSReenableUpdate(engine->connection);
+    buf_free(finished_list);
+
+    if (buf_len(engine->animation_list) == 0) {
+        CVDisplayLinkStop(engine->link);
+        engine->is_running = false;
     }
-    
-    return result;
 }
 
-// Legacy compatibility function - converts unified anchor to old resize_anchor int
-static int unified_anchor_to_legacy_resize_anchor(unified_anchor_info anchor) {
-    return anchor.legacy_resize_anchor;
+//
+// NOTE: The frame kernel reads the animations from a structure of arrays that
+// is rebuilt only when animations are added, retargeted or finished, rather
+// than on every frame. Called with the animation lock held.
+//
+
+static void window_manager_update_animation_batch(struct window_animation_engine *engine)
+{
+    int animation_count = buf_len(engine->animation_list);
+    animation_batch_reset(&engine->batch, animation_count);
+
+    for (int i = 0; i < animation_count; ++i) {
+        struct window_animation *animation = engine->animation_list[i];
+        animation_batch_set_plan(&engine->batch, i, &animation->plan, animation->easing);
+    }
+
+    engine->is_batch_dirty = false;
 }
 
+//
+// NOTE: The backend that the proxy animations send their frames to: every
+// frame is one window server transaction.
+//
+
+static void window_manager_transaction_set_transform(void *context, uint32_t id, struct animation_transform *transform)
+{
+    CGAffineTransform affine = { transform->a, transform->b, transform->c, transform->d, transform->tx, transform->ty };
+    SLSTransactionSetWindowTransform((CFTypeRef) context, id, 0, 0, affine);
+}
 
+static void window_manager_transaction_set_alpha(void *context, uint32_t id, float alpha)
+{
+    SLSTransactionSetWindowAlpha((CFTypeRef) context, id, alpha);
+}
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-parameter"
 static CVReturn window_manager_animate_window_list_thread_proc(CVDisplayLinkRef link, const CVTimeStamp *now, const CVTimeStamp *output_time, CVOptionFlags flags, CVOptionFlags *flags_out, void *data)
 {
-    struct window_animation_context *context = data;
-    int animation_count = context->animation_count;
-
+    struct window_animation_engine *engine = data;
     uint64_t current_clock = output_time->hostTime;
-    if (!context->animation_clock) context->animation_clock = now->hostTime;
+    struct frame_sample sample = {0};
+    bool did_finish = false;
 
-    double t = (double)(current_clock - context->animation_clock) / (double)(context->animation_duration * g_cv_host_clock_frequency);
-    if (t <= 0.0) t = 0.0f;
-    if (t >= 1.0) t = 1.0f;
+    pthread_mutex_lock(&g_window_manager.window_animations_lock);
+    uint64_t frame_begin = mach_absolute_time();
 
-    float mt;
-    if (g_window_manager.window_animation_simplified_easing || g_window_manager.window_animation_fast_mode) {
-        // Use linear interpolation for simplified/fast mode
-        mt = t;
-    } else {
-        // Use configured easing function
-        switch (context->animation_easing) {
-#define ANIMATION_EASING_TYPE_ENTRY(value) case value##_type: mt = value(t); break;
-            ANIMATION_EASING_TYPE_LIST
-#undef ANIMATION_EASING_TYPE_ENTRY
+    if (engine->is_batch_dirty) window_manager_update_animation_batch(engine);
+
+    for (int i = 0; i < buf_len(engine->animation_list); ++i) {
+        struct window_animation *animation = engine->animation_list[i];
+        if (!animation->clock) animation->clock = now->hostTime;
+
+        double t = (double)(current_clock - animation->clock) / (double)(animation->duration * g_cv_host_clock_frequency);
+        if (t <= 0.0) t = 0.0f;
+        if (t >= 1.0) t = 1.0f;
+
+        if (t == 1.0f) {
+            animation->clock = UINT64_MAX;
+            did_finish = true;
         }
+
+        engine->batch.t[i] = t;
     }
 
-    CFTypeRef transaction = SLSTransactionCreate(context->animation_connection);
-    for (int i = 0; i < animation_count; ++i) {
-        if (__atomic_load_n(&context->animation_list[i].skip, __ATOMIC_RELAXED)) continue;
-
-        // Calculate size difference ratio for this window
-        float size_ratio = calculate_size_difference_ratio(
-            context->animation_list[i].proxy.frame.size.width,
-            context->animation_list[i].proxy.frame.size.height,
-            context->animation_list[i].w,
-            context->animation_list[i].h
-        );
-
-        // UNIFIED SPLIT-AWARE ANCHORING ANIMATION SYSTEM
-        if (context->animation_list[i].is_two_phase) {
-            // Two-phase animation with unified anchoring
-            float slide_duration = g_window_manager.window_animation_slide_ratio;
-            
-            // Calculate unified anchor information once per animation
-            CGRect start_rect = context->animation_list[i].proxy.frame;
-            CGRect end_rect = CGRectMake(context->animation_list[i].x, context->animation_list[i].y, 
-                                       context->animation_list[i].w, context->animation_list[i].h);
-            
-            unified_anchor_info anchor = calculate_unified_anchor(start_rect, end_rect, 
-                                                                context->animation_list[i].parent_split,
-                                                                g_window_manager.window_animation_edge_threshold,
-                                                                &context->animation_list[i]);
-            
-            // Enhanced debug logging for unified anchor detection
-            const char *op_type = (anchor.operation_type == WINDOW_OPERATION_RESIZE) ? "resize" : 
-                                 (anchor.operation_type == WINDOW_OPERATION_TRANSLATE) ? "move" : "mixed";
-            debug("🔗 Window %d (2-phase): anchor(%.1f,%.1f) edges(T:%d B:%d L:%d R:%d) split:%d op:%s monitor:%d", 
-                  context->animation_list[i].wid, anchor.anchor_x, anchor.anchor_y,
-                  anchor.has_common_top, anchor.has_common_bottom, 
-                  anchor.has_common_left, anchor.has_common_right,
-                  context->animation_list[i].parent_split, op_type, anchor.crosses_monitors);
-            
-            // Get container bounds for constraint enforcement
-            uint32_t did = window_display_id(context->animation_list[i].wid);
-            CGRect container_bounds = display_bounds_constrained(did, false);
-            
-            // Define minimum size constraints
-            float min_width = 100.0f;
-            float min_height = 50.0f;
-            
-            if (t <= slide_duration) {
-                // Phase 1: Slide with unified anchor preservation
-                float slide_t = t / slide_duration;
-                float slide_mt = ease_out_circ(slide_t);
-                
-                // For slide phase, maintain size but move to anchor-relative position
-                CGRect slide_end_rect = CGRectMake(context->animation_list[i].x, context->animation_list[i].y,
-                                                  start_rect.size.width, start_rect.size.height);
-                
-                CGRect current_rect = interpolate_with_unified_anchor(start_rect, slide_end_rect, anchor, slide_mt, 
-                                                                    container_bounds, min_width, min_height);
-                
-                context->animation_list[i].proxy.tx = current_rect.origin.x;
-                context->animation_list[i].proxy.ty = current_rect.origin.y;
-                context->animation_list[i].proxy.tw = current_rect.size.width;
-                context->animation_list[i].proxy.th = current_rect.size.height;
-            } else {
-                // Phase 2: Resize with unified anchor preservation
-                float resize_t = (t - slide_duration) / (1.0f - slide_duration);
-                float resize_mt = ease_in_out_cubic(resize_t);
-                
-                // Start from slide end position and resize to final
-                CGRect resize_start_rect = CGRectMake(context->animation_list[i].x, context->animation_list[i].y,
-                                                     start_rect.size.width, start_rect.size.height);
-                
-                CGRect current_rect = interpolate_with_unified_anchor(resize_start_rect, end_rect, anchor, resize_mt,
-                                                                    container_bounds, min_width, min_height);
-                
-                context->animation_list[i].proxy.tx = current_rect.origin.x;
-                context->animation_list[i].proxy.ty = current_rect.origin.y;
-                context->animation_list[i].proxy.tw = current_rect.size.width;
-                context->animation_list[i].proxy.th = current_rect.size.height;
-            }
-            
-            // Handle multi-monitor handoffs with special easing for unified anchoring
-            if (anchor.crosses_monitors && t > 0.2f && t < 0.8f) {
-                // Apply smoother motion for monitor transitions
-                float monitor_mt = ease_in_out_sine(t);
-                context->animation_list[i].proxy.tx = lerp(start_rect.origin.x, monitor_mt, context->animation_list[i].x);
-                context->animation_list[i].proxy.ty = lerp(start_rect.origin.y, monitor_mt, context->animation_list[i].y);
-            }
-            
-            // Update legacy resize_anchor for compatibility
-            context->animation_list[i].resize_anchor = unified_anchor_to_legacy_resize_anchor(anchor);
-            
-            // Use the same transform calculation as classic animation
-            CGAffineTransform transform = CGAffineTransformMakeTranslation(-context->animation_list[i].proxy.tx, -context->animation_list[i].proxy.ty);
-            CGAffineTransform scale = CGAffineTransformMakeScale(context->animation_list[i].proxy.frame.size.width / context->animation_list[i].proxy.tw, context->animation_list[i].proxy.frame.size.height / context->animation_list[i].proxy.th);
-            SLSTransactionSetWindowTransform(transaction, context->animation_list[i].proxy.id, 0, 0, CGAffineTransformConcat(transform, scale));
-        } else {
-            // Enhanced single-phase animation with unified anchoring
-            CGRect start_rect = context->animation_list[i].proxy.frame;
-            CGRect end_rect = CGRectMake(context->animation_list[i].x, context->animation_list[i].y, 
-                                       context->animation_list[i].w, context->animation_list[i].h);
-            
-            unified_anchor_info anchor = calculate_unified_anchor(start_rect, end_rect, 
-                                                                context->animation_list[i].parent_split,
-                                                                g_window_manager.window_animation_edge_threshold,
-                                                                &context->animation_list[i]);
-            
-            // Enhanced debug logging for unified single-phase anchor detection
-            const char *op_type = (anchor.operation_type == WINDOW_OPERATION_RESIZE) ? "resize" : 
-                                 (anchor.operation_type == WINDOW_OPERATION_TRANSLATE) ? "move" : "mixed";
-            debug("🔗 Window %d (single): anchor(%.1f,%.1f) edges(T:%d B:%d L:%d R:%d) split:%d op:%s", 
-                  context->animation_list[i].wid, anchor.anchor_x, anchor.anchor_y,
-                  anchor.has_common_top, anchor.has_common_bottom, 
-                  anchor.has_common_left, anchor.has_common_right,
-                  context->animation_list[i].parent_split, op_type);
-            
-            uint32_t did = window_display_id(context->animation_list[i].wid);
-            CGRect container_bounds = display_bounds_constrained(did, false);
-            float min_width = 100.0f;
-            float min_height = 50.0f;
-            
-            CGRect current_rect = interpolate_with_unified_anchor(start_rect, end_rect, anchor, mt,
-                                                                container_bounds, min_width, min_height);
-            
-            context->animation_list[i].proxy.tx = current_rect.origin.x;
-            context->animation_list[i].proxy.ty = current_rect.origin.y;
-            context->animation_list[i].proxy.tw = current_rect.size.width;
-            context->animation_list[i].proxy.th = current_rect.size.height;
-            
-            // Handle multi-monitor handoffs
-            if (anchor.crosses_monitors) {
-                float monitor_mt = ease_in_out_sine(mt);
-                context->animation_list[i].proxy.tx = lerp(start_rect.origin.x, monitor_mt, context->animation_list[i].x);
-                context->animation_list[i].proxy.ty = lerp(start_rect.origin.y, monitor_mt, context->animation_list[i].y);
-            }
-            
-            // Update legacy resize_anchor for compatibility
-            context->animation_list[i].resize_anchor = unified_anchor_to_legacy_resize_anchor(anchor);
-            
-            // Transform logic
-            CGAffineTransform transform = CGAffineTransformMakeTranslation(-context->animation_list[i].proxy.tx, -context->animation_list[i].proxy.ty);
-            CGAffineTransform scale = CGAffineTransformMakeScale(context->animation_list[i].proxy.frame.size.width / context->animation_list[i].proxy.tw, context->animation_list[i].proxy.frame.size.height / context->animation_list[i].proxy.th);
-            SLSTransactionSetWindowTransform(transaction, context->animation_list[i].proxy.id, 0, 0, CGAffineTransformConcat(transform, scale));
-        }
+    animation_batch_evaluate(&engine->batch, g_window_manager.animation_quality.is_simplified_easing);
 
-        float alpha = 0.0f;
-        SLSGetWindowAlpha(context->animation_connection, context->animation_list[i].wid, &alpha);
-        
-        // Apply opacity fade for large size differences (Approach 1: Crossfade)
-        if (g_window_manager.window_animation_fade_enabled && size_ratio > g_window_manager.window_animation_fade_threshold) {
-            float fade_intensity = g_window_manager.window_animation_fade_intensity;
-            float opacity_curve;
-            
-            if (t < 0.3f) {
-                // Fade out during first 30% of animation
-                opacity_curve = 1.0f - (t / 0.3f) * fade_intensity;
-            } else if (t > 0.7f) {
-                // Fade back in during last 30%
-                opacity_curve = (1.0f - fade_intensity) + ((t - 0.7f) / 0.3f) * fade_intensity;
-            } else {
-                // Stay at reduced opacity during middle 40%
-                opacity_curve = 1.0f - fade_intensity;
-            }
-            
-            alpha *= opacity_curve;
-        }
-        
-        if (alpha != 0.0f) SLSTransactionSetWindowAlpha(transaction, context->animation_list[i].proxy.id, alpha);
+    CFTypeRef transaction = SLSTransactionCreate(engine->connection);
+    struct animation_backend backend = {
+        .context       = (void *) transaction,
+        .set_transform = window_manager_transaction_set_transform,
+        .set_alpha     = window_manager_transaction_set_alpha
+    };
+
+    for (int i = 0; i < buf_len(engine->animation_list); ++i) {
+        struct window_animation *animation = engine->animation_list[i];
+
+        animation->proxy.tx = engine->batch.x[i];
+        animation->proxy.ty = engine->batch.y[i];
+        animation->proxy.tw = engine->batch.w[i];
+        animation->proxy.th = engine->batch.h[i];
+
+        animation_batch_emit(&engine->batch, i, animation->proxy.id, animation->proxy.frame.size.width, animation->proxy.frame.size.height, &animation->plan, &backend);
+        sample.profile |= animation->profile;
     }
-    SLSTransactionCommit(transaction, 0);
+
+    uint64_t commit_begin = mach_absolute_time();
+    uint64_t commit_time = window_manager_commit_transaction(transaction);
+    uint64_t commit_end = commit_begin + commit_time;
     CFRelease(transaction);
-    if (t != 1.0f) goto out;
 
-    pthread_mutex_lock(&g_window_manager.window_animations_lock);
-    SLSDisableUpdate(context->animation_connection);
-    window_manager_notify_jankyborders(context->animation_list, context->animation_count, 1326, true, true);
-    scripting_addition_swap_window_proxy_out(context->animation_list, context->animation_count);
-    for (int i = 0; i < animation_count; ++i) {
-        if (__atomic_load_n(&context->animation_list[i].skip, __ATOMIC_RELAXED)) continue;
+    //
+    // NOTE: The frame is late if its transaction was committed after the time
+    // that the display link asked it to be presented at.
+    //
 
-        table_remove(&g_window_manager.window_animations_table, &context->animation_list[i].wid);
-        window_manager_destroy_window_proxy(context->animation_connection, &context->animation_list[i].proxy);
+    sample.cpu_ns    = window_manager_host_time_ns(commit_begin - frame_begin);
+    sample.commit_ns = window_manager_host_time_ns(commit_time);
+    sample.slack_ns  = window_manager_host_time_ns((int64_t) output_time->hostTime - (int64_t) commit_end);
+    frame_telemetry_record_frame(&g_frame_telemetry, &sample);
 
+    if (output_time->videoTimeScale > 0) {
+        float budget_ms = 1000.0f * (float) output_time->videoRefreshPeriod / (float) output_time->videoTimeScale;
+        animation_governor_record_frame(&g_window_manager.animation_governor, (sample.cpu_ns + sample.commit_ns) / 1000000.0f, budget_ms);
     }
-    SLSReenableUpdate(context->animation_connection);
-    pthread_mutex_unlock(&g_window_manager.window_animations_lock);
 
-    SLSReleaseConnection(context->animation_connection);
-    free(context->animation_list);
-    free(context);
+    if (sample.slack_ns < 0) {
+        for (int i = 0; i < buf_len(engine->animation_list); ++i) {
+            engine->animation_list[i]->missed_frame_count += 1;
+        }
+    }
 
-    CVDisplayLinkStop(link);
-    CVDisplayLinkRelease(link);
+    if (did_finish) window_manager_finish_animations(engine);
+    pthread_mutex_unlock(&g_window_manager.window_animations_lock);
 
-out:
     return kCVReturnSuccess;
 }
 #pragma clang diagnostic pop
 
+//
+// NOTE: Computes everything about an animation that only depends on where it
+// starts and where it ends. It runs when an animation is created and again
+// whenever it is retargeted.
+//
+
+static void window_manager_plan_animation(struct window_animation *animation, int window_count)
+{
+    CGRect end = CGRectMake(animation->x, animation->y, animation->w, animation->h);
+    window_manager_plan_window_animation(&animation->plan, animation->window, animation->start, end, window_count, animation->alpha);
+    animation->profile = window_manager_frame_profile(false, animation->plan.is_two_phase);
+}
+
+//
+// NOTE: A window that is already animating keeps its proxy, and continues from
+// the frame that the proxy was last drawn at towards the new target, with a
+// fresh clock that the display link starts on its next frame.
+//
+
+static void window_manager_retarget_animation(struct window_animation *animation, struct window_capture *capture, int window_count)
+{
+    animation->start    = CGRectMake(animation->proxy.tx, animation->proxy.ty, animation->proxy.tw, animation->proxy.th);
+    animation->window   = capture->window;
+    animation->x        = capture->x;
+    animation->y        = capture->y;
+    animation->w        = capture->w;
+    animation->h        = capture->h;
+    animation->clock    = 0;
+    animation->duration = g_window_manager.window_animation_duration;
+    animation->easing   = g_window_manager.window_animation_easing;
+
+    window_manager_plan_animation(animation, window_count);
+    g_window_manager.animation_engine.is_batch_dirty = true;
+}
+
 void window_manager_animate_window_list_async(struct window_capture *window_list, int window_count)
 {
-    struct window_animation_context *context = malloc(sizeof(struct window_animation_context));
+    struct window_animation_engine *engine = &g_window_manager.animation_engine;
 
-    SLSNewConnection(0, &context->animation_connection);
-    context->animation_count    = window_count;
-    context->animation_list     = malloc(window_count * sizeof(struct window_animation));
-    context->animation_duration = g_window_manager.window_animation_duration;
-    context->animation_easing   = g_window_manager.window_animation_easing;
-    context->animation_clock    = 0;
+    if (!engine->connection) {
+        SLSNewConnection(0, &engine->connection);
+    }
 
-    int thread_count = 0;
-    pthread_t *threads = ts_alloc_list(pthread_t, window_count);
+    if (!engine->link) {
+        CVDisplayLinkCreateWithActiveCGDisplays(&engine->link);
+        CVDisplayLinkSetOutputCallback(engine->link, window_manager_animate_window_list_thread_proc, engine);
+        worker_pool_init(&engine->capture_pool, worker_pool_core_count() - 1);
+    }
+
+    int animation_count = 0;
+    struct window_animation **animation_list = ts_alloc_list(struct window_animation *, window_count);
+    struct worker_task *task_list = ts_alloc_list(struct worker_task, window_count);
 
     TIME_BODY(window_manager_animate_window_list_async___prep_proxies, {
-    SLSDisableUpdate(context->animation_connection);
     pthread_mutex_lock(&g_window_manager.window_animations_lock);
+    window_manager_update_animation_quality(&g_window_manager, window_count);
     for (int i = 0; i < window_count; ++i) {
-        context->animation_list[i].window = window_list[i].window;
-        context->animation_list[i].wid    = window_list[i].window->id;
-        context->animation_list[i].x      = window_list[i].x;
-        context->animation_list[i].y      = window_list[i].y;
-        context->animation_list[i].w      = window_list[i].w;
-        context->animation_list[i].h      = window_list[i].h;
-        context->animation_list[i].cid    = context->animation_connection;
-        context->animation_list[i].skip   = false;
-        memset(&context->animation_list[i].proxy, 0, sizeof(struct window_proxy));
-
-        // Initialize two-phase animation fields
-        context->animation_list[i].original_w = 0;
-        context->animation_list[i].original_h = 0;
-        context->animation_list[i].is_two_phase = false;
-        context->animation_list[i].resize_anchor = 0;
-
-        struct window_animation *existing_animation = table_find(&g_window_manager.window_animations_table, &context->animation_list[i].wid);
+        struct window_animation *existing_animation = table_find(&g_window_manager.window_animations_table, &window_list[i].window->id);
         if (existing_animation) {
-            __atomic_store_n(&existing_animation->skip, true, __ATOMIC_RELEASE);
-
-            context->animation_list[i].proxy.frame.origin.x    = (int)(existing_animation->proxy.tx);
-            context->animation_list[i].proxy.frame.origin.y    = (int)(existing_animation->proxy.ty);
-            context->animation_list[i].proxy.frame.size.width  = (int)(existing_animation->proxy.tw);
-            context->animation_list[i].proxy.frame.size.height = (int)(existing_animation->proxy.th);
-            context->animation_list[i].proxy.tx                = (int)(existing_animation->proxy.tx);
-            context->animation_list[i].proxy.ty                = (int)(existing_animation->proxy.ty);
-            context->animation_list[i].proxy.tw                = (int)(existing_animation->proxy.tw);
-            context->animation_list[i].proxy.th                = (int)(existing_animation->proxy.th);
-            context->animation_list[i].proxy.level             = existing_animation->proxy.level;
-            context->animation_list[i].proxy.sub_level         = existing_animation->proxy.sub_level;
-            context->animation_list[i].proxy.image             = existing_animation->proxy.image
-                                                               ? (CGImageRef) CFRetain(existing_animation->proxy.image)
-                                                               : NULL;
-            __asm__ __volatile__ ("" ::: "memory");
-
-            float alpha = 1.0f;
-            SLSGetWindowAlpha(context->animation_connection, context->animation_list[i].wid, &alpha);
-            window_manager_create_window_proxy(context->animation_connection, alpha, &context->animation_list[i].proxy);
-            window_manager_notify_jankyborders(&context->animation_list[i], 1, 1325, true, false);
-            window_manager_notify_jankyborders(existing_animation, 1, 1326, false, false);
-
-            CFTypeRef transaction = SLSTransactionCreate(context->animation_connection);
-            SLSTransactionOrderWindowGroup(transaction, context->animation_list[i].proxy.id, 1, context->animation_list[i].wid);
-            SLSTransactionSetWindowSystemAlpha(transaction, existing_animation->proxy.id, 0);
-            SLSTransactionCommit(transaction, 0);
-            CFRelease(transaction);
+            //
+            // NOTE: The frame-based animations register a placeholder without a
+            // proxy; their thread owns the window until it is done with it.
+            //
 
-            table_remove(&g_window_manager.window_animations_table, &context->animation_list[i].wid);
-            window_manager_destroy_window_proxy(existing_animation->cid, &existing_animation->proxy);
-        } else {
-            pthread_t thread;
-            if (pthread_create(&thread, NULL, &window_manager_build_window_proxy_thread_proc, &context->animation_list[i]) == 0) {
-                threads[thread_count++] = thread;
-            } else {
-                window_manager_build_window_proxy_thread_proc(&context->animation_list[i]);
+            if (existing_animation->proxy.id) {
+                window_manager_retarget_animation(existing_animation, &window_list[i], window_count);
             }
+
+            continue;
         }
 
-        table_add(&g_window_manager.window_animations_table, &context->animation_list[i].wid, &context->animation_list[i]);
+        struct window_animation *animation = malloc(sizeof(struct window_animation));
+        memset(animation, 0, sizeof(struct window_animation));
+
+        animation->window     = window_list[i].window;
+        animation->wid        = window_list[i].window->id;
+        animation->x          = window_list[i].x;
+        animation->y          = window_list[i].y;
+        animation->w          = window_list[i].w;
+        animation->h          = window_list[i].h;
+        animation->cid        = engine->connection;
+        animation->generation = window_list[i].window->content_generation;
+        animation->duration   = g_window_manager.window_animation_duration;
+        animation->easing     = g_window_manager.window_animation_easing;
+
+        task_list[animation_count].proc = &window_manager_build_window_proxy_thread_proc;
+        task_list[animation_count].data = animation;
+
+        table_add(&g_window_manager.window_animations_table, &animation->wid, animation);
+        animation_list[animation_count++] = animation;
     }
     pthread_mutex_unlock(&g_window_manager.window_animations_lock);
     });
 
-    TIME_BODY(window_manager_animate_window_list_async___wait_for_threads, {
-    for (int i = 0; i < thread_count; ++i) {
-        pthread_join(threads[i], NULL);
-    }
+    uint64_t prep_begin = mach_absolute_time();
+    TIME_BODY(window_manager_animate_window_list_async___build_proxies, {
+    worker_pool_run(&engine->capture_pool, task_list, animation_count);
     });
+    uint64_t prep_time = mach_absolute_time() - prep_begin;
 
-    // Calculate unified anchor for every window (centralized system)
-    for (int i = 0; i < window_count; ++i) {
-        CGRect start_rect = context->animation_list[i].proxy.frame;
-        CGRect end_rect = CGRectMake(context->animation_list[i].x, context->animation_list[i].y,
-                                   context->animation_list[i].w, context->animation_list[i].h);
-        
-        // Analyze BSP positioning for context
-        analyze_window_position(context->animation_list[i].window, &context->animation_list[i]);
-        
-        // Use unified anchoring system
-        unified_anchor_info anchor = calculate_unified_anchor(start_rect, end_rect,
-                                                            context->animation_list[i].parent_split,
-                                                            g_window_manager.window_animation_edge_threshold,
-                                                            &context->animation_list[i]);
-        
-        // Set legacy resize_anchor for compatibility with existing code
-        context->animation_list[i].resize_anchor = unified_anchor_to_legacy_resize_anchor(anchor);
-        
-        debug("🔗 Setup: Window %d unified anchor=%d legacy_anchor=%d split=%d", 
-              context->animation_list[i].wid, (int)(anchor.anchor_x), 
-              context->animation_list[i].resize_anchor, context->animation_list[i].parent_split);
+    for (int i = 0; i < animation_count; ++i) {
+        TIME_RECORD(window_manager_build_window_proxy, task_list[i].elapsed_ns);
     }
 
+    debug("%s: built %d proxies on %d threads (%.3fms average, %.3fms slowest so far)\n", __FUNCTION__, animation_count, engine->capture_pool.thread_count + 1,
+          engine->capture_pool.completed_count ? engine->capture_pool.elapsed_total_ns / 1000000.0 / engine->capture_pool.completed_count : 0.0,
+          engine->capture_pool.elapsed_max_ns / 1000000.0);
+
+    for (int i = 0; i < animation_count; ++i) {
+        window_manager_plan_animation(animation_list[i], window_count);
+    }
+
+    SLSDisableUpdate(engine->connection);
+
     TIME_BODY(window_manager_animate_window_list_async___swap_proxy_in, {
-    scripting_addition_swap_window_proxy_in(context->animation_list, context->animation_count);
+    if (animation_count) scripting_addition_swap_window_proxy_in(animation_list, animation_count);
     });
 
     TIME_BODY(window_manager_animate_window_list_async___notify_jb, {
-    window_manager_notify_jankyborders(context->animation_list, context->animation_count, 1325, true, false);
+    if (animation_count) window_manager_notify_jankyborders(animation_list, animation_count, 1325, false);
     });
 
     TIME_BODY(window_manager_animate_window_list_async___set_frame, {
     for (int i = 0; i < window_count; ++i) {
-        window_manager_set_window_frame(context->animation_list[i].window, context->animation_list[i].x, context->animation_list[i].y, context->animation_list[i].w, context->animation_list[i].h);
+        window_manager_set_window_frame(window_list[i].window, window_list[i].x, window_list[i].y, window_list[i].w, window_list[i].h);
     }
     });
 
-    CVDisplayLinkRef link;
-    SLSReenableUpdate(context->animation_connection);
-    CVDisplayLinkCreateWithActiveCGDisplays(&link);
-    CVDisplayLinkSetOutputCallback(link, window_manager_animate_window_list_thread_proc, context);
-    CVDisplayLinkStart(link);
+    SLSReenableUpdate(engine->connection);
+
+    pthread_mutex_lock(&g_window_manager.window_animations_lock);
+    for (int i = 0; i < animation_count; ++i) {
+        buf_push(engine->animation_list, animation_list[i]);
+    }
+    if (animation_count) {
+        engine->is_batch_dirty = true;
+        animation_governor_record_prep(&g_window_manager.animation_governor, window_manager_host_time_ns(prep_time) / 1000000.0f);
+    }
+
+    if (!engine->is_running && buf_len(engine->animation_list)) {
+        CVDisplayLinkStart(engine->link);
+        engine->is_running = true;
+    }
+    pthread_mutex_unlock(&g_window_manager.window_animations_lock);
+}
+
+//
+// NOTE: Frames are drawn at the refresh rate of the display, or at an even
+// fraction of it when that is above the configured frame rate, so that every
+// frame lines up with a refresh of the display.
+//
+
+static float window_manager_animation_frame_rate(uint32_t did)
+{
+    float refresh_rate = display_refresh_rate(did);
+    float divisor = ceilf(refresh_rate / g_window_manager.window_animation_frame_rate);
+    return refresh_rate / max(divisor, 1.0f);
 }
 
 // Frame-based animation context structure
@@ -1637,6 +1241,8 @@ struct window_frame_animation_context {
     uint64_t animation_clock;
     pthread_t animation_thread;
     bool animation_running;
+    uint32_t animation_profile;
+    uint64_t missed_frame_count;
 };
 
 // Frame-based animation data structure
@@ -1661,6 +1267,7 @@ static void *window_manager_animate_window_list_frame_based_thread_proc(void *da
 {
     struct window_frame_animation_context *context = data;
     int animation_count = context->animation_count;
+    struct window_scale *scale_list = malloc(sizeof(struct window_scale) * animation_count);
     
     debug("🎬 Frame-based async animation thread started for %d windows", animation_count);
     
@@ -1670,11 +1277,12 @@ static void *window_manager_animate_window_list_frame_based_thread_proc(void *da
     float frame_rate = context->animation_frame_rate;
     
     // Calculate frame timing
-    int total_frames = (int)(duration * frame_rate);
+    int total_frames = (int)(duration * frame_rate + 0.5);
     if (total_frames < 2) total_frames = 2; // Minimum 2 frames
-    if (total_frames > 120) total_frames = 120; // Maximum 120 frames (2 seconds at 60fps)
     
     double frame_duration = duration / total_frames;
+    uint64_t frame_ticks = max((uint64_t)(frame_duration * g_cv_host_clock_frequency), 1ULL);
+    uint64_t skipped_frame_count = 0;
     
     debug("🎬 Async frame animation: duration=%.1fs, frame_rate=%.1f fps, total_frames=%d, frame_duration=%.3fs", 
           duration, frame_rate, total_frames, frame_duration);
@@ -1682,15 +1290,18 @@ static void *window_manager_animate_window_list_frame_based_thread_proc(void *da
     context->animation_clock = mach_absolute_time();
     
     // Animate frame by frame using PiP scaling (asynchronous)
-    for (int frame = 0; frame <= total_frames && context->animation_running; ++frame) {
+    int next_frame = 0;
+    for (int frame = 0; frame <= total_frames && context->animation_running; frame = next_frame) {
         uint64_t frame_start_time = mach_absolute_time();
+        uint64_t commit_time = 0;
+        int scale_count = 0;
         
         double t = (double)frame / (double)total_frames;
         if (t > 1.0) t = 1.0;
         
         // Apply easing function like the proxy animation system
         float mt;
-        if (g_window_manager.window_animation_simplified_easing || g_window_manager.window_animation_fast_mode) {
+        if (g_window_manager.animation_quality.is_simplified_easing) {
             // Use linear interpolation for simplified/fast mode
             mt = t;
         } else {
@@ -1906,108 +1517,110 @@ static void *window_manager_animate_window_list_frame_based_thread_proc(void *da
                       frame, total_frames, context->animation_list[i].wid, t, mt, current_anchor_x, current_anchor_y, current_x, current_y, current_w, current_h, context->animation_list[i].resize_anchor);
             }
             
-            // Execute PiP animation for this frame using transactions for better coordination
+            // Gather the PiP request of this window into the batch of this frame
+            bool is_opacity_enabled = (g_window_manager.window_opacity_duration > 0.0f) && g_window_manager.window_animation_opacity_enabled;
+            struct window_scale *scale = &scale_list[scale_count++];
+
+            scale->wid = context->animation_list[i].wid;
+            scale->x = current_x;
+            scale->y = current_y;
+            scale->w = current_w;
+            scale->h = current_h;
+            scale->alpha = -1.0f;
+
             if (frame == 0) {
-                // First frame: create PiP with transaction coordination
-                CFTypeRef transaction = SLSTransactionCreate(g_connection);
-                
                 window_manager_resize_window(context->animation_list[i].window, end_w, end_h);
-                
-                // Use transaction-aware PiP creation
-                scripting_addition_scale_window_forced_mode_with_transaction(
-                    context->animation_list[i].wid, 
-                    transaction,
-                    0, // create mode
-                    current_x, current_y, current_w, current_h
-                );
-                
-                // Apply opacity fade transition in the same transaction if enabled
-                float opacity_fade_duration = g_window_manager.window_opacity_duration;
-                if ((opacity_fade_duration > 0.0f) && g_window_manager.window_animation_opacity_enabled) {
-                    SLSTransactionSetWindowSystemAlpha(transaction, context->animation_list[i].wid, 0.3f);
-                }
-                
-                // Commit all changes atomically
-                SLSTransactionCommit(transaction, 0);
-                CFRelease(transaction);
-                
-                // Follow up with opacity animation if enabled
-                if ((opacity_fade_duration > 0.0f) && g_window_manager.window_animation_opacity_enabled) {
-                    scripting_addition_set_opacity(context->animation_list[i].wid, 1.0f, opacity_fade_duration); // Fade in
-                }
-                
-                debug("🎬 Async Creating PiP+TX for window %d at (%.1f,%.1f,%.1fx%.1f)", 
-                      context->animation_list[i].wid, current_x, current_y, current_w, current_h);
+                scale->mode = 0; // create mode
+                if (is_opacity_enabled) scale->alpha = 0.3f;
             } else if (frame == total_frames) {
-                // Last frame: restore PiP with transaction coordination
-                CFTypeRef transaction = SLSTransactionCreate(g_connection);
-                
-                float opacity_fade_duration = g_window_manager.window_opacity_duration;
-                if ((opacity_fade_duration > 0.0f) && g_window_manager.window_animation_opacity_enabled) {
-                    SLSTransactionSetWindowSystemAlpha(transaction, context->animation_list[i].wid, 0.7f);
-                }
-                
-                // Use transaction-aware PiP restoration
-                scripting_addition_scale_window_forced_mode_with_transaction(
-                    context->animation_list[i].wid,
-                    transaction,
-                    2, // restore mode
-                    0, 0, 0, 0 // coordinates ignored for restore
-                );
-                
-                // Commit all changes atomically
-                SLSTransactionCommit(transaction, 0);
-                CFRelease(transaction);
-                
-                if ((opacity_fade_duration > 0.0f) && g_window_manager.window_animation_opacity_enabled) {
-                    scripting_addition_set_opacity(context->animation_list[i].wid, 1.0f, opacity_fade_duration * 0.5f);
-                }
-                
-                debug("🎬 Async Restoring PiP+TX for window %d", context->animation_list[i].wid);
+                scale->mode = 2; // restore mode
+                if (is_opacity_enabled) scale->alpha = 0.7f;
             } else {
-                // Middle frames: animate PiP with transaction coordination for smoother updates
-                CFTypeRef transaction = SLSTransactionCreate(g_connection);
-                
-                // Use transaction-aware PiP movement
-                scripting_addition_scale_window_forced_mode_with_transaction(
-                    context->animation_list[i].wid,
-                    transaction,
-                    1, // move mode
-                    current_x, current_y, current_w, current_h
-                );
-                
-                // Optional: Add subtle opacity pulsing during animation in the same transaction
-                float opacity_fade_duration = g_window_manager.window_opacity_duration;
-                if ((opacity_fade_duration > 0.0f) && g_window_manager.window_animation_opacity_enabled && (frame % 5 == 0)) {
-                    float pulse_opacity = 0.85f + 0.15f * sinf(t * 3.14159f); // Subtle pulse between 0.85 and 1.0
-                    SLSTransactionSetWindowSystemAlpha(transaction, context->animation_list[i].wid, pulse_opacity);
-                }
-                
-                // Commit all changes atomically
-                SLSTransactionCommit(transaction, 0);
-                CFRelease(transaction);
-                
-                debug("🎬 Async Animating PiP+TX for window %d to (%.1f,%.1f,%.1fx%.1f)", 
-                      context->animation_list[i].wid, current_x, current_y, current_w, current_h);
+                scale->mode = 1; // move mode
+                // Optional: Add subtle opacity pulsing during animation
+                if (is_opacity_enabled && (frame % 5 == 0)) scale->alpha = 0.85f + 0.15f * sinf(t * 3.14159f);
+            }
+        }
+
+        //
+        // NOTE: Every window of the frame is sent to the scripting addition in one
+        // message, which applies them in a single transaction and commits it once,
+        // instead of one round-trip and one commit for every window.
+        //
+
+        if (scale_count) {
+            uint64_t batch_begin = mach_absolute_time();
+            scripting_addition_scale_window_list_forced(scale_list, scale_count);
+            commit_time += mach_absolute_time() - batch_begin;
+
+            debug("🎬 Async Frame %d/%d: applied %d windows in one transaction", frame, total_frames, scale_count);
+        }
+
+        // Follow up with opacity animation if enabled
+        if (g_window_manager.window_opacity_duration > 0.0f && g_window_manager.window_animation_opacity_enabled && (frame == 0 || frame == total_frames)) {
+            float opacity_fade_duration = frame == 0 ? g_window_manager.window_opacity_duration : g_window_manager.window_opacity_duration * 0.5f;
+            for (int i = 0; i < scale_count; ++i) {
+                scripting_addition_set_opacity(scale_list[i].wid, 1.0f, opacity_fade_duration);
             }
         }
         
-        // Wait for next frame (unless this is the last frame)
+        //
+        // NOTE: A frame is due by the time the next one is scheduled to start,
+        // counted from the start of the animation rather than of this frame, so
+        // that a late frame is not hidden by the frames that follow it.
+        //
+
+        uint64_t frame_end_time = mach_absolute_time();
+        uint64_t frame_deadline = context->animation_clock + (uint64_t)(frame + 1) * frame_ticks;
+
+        struct frame_sample sample = {
+            .profile   = context->animation_profile,
+            .cpu_ns    = window_manager_host_time_ns(frame_end_time - frame_start_time - commit_time),
+            .commit_ns = window_manager_host_time_ns(commit_time),
+            .slack_ns  = window_manager_host_time_ns((int64_t) frame_deadline - (int64_t) frame_end_time)
+        };
+        frame_telemetry_record_frame(&g_frame_telemetry, &sample);
+        if (sample.slack_ns < 0) ++context->missed_frame_count;
+
+        pthread_mutex_lock(&g_window_manager.window_animations_lock);
+        animation_governor_record_frame(&g_window_manager.animation_governor, (sample.cpu_ns + sample.commit_ns) / 1000000.0f, frame_duration * 1000.0f);
+        pthread_mutex_unlock(&g_window_manager.window_animations_lock);
+
+        //
+        // NOTE: The next frame starts at its deadline counted from the start of
+        // the animation, so the time spent drawing and waking up never adds up
+        // over the frames. When the deadline has already passed, the frames that
+        // are overdue are skipped and the latest one that is due is drawn right
+        // away, so that the animation ends on time instead of running long. The
+        // last frame is never skipped, as it restores the windows.
+        //
+
+        next_frame = frame + 1;
         if (frame < total_frames && context->animation_running) {
-            uint64_t frame_end_time = mach_absolute_time();
-            uint64_t frame_elapsed_time = frame_end_time - frame_start_time;
-            double frame_elapsed_ms = (double)frame_elapsed_time / (double)g_cv_host_clock_frequency * 1000.0;
-            
-            // Calculate remaining time for this frame
-            double target_frame_ms = frame_duration * 1000.0;
-            double sleep_ms = target_frame_ms - frame_elapsed_ms;
-            
-            if (sleep_ms > 0.0) {
-                usleep((useconds_t)(sleep_ms * 1000)); // Convert ms to µs
+            uint64_t now = mach_absolute_time();
+            if (now < frame_deadline) {
+                mach_wait_until(frame_deadline);
+            } else {
+                int due_frame = (int)((now - context->animation_clock) / frame_ticks);
+                if (due_frame > total_frames) due_frame = total_frames;
+
+                if (due_frame > next_frame) {
+                    debug("🎬 Async Frame %d/%d: behind schedule, skipping %d frames", frame, total_frames, due_frame - next_frame);
+                    skipped_frame_count += due_frame - next_frame;
+                    next_frame = due_frame;
+                }
             }
         }
     }
     
+    //
+    // NOTE: Frames that were skipped were never drawn, so they count as missed
+    // along with the frames that finished after their deadline.
+    //
+
+    context->missed_frame_count += skipped_frame_count;
+    frame_telemetry_record_animation(&g_frame_telemetry, context->animation_profile, context->missed_frame_count);
+
     // Clean up
     pthread_mutex_lock(&g_window_manager.window_animations_lock);
     for (int i = 0; i < animation_count; ++i) {
@@ -2039,6 +1652,7 @@ static void *window_manager_animate_window_list_frame_based_thread_proc(void *da
     pthread_mutex_unlock(&g_window_manager.window_animations_lock);
     
     // Free context
+    free(scale_list);
     free(context->animation_list);
     free(context);
     
@@ -2076,12 +1690,16 @@ void window_manager_animate_window_list_frame_based_async(struct window_capture
     context->animation_list = malloc(window_count * sizeof(struct window_frame_animation));
     context->animation_duration = g_window_manager.window_animation_duration;
     context->animation_easing = g_window_manager.window_animation_easing;
-    context->animation_frame_rate = g_window_manager.window_animation_frame_rate;
+    context->animation_frame_rate = window_manager_animation_frame_rate(window_display_id(window_list[0].window->id));
     context->animation_clock = 0;
     context->animation_running = true;
+    context->missed_frame_count = 0;
     
     // Prepare animation data and mark windows as animating
     pthread_mutex_lock(&g_window_manager.window_animations_lock);
+    uint64_t prep_begin = mach_absolute_time();
+    window_manager_update_animation_quality(&g_window_manager, window_count);
+    context->animation_profile = window_manager_frame_profile(true, false);
     for (int i = 0; i < window_count; ++i) {
         context->animation_list[i].window = window_list[i].window;
         context->animation_list[i].wid = window_list[i].window->id;
@@ -2103,48 +1721,20 @@ void window_manager_animate_window_list_frame_based_async(struct window_capture
         context->animation_list[i].calculated_w = context->animation_list[i].original_frame.size.width;
         context->animation_list[i].calculated_h = context->animation_list[i].original_frame.size.height;
         
-        // Calculate size difference ratio to determine if 2-phase animation is beneficial
-        context->animation_list[i].size_ratio = calculate_size_difference_ratio(
-            context->animation_list[i].original_w, context->animation_list[i].original_h,
-            window_list[i].w, window_list[i].h
-        );
-        
-        // Enable 2-phase animation for significant size changes (integrated from proxy system)
-        context->animation_list[i].is_two_phase = (g_window_manager.window_animation_two_phase_enabled && 
-                                                 window_count >= 2 && 
-                                                 context->animation_list[i].size_ratio > g_window_manager.window_animation_fade_threshold);
-        
-        // Use centralized anchoring system for all animations
-        CGRect start_rect = context->animation_list[i].original_frame;
-        CGRect end_rect = CGRectMake(context->animation_list[i].x, context->animation_list[i].y,
-                                   context->animation_list[i].w, context->animation_list[i].h);
-        
-        // Get the parent split if available from the window's node
-        enum window_node_split parent_split = SPLIT_NONE;
-        struct view *view = window_manager_find_managed_window(&g_window_manager, context->animation_list[i].window);
-        if (view && view->root) {
-            struct window_node *node = view_find_window_node(view, context->animation_list[i].wid);
-            if (node && node->parent) {
-                parent_split = node->parent->split;
-            }
-        }
-        
-        // Use unified anchoring system
-        unified_anchor_info anchor = calculate_unified_anchor(start_rect, end_rect,
-                                                            parent_split,
-                                                            g_window_manager.window_animation_edge_threshold,
-                                                            NULL); // No animation struct for frame-based
-        
-        // Set resize_anchor from centralized calculation
-        context->animation_list[i].resize_anchor = unified_anchor_to_legacy_resize_anchor(anchor);
-        
-        debug("🔗 Frame-async: Window %d centralized anchor=%d parent_split=%d", 
-              context->animation_list[i].wid, context->animation_list[i].resize_anchor, parent_split);
-       
+        struct animation_plan plan;
+        CGRect end_rect = CGRectMake(context->animation_list[i].x, context->animation_list[i].y, context->animation_list[i].w, context->animation_list[i].h);
+        window_manager_plan_window_animation(&plan, context->animation_list[i].window, context->animation_list[i].original_frame, end_rect, window_count, 1.0f);
+
+        context->animation_list[i].size_ratio    = plan.size_ratio;
+        context->animation_list[i].is_two_phase  = plan.is_two_phase;
+        context->animation_list[i].resize_anchor = plan.resize_anchor;
+        if (plan.is_two_phase) context->animation_profile |= FRAME_PROFILE_TWO_PHASE;
+
         // Add a dummy entry to prevent duplicate animations
         static struct window_animation dummy_animation = {0};
         table_add(&g_window_manager.window_animations_table, &window_list[i].window->id, &dummy_animation);
     }
+    animation_governor_record_prep(&g_window_manager.animation_governor, window_manager_host_time_ns(mach_absolute_time() - prep_begin) / 1000000.0f);
     pthread_mutex_unlock(&g_window_manager.window_animations_lock);
     
     // Create and start the animation thread
@@ -2218,6 +1808,11 @@ void window_manager_animate_window_frame_based(struct window_capture *window_lis
         float calculated_x, calculated_y;
     } animation_data[window_count];
 
+    pthread_mutex_lock(&g_window_manager.window_animations_lock);
+    window_manager_update_animation_quality(&g_window_manager, window_count);
+    uint32_t animation_profile = window_manager_frame_profile(true, false);
+    pthread_mutex_unlock(&g_window_manager.window_animations_lock);
+
     // Prepare animation data and mark windows as animating
     for (int i = 0; i < window_count; ++i) {
         animation_data[i].capture = window_list[i];
@@ -2240,41 +1835,15 @@ void window_manager_animate_window_frame_based(struct window_capture *window_lis
         animation_data[i].original_w = animation_data[i].original_frame.size.width;
         animation_data[i].original_h = animation_data[i].original_frame.size.height;
 
-        animation_data[i].size_ratio = calculate_size_difference_ratio(
-            animation_data[i].original_w, animation_data[i].original_h,
-            window_list[i].w, window_list[i].h
-        );
-
-        // Enable 2-phase animation for significant size changes (integrated from proxy system)
-        animation_data[i].is_two_phase = (g_window_manager.window_animation_two_phase_enabled &&
-                                         window_count >= 2 &&
-                                         animation_data[i].size_ratio > g_window_manager.window_animation_fade_threshold);
-
-        // Use centralized anchoring system for all animations
-        CGRect start_rect = animation_data[i].original_frame;
+        struct animation_plan plan;
         CGRect end_rect = CGRectMake(window_list[i].x, window_list[i].y, window_list[i].w, window_list[i].h);
-        
-        // Get the parent split if available from the window's node
-        enum window_node_split parent_split = SPLIT_NONE;
-        struct view *view = window_manager_find_managed_window(&g_window_manager, animation_data[i].capture.window);
-        if (view && view->root) {
-            struct window_node *node = view_find_window_node(view, window_list[i].window->id);
-            if (node && node->parent) {
-                parent_split = node->parent->split;
-            }
-        }
-        
-        // Use unified anchoring system
-        unified_anchor_info anchor = calculate_unified_anchor(start_rect, end_rect,
-                                                            parent_split,
-                                                            g_window_manager.window_animation_edge_threshold,
-                                                            NULL); // No animation struct for frame-based
-        
-        // Set resize_anchor from centralized calculation
-        animation_data[i].resize_anchor = unified_anchor_to_legacy_resize_anchor(anchor);
+        window_manager_plan_window_animation(&plan, window_list[i].window, animation_data[i].original_frame, end_rect, window_count, 1.0f);
 
-        // Assign anchor_point to the calculated resize_anchor value
-        animation_data[i].anchor_point = animation_data[i].resize_anchor;
+        animation_data[i].size_ratio    = plan.size_ratio;
+        animation_data[i].is_two_phase  = plan.is_two_phase;
+        animation_data[i].resize_anchor = plan.resize_anchor;
+        animation_data[i].anchor_point  = plan.resize_anchor;
+        if (plan.is_two_phase) animation_profile |= FRAME_PROFILE_TWO_PHASE;
 
         // Initialize calculated dimensions with original frame values
         animation_data[i].calculated_x = animation_data[i].original_frame.origin.x;
@@ -2313,21 +1882,32 @@ void window_manager_animate_window_frame_based(struct window_capture *window_lis
     // Animation parameters
     double duration = g_window_manager.window_animation_duration;
     int easing = g_window_manager.window_animation_easing;
-    float frame_rate = g_window_manager.window_animation_frame_rate;
+    float frame_rate = window_manager_animation_frame_rate(window_display_id(window_list[0].window->id));
     
     // Calculate frame timing
-    int total_frames = (int)(duration * frame_rate);
+    int total_frames = (int)(duration * frame_rate + 0.5);
     if (total_frames < 2) total_frames = 2; // Minimum 2 frames
-    if (total_frames > 120) total_frames = 120; // Maximum 120 frames (2 seconds at 60fps)
     
     double frame_duration = duration / total_frames;
+    uint64_t frame_ticks = max((uint64_t)(frame_duration * g_cv_host_clock_frequency), 1ULL);
+    uint64_t missed_frame_count = 0;
+    uint64_t skipped_frame_count = 0;
+    uint64_t animation_clock = mach_absolute_time();
     
-    for (int frame = 0; frame <= total_frames; ++frame) {
+    struct window_scale scale_list[window_count];
+
+    int next_frame = 0;
+    for (int frame = 0; frame <= total_frames; frame = next_frame) {
+        uint64_t frame_start_time = mach_absolute_time();
+        uint64_t commit_time = 0;
+        bool is_large_change = false;
+        int scale_count = 0;
+
         double t = (double)frame / (double)total_frames;
         if (t > 1.0) t = 1.0;
         
         float mt;
-        if (g_window_manager.window_animation_simplified_easing || g_window_manager.window_animation_fast_mode) {
+        if (g_window_manager.animation_quality.is_simplified_easing) {
             // Use linear interpolation for simplified/fast mode
             mt = t;
         } else {
@@ -2361,7 +1941,7 @@ void window_manager_animate_window_frame_based(struct window_capture *window_lis
                 float slide_t = t / slide_duration;
                 
                 float slide_mt;
-                if (g_window_manager.window_animation_simplified_easing || g_window_manager.window_animation_fast_mode) {
+                if (g_window_manager.animation_quality.is_simplified_easing) {
                     slide_mt = slide_t; // Linear for simplified/fast mode
                 } else {
                     // Apply the same easing function configured for animations
@@ -2533,6 +2113,8 @@ void window_manager_animate_window_frame_based(struct window_capture *window_lis
 
 
             if (frame == 0) {
+                uint64_t commit_begin = mach_absolute_time();
+
                 // Create transaction for smooth multi-window coordination
                 CFTypeRef transaction = SLSTransactionCreate(g_connection);
                 
@@ -2541,247 +2123,128 @@ void window_manager_animate_window_frame_based(struct window_capture *window_lis
                     SLSTransactionSetWindowSystemAlpha(transaction, animation_data[i].capture.window->id, 0.3f);
                 }
                 
-                // Add initial PiP scaling to transaction
-                // Note: This would require extending scripting_addition_scale_window_forced_mode 
-                // to accept transaction parameter for true batching
-                
                 SLSTransactionCommit(transaction, 0);
                 CFRelease(transaction);
 
-                char *title = window_title_ts(animation_data[i].capture.window);
-                
-                struct application *app = animation_data[i].capture.window
-                                          ? animation_data[i].capture.window->application
-                                          : NULL;
-                char *app_name = app ? app->name : NULL;
-                const char *anchor_label;
-                switch (animation_data[i].anchor_point) {
-                    case 0: anchor_label = "top-left";     break;
-                    case 1: anchor_label = "top-right";    break;
-                    case 2: anchor_label = "bottom-left";  break;
-                    case 3: anchor_label = "bottom-right"; break;
-                    default: anchor_label = "unknown";     break;
-                }
-                
-                // Get display ID for this window
-                uint32_t display_id = display_manager_point_display_id((CGPoint){start_x + start_w/2, start_y + start_h/2});
-                
-                // Get view for space padding information
-                struct view *view = window_manager_find_managed_window(&g_window_manager, animation_data[i].capture.window);
-                
-                // Analyze screen edge relationships for start and end positions
-                CGRect start_rect = CGRectMake(start_x, start_y, start_w, start_h);
-                CGRect end_rect = CGRectMake(end_x, end_y, end_w, end_h);
-                screen_edge_info start_edges = analyze_screen_edges(start_rect, display_id, view);
-                screen_edge_info end_edges = analyze_screen_edges(end_rect, display_id, view);
-                
-                // Analyze tree position
-                tree_position_info tree_info = analyze_tree_position(animation_data[i].capture.window);
-                
-                // Calculate operation type details
-                float size_change = fabsf((end_w * end_h) - (start_w * start_h)) / (start_w * start_h);
-                float position_change = sqrtf(powf(end_x - start_x, 2) + powf(end_y - start_y, 2));
-                float aspect_change = calculate_aspect_difference(start_w, start_h, end_w, end_h);
-                
-                // Determine which edges are moving/stationary
-                bool top_edge_moves = fabsf(start_y - end_y) > 1.0f;
-                bool bottom_edge_moves = fabsf((start_y + start_h) - (end_y + end_h)) > 1.0f;
-                bool left_edge_moves = fabsf(start_x - end_x) > 1.0f;
-                bool right_edge_moves = fabsf((start_x + start_w) - (end_x + end_w)) > 1.0f;
-                
-                // Build edge movement description
-                char edge_movement[128] = "";
-                char stationary_edges[64] = "";
-                char moving_edges[64] = "";
-                
-                if (!top_edge_moves) strcat(stationary_edges, "T");
-                else strcat(moving_edges, "T");
-                if (!bottom_edge_moves) strcat(stationary_edges, "B");
-                else strcat(moving_edges, "B");
-                if (!left_edge_moves) strcat(stationary_edges, "L");
-                else strcat(moving_edges, "L");
-                if (!right_edge_moves) strcat(stationary_edges, "R");
-                else strcat(moving_edges, "R");
-                
-                snprintf(edge_movement, sizeof(edge_movement), "stationary=[%s] moving=[%s]", 
-                        strlen(stationary_edges) > 0 ? stationary_edges : "none",
-                        strlen(moving_edges) > 0 ? moving_edges : "none");
-                
-                // Enhanced debug output with comprehensive anchoring data
-                printf("fdb ======================================================================\n"
-                       "fdb ANCHORING ANALYSIS: %s -> %s\n"
-                       "fdb ======================================================================\n"
-                       "fdb GEOMETRY:\n"
-                       "fdb   start: x: %-5.1f y: %-5.1f w: %-5.1f h: %-5.1f\n"
-                       "fdb   end:   x: %-5.1f y: %-5.1f w: %-5.1f h: %-5.1f\n"
-                       "fdb   size_change: %.1f%% position_change: %.1fpx aspect_change: %.3f\n"
-                       "fdb\n"
-                       "fdb CURRENT ANCHOR: %s (index=%d)\n"
-                       "fdb EDGE MOVEMENT: %s\n"
-                       "fdb\n"
-                       "fdb SCREEN EDGES (START):\n"
-                       "fdb   position: %s\n"
-                       "fdb   touches: %s%s%s%s\n"
-                       "fdb   distances: T=%.1f B=%.1f L=%.1f R=%.1f\n"
-                       "fdb\n"
-                       "fdb SCREEN EDGES (END):\n"
-                       "fdb   position: %s\n"
-                       "fdb   touches: %s%s%s%s\n"
-                       "fdb   distances: T=%.1f B=%.1f L=%.1f R=%.1f\n"
-                       "fdb\n"
-                       "fdb TREE POSITION:\n"
-                       "fdb   layout: %s\n"
-                       "fdb   path: %s (depth=%d)\n"
-                       "fdb   node_split: %s parent_split: %s\n"
-                       "fdb   child_position: %s%s\n"
-                       "fdb\n"
-                       "fdb SPACE PADDING:\n"
-                       "fdb   padding: T=%.1f B=%.1f L=%.1f R=%.1f\n"
-                       "fdb   edge_threshold: %.1f pixels\n"
-                       "fdb   effective_screen: x=%.1f y=%.1f w=%.1f h=%.1f\n"
-                       "fdb\n"
-                       "fdb RECOMMENDATIONS:\n"
-                       "fdb   - PRIORITY: %s edges are stationary -> anchor to stationary edge!\n"
-                       "fdb   - Edge priority order: Bottom > Top > Left > Right\n"
-                       "fdb   - Tree position suggests %s-based anchoring\n"
-                       "fdb   - Screen position indicates %s anchor preference\n"
-                       "fdb   - Space padding factored into edge detection\n"
-                       "fdb ======================================================================\n",
-                       (app_name ? app_name : "Unknown"),
-                       (title ? title : "Unknown"),
-                       start_x, start_y, start_w, start_h,
-                       end_x, end_y, end_w, end_h,
-                       size_change * 100.0f, position_change, aspect_change,
-                       anchor_label, animation_data[i].anchor_point,
-                       edge_movement,
-                       start_edges.position_desc,
-                       start_edges.touches_top ? "T" : "",
-                       start_edges.touches_bottom ? "B" : "",
-                       start_edges.touches_left ? "L" : "",
-                       start_edges.touches_right ? "R" : "",
-                       start_edges.distance_to_top, start_edges.distance_to_bottom,
-                       start_edges.distance_to_left, start_edges.distance_to_right,
-                       end_edges.position_desc,
-                       end_edges.touches_top ? "T" : "",
-                       end_edges.touches_bottom ? "B" : "",
-                       end_edges.touches_left ? "L" : "",
-                       end_edges.touches_right ? "R" : "",
-                       end_edges.distance_to_top, end_edges.distance_to_bottom,
-                       end_edges.distance_to_left, end_edges.distance_to_right,
-                       tree_info.position_desc,
-                       tree_info.tree_path, tree_info.depth,
-                       tree_info.node_split == SPLIT_X ? "vertical" : 
-                       tree_info.node_split == SPLIT_Y ? "horizontal" : "none",
-                       tree_info.parent_split == SPLIT_X ? "vertical" : 
-                       tree_info.parent_split == SPLIT_Y ? "horizontal" : "none",
-                       tree_info.is_left_child ? "left-child" : "",
-                       tree_info.is_right_child ? "right-child" : "",
-                       view ? view->top_padding : 0.0f,
-                       view ? view->bottom_padding : 0.0f,
-                       view ? view->left_padding : 0.0f,
-                       view ? view->right_padding : 0.0f,
-                       g_window_manager.window_animation_edge_threshold,
-                       view ? (display_bounds_constrained(display_id, false).origin.x + view->left_padding) : 0.0f,
-                       view ? (display_bounds_constrained(display_id, false).origin.y + view->top_padding) : 0.0f,
-                       view ? (display_bounds_constrained(display_id, false).size.width - view->left_padding - view->right_padding) : 0.0f,
-                       view ? (display_bounds_constrained(display_id, false).size.height - view->top_padding - view->bottom_padding) : 0.0f,
-                       strlen(stationary_edges) > 0 ? stationary_edges : "no",
-                       tree_info.parent_split == SPLIT_X ? "horizontal" : "vertical",
-                       start_edges.touches_left && start_edges.touches_top ? "top-left" :
-                       start_edges.touches_right && start_edges.touches_top ? "top-right" :
-                       start_edges.touches_left && start_edges.touches_bottom ? "bottom-left" :
-                       start_edges.touches_right && start_edges.touches_bottom ? "bottom-right" :
-                       start_edges.touches_top ? "top" :
-                       start_edges.touches_bottom ? "bottom" :
-                       start_edges.touches_left ? "left" :
-                       start_edges.touches_right ? "right" : "center");
-                      
-                    
-                    // move window straight away to satisfy bsp
-
-                   if(!(start_edges.touches_top && start_edges.touches_left 
-                    && end_edges.touches_right && end_edges.touches_bottom)){
-                        //? this means your doing zoom-fullscreen
-                        //? not sure why it only affects top left?
-                        //? window_manager_set_window_frame(animation_data[i].capture.window, 
-                        //                          ??, 
-                        //                          ??, 
-                        //                          ??, 
-                        //                          ??);
-                    }
-                    window_manager_set_window_frame(animation_data[i].capture.window, 
-                                                  end_x, 
-                                                  end_y, 
-                                                  end_w, 
-                                                  end_h);
-                    
-                
+                // move window straight away to satisfy bsp
+                window_manager_set_window_frame(animation_data[i].capture.window, end_x, end_y, end_w, end_h);
+
                 // Start with reduced opacity and fade in
                 if (use_opacity_fade) {
                     scripting_addition_set_opacity(animation_data[i].capture.window->id, 0.3f, 0.0f); // Set initial low opacity
                     scripting_addition_set_opacity(animation_data[i].capture.window->id, 1.0f, opacity_fade_duration); // Fade in
                 }
-                
-            } 
-            else if (frame == 1){
+
+                commit_time += mach_absolute_time() - commit_begin;
+                continue;
+            }
+
+            // Gather the PiP request of this window into the batch of this frame
+            struct window_scale *scale = &scale_list[scale_count++];
+
+            scale->wid = animation_data[i].capture.window->id;
+            scale->alpha = -1.0f;
+
+            if (frame == 1) {
                 float size_diff = fabsf((end_w * end_h) - (start_w * start_h)) / (start_w * start_h);
-               
-                scripting_addition_scale_window_forced_mode(animation_data[i].capture.window->id,0,
-                    end_x,
-                    end_y,
-                    end_w,
-                    end_h);
-                    if(size_diff > 100.0f){
-                        usleep(100000); // brief pause for very large changes
-                    }
-            } else if (frame == total_frames) {
-                // Fade out before restoring
-                //if (use_opacity_fade) {
-                //    scripting_addition_set_opacity(animation_data[i].capture.window->id, 0.7f, opacity_fade_duration * 0.5f);
-                //}
-                
-                scripting_addition_restore_pip_forced(animation_data[i].capture.window->id);
-                //window_manager_resize_window(animation_data[i].capture.window, end_w, end_h);
-                //window_manager_move_window(animation_data[i].capture.window, end_x, end_y);
-                //window_manager_resize_window(animation_data[i].capture.window, end_w, end_h);
+                if (size_diff > 100.0f) is_large_change = true;
 
-                // Restore full opacity after restoration
-                if (use_opacity_fade) {
-                    scripting_addition_set_opacity(animation_data[i].capture.window->id, 1.0f, opacity_fade_duration * 0.5f);
-                }
+                scale->mode = 0; // create mode
+                scale->x = end_x;
+                scale->y = end_y;
+                scale->w = end_w;
+                scale->h = end_h;
+            } else if (frame == total_frames) {
+                scale->mode = 2; // restore mode
+                scale->x = end_x;
+                scale->y = end_y;
+                scale->w = end_w;
+                scale->h = end_h;
             } else {
-                // Create transaction for smooth PiP updates with opacity changes
-                CFTypeRef transaction = SLSTransactionCreate(g_connection);
-                
-                // First apply the PiP scaling
-                scripting_addition_scale_window_forced_mode(
-                    animation_data[i].capture.window->id,
-                    1, // move mode
-                    current_x,
-                    current_y,
-                    current_w,
-                    current_h 
-                );
-                
-                // Then apply any opacity changes in the same transaction
+                scale->mode = 1; // move mode
+                scale->x = current_x;
+                scale->y = current_y;
+                scale->w = current_w;
+                scale->h = current_h;
+
                 if (use_opacity_fade && frame > total_frames * 0.8f) {
                     // Fade out slightly near the end for smoother transition
                     float fade_progress = (frame - total_frames * 0.8f) / (total_frames * 0.2f);
-                    float target_opacity = 1.0f - (fade_progress * 0.2f); // Subtle fade
-                    SLSTransactionSetWindowSystemAlpha(transaction, animation_data[i].capture.window->id, target_opacity);
+                    scale->alpha = 1.0f - (fade_progress * 0.2f); // Subtle fade
                 }
-                
-                SLSTransactionCommit(transaction, 0);
-                CFRelease(transaction);
             }
-            
         }
-        
-        // Wait for next frame (unless this is the last frame)
+
+        //
+        // NOTE: Every window of the frame is sent to the scripting addition in one
+        // message, applied in a single transaction, as on the async thread.
+        //
+
+        if (scale_count) {
+            uint64_t batch_begin = mach_absolute_time();
+            scripting_addition_scale_window_list_forced(scale_list, scale_count);
+
+            if (frame == 1 && is_large_change) {
+                usleep(100000); // brief pause for very large changes
+            }
+
+            // Restore full opacity after restoration
+            if (frame == total_frames && g_window_manager.window_opacity_duration > 0.0f && g_window_manager.window_animation_opacity_enabled) {
+                for (int i = 0; i < scale_count; ++i) {
+                    scripting_addition_set_opacity(scale_list[i].wid, 1.0f, g_window_manager.window_opacity_duration * 0.5f);
+                }
+            }
+            commit_time += mach_absolute_time() - batch_begin;
+        }
+
+        //
+        // NOTE: Frames are recorded the same way as those of the async thread,
+        // with the time spent waiting on the scripting addition and the window
+        // server counted apart from the time spent computing the frame.
+        //
+
+        uint64_t frame_end_time = mach_absolute_time();
+        uint64_t frame_deadline = animation_clock + (uint64_t)(frame + 1) * frame_ticks;
+
+        struct frame_sample sample = {
+            .profile   = animation_profile,
+            .cpu_ns    = window_manager_host_time_ns(frame_end_time - frame_start_time - commit_time),
+            .commit_ns = window_manager_host_time_ns(commit_time),
+            .slack_ns  = window_manager_host_time_ns((int64_t) frame_deadline - (int64_t) frame_end_time)
+        };
+        frame_telemetry_record_frame(&g_frame_telemetry, &sample);
+        if (sample.slack_ns < 0) ++missed_frame_count;
+
+        pthread_mutex_lock(&g_window_manager.window_animations_lock);
+        animation_governor_record_frame(&g_window_manager.animation_governor, (sample.cpu_ns + sample.commit_ns) / 1000000.0f, frame_duration * 1000.0f);
+        pthread_mutex_unlock(&g_window_manager.window_animations_lock);
+
+        //
+        // NOTE: Frames are scheduled the same way as on the async thread. The
+        // second frame is not skipped either, as it is the one that puts the
+        // windows into PiP for the frames that follow to move.
+        //
+
+        next_frame = frame + 1;
         if (frame < total_frames) {
-            usleep((useconds_t)(frame_duration * 1000000));
+            uint64_t now = mach_absolute_time();
+            if (now < frame_deadline) {
+                mach_wait_until(frame_deadline);
+            } else if (frame > 0) {
+                int due_frame = (int)((now - animation_clock) / frame_ticks);
+                if (due_frame > total_frames) due_frame = total_frames;
+
+                if (due_frame > next_frame) {
+                    debug("🎬 Frame %d/%d: behind schedule, skipping %d frames", frame, total_frames, due_frame - next_frame);
+                    skipped_frame_count += due_frame - next_frame;
+                    next_frame = due_frame;
+                }
+            }
         }
     }
+
+    missed_frame_count += skipped_frame_count;
+    frame_telemetry_record_animation(&g_frame_telemetry, animation_profile, missed_frame_count);
     
     // Clean up
     for (int i = 0; i < window_count; ++i) {
@@ -2799,19 +2262,65 @@ void window_manager_animate_window_frame_based(struct window_capture *window_lis
     }
 }
 
+//
+// NOTE: A capture is only dropped when both the frame that was last applied to
+// the window and the frame last reported for it by the AX API match its target.
+// The reported frame alone is not reliable, as it lags behind operations that
+// are applied in rapid succession (see window_manager_set_window_frame), and a
+// window that is still animating may be on its way to a different frame.
+//
+
+static inline bool window_manager_frame_matches(CGRect frame, struct window_capture *capture)
+{
+    return !AX_DIFF(frame.origin.x,    capture->x) &&
+           !AX_DIFF(frame.origin.y,    capture->y) &&
+           !AX_DIFF(frame.size.width,  capture->w) &&
+           !AX_DIFF(frame.size.height, capture->h);
+}
+
+static int window_manager_drop_applied_frames(struct window_capture *window_list, int window_count)
+{
+    int count = 0;
+
+    pthread_mutex_lock(&g_window_manager.window_animations_lock);
+    for (int i = 0; i < window_count; ++i) {
+        struct window *window = window_list[i].window;
+
+        if (window_manager_frame_matches(window->applied_frame, &window_list[i]) &&
+            window_manager_frame_matches(window->frame, &window_list[i]) &&
+            !table_find(&g_window_manager.window_animations_table, &window->id)) {
+            continue;
+        }
+
+        window_list[count++] = window_list[i];
+    }
+    pthread_mutex_unlock(&g_window_manager.window_animations_lock);
+
+    g_window_manager.frame_apply_count += count;
+    g_window_manager.frame_skip_count  += window_count - count;
+    debug("%s: skipped %d of %d window moves (%lld skipped in total)\n", __FUNCTION__, window_count - count, window_count, g_window_manager.frame_skip_count);
+
+    return count;
+}
+
 void window_manager_animate_window_list(struct window_capture *window_list, int window_count)
 {
     TIME_FUNCTION;
 
+    window_count = window_manager_drop_applied_frames(window_list, window_count);
+    if (!window_count) return;
+
     if (g_window_manager.window_animation_duration) {
         // Use frame-based animation if enabled via a flag
         if (g_window_manager.window_animation_frame_based_enabled) {
             debug("fdb FRAME-BASED SYNC LIST %d windows (for testing)\n", window_count);
             // Temporarily use synchronous version for debugging
             window_manager_animate_window_frame_based(window_list, window_count);
+        } else if (g_window_manager.window_animation_proxy_enabled) {
+            debug("fdb PROXY LIST %d windows\n", window_count);
+            window_manager_animate_window_list_async(window_list, window_count);
         } else {
             debug("fdb CLASSIC LIST %d windows\n", window_count);
-            //window_manager_animate_window_list_async(window_list, window_count);
             window_manager_animate_window_list_frame_based_async(window_list, window_count);
         }
     } else {
@@ -2825,15 +2334,14 @@ void window_manager_animate_window(struct window_capture capture)
 {
     TIME_FUNCTION;
 
+    if (!window_manager_drop_applied_frames(&capture, 1)) return;
+
     if (g_window_manager.window_animation_duration) {
-        // Use frame-based animation if enabled via a flag
-        //if (g_window_manager.window_animation_frame_based_enabled) {
-            //debug("fdb FRAME-BASED SINGLE WINDOW %d window\n", window_count);
+        if (g_window_manager.window_animation_proxy_enabled && !g_window_manager.window_animation_frame_based_enabled) {
+            window_manager_animate_window_list_async(&capture, 1);
+        } else {
             window_manager_animate_window_frame_based(&capture, 1);
-        //} 
-        //else {
-        //    window_manager_animate_window_list_frame_based_async(&capture, 1);
-        //}
+        }
     } else {
         window_manager_set_window_frame(capture.window, capture.x, capture.y, capture.w, capture.h);
     }
@@ -3074,6 +2582,8 @@ static void refresh_node_order(struct window_node *n, uint64_t sid)
             }
         }
     }
+
+    window_node_invalidate_min_size(n);
 }
 void stack_pass_begin(struct window_manager *wm)
 {
@@ -3194,7 +2704,7 @@ void window_manager_sweep_stacks(struct view *view,
     stack_pass_begin(wm);
 
     // Depth-first walk of all nodes in the view
-    struct window_node *stack[64];
+    struct window_node **stack = ts_alloc_list(struct window_node *, view->pool.node_pool.count);
     int top = 0;
     if (view->root) stack[top++] = view->root;
     while (top) {
@@ -3882,9 +3392,10 @@ struct window *window_manager_create_and_add_window(struct space_manager *sm, st
             //
 
             if (g_verbose) {
+                struct serializer s = serializer_create(stdout, SERIALIZER_FORMAT_JSON);
                 fprintf(stdout, "window info: \n");
-                window_serialize(stdout, window, 0);
-                fprintf(stdout, "\n");
+                window_serialize(&s, window, 0, NULL);
+                serializer_end(&s);
             }
         }
     } else {
@@ -3896,9 +3407,10 @@ struct window *window_manager_create_and_add_window(struct space_manager *sm, st
         //
 
         if (g_verbose) {
+            struct serializer s = serializer_create(stdout, SERIALIZER_FORMAT_JSON);
             fprintf(stdout, "window info: \n");
-            window_serialize(stdout, window, 0);
-            fprintf(stdout, "\n");
+            window_serialize(&s, window, 0, NULL);
+            serializer_end(&s);
         }
     }
 
@@ -4198,8 +3710,6 @@ enum window_op_error window_manager_stack_window(struct space_manager *sm, struc
     }
 
     struct window_node *a_node = view_find_window_node(a_view, a->id);
-    if (a_node->window_count+1 >= NODE_MAX_WINDOW_COUNT) return WINDOW_OP_ERROR_MAX_STACK;
-
     view_stack_window_node(a_node, b);
     window_manager_add_managed_window(wm, b, a_view);
     window_manager_adjust_layer(b, LAYER_BELOW);
@@ -4277,7 +3787,8 @@ enum window_op_error window_manager_warp_window(struct space_manager *sm, struct
             //
 
             struct area cf, cs;
-            area_make_pair(window_node_get_split(b_view, b_node), window_node_get_gap(b_view), window_node_get_ratio(b_node), &b_node->area, &cf, &cs);
+            struct layout_config config = view_layout_config(b_view);
+            area_make_pair(window_node_get_split(&config, b_node), config.gap, window_node_get_ratio(&config, b_node), &b_node->area, &cf, &cs);
 
             CGPoint ca = { (int)(0.5f + a_node->area.x + a_node->area.w / 2.0f), (int)(0.5f + a_node->area.y + a_node->area.h / 2.0f) };
             float dcf = powf((ca.x - (int)(0.5f + cf.x + cf.w / 2.0f)), 2.0f) + powf((ca.y - (int)(0.5f + cf.y + cf.h / 2.0f)), 2.0f);
@@ -4377,6 +3888,7 @@ enum window_op_error window_manager_swap_window(struct space_manager *sm, struct
 
         a_node->window_list[b_list_index] = a->id;
         a_node->window_order[b_order_index] = a->id;
+        window_node_invalidate_min_size(a_node);
 
         if (a->id == wm->focused_window_id) {
             window_manager_focus_window_with_raise(&b->application->psn, b->id, b->ref);
@@ -5255,6 +4767,60 @@ static void window_manager_check_for_windows_on_space(struct window_manager *wm,
     }
 }
 
+struct saved_layout_context
+{
+    struct window_manager *wm;
+    uint32_t *window_list;
+    int window_count;
+};
+
+static bool window_manager_is_saved_layout_window(void *context, uint32_t window_id)
+{
+    struct saved_layout_context *saved_layout_context = context;
+
+    for (int i = 0; i < saved_layout_context->window_count; ++i) {
+        if (saved_layout_context->window_list[i] != window_id) continue;
+
+        struct window *window = window_manager_find_window(saved_layout_context->wm, window_id);
+        return window && window_manager_should_manage_window(window) && !window_manager_find_managed_window(saved_layout_context->wm, window);
+    }
+
+    return false;
+}
+
+//
+// NOTE: A view that is tiled for the first time since the daemon started, and
+// that has a layout saved by a previous run, is built from that layout in one
+// go. Windows that are not part of it are inserted afterwards as usual. The
+// saved layout is discarded once the view has been tiled either way.
+//
+
+static void window_manager_restore_saved_layout(struct space_manager *sm, struct window_manager *wm, struct view *view, uint32_t *window_list, int window_count)
+{
+    struct saved_layout *saved_layout = space_manager_find_saved_layout(sm, view);
+    if (!saved_layout) return;
+
+    struct saved_layout_context context = { wm, window_list, window_count };
+    bool can_restore = saved_layout->layout == view->layout && window_node_is_leaf(view->root) && !window_node_is_occupied(view->root);
+
+    if (can_restore && view_restore_tree(view, saved_layout->snapshot, window_manager_is_saved_layout_window, &context)) {
+        view->insertion_point = saved_layout->insertion_point;
+
+        for (struct window_node *node = window_node_find_first_leaf(view->root); node; node = window_node_find_next_leaf(node)) {
+            for (int i = 0; i < node->window_count; ++i) {
+                struct window *window = window_manager_find_window(wm, node->window_list[i]);
+                window_manager_adjust_layer(window, LAYER_BELOW);
+                window_manager_add_managed_window(wm, window, view);
+            }
+        }
+
+        view_set_flag(view, VIEW_IS_DIRTY);
+        debug("%s: restored saved layout of space %lld\n", __FUNCTION__, view->sid);
+    }
+
+    space_manager_remove_saved_layout(sm, saved_layout);
+}
+
 void window_manager_validate_and_check_for_windows_on_space(struct space_manager *sm, struct window_manager *wm, uint64_t sid)
 {
     struct view *view = space_manager_find_view(sm, sid);
@@ -5263,6 +4829,7 @@ void window_manager_validate_and_check_for_windows_on_space(struct space_manager
     int window_count = 0;
     uint32_t *window_list = space_window_list(sid, &window_count, false);
     window_manager_validate_windows_on_space(wm, view, window_list, window_count);
+    window_manager_restore_saved_layout(sm, wm, view, window_list, window_count);
     window_manager_check_for_windows_on_space(wm, view, window_list, window_count);
 
     //
@@ -5384,7 +4951,12 @@ void window_manager_init(struct window_manager *wm)
     wm->window_animation_starting_size = 1.0f;                 // Start at target size by default (no scaling effect)
     
     wm->window_animation_frame_based_enabled = false;          // Frame-based animation disabled by default (POC)
-    wm->window_animation_frame_rate = 60.0f;                   // Default 60 fps for AX API calls
+    wm->window_animation_frame_rate = 120.0f;                  // Upper limit, follows the display below it
+    wm->window_animation_proxy_enabled = false;                // Frame-based scaling by default
+    wm->window_animation_governor_enabled = true;              // Step quality down for large or slow flushes
+
+    animation_governor_init(&wm->animation_governor);
+    window_manager_update_animation_quality(wm, 0);
 
     wm->insert_feedback_color = rgba_color_from_hex(0xffd75f5f);
 
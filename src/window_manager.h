@@ -19,7 +19,6 @@ enum window_op_error
     WINDOW_OP_ERROR_MINIMIZE_FAILED,
     WINDOW_OP_ERROR_NOT_MINIMIZED,
     WINDOW_OP_ERROR_DEMINIMIZE_FAILED,
-    WINDOW_OP_ERROR_MAX_STACK,
     WINDOW_OP_ERROR_SAME_STACK,
     WINDOW_OP_ERROR_MIN_CONSTRAINT,
 };
@@ -112,6 +111,7 @@ struct window_manager
     struct table window_animations_table;
     struct table insert_feedback;
     pthread_mutex_t window_animations_lock;
+    struct window_animation_engine animation_engine;
     struct rule *rules;
     struct application **applications_to_refresh;
     uint32_t focused_window_id;
@@ -159,18 +159,28 @@ struct window_manager
     
     // Frame-based animation (POC alternative to proxy windows)
     bool window_animation_frame_based_enabled; // Use frame-based scaling instead of proxy windows
-    float window_animation_frame_rate;         // Frame rate for AX API calls (1.0-120.0 fps)
+    float window_animation_frame_rate;         // Upper limit of the frame rate, below the display refresh rate (1.0-120.0 fps)
+
+    // Proxy animation engine (captured window images moved by one display link)
+    bool window_animation_proxy_enabled;       // Animate through proxy windows instead of frame-based scaling
+
+    // Quality that animations actually run at, stepped down by the governor
+    bool window_animation_governor_enabled;    // Step quality down for large or slow flushes
+    struct animation_governor animation_governor;
+    struct animation_quality animation_quality;
     
     struct rgba_color insert_feedback_color;
     struct scratchpad *scratchpad_window;
     struct table stack_state;
     uint64_t     stack_gen;
+    uint64_t frame_apply_count;
+    uint64_t frame_skip_count;
 };
 
 void window_manager_query_window_rules(FILE *rsp);
-void window_manager_query_windows_for_spaces(FILE *rsp, uint64_t *space_list, int space_count, uint64_t flags);
-void window_manager_query_windows_for_display(FILE *rsp, uint32_t did, uint64_t flags);
-void window_manager_query_windows_for_displays(FILE *rsp, uint64_t flags);
+void window_manager_query_windows_for_spaces(struct serializer *s, uint64_t *space_list, int space_count, uint64_t flags, struct query_predicate *where);
+void window_manager_query_windows_for_display(struct serializer *s, uint32_t did, uint64_t flags, struct query_predicate *where);
+void window_manager_query_windows_for_displays(struct serializer *s, uint64_t flags, struct query_predicate *where);
 bool window_manager_rule_matches_window(struct rule *rule, struct window *window, char *window_title, char *window_role, char *window_subrole);
 void window_manager_apply_manage_rule_effects_to_window(struct space_manager *sm, struct window_manager *wm, struct window *window, struct rule_effects *effects);
 void window_manager_apply_rule_effects_to_window(struct space_manager *sm, struct window_manager *wm, struct window *window, struct rule_effects *effects);
@@ -185,6 +195,7 @@ void window_manager_resize_window(struct window *window, float width, float heig
 enum window_op_error window_manager_adjust_window_ratio(struct window_manager *wm, struct window *window, int action, float ratio);
 void window_manager_animate_window(struct window_capture capture);
 void window_manager_animate_window_frame_based(struct window_capture *window_list, int window_count);
+void window_manager_update_animation_quality(struct window_manager *wm, int window_count);
 void window_manager_animate_window_list(struct window_capture *window_list, int window_count);
 void window_manager_set_window_frame(struct window *window, float x, float y, float width, float height);
 int window_manager_find_rank_of_window_in_list(uint32_t wid, uint32_t *window_list, int window_count);
@@ -1,6 +1,9 @@
 #define SA_SOCKET_PATH_FMT      "/tmp/yabai-sa_%s.socket"
 #define SOCKET_PATH_FMT         "/tmp/yabai_%s.socket"
 #define LCFILE_PATH_FMT         "/tmp/yabai_%s.lock"
+#define LAYOUT_PATH_FMT         "/tmp/yabai_%s.layout"
+#define LAYOUT_SAVE_INTERVAL    30
+#define LAYOUT_EXIT_TIMEOUT     2
 
 #define SCRPT_ADD_LOAD_OPT      "--load-sa"
 #define SCRPT_ADD_UNINSTALL_OPT "--uninstall-sa"
@@ -30,6 +33,10 @@ struct display_manager g_display_manager;
 struct window_manager g_window_manager;
 struct space_manager g_space_manager;
 struct memory_pool g_signal_storage;
+struct event_stream g_event_stream;
+struct query_cache g_query_cache;
+struct capture_cache g_capture_cache;
+struct frame_telemetry g_frame_telemetry;
 struct mouse_state g_mouse_state;
 struct event_loop g_event_loop;
 void *g_workspace_context;
@@ -45,6 +52,7 @@ char g_sa_socket_file[MAXLEN];
 char g_socket_file[MAXLEN];
 char g_config_file[4096];
 char g_lock_file[MAXLEN];
+char g_layout_file[MAXLEN];
 
 mach_port_t g_bs_port;
 int g_connection;
@@ -104,20 +112,28 @@ static int client_send_message(int argc, char **argv)
     int result = EXIT_SUCCESS;
     FILE *output = stdout;
     int bytes_read = 0;
+    bool did_read = false;
     char rsp[BUFSIZ];
 
-    while ((bytes_read = read(sockfd, rsp, sizeof(rsp)-1)) > 0) {
-        rsp[bytes_read] = '\0';
+    //
+    // NOTE: responses may be binary (query --format msgpack), so the data is
+    // written as-is instead of being treated as a string, and only the first
+    // byte of the response can indicate a failure.
+    //
 
-        if (rsp[0] == FAILURE_MESSAGE[0]) {
+    while ((bytes_read = read(sockfd, rsp, sizeof(rsp))) > 0) {
+        char *data = rsp;
+
+        if (!did_read && rsp[0] == FAILURE_MESSAGE[0]) {
             result = EXIT_FAILURE;
             output = stderr;
-            fprintf(output, "%s", rsp + 1);
-            fflush(output);
-        } else {
-            fprintf(output, "%s", rsp);
-            fflush(output);
+            ++data;
+            --bytes_read;
         }
+
+        did_read = true;
+        fwrite(data, 1, bytes_read, output);
+        fflush(output);
     }
 
     socket_close(sockfd);
@@ -174,6 +190,7 @@ static inline bool configure_settings_and_acquire_lock(void)
     snprintf(g_sa_socket_file, sizeof(g_sa_socket_file), SA_SOCKET_PATH_FMT, user);
     snprintf(g_socket_file, sizeof(g_socket_file), SOCKET_PATH_FMT, user);
     snprintf(g_lock_file, sizeof(g_lock_file), LCFILE_PATH_FMT, user);
+    snprintf(g_layout_file, sizeof(g_layout_file), LAYOUT_PATH_FMT, user);
 
     NSApplicationLoad();
     g_pid = getpid();
@@ -191,6 +208,9 @@ static inline bool configure_settings_and_acquire_lock(void)
     CGSetLocalEventsSuppressionInterval(0.0f);
     CGEnableEventStateCombining(false);
     mouse_state_init(&g_mouse_state);
+    query_cache_init(&g_query_cache);
+    capture_cache_init(&g_capture_cache, CAPTURE_CACHE_BUDGET);
+    frame_telemetry_init(&g_frame_telemetry);
     task_get_special_port(mach_task_self(), TASK_BOOTSTRAP_PORT, &g_bs_port);
 
 #if 0
@@ -216,6 +236,41 @@ static inline bool configure_settings_and_acquire_lock(void)
 }
 #pragma clang diagnostic pop
 
+//
+// NOTE: The layouts of all spaces are written from the event loop thread, which
+// owns the views. They are saved periodically in case the daemon crashes, and
+// once more when it is asked to terminate, after which the daemon exits. If the
+// event loop is stuck and has not saved them within LAYOUT_EXIT_TIMEOUT seconds,
+// or the signal arrives a second time, the daemon exits without saving.
+//
+
+static void schedule_layout_save(void)
+{
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, LAYOUT_SAVE_INTERVAL * NSEC_PER_SEC), dispatch_get_main_queue(), ^{
+        event_loop_post(&g_event_loop, LAYOUT_SAVE, NULL, 0);
+        schedule_layout_save();
+    });
+}
+
+static void save_layouts_on_signal(int signal_number)
+{
+    signal(signal_number, SIG_IGN);
+
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_SIGNAL, signal_number, 0, dispatch_get_main_queue());
+    dispatch_source_set_event_handler(source, ^{
+        static bool is_exiting;
+        if (is_exiting) _exit(EXIT_FAILURE);
+
+        is_exiting = true;
+        event_loop_post(&g_event_loop, LAYOUT_SAVE, NULL, 1);
+
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, LAYOUT_EXIT_TIMEOUT * NSEC_PER_SEC), dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            _exit(EXIT_FAILURE);
+        });
+    });
+    dispatch_resume(source);
+}
+
 static void parse_arguments(int argc, char **argv)
 {
     if ((string_equals(argv[1], HELP_OPT_LONG)) ||
@@ -371,6 +426,7 @@ int main(int argc, char **argv)
     set_next_space_shortcut((1<<3)|(1<<1), 124);
     window_manager_init(&g_window_manager);
     space_manager_begin(&g_space_manager);
+    space_manager_load_layouts(&g_space_manager, g_layout_file);
     window_manager_begin(&g_space_manager, &g_window_manager);
     
     // Refresh space widget after window manager has finished initializing
@@ -387,6 +443,10 @@ int main(int argc, char **argv)
 
     exec_config_file(g_config_file, sizeof(g_config_file));
 
+    save_layouts_on_signal(SIGTERM);
+    save_layouts_on_signal(SIGINT);
+    schedule_layout_save();
+
     for (;;) {
         NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
         CFRunLoopRunResult result = CFRunLoopRunInMode(kCFRunLoopDefaultMode, 300, true);
@@ -0,0 +1,251 @@
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef __x86_64__
+#include <emmintrin.h>
+#elif __arm64__
+#include <arm_neon.h>
+#endif
+
+#include "../../src/misc/macros.h"
+#include "../../src/misc/easing.h"
+#include "../../src/misc/object_pool.h"
+#include "../../src/layout.h"
+#include "../../src/animation.h"
+#include "../../src/animation_sim.h"
+#include "../../src/animation.c"
+#include "../../src/animation_sim.c"
+#include "../src/animation_sim_golden.c"
+
+#define BENCH_FRAME_COUNT 100000
+#define BENCH_TOLERANCE   0.01f
+
+static int bench_window_count_list[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+static int bench_sim_window_count_list[] = { 1, 10, 50, 100, 250, 500 };
+
+static inline uint32_t bench_random(uint64_t *rng)
+{
+    *rng = *rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(*rng >> 33);
+}
+
+static inline double bench_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 1000.0 * ts.tv_sec + ts.tv_nsec / 1000000.0;
+}
+
+static struct animation_rect bench_rect(uint64_t *rng)
+{
+    return (struct animation_rect) {
+        (float)(bench_random(rng) % 2560),
+        (float)(bench_random(rng) % 1440),
+        (float)(50 + bench_random(rng) % 1600),
+        (float)(25 + bench_random(rng) % 900)
+    };
+}
+
+//
+// NOTE: Fills a batch the way a layout change does: a few windows cross to
+// another display, about a third of them use the two-phase animation, and
+// every window is kept inside the bounds of its display.
+//
+
+static void bench_fill(struct animation_batch *batch, int count, int easing, uint64_t *rng)
+{
+    animation_batch_reset(batch, count);
+
+    for (int i = 0; i < count; ++i) {
+        struct animation_lane lane = {
+            .start            = bench_rect(rng),
+            .end              = bench_rect(rng),
+            .bounds           = { 0, 0, 2560, 1440 },
+            .slide            = 0.4f,
+            .easing           = easing < 0 ? (int)(bench_random(rng) % EASING_TYPE_COUNT) : easing,
+            .is_two_phase     = bench_random(rng) % 3 == 0,
+            .crosses_monitors = bench_random(rng) % 16 == 0
+        };
+        animation_batch_set(batch, i, &lane);
+    }
+}
+
+static void bench_step(struct animation_batch *batch, int frame)
+{
+    float t = (float)(frame % 61) / 60.0f;
+    for (int i = 0; i < batch->count; ++i) {
+        batch->t[i] = t;
+    }
+}
+
+static bool bench_compare(struct animation_batch *batch, struct animation_batch *reference, char *stage)
+{
+    for (int i = 0; i < batch->count; ++i) {
+        if (fabsf(batch->x[i] - reference->x[i]) > BENCH_TOLERANCE ||
+            fabsf(batch->y[i] - reference->y[i]) > BENCH_TOLERANCE ||
+            fabsf(batch->w[i] - reference->w[i]) > BENCH_TOLERANCE ||
+            fabsf(batch->h[i] - reference->h[i]) > BENCH_TOLERANCE) {
+            printf("  %-10s lane %d differs: (%.3f,%.3f,%.3f,%.3f) != (%.3f,%.3f,%.3f,%.3f)\n", stage, i,
+                   batch->x[i], batch->y[i], batch->w[i], batch->h[i],
+                   reference->x[i], reference->y[i], reference->w[i], reference->h[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool bench_run(int easing, char *name)
+{
+    bool result = true;
+    struct animation_batch batch, reference;
+    animation_batch_init(&batch);
+    animation_batch_init(&reference);
+
+    printf("animation: %s\n", name);
+    printf("  %-10s %12s %12s %8s\n", "windows", "scalar", "kernel", "speedup");
+
+    for (int i = 0; i < (int) array_count(bench_window_count_list); ++i) {
+        int count = bench_window_count_list[i];
+        uint64_t rng = 0x9e3779b97f4a7c15ULL;
+        uint64_t reference_rng = rng;
+
+        bench_fill(&batch, count, easing, &rng);
+        bench_fill(&reference, count, easing, &reference_rng);
+
+        for (int frame = 0; frame <= 60; ++frame) {
+            bench_step(&batch, frame);
+            bench_step(&reference, frame);
+            animation_batch_evaluate(&batch, false);
+            animation_batch_evaluate_scalar(&reference, false);
+            result &= bench_compare(&batch, &reference, name);
+        }
+
+        int frame_count = BENCH_FRAME_COUNT / count;
+        if (frame_count < 1000) frame_count = 1000;
+
+        double begin = bench_time_ms();
+        for (int frame = 0; frame < frame_count; ++frame) {
+            bench_step(&reference, frame);
+            animation_batch_evaluate_scalar(&reference, false);
+        }
+        double scalar_ns = 1000000.0 * (bench_time_ms() - begin) / frame_count;
+
+        begin = bench_time_ms();
+        for (int frame = 0; frame < frame_count; ++frame) {
+            bench_step(&batch, frame);
+            animation_batch_evaluate(&batch, false);
+        }
+        double kernel_ns = 1000000.0 * (bench_time_ms() - begin) / frame_count;
+
+        printf("  %-10d %9.1fns %9.1fns %7.2fx\n", count, scalar_ns, kernel_ns, scalar_ns / kernel_ns);
+    }
+
+    animation_batch_destroy(&batch);
+    animation_batch_destroy(&reference);
+    return result;
+}
+
+//
+// NOTE: Runs the whole pipeline in the simulator: plans are made once for every
+// window, and every frame is evaluated by the kernel and recorded in the trace
+// the way the display link callback hands it to the window server.
+//
+
+static bool bench_sim(void)
+{
+    struct animation_planner planner = {
+        .edge_threshold       = 5.0f,
+        .is_two_phase_enabled = true,
+        .slide_ratio          = 0.4f,
+        .is_fade_enabled      = true,
+        .fade_threshold       = 0.3f,
+        .fade_intensity       = 0.5f
+    };
+
+    printf("animation: simulator (0.25s at 120hz)\n");
+    printf("  %-10s %12s %12s %12s\n", "windows", "per frame", "max frame", "per window");
+
+    for (int i = 0; i < (int) array_count(bench_sim_window_count_list); ++i) {
+        int count = bench_sim_window_count_list[i];
+        uint64_t rng = 0x9e3779b97f4a7c15ULL;
+
+        struct animation_placement placement = {
+            .screen       = { 0, 0, 2560, 1440 },
+            .bounds       = { 0, 0, 2560, 1440 },
+            .parent_split = SPLIT_Y,
+            .window_count = count,
+            .alpha        = 1.0f
+        };
+
+        struct animation_sim sim;
+        animation_sim_init(&sim, 0.25f, 120.0f);
+
+        for (int j = 0; j < count; ++j) {
+            struct animation_plan plan;
+            animation_plan_create(&plan, &planner, bench_rect(&rng), bench_rect(&rng), &placement);
+            animation_sim_add(&sim, j + 1, &plan, (int)(bench_random(&rng) % EASING_TYPE_COUNT));
+        }
+
+        uint64_t elapsed_ns = 0;
+        uint64_t elapsed_max_ns = 0;
+        int frame_count = 0;
+
+        for (int run = 0; run < 20; ++run) {
+            frame_count += animation_sim_run(&sim);
+            elapsed_ns += sim.elapsed_ns;
+            if (sim.elapsed_max_ns > elapsed_max_ns) elapsed_max_ns = sim.elapsed_max_ns;
+        }
+
+        double frame_ns = (double) elapsed_ns / frame_count;
+        printf("  %-10d %10.1fns %10.1fns %10.1fns\n", count, frame_ns, (double) elapsed_max_ns, frame_ns / count);
+
+        bool result = sim.trace.entry_count == sim.frame_count * count;
+        animation_sim_destroy(&sim);
+        if (!result) return false;
+    }
+
+    return true;
+}
+
+//
+// NOTE: The same golden trace that the tests compare against, so that a change
+// to the animation math is caught by the benchmark on platforms that can not
+// build the tests.
+//
+
+static bool bench_sim_golden(void)
+{
+    struct animation_sim sim;
+    test_animation_sim_golden_scene(&sim);
+
+    bool result = animation_sim_run(&sim) == 7 &&
+                  sim.trace.entry_count == (int) array_count(test_animation_sim_golden) &&
+                  test_animation_sim_compare(&sim, test_animation_sim_golden, array_count(test_animation_sim_golden)) == 0;
+
+    printf("animation: golden trace %s\n", result ? "matches" : "differs");
+    animation_sim_destroy(&sim);
+    return result;
+}
+
+int main(void)
+{
+    bool result = true;
+
+    result &= bench_run(ease_out_cubic_type, "ease_out_cubic (per frame)");
+    result &= bench_run(ease_in_out_circ_type, "ease_in_out_circ (per frame)");
+    result &= bench_run(ease_in_out_sine_type, "ease_in_out_sine (per frame)");
+    result &= bench_run(-1, "mixed easing (per frame)");
+    result &= bench_sim();
+    result &= bench_sim_golden();
+
+    printf("%s\n", result ? "success" : "failed");
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
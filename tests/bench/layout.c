@@ -0,0 +1,395 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#include "../../src/misc/macros.h"
+#include "../../src/misc/object_pool.h"
+#include "../../src/layout.h"
+#include "../../src/layout.c"
+
+#define BENCH_LEAF_COUNT   10000
+#define BENCH_RESIZE_COUNT 10000
+#define BENCH_REMOVE_COUNT 2500
+#define BENCH_QUERY_COUNT  1000
+#define BENCH_DEEP_COUNT   10000
+#define BENCH_SOLVE_COUNT  10000
+
+struct bench_state
+{
+    struct layout_pool pool;
+    struct layout_config config;
+    struct window_node *root;
+    struct window_node **leaf_list;
+    int leaf_count;
+    uint32_t next_window_id;
+    uint64_t rng;
+};
+
+static inline uint32_t bench_random(struct bench_state *state)
+{
+    state->rng = state->rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t)(state->rng >> 33);
+}
+
+static inline double bench_time_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 1000.0 * ts.tv_sec + ts.tv_nsec / 1000000.0;
+}
+
+static uint32_t bench_min_width(void *context, uint32_t window_id)
+{
+    uint32_t *min_width = context;
+    return window_id % 16 == 0 ? *min_width : 0;
+}
+
+static uint32_t bench_min_height(void *context, uint32_t window_id)
+{
+    uint32_t *min_width = context;
+    return window_id % 24 == 0 ? *min_width / 2 : 0;
+}
+
+struct bench_rank_list
+{
+    uint32_t *window_list;
+    int window_count;
+};
+
+static int bench_rank(void *context, uint32_t window_id)
+{
+    struct bench_rank_list *rank_list = context;
+
+    for (int i = 0; i < rank_list->window_count; ++i) {
+        if (rank_list->window_list[i] == window_id) return i;
+    }
+
+    return INT_MAX;
+}
+
+//
+// NOTE: Stands in for capturing the windows of the dirty leaves, which is what
+// clears NODE_DIRTY_FRAME in the daemon.
+//
+
+static int bench_consume_dirty(struct window_node *node)
+{
+    if (!node->dirty) return 0;
+
+    int count = 0;
+
+    if (window_node_is_leaf(node)) {
+        count = (node->dirty & NODE_DIRTY_FRAME) != 0;
+        node->dirty &= ~NODE_DIRTY_FRAME;
+    } else {
+        count += bench_consume_dirty(node->left);
+        count += bench_consume_dirty(node->right);
+    }
+
+    window_node_update_child_flag(node);
+    return count;
+}
+
+static void bench_collect_leaves(struct bench_state *state)
+{
+    state->leaf_count = 0;
+
+    for (struct window_node *node = window_node_find_first_leaf(state->root); node; node = window_node_find_next_leaf(node)) {
+        state->leaf_list[state->leaf_count++] = node;
+    }
+}
+
+static bool bench_verify(struct bench_state *state, char *stage)
+{
+    struct area *root = &state->root->area;
+    int count = 0;
+
+    for (struct window_node *node = window_node_find_first_leaf(state->root); node; node = window_node_find_next_leaf(node)) {
+        if (node->area.x < root->x || node->area.y < root->y ||
+            node->area.x + node->area.w > root->x + root->w ||
+            node->area.y + node->area.h > root->y + root->h) {
+            printf("  %-10s leaf %d is outside of the root area\n", stage, count);
+            return false;
+        }
+
+        ++count;
+    }
+
+    if (count != state->leaf_count) {
+        printf("  %-10s expected %d leaves, found %d\n", stage, state->leaf_count, count);
+        return false;
+    }
+
+    //
+    // NOTE: A full layout pass must agree with the areas computed by the
+    // incremental passes, so it should not find a single leaf to move.
+    //
+
+    layout_update(&state->config, state->root);
+    int moved = bench_consume_dirty(state->root);
+
+    if (moved) {
+        printf("  %-10s full layout moved %d leaves\n", stage, moved);
+        return false;
+    }
+
+    return true;
+}
+
+static void bench_report(char *stage, int count, double ms)
+{
+    printf("  %-10s %6d ops %10.3fms %10.3fus/op\n", stage, count, ms, 1000.0 * ms / count);
+}
+
+//
+// NOTE: Recomputes the minimum size of a subtree without looking at the cache,
+// and reports the number of nodes whose cached size disagrees with it.
+//
+
+static int bench_check_min_size(struct layout_config *config, struct window_node *node, uint32_t *min_width, uint32_t *min_height)
+{
+    int mismatch = 0;
+
+    if (window_node_is_leaf(node)) {
+        uint32_t rule_width = node->window_count ? config->min_width(config->context, node->window_order[0]) : 0;
+        *min_width  = node->window_count ? (rule_width ? rule_width : NODE_DEFAULT_MIN_WIDTH) : 0;
+        *min_height = node->window_count ? config->min_height(config->context, node->window_order[0]) : 0;
+    } else {
+        uint32_t lw, lh, rw, rh;
+        mismatch += bench_check_min_size(config, node->left, &lw, &lh);
+        mismatch += bench_check_min_size(config, node->right, &rw, &rh);
+
+        *min_width  = node->split == SPLIT_Y ? min_size_add(lw, rw, config->gap) : max(lw, rw);
+        *min_height = node->split == SPLIT_X ? min_size_add(lh, rh, config->gap) : max(lh, rh);
+    }
+
+    return mismatch + (!node->is_min_size_valid || node->min_width != *min_width || node->min_height != *min_height);
+}
+
+//
+// NOTE: A chain where every split takes the newest leaf, which is the deepest
+// and most unbalanced tree that a space can end up with. Every leaf sits on a
+// path as long as the tree, so a solve that walks from each fence down to its
+// leaves would be quadratic here.
+//
+
+static bool bench_deep(struct layout_config *config, uint32_t *next_window_id, uint64_t *rng)
+{
+    struct layout_pool pool;
+    layout_pool_init(&pool);
+
+    struct window_node **leaf_list = malloc(sizeof(struct window_node *) * BENCH_DEEP_COUNT);
+    int leaf_count = 0;
+
+    struct window_node *root = window_node_create(&pool, true);
+    root->area = (struct area) { 0, 0, 65536, 65536 };
+    root->window_list[0] = root->window_order[0] = ++*next_window_id;
+    root->window_count = 1;
+    leaf_list[leaf_count++] = root;
+
+    for (struct window_node *leaf = root; leaf_count < BENCH_DEEP_COUNT; leaf = leaf->right) {
+        window_node_split(&pool, config, leaf, ++*next_window_id, NULL);
+        leaf_list[leaf_count - 1] = leaf->left;
+        leaf_list[leaf_count++] = leaf->right;
+    }
+
+    layout_update(config, root);
+    bench_consume_dirty(root);
+
+    double begin = bench_time_ms();
+    layout_enforce_min_size(config, root);
+    bench_report("deep-solve", 1, bench_time_ms() - begin);
+
+    begin = bench_time_ms();
+    for (int i = 0; i < BENCH_SOLVE_COUNT; ++i) {
+        *rng = *rng * 6364136223846793005ULL + 1442695040888963407ULL;
+        window_node_invalidate_min_size(leaf_list[(*rng >> 33) % leaf_count]);
+        window_node_update_min_size(config, root);
+    }
+    bench_report("deep-leaf", BENCH_SOLVE_COUNT, bench_time_ms() - begin);
+
+    uint32_t min_width, min_height;
+    int mismatch = bench_check_min_size(config, root, &min_width, &min_height);
+
+    if (mismatch) {
+        printf("  %-10s %d nodes have a stale minimum size\n", "deep-leaf", mismatch);
+    }
+
+    free(leaf_list);
+    layout_pool_destroy(&pool);
+
+    return mismatch == 0;
+}
+
+int main(void)
+{
+    struct bench_state state;
+    memset(&state, 0, sizeof(struct bench_state));
+    uint32_t min_width = 40;
+
+    state.rng = 0x9e3779b97f4a7c15ULL;
+    state.config.split_type  = SPLIT_AUTO;
+    state.config.child       = CHILD_SECOND;
+    state.config.split_ratio = 0.5f;
+    state.config.gap         = 4;
+    state.config.min_width   = bench_min_width;
+    state.config.min_height  = bench_min_height;
+    state.config.context     = &min_width;
+
+    layout_pool_init(&state.pool);
+    state.leaf_list = malloc(sizeof(struct window_node *) * BENCH_LEAF_COUNT);
+
+    state.root = window_node_create(&state.pool, true);
+    state.root->area = (struct area) { 0, 0, 65536, 65536 };
+    state.root->window_list[0] = state.root->window_order[0] = ++state.next_window_id;
+    state.root->window_count = 1;
+    state.leaf_list[state.leaf_count++] = state.root;
+
+    bool result = true;
+    printf("layout: %d leaves\n", BENCH_LEAF_COUNT);
+
+    double begin = bench_time_ms();
+    //
+    // NOTE: Split the larger of two random leaves, which keeps the tree about as
+    // deep as the trees that result from splitting the focused window.
+    //
+
+    while (state.leaf_count < BENCH_LEAF_COUNT) {
+        int index = bench_random(&state) % state.leaf_count;
+        int other = bench_random(&state) % state.leaf_count;
+
+        struct area *a = &state.leaf_list[index]->area;
+        struct area *b = &state.leaf_list[other]->area;
+        if (b->w * b->h > a->w * a->h) index = other;
+
+        struct window_node *leaf = state.leaf_list[index];
+
+        window_node_split(&state.pool, &state.config, leaf, ++state.next_window_id, NULL);
+        state.leaf_list[index] = leaf->left;
+        state.leaf_list[state.leaf_count++] = leaf->right;
+    }
+    bench_report("split", BENCH_LEAF_COUNT - 1, bench_time_ms() - begin);
+
+    begin = bench_time_ms();
+    layout_update(&state.config, state.root);
+    bench_consume_dirty(state.root);
+    bench_report("layout", 1, bench_time_ms() - begin);
+    result &= bench_verify(&state, "layout");
+
+    begin = bench_time_ms();
+    layout_enforce_min_size(&state.config, state.root);
+    layout_update_dirty(&state.config, state.root);
+    bench_consume_dirty(state.root);
+    bench_report("min-size", 1, bench_time_ms() - begin);
+    result &= bench_verify(&state, "min-size");
+
+    result &= bench_deep(&state.config, &state.next_window_id, &state.rng);
+
+    int moved = 0;
+    begin = bench_time_ms();
+    for (int i = 0; i < BENCH_RESIZE_COUNT; ++i) {
+        struct window_node *fence = state.leaf_list[bench_random(&state) % state.leaf_count]->parent;
+
+        fence->ratio = 0.25f + (bench_random(&state) % 50) / 100.0f;
+        window_node_mark_dirty(fence, NODE_DIRTY_LAYOUT);
+        layout_update_dirty(&state.config, state.root);
+        moved += bench_consume_dirty(state.root);
+    }
+    bench_report("resize", BENCH_RESIZE_COUNT, bench_time_ms() - begin);
+    printf("  %-10s %6.1f leaves moved per resize\n", "", (double) moved / BENCH_RESIZE_COUNT);
+    result &= bench_verify(&state, "resize");
+
+    begin = bench_time_ms();
+    window_node_rotate(state.root, 90);
+    window_node_mirror(state.root, SPLIT_Y);
+    window_node_balance(state.root, SPLIT_Y | SPLIT_X);
+    layout_update(&state.config, state.root);
+    bench_consume_dirty(state.root);
+    bench_report("rebalance", 1, bench_time_ms() - begin);
+    bench_collect_leaves(&state);
+    result &= bench_verify(&state, "rebalance");
+
+    begin = bench_time_ms();
+    for (int i = 0; i < BENCH_REMOVE_COUNT; ++i) {
+        int index = bench_random(&state) % state.leaf_count;
+        struct window_node *leaf = state.leaf_list[index];
+        struct window_node *sibling = window_node_is_left_child(leaf) ? leaf->parent->right : leaf->parent->left;
+
+        if (!window_node_is_leaf(sibling)) {
+            continue;
+        }
+
+        for (int j = 0; j < state.leaf_count; ++j) {
+            if (state.leaf_list[j] == sibling) {
+                state.leaf_list[j] = leaf->parent;
+                break;
+            }
+        }
+
+        state.leaf_list[index] = state.leaf_list[--state.leaf_count];
+        window_node_collapse(&state.pool, leaf);
+        layout_update_dirty(&state.config, state.root);
+        bench_consume_dirty(state.root);
+    }
+    bench_report("remove", BENCH_LEAF_COUNT - state.leaf_count, bench_time_ms() - begin);
+    result &= bench_verify(&state, "remove");
+
+    int window_count = 0;
+    uint32_t *window_list = malloc(sizeof(uint32_t) * state.leaf_count);
+    for (struct window_node *node = window_node_find_first_leaf(state.root); node; node = window_node_find_next_leaf(node)) {
+        window_list[window_count++] = node->window_order[0];
+    }
+
+    struct window_node *source_list[BENCH_QUERY_COUNT];
+    struct window_node *linear_list[BENCH_QUERY_COUNT];
+    int direction_list[BENCH_QUERY_COUNT];
+
+    for (int i = 0; i < BENCH_QUERY_COUNT; ++i) {
+        source_list[i] = state.leaf_list[bench_random(&state) % state.leaf_count];
+        direction_list[i] = 90 * (1 + bench_random(&state) % 4);
+    }
+
+    int found = 0;
+    begin = bench_time_ms();
+    for (int i = 0; i < BENCH_QUERY_COUNT; ++i) {
+        linear_list[i] = window_node_find_in_direction(state.root, source_list[i], direction_list[i], window_list, window_count);
+        found += linear_list[i] != NULL;
+    }
+    bench_report("direction", BENCH_QUERY_COUNT, bench_time_ms() - begin);
+    printf("  %-10s %6d of %d queries found a neighbour\n", "", found, BENCH_QUERY_COUNT);
+
+    struct layout_index index;
+    memset(&index, 0, sizeof(struct layout_index));
+    struct bench_rank_list rank_list = { window_list, window_count };
+
+    begin = bench_time_ms();
+    layout_index_find_in_direction(&index, state.root, source_list[0], direction_list[0], bench_rank, &rank_list);
+    bench_report("index", 1, bench_time_ms() - begin);
+
+    int mismatch = 0;
+    begin = bench_time_ms();
+    for (int i = 0; i < BENCH_QUERY_COUNT; ++i) {
+        mismatch += layout_index_find_in_direction(&index, state.root, source_list[i], direction_list[i], bench_rank, &rank_list) != linear_list[i];
+    }
+    bench_report("indexed", BENCH_QUERY_COUNT, bench_time_ms() - begin);
+
+    if (mismatch) {
+        printf("  %-10s %d queries differ from the linear search\n", "indexed", mismatch);
+        result = false;
+    }
+
+    layout_index_destroy(&index);
+    free(window_list);
+    free(state.leaf_list);
+    layout_pool_destroy(&state.pool);
+
+    printf("%s\n", result ? "success" : "failed");
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
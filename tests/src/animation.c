@@ -0,0 +1,233 @@
+static int test_animation_easing_list[] = { ease_out_cubic_type, ease_in_out_quint_type, ease_in_out_circ_type, ease_in_out_sine_type, -1 };
+
+static struct animation_lane test_animation_lane(int i, int easing)
+{
+    return (struct animation_lane) {
+        .start            = { 40.0f * i, 10.0f * i, 300.0f + 7.0f * i, 200.0f + 3.0f * i },
+        .end              = { 1200.0f - 30.0f * i, 25.0f * i, 900.0f - 11.0f * i, 80.0f + 5.0f * i },
+        .bounds           = { 0.0f, 0.0f, 1920.0f, 1080.0f },
+        .slide            = 0.5f,
+        .easing           = easing < 0 ? i % EASING_TYPE_COUNT : easing,
+        .is_two_phase     = i % 3 == 0,
+        .crosses_monitors = i % 7 == 0
+    };
+}
+
+TEST_FUNC(animation_kernel_matches_scalar_reference,
+{
+    struct animation_batch batch;
+    struct animation_batch reference;
+    animation_batch_init(&batch);
+    animation_batch_init(&reference);
+
+    for (int e = 0; e < array_count(test_animation_easing_list); ++e) {
+        int window_count = 37;
+        animation_batch_reset(&batch, window_count);
+        animation_batch_reset(&reference, window_count);
+
+        for (int i = 0; i < window_count; ++i) {
+            struct animation_lane lane = test_animation_lane(i, test_animation_easing_list[e]);
+            animation_batch_set(&batch, i, &lane);
+            animation_batch_set(&reference, i, &lane);
+        }
+
+        int mismatch = 0;
+        for (int frame = 0; frame <= 30; ++frame) {
+            for (int i = 0; i < window_count; ++i) {
+                batch.t[i] = reference.t[i] = (float) frame / 30.0f;
+            }
+
+            animation_batch_evaluate(&batch, false);
+            animation_batch_evaluate_scalar(&reference, false);
+
+            for (int i = 0; i < window_count; ++i) {
+                mismatch += fabsf(batch.x[i] - reference.x[i]) > 0.01f || fabsf(batch.y[i] - reference.y[i]) > 0.01f;
+                mismatch += fabsf(batch.w[i] - reference.w[i]) > 0.01f || fabsf(batch.h[i] - reference.h[i]) > 0.01f;
+                if (!batch.crosses_monitors[i]) mismatch += batch.x[i] < 0.0f || batch.x[i] + batch.w[i] > 1920.0f + 0.01f;
+            }
+        }
+        TEST_CHECK(mismatch, 0);
+
+        TEST_CHECK(batch.x[5] == 1050.0f && batch.y[5] == 125.0f && batch.w[5] == 845.0f && batch.h[5] == 105.0f, true);
+    }
+
+    animation_batch_destroy(&batch);
+    animation_batch_destroy(&reference);
+});
+
+static struct animation_planner test_animation_planner(void)
+{
+    return (struct animation_planner) {
+        .edge_threshold       = 5.0f,
+        .is_two_phase_enabled = true,
+        .slide_ratio          = 0.4f,
+        .is_fade_enabled      = true,
+        .fade_threshold       = 0.3f,
+        .fade_intensity       = 0.5f
+    };
+}
+
+static struct animation_placement test_animation_placement(enum window_node_split split, int window_count)
+{
+    return (struct animation_placement) {
+        .screen       = { 0.0f, 25.0f, 1920.0f, 1055.0f },
+        .bounds       = { 0.0f, 25.0f, 1920.0f, 1055.0f },
+        .parent_split = split,
+        .window_count = window_count,
+        .alpha        = 1.0f
+    };
+}
+
+static struct animation_rect test_animation_rect(float x, float y, float w, float h)
+{
+    return (struct animation_rect) { x, y, w, h };
+}
+
+TEST_FUNC(animation_plan_anchors_at_common_edges,
+{
+    struct animation_plan plan;
+    struct animation_planner planner = test_animation_planner();
+    struct animation_placement placement = test_animation_placement(SPLIT_X, 2);
+
+    animation_plan_create(&plan, &planner, test_animation_rect(0, 25, 1920, 1055), test_animation_rect(0, 25, 960, 1055), &placement);
+    TEST_CHECK(plan.resize_anchor, ANIMATION_ANCHOR_TOP_LEFT);
+    TEST_CHECK(plan.anchor_x == 0.0f && plan.anchor_y == 25.0f, true);
+    TEST_CHECK(plan.screen_edges, ANIMATION_EDGE_TOP | ANIMATION_EDGE_BOTTOM | ANIMATION_EDGE_LEFT);
+    TEST_CHECK(plan.use_split_fallback, false);
+
+    animation_plan_create(&plan, &planner, test_animation_rect(960, 25, 960, 1055), test_animation_rect(1280, 25, 640, 1055), &placement);
+    TEST_CHECK(plan.resize_anchor, ANIMATION_ANCHOR_TOP_RIGHT);
+    TEST_CHECK(plan.anchor_x == 1920.0f && plan.anchor_y == 25.0f, true);
+
+    animation_plan_create(&plan, &planner, test_animation_rect(100, 500, 800, 400), test_animation_rect(300, 300, 400, 600), &placement);
+    TEST_CHECK(plan.common_edges, ANIMATION_EDGE_BOTTOM);
+    TEST_CHECK(plan.resize_anchor, ANIMATION_ANCHOR_BOTTOM_LEFT);
+    TEST_CHECK(plan.anchor_x == 500.0f && plan.anchor_y == 900.0f, true);
+});
+
+TEST_FUNC(animation_plan_falls_back_to_parent_split,
+{
+    struct animation_plan plan;
+    struct animation_planner planner = test_animation_planner();
+    struct animation_placement placement = test_animation_placement(SPLIT_Y, 2);
+
+    animation_plan_create(&plan, &planner, test_animation_rect(100, 100, 400, 300), test_animation_rect(1300, 700, 400, 300), &placement);
+    TEST_CHECK(plan.operation, ANIMATION_OPERATION_TRANSLATE);
+    TEST_CHECK(plan.use_split_fallback, true);
+    TEST_CHECK(plan.anchor_x == 300.0f && plan.anchor_y == 250.0f, true);
+    TEST_CHECK(plan.crosses_monitors, true);
+
+    animation_plan_create(&plan, &planner, test_animation_rect(100, 100, 400, 300), test_animation_rect(90, 110, 600, 700), &placement);
+    TEST_CHECK(plan.operation, ANIMATION_OPERATION_RESIZE);
+    TEST_CHECK(plan.use_split_fallback, true);
+    TEST_CHECK(plan.resize_anchor, ANIMATION_ANCHOR_TOP_LEFT);
+    TEST_CHECK(plan.crosses_monitors, false);
+
+    planner.force_edge = ANIMATION_EDGE_RIGHT;
+    animation_plan_create(&plan, &planner, test_animation_rect(100, 100, 400, 300), test_animation_rect(90, 110, 600, 700), &placement);
+    TEST_CHECK(plan.use_split_fallback, false);
+    TEST_CHECK(plan.resize_anchor, ANIMATION_ANCHOR_TOP_RIGHT);
+    TEST_CHECK(plan.anchor_x == 500.0f && plan.anchor_y == 250.0f, true);
+
+    planner.force_edge = 0;
+    planner.override_stacked_bottom = true;
+    planner.stacked_bottom_anchor = ANIMATION_ANCHOR_BOTTOM_RIGHT;
+    placement.is_stacked_bottom = true;
+    animation_plan_create(&plan, &planner, test_animation_rect(100, 100, 400, 300), test_animation_rect(90, 110, 600, 700), &placement);
+    TEST_CHECK(plan.resize_anchor, ANIMATION_ANCHOR_BOTTOM_RIGHT);
+    TEST_CHECK(plan.anchor_x == 500.0f && plan.anchor_y == 400.0f, true);
+});
+
+TEST_FUNC(animation_plan_two_phase_and_fade,
+{
+    struct animation_plan plan;
+    struct animation_planner planner = test_animation_planner();
+    struct animation_placement placement = test_animation_placement(SPLIT_X, 1);
+
+    animation_plan_create(&plan, &planner, test_animation_rect(0, 25, 1920, 1055), test_animation_rect(0, 25, 480, 1055), &placement);
+    TEST_CHECK(fabsf(plan.size_ratio - 0.75f) < 0.0001f, true);
+    TEST_CHECK(plan.is_two_phase, false);
+    TEST_CHECK(plan.slide == 0.0f, true);
+
+    placement.window_count = 3;
+    placement.alpha = 0.8f;
+    animation_plan_create(&plan, &planner, test_animation_rect(0, 25, 1920, 1055), test_animation_rect(0, 25, 480, 1055), &placement);
+    TEST_CHECK(plan.is_two_phase, true);
+    TEST_CHECK(plan.slide == 0.4f, true);
+    TEST_CHECK(fabsf(animation_plan_opacity(&plan, 0.0f) - 0.8f) < 0.0001f, true);
+    TEST_CHECK(fabsf(animation_plan_opacity(&plan, 0.5f) - 0.4f) < 0.0001f, true);
+    TEST_CHECK(fabsf(animation_plan_opacity(&plan, 1.0f) - 0.8f) < 0.0001f, true);
+
+    animation_plan_create(&plan, &planner, test_animation_rect(0, 25, 960, 1055), test_animation_rect(0, 25, 900, 1055), &placement);
+    TEST_CHECK(plan.is_two_phase, false);
+    TEST_CHECK(animation_plan_opacity(&plan, 0.5f) == 0.8f, true);
+});
+
+static void test_animation_governor_flush(struct animation_governor *governor, float frame_ms, float prep_ms)
+{
+    for (int i = 0; i < ANIMATION_GOVERNOR_MIN_FRAMES; ++i) {
+        animation_governor_record_frame(governor, frame_ms, 16.666f);
+    }
+    animation_governor_record_prep(governor, prep_ms);
+}
+
+TEST_FUNC(animation_governor_steps_with_hysteresis,
+{
+    struct animation_governor governor;
+    animation_governor_init(&governor);
+
+    TEST_CHECK(animation_governor_update(&governor, 4), ANIMATION_QUALITY_full);
+    TEST_CHECK(animation_governor_update(&governor, 9), ANIMATION_QUALITY_no_blur);
+    TEST_CHECK(animation_governor_update(&governor, 40), ANIMATION_QUALITY_simplified);
+    TEST_CHECK(animation_governor_update(&governor, 500), ANIMATION_QUALITY_fast);
+    TEST_CHECK(governor.load_tier, ANIMATION_QUALITY_full);
+
+    test_animation_governor_flush(&governor, 15.0f, 5.0f);
+    TEST_CHECK(animation_governor_update(&governor, 2), ANIMATION_QUALITY_no_blur);
+    TEST_CHECK(governor.frame_count, 0);
+
+    animation_governor_record_prep(&governor, 80.0f);
+    TEST_CHECK(animation_governor_update(&governor, 2), ANIMATION_QUALITY_reduced);
+
+    test_animation_governor_flush(&governor, 10.0f, 10.0f);
+    TEST_CHECK(animation_governor_update(&governor, 2), ANIMATION_QUALITY_reduced);
+
+    for (int i = 0; i < ANIMATION_GOVERNOR_CALM_FLUSHES - 1; ++i) {
+        test_animation_governor_flush(&governor, 2.0f, 5.0f);
+        TEST_CHECK(animation_governor_update(&governor, 2), ANIMATION_QUALITY_reduced);
+    }
+
+    test_animation_governor_flush(&governor, 2.0f, 5.0f);
+    TEST_CHECK(animation_governor_update(&governor, 2), ANIMATION_QUALITY_no_blur);
+    TEST_CHECK(governor.step_down_count, 2);
+    TEST_CHECK(governor.step_up_count, 1);
+});
+
+TEST_FUNC(animation_quality_tiers_only_turn_features_off,
+{
+    struct animation_quality config;
+    struct animation_quality quality;
+    memset(&config, 0, sizeof(struct animation_quality));
+    config.is_blur_enabled = true;
+    config.is_shadows_enabled = true;
+    config.is_two_phase_enabled = true;
+
+    animation_quality_for_tier(&quality, &config, ANIMATION_QUALITY_full);
+    TEST_CHECK(memcmp(&quality, &config, sizeof(struct animation_quality)), 0);
+
+    animation_quality_for_tier(&quality, &config, ANIMATION_QUALITY_reduced);
+    TEST_CHECK(quality.is_blur_enabled, false);
+    TEST_CHECK(quality.is_shadows_enabled, false);
+    TEST_CHECK(quality.is_reduced_resolution, true);
+    TEST_CHECK(quality.is_two_phase_enabled, true);
+
+    animation_quality_for_tier(&quality, &config, ANIMATION_QUALITY_simplified);
+    TEST_CHECK(quality.is_simplified_easing, true);
+    TEST_CHECK(quality.is_two_phase_enabled, false);
+    TEST_CHECK(quality.is_fast_mode, false);
+
+    config.is_fast_mode = true;
+    animation_quality_for_tier(&quality, &config, ANIMATION_QUALITY_full);
+    TEST_CHECK(quality.is_blur_enabled, false);
+    TEST_CHECK(quality.is_simplified_easing, true);
+});
@@ -0,0 +1,70 @@
+TEST_FUNC(animation_sim_matches_golden_trace,
+{
+    struct animation_sim sim;
+    test_animation_sim_golden_scene(&sim);
+
+    TEST_CHECK(animation_sim_run(&sim), 7);
+    TEST_CHECK(sim.trace.entry_count, array_count(test_animation_sim_golden));
+    TEST_CHECK(test_animation_sim_compare(&sim, test_animation_sim_golden, array_count(test_animation_sim_golden)), 0);
+
+    animation_sim_destroy(&sim);
+});
+
+//
+// NOTE: Every window starts out at the size its proxy was captured at and ends
+// up exactly where it was retiled to, for any number of windows.
+//
+
+static int test_animation_sim_window_count_list[] = { 1, 3, 4, 17, 64, 255, 500 };
+
+static int test_animation_sim_check_endpoints(struct animation_sim *sim, int frame_count)
+{
+    int mismatch = 0;
+
+    for (int i = 0; i < sim->count; ++i) {
+        struct animation_plan *plan = &sim->plan_list[i];
+        struct animation_trace_entry *first = animation_sim_find(sim, 0, sim->id_list[i]);
+        struct animation_trace_entry *last = animation_sim_find(sim, frame_count - 1, sim->id_list[i]);
+        if (!first || !last) { ++mismatch; continue; }
+
+        float sx = plan->start.w / plan->end.w;
+        float sy = plan->start.h / plan->end.h;
+
+        mismatch += !test_animation_sim_near(first->transform.a, 1.0f) || !test_animation_sim_near(first->transform.d, 1.0f);
+        mismatch += !test_animation_sim_near(first->transform.tx, -plan->start.x) || !test_animation_sim_near(first->transform.ty, -plan->start.y);
+        mismatch += !test_animation_sim_near(last->transform.a, sx) || !test_animation_sim_near(last->transform.d, sy);
+        mismatch += !test_animation_sim_near(last->transform.tx, -plan->end.x * sx) || !test_animation_sim_near(last->transform.ty, -plan->end.y * sy);
+    }
+
+    return mismatch;
+}
+
+static void test_animation_sim_fill(struct animation_sim *sim, struct animation_planner *planner, struct animation_placement *placement, int window_count)
+{
+    for (int i = 0; i < window_count; ++i) {
+        struct animation_rect start = test_animation_rect(2.0f * (i % 500), 25.0f + (i % 300), 200.0f + (i % 700), 100.0f + (i % 400));
+        struct animation_rect end = test_animation_rect(1700.0f - 3.0f * (i % 500), 25.0f + (i % 250), 150.0f + (i % 70), 300.0f + (i % 400));
+        test_animation_sim_add(sim, planner, placement, 100 + i, start, end);
+    }
+}
+
+TEST_FUNC(animation_sim_runs_1_to_500_windows,
+{
+    struct animation_planner planner = test_animation_planner();
+
+    for (int c = 0; c < array_count(test_animation_sim_window_count_list); ++c) {
+        int window_count = test_animation_sim_window_count_list[c];
+        struct animation_placement placement = test_animation_placement(c % 2 ? SPLIT_X : SPLIT_Y, window_count);
+
+        struct animation_sim sim;
+        animation_sim_init(&sim, 0.25f, 120.0f);
+        test_animation_sim_fill(&sim, &planner, &placement, window_count);
+
+        int frame_count = animation_sim_run(&sim);
+        TEST_CHECK(frame_count, 31);
+        TEST_CHECK(sim.trace.entry_count, frame_count * window_count);
+        TEST_CHECK(test_animation_sim_check_endpoints(&sim, frame_count), 0);
+
+        animation_sim_destroy(&sim);
+    }
+});
@@ -0,0 +1,95 @@
+//
+// NOTE: The trace of three windows being retiled at 60hz for 0.1 seconds with
+// ease_out_cubic: two windows that are resized by the two-phase animation with
+// a fade, and one that moves to another display. Regenerate it with
+// animation_sim_serialize when the animation math is meant to change. It only
+// depends on the animation core, so that the tests and the animation benchmark
+// can both compare against it.
+//
+
+static struct animation_trace_entry test_animation_sim_golden[] =
+{
+    {  0, 1, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, 0.0000f, -25.0000f }, 0.8000f },
+    {  0, 2, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -960.0000f, -25.0000f }, 0.8000f },
+    {  0, 3, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -100.0000f, -100.0000f }, 0.8000f },
+    {  1, 1, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, 0.0000f, -25.0000f }, 0.5778f },
+    {  1, 2, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -960.0000f, -25.0000f }, 0.5778f },
+    {  1, 3, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -553.1541f, -326.5771f }, 0.8000f },
+    {  2, 1, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, 0.0000f, -25.0000f }, 0.4000f },
+    {  2, 2, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -960.0000f, -25.0000f }, 0.4000f },
+    {  2, 3, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -1058.2952f, -579.1476f }, 0.8000f },
+    {  3, 1, { 1.0093f, 0.0000f, 0.0000f, 1.0000f, 0.0000f, -25.0000f }, 0.4000f },
+    {  3, 2, { 1.0000f, 0.0000f, 0.0000f, 1.0094f, -960.0000f, -35.1032f }, 0.4000f },
+    {  3, 3, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -1254.3278f, -677.1639f }, 0.8000f },
+    {  4, 1, { 1.2130f, 0.0000f, 0.0000f, 1.0000f, 0.0000f, -25.0000f }, 0.4000f },
+    {  4, 2, { 1.0000f, 0.0000f, 0.0000f, 1.2132f, -960.0000f, -255.2812f }, 0.4000f },
+    {  4, 3, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -1295.9430f, -697.9715f }, 0.8000f },
+    {  5, 1, { 1.8421f, 0.0000f, 0.0000f, 1.0000f, 0.0000f, -25.0000f }, 0.5778f },
+    {  5, 2, { 1.0000f, 0.0000f, 0.0000f, 1.8435f, -960.0000f, -936.0269f }, 0.5778f },
+    {  5, 3, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -1299.9365f, -699.9683f }, 0.8000f },
+    {  6, 1, { 2.0000f, 0.0000f, 0.0000f, 1.0000f, 0.0000f, -25.0000f }, 0.8000f },
+    {  6, 2, { 1.0000f, 0.0000f, 0.0000f, 2.0019f, -960.0000f, -1107.0493f }, 0.8000f },
+    {  6, 3, { 1.0000f, 0.0000f, 0.0000f, 1.0000f, -1300.0000f, -700.0000f }, 0.8000f }
+};
+
+static void test_animation_sim_add(struct animation_sim *sim, struct animation_planner *planner, struct animation_placement *placement, uint32_t id, struct animation_rect start, struct animation_rect end)
+{
+    struct animation_plan plan;
+    animation_plan_create(&plan, planner, start, end, placement);
+    animation_sim_add(sim, id, &plan, ease_out_cubic_type);
+}
+
+static void test_animation_sim_golden_scene(struct animation_sim *sim)
+{
+    struct animation_planner planner = {
+        .edge_threshold       = 5.0f,
+        .is_two_phase_enabled = true,
+        .slide_ratio          = 0.4f,
+        .is_fade_enabled      = true,
+        .fade_threshold       = 0.3f,
+        .fade_intensity       = 0.5f
+    };
+
+    struct animation_placement placement = {
+        .screen       = { 0.0f, 25.0f, 1920.0f, 1055.0f },
+        .bounds       = { 0.0f, 25.0f, 1920.0f, 1055.0f },
+        .parent_split = SPLIT_X,
+        .window_count = 3,
+        .alpha        = 0.8f
+    };
+
+    animation_sim_init(sim, 0.1f, 60.0f);
+    test_animation_sim_add(sim, &planner, &placement, 1, (struct animation_rect) { 0, 25, 1920, 1055 }, (struct animation_rect) { 0, 25, 960, 1055 });
+    test_animation_sim_add(sim, &planner, &placement, 2, (struct animation_rect) { 960, 25, 960, 1055 }, (struct animation_rect) { 960, 553, 960, 527 });
+    test_animation_sim_add(sim, &planner, &placement, 3, (struct animation_rect) { 100, 100, 400, 300 }, (struct animation_rect) { 1300, 700, 400, 300 });
+}
+
+static bool test_animation_sim_near(float value, float expected)
+{
+    return fabsf(value - expected) <= 0.001f * fmaxf(1.0f, fabsf(expected));
+}
+
+static bool test_animation_sim_entry_matches(struct animation_trace_entry *entry, struct animation_trace_entry *golden)
+{
+    return entry->frame == golden->frame && entry->id == golden->id &&
+           test_animation_sim_near(entry->transform.a, golden->transform.a) &&
+           test_animation_sim_near(entry->transform.b, golden->transform.b) &&
+           test_animation_sim_near(entry->transform.c, golden->transform.c) &&
+           test_animation_sim_near(entry->transform.d, golden->transform.d) &&
+           test_animation_sim_near(entry->transform.tx, golden->transform.tx) &&
+           test_animation_sim_near(entry->transform.ty, golden->transform.ty) &&
+           test_animation_sim_near(entry->alpha, golden->alpha);
+}
+
+static int test_animation_sim_compare(struct animation_sim *sim, struct animation_trace_entry *golden, int golden_count)
+{
+    for (int i = 0; i < sim->trace.entry_count && i < golden_count; ++i) {
+        if (!test_animation_sim_entry_matches(&sim->trace.entry_list[i], &golden[i])) {
+            printf("                   trace entry %d differs from the golden trace:\n", i);
+            animation_sim_serialize(stdout, sim);
+            return 1;
+        }
+    }
+
+    return 0;
+}
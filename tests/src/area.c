@@ -1,7 +1,7 @@
 struct test_area
 {
     struct area area;
-    CGPoint area_max;
+    struct area_point area_max;
 };
 
 static inline void init_test_display_list(struct test_area display_list[3])
@@ -87,3 +87,90 @@ TEST_FUNC(closest_display_in_direction,
     best_index = closest_display_in_direction(display_list, array_count(display_list), 2, DIR_EAST);
     TEST_CHECK(best_index, -1);
 });
+
+struct test_rank_list
+{
+    uint32_t *window_list;
+    int window_count;
+};
+
+static int test_area_rank(void *context, uint32_t window_id)
+{
+    struct test_rank_list *rank_list = context;
+    return window_manager_find_rank_of_window_in_list(window_id, rank_list->window_list, rank_list->window_count);
+}
+
+TEST_FUNC(area_index_matches_linear_search,
+{
+    int leaf_count = 1;
+    int window_count = 0;
+    int mismatch_count = 0;
+    int found_count = 0;
+    uint32_t seed = 1;
+
+    struct layout_pool pool;
+    layout_pool_init(&pool);
+
+    struct layout_config config;
+    memset(&config, 0, sizeof(struct layout_config));
+    config.split_type = SPLIT_AUTO;
+    config.child = CHILD_SECOND;
+    config.split_ratio = 0.5f;
+
+    struct layout_index index;
+    memset(&index, 0, sizeof(struct layout_index));
+
+    struct window_node *leaf_list[96];
+    uint32_t window_list[96];
+
+    struct window_node *root = window_node_create(&pool, true);
+    root->area = area_from_cgrect(CGRectMake(0, 0, 2560, 1440));
+    root->window_list[0] = root->window_order[0] = 1;
+    root->window_count = 1;
+    leaf_list[0] = root;
+
+    //
+    // NOTE: Most splits are even, which lines up a lot of edges and produces
+    // ties that have to be broken by the window order.
+    //
+
+    while (leaf_count < array_count(leaf_list)) {
+        seed = seed * 1103515245 + 12345;
+        int i = (seed >> 16) % leaf_count;
+
+        struct window_node *leaf = leaf_list[i];
+        if ((seed >> 8) % 4 == 0) leaf->ratio = 0.3f;
+
+        window_node_split(&pool, &config, leaf, leaf_count + 1, NULL);
+        leaf_list[i] = leaf->left;
+        leaf_list[leaf_count++] = leaf->right;
+    }
+
+    layout_update(&config, root);
+
+    int leaf_index = 0;
+    for (struct window_node *node = window_node_find_last_leaf(root); node; node = window_node_find_prev_leaf(node)) {
+        if (leaf_index++ % 3 != 2) window_list[window_count++] = node->window_order[0];
+    }
+
+    struct test_rank_list rank_list;
+    rank_list.window_list = window_list;
+    rank_list.window_count = window_count;
+
+    for (int i = 0; i < leaf_count; ++i) {
+        for (int direction = DIR_EAST; direction <= DIR_NORTH; direction += 90) {
+            struct window_node *linear = window_node_find_in_direction(root, leaf_list[i], direction, window_list, window_count);
+            struct window_node *indexed = layout_index_find_in_direction(&index, root, leaf_list[i], direction, test_area_rank, &rank_list);
+
+            if (linear != indexed) ++mismatch_count;
+            if (linear) ++found_count;
+        }
+    }
+
+    TEST_CHECK(mismatch_count, 0);
+    TEST_CHECK(found_count > 0, true);
+    TEST_CHECK(index.count, leaf_count);
+
+    layout_index_destroy(&index);
+    layout_pool_destroy(&pool);
+});
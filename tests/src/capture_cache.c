@@ -0,0 +1,108 @@
+static CGImageRef test_capture_cache_image(int width, int height)
+{
+    CGColorSpaceRef color_space = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(NULL, width, height, 8, 0, color_space, kCGImageAlphaPremultipliedFirst);
+    CGImageRef image = CGBitmapContextCreateImage(context);
+    CGContextRelease(context);
+    CGColorSpaceRelease(color_space);
+    return image;
+}
+
+static bool test_capture_cache_has(struct capture_cache *cache, uint32_t wid)
+{
+    CGImageRef image = capture_cache_find(cache, wid, 1, 1.0f, 64, 64);
+    if (image) CFRelease(image);
+    return image != NULL;
+}
+
+TEST_FUNC(capture_cache_evicts_least_recently_used,
+{
+    CGImageRef image = test_capture_cache_image(64, 64);
+    uint64_t size = (uint64_t) CGImageGetBytesPerRow(image) * (uint64_t) CGImageGetHeight(image);
+
+    struct capture_cache cache;
+    capture_cache_init(&cache, 3 * size);
+
+    capture_cache_store(&cache, 1, 1, 1.0f, 64, 64, image);
+    capture_cache_store(&cache, 2, 1, 1.0f, 64, 64, image);
+    capture_cache_store(&cache, 3, 1, 1.0f, 64, 64, image);
+    TEST_CHECK(cache.count, 3);
+    TEST_CHECK(cache.size == 3 * size, true);
+    TEST_CHECK(cache.head->wid, 3);
+    TEST_CHECK(cache.tail->wid, 1);
+
+    //
+    // NOTE: A hit moves the entry to the front, so the entry that has gone
+    // unused the longest is the one evicted once the budget is exceeded.
+    //
+
+    TEST_CHECK(test_capture_cache_has(&cache, 1), true);
+    TEST_CHECK(cache.head->wid, 1);
+    TEST_CHECK(cache.tail->wid, 2);
+
+    capture_cache_store(&cache, 4, 1, 1.0f, 64, 64, image);
+    TEST_CHECK(cache.count, 3);
+    TEST_CHECK(cache.size == 3 * size, true);
+    TEST_CHECK(cache.evict_count == 1, true);
+    TEST_CHECK(cache.head->wid, 4);
+    TEST_CHECK(cache.tail->wid, 3);
+
+    TEST_CHECK(test_capture_cache_has(&cache, 2), false);
+    TEST_CHECK(test_capture_cache_has(&cache, 3), true);
+    TEST_CHECK(test_capture_cache_has(&cache, 1), true);
+    TEST_CHECK(test_capture_cache_has(&cache, 4), true);
+
+    //
+    // NOTE: Storing a window again replaces its entry instead of evicting
+    // another one, and an image larger than the whole budget is not kept.
+    //
+
+    capture_cache_store(&cache, 1, 2, 1.0f, 64, 64, image);
+    TEST_CHECK(cache.count, 3);
+    TEST_CHECK(cache.evict_count == 1, true);
+
+    CGImageRef large = test_capture_cache_image(256, 256);
+    capture_cache_store(&cache, 5, 1, 1.0f, 256, 256, large);
+    TEST_CHECK(cache.count, 3);
+    TEST_CHECK(cache.evict_count == 1, true);
+    CFRelease(large);
+
+    capture_cache_destroy(&cache);
+    CFRelease(image);
+});
+
+TEST_FUNC(capture_cache_rejects_stale_entries,
+{
+    CGImageRef image = test_capture_cache_image(64, 64);
+
+    struct capture_cache cache;
+    capture_cache_init(&cache, CAPTURE_CACHE_BUDGET);
+
+    capture_cache_store(&cache, 1, 1, 1.0f, 64, 64, image);
+    TEST_CHECK(test_capture_cache_has(&cache, 1), true);
+
+    //
+    // NOTE: A window that was resized without an event saying so keeps its
+    // content generation, so the size is all that tells its entry apart.
+    //
+
+    CGImageRef result = capture_cache_find(&cache, 1, 1, 1.0f, 64, 48);
+    TEST_CHECK(result == NULL, true);
+    TEST_CHECK(cache.count, 0);
+
+    capture_cache_store(&cache, 1, 1, 1.0f, 64, 64, image);
+    result = capture_cache_find(&cache, 1, 2, 1.0f, 64, 64);
+    TEST_CHECK(result == NULL, true);
+    TEST_CHECK(cache.count, 0);
+
+    capture_cache_store(&cache, 1, 1, 1.0f, 64, 64, image);
+    result = capture_cache_find(&cache, 1, 1, 0.5f, 64, 64);
+    TEST_CHECK(result == NULL, true);
+    TEST_CHECK(cache.count, 0);
+
+    TEST_CHECK(cache.hit_count == 1, true);
+    TEST_CHECK(cache.miss_count == 3, true);
+
+    capture_cache_destroy(&cache);
+    CFRelease(image);
+});
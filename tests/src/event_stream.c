@@ -0,0 +1,89 @@
+static void test_event_stream_push_spaces(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        event_stream_push(SIGNAL_SPACE_CREATED, (void *)(uintptr_t)(1000 + i));
+    }
+}
+
+//
+// NOTE: Reads everything that the subscriber has been sent so far, flushing
+// the subscriber whenever the socket has been drained, and stops once its
+// buffer is empty and no resync is pending.
+//
+
+static char *test_event_stream_drain(int sockfd, struct event_stream_subscriber *subscriber)
+{
+    char *data = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&data, &size);
+    char buffer[4096];
+
+    for (int i = 0; i < 10000; ++i) {
+        event_stream_flush();
+
+        ssize_t bytes_read;
+        while ((bytes_read = read(sockfd, buffer, sizeof(buffer))) > 0) {
+            fwrite(buffer, 1, bytes_read, out);
+        }
+
+        if (subscriber->buffer_used == 0 && !subscriber->needs_resync) break;
+    }
+
+    fclose(out);
+    return data;
+}
+
+TEST_FUNC(event_stream_resyncs_and_drops_slow_subscribers,
+{
+    int sockfd[2];
+    TEST_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, sockfd), 0);
+    fcntl(sockfd[0], F_SETFL, O_NONBLOCK | fcntl(sockfd[0], F_GETFL));
+
+    TEST_CHECK(event_stream_add_subscriber(sockfd[1], EVENT_STREAM_DOMAIN_SPACES, SERIALIZER_FORMAT_JSON), true);
+    TEST_CHECK(buf_len(g_event_stream.subscribers), 1);
+    struct event_stream_subscriber *subscriber = &g_event_stream.subscribers[0];
+
+    //
+    // NOTE: Nothing is written until the subscriber is flushed, so pushing
+    // records past the size of its buffer has it discard the rest.
+    //
+
+    test_event_stream_push_spaces(4000);
+    TEST_CHECK(subscriber->needs_resync, true);
+    TEST_CHECK(subscriber->buffer_used <= EVENT_STREAM_BUFFER_SIZE, true);
+    TEST_CHECK(subscriber->buffer_used > EVENT_STREAM_BUFFER_SIZE - KILOBYTES(1), true);
+
+    int buffered = subscriber->buffer_used;
+    test_event_stream_push_spaces(1);
+    TEST_CHECK(subscriber->buffer_used, buffered);
+
+    char *data = test_event_stream_drain(sockfd[0], subscriber);
+    TEST_CHECK(buf_len(g_event_stream.subscribers), 1);
+    TEST_CHECK(subscriber->needs_resync, false);
+    TEST_CHECK(strstr(data, "\"event\":\"space_created\"") != NULL, true);
+    TEST_CHECK(strstr(data, "\"event\":\"resync\"") != NULL, true);
+    TEST_CHECK(strstr(data, "\"id\":4000") == NULL, true);
+    free(data);
+
+    //
+    // NOTE: A subscriber that stops reading is dropped once its socket has been
+    // full for EVENT_STREAM_MAX_STALLED flushes in a row.
+    //
+
+    int flush_count = 0;
+    while (buf_len(g_event_stream.subscribers) && flush_count < 100000) {
+        test_event_stream_push_spaces(16);
+        event_stream_flush();
+        ++flush_count;
+    }
+
+    TEST_CHECK(buf_len(g_event_stream.subscribers), 0);
+    TEST_CHECK(flush_count >= EVENT_STREAM_MAX_STALLED, true);
+
+    char buffer[4096];
+    while (read(sockfd[0], buffer, sizeof(buffer)) > 0);
+    TEST_CHECK(read(sockfd[0], buffer, sizeof(buffer)), 0);
+
+    close(sockfd[0]);
+    g_event_stream.flush_scheduled = false;
+});
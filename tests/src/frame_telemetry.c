@@ -0,0 +1,49 @@
+TEST_FUNC(frame_histogram_percentiles_follow_buckets,
+{
+    struct frame_histogram histogram;
+    memset(&histogram, 0, sizeof(struct frame_histogram));
+
+    for (int i = 0; i < 90; ++i) frame_histogram_add(&histogram, frame_time_bounds, 700);
+    for (int i = 0; i < 9; ++i)  frame_histogram_add(&histogram, frame_time_bounds, 9000);
+    frame_histogram_add(&histogram, frame_time_bounds, 250000);
+
+    TEST_CHECK(histogram.count, 100);
+    TEST_CHECK(histogram.max, 250000);
+    TEST_CHECK(histogram.bucket[2], 90);
+    TEST_CHECK(histogram.bucket[6], 9);
+    TEST_CHECK(histogram.bucket[FRAME_HISTOGRAM_BUCKET_COUNT - 1], 1);
+
+    TEST_CHECK(frame_histogram_percentile(&histogram, frame_time_bounds, 0.50f), 1000);
+    TEST_CHECK(frame_histogram_percentile(&histogram, frame_time_bounds, 0.95f), 16666);
+    TEST_CHECK(frame_histogram_percentile(&histogram, frame_time_bounds, 0.99f), 16666);
+    TEST_CHECK(frame_histogram_percentile(&histogram, frame_time_bounds, 1.00f), 250000);
+});
+
+TEST_FUNC(frame_telemetry_counts_missed_frames_per_profile,
+{
+    struct frame_telemetry telemetry;
+    frame_telemetry_init(&telemetry);
+
+    struct frame_sample sample;
+    memset(&sample, 0, sizeof(struct frame_sample));
+    sample.profile   = FRAME_PROFILE_BLUR | FRAME_PROFILE_TWO_PHASE;
+    sample.cpu_ns    = 1500000;
+    sample.commit_ns = 300000;
+
+    sample.slack_ns = 4000000;
+    frame_telemetry_record_frame(&telemetry, &sample);
+    sample.slack_ns = -2500000;
+    frame_telemetry_record_frame(&telemetry, &sample);
+    frame_telemetry_record_animation(&telemetry, sample.profile, 1);
+
+    struct frame_profile *profile = &telemetry.profile[FRAME_PROFILE_BLUR | FRAME_PROFILE_TWO_PHASE];
+    TEST_CHECK(profile->frame_count, 2);
+    TEST_CHECK(profile->missed_frame_count, 1);
+    TEST_CHECK(profile->animation_count, 1);
+    TEST_CHECK(profile->cpu.bucket[3], 2);
+    TEST_CHECK(profile->commit.bucket[1], 2);
+    TEST_CHECK(profile->slack.max, 4000);
+    TEST_CHECK(profile->late.max, 2500);
+    TEST_CHECK(profile->missed_per_animation.bucket[1], 1);
+    TEST_CHECK(telemetry.profile[0].frame_count, 0);
+});
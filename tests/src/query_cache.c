@@ -0,0 +1,70 @@
+static int test_query_cache_serialize_count;
+
+static void test_query_cache_serialize_object(struct query_cache *cache, struct serializer *s, uint64_t id, uint32_t generation)
+{
+    if (query_cache_emit(cache, s, QUERY_CACHE_DOMAIN_WINDOW, id, generation, 0x3)) return;
+
+    struct query_cache_capture capture;
+    struct serializer *out = query_cache_begin(&capture, s, QUERY_CACHE_DOMAIN_WINDOW, id, 0x3);
+
+    ++test_query_cache_serialize_count;
+    serializer_begin_object(out, 2);
+    serializer_key(out, "id");    serializer_uint(out, id);
+    serializer_key(out, "frame"); serializer_frame(out, CGRectMake(id, 0, 100, 50));
+    serializer_end_object(out);
+
+    query_cache_end(cache, &capture, generation);
+}
+
+static char *test_query_cache_serialize_list(struct query_cache *cache, uint32_t *generation, int count, enum serializer_format format)
+{
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *rsp = open_memstream(&buffer, &size);
+
+    struct serializer s = serializer_create(rsp, format);
+    serializer_begin_array(&s, count);
+    for (int i = 0; i < count; ++i) {
+        test_query_cache_serialize_object(cache, &s, 100 + i, generation[i]);
+    }
+    serializer_end_array(&s);
+    serializer_end(&s);
+
+    fclose(rsp);
+    return buffer;
+}
+
+TEST_FUNC(query_cache_reuses_fragments_until_invalidated,
+{
+    struct query_cache cache;
+    query_cache_init(&cache);
+
+    uint32_t generation[3] = {0};
+    test_query_cache_serialize_count = 0;
+
+    char *first = test_query_cache_serialize_list(&cache, generation, 3, SERIALIZER_FORMAT_JSON);
+    TEST_CHECK(test_query_cache_serialize_count, 3);
+
+    char *second = test_query_cache_serialize_list(&cache, generation, 3, SERIALIZER_FORMAT_JSON);
+    TEST_CHECK(test_query_cache_serialize_count, 3);
+    TEST_CHECK(strcmp(first, second), 0);
+
+    ++generation[1];
+    char *third = test_query_cache_serialize_list(&cache, generation, 3, SERIALIZER_FORMAT_JSON);
+    TEST_CHECK(test_query_cache_serialize_count, 4);
+    TEST_CHECK(strcmp(first, third), 0);
+
+    char *msgpack = test_query_cache_serialize_list(&cache, generation, 3, SERIALIZER_FORMAT_MSGPACK);
+    TEST_CHECK(test_query_cache_serialize_count, 7);
+
+    query_cache_invalidate_all(&cache);
+    char *fourth = test_query_cache_serialize_list(&cache, generation, 3, SERIALIZER_FORMAT_JSON);
+    TEST_CHECK(test_query_cache_serialize_count, 10);
+    TEST_CHECK(strcmp(first, fourth), 0);
+
+    free(first);
+    free(second);
+    free(third);
+    free(msgpack);
+    free(fourth);
+});
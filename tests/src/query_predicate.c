@@ -0,0 +1,52 @@
+static void test_query_predicate_serialize_window(struct serializer *s)
+{
+    serializer_begin_object(s, 6);
+    serializer_key(s, "app");         serializer_string(s, "Google Chrome");
+    serializer_key(s, "title");       serializer_string(s, "yabai - GitHub");
+    serializer_key(s, "frame");       serializer_frame(s, CGRectMake(0, 25, 1280, 775));
+    serializer_key(s, "stack-index"); serializer_int(s, 2);
+    serializer_key(s, "is-floating"); serializer_bool(s, true);
+    serializer_key(s, "opacity");     serializer_float(s, 0.9f, 4);
+    serializer_end_object(s);
+}
+
+static int test_query_predicate_eval(char *expression)
+{
+    struct query_predicate predicate;
+    if (!query_predicate_parse(&predicate, expression, window_property_str, window_property_val, array_count(window_property_str))) return -1;
+
+    struct query_predicate_capture capture;
+    query_predicate_begin(&capture);
+    test_query_predicate_serialize_window(&capture.s);
+    bool result = query_predicate_end(&predicate, &capture);
+
+    query_predicate_destroy(&predicate);
+    return result;
+}
+
+TEST_FUNC(query_predicate_evaluates_expressions,
+{
+    TEST_CHECK(test_query_predicate_eval("app==\"Google Chrome\""), 1);
+    TEST_CHECK(test_query_predicate_eval("app=='Safari'"), 0);
+    TEST_CHECK(test_query_predicate_eval("app!=Safari && is-floating"), 1);
+    TEST_CHECK(test_query_predicate_eval("!is-floating || stack-index>2"), 0);
+    TEST_CHECK(test_query_predicate_eval("stack-index>=2 && stack-index<3"), 1);
+    TEST_CHECK(test_query_predicate_eval("title=~'^yabai' && title!~Safari"), 1);
+    TEST_CHECK(test_query_predicate_eval("frame.w==1280 && frame.y<=25"), 1);
+    TEST_CHECK(test_query_predicate_eval("(app==Safari || app=~Chrome) && is-floating==true"), 1);
+    TEST_CHECK(test_query_predicate_eval("has-focus"), 0);
+    TEST_CHECK(test_query_predicate_eval("opacity==0.9"), 1);
+    TEST_CHECK(test_query_predicate_eval("opacity!=0.9"), 0);
+    TEST_CHECK(test_query_predicate_eval("opacity<=0.9 && opacity>=0.9"), 1);
+    TEST_CHECK(test_query_predicate_eval("opacity<0.9 || opacity>0.9"), 0);
+});
+
+TEST_FUNC(query_predicate_rejects_invalid_expressions,
+{
+    TEST_CHECK(test_query_predicate_eval("unknown-property==1"), -1);
+    TEST_CHECK(test_query_predicate_eval("app=="), -1);
+    TEST_CHECK(test_query_predicate_eval("(app==Safari"), -1);
+    TEST_CHECK(test_query_predicate_eval("app==Safari is-floating"), -1);
+    TEST_CHECK(test_query_predicate_eval("title=~'('"), -1);
+    TEST_CHECK(test_query_predicate_eval("app=='Safari"), -1);
+});
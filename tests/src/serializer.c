@@ -0,0 +1,282 @@
+struct test_window_record
+{
+    uint32_t id;
+    int pid;
+    char *app;
+    char *title;
+    CGRect frame;
+    int display;
+    int space;
+    int level;
+    float opacity;
+    int stack_index;
+    bool has_focus;
+    bool is_visible;
+    bool is_floating;
+};
+
+static inline void test_window_record_serialize(struct serializer *s, struct test_window_record *record)
+{
+    serializer_begin_object(s, 15);
+    serializer_key(s, "id");          serializer_int(s, record->id);
+    serializer_key(s, "pid");         serializer_int(s, record->pid);
+    serializer_key(s, "app");         serializer_string(s, record->app);
+    serializer_key(s, "title");       serializer_string(s, record->title);
+    serializer_key(s, "frame");       serializer_frame(s, record->frame);
+    serializer_key(s, "role");        serializer_string(s, "AXWindow");
+    serializer_key(s, "subrole");     serializer_string(s, "AXStandardWindow");
+    serializer_key(s, "display");     serializer_int(s, record->display);
+    serializer_key(s, "space");       serializer_int(s, record->space);
+    serializer_key(s, "level");       serializer_int(s, record->level);
+    serializer_key(s, "opacity");     serializer_float(s, record->opacity, 4);
+    serializer_key(s, "stack-index"); serializer_int(s, record->stack_index);
+    serializer_key(s, "has-focus");   serializer_bool(s, record->has_focus);
+    serializer_key(s, "is-visible");  serializer_bool(s, record->is_visible);
+    serializer_key(s, "is-floating"); serializer_bool(s, record->is_floating);
+    serializer_end_object(s);
+}
+
+static inline struct test_window_record test_window_record_make(uint32_t id, int i)
+{
+    return (struct test_window_record) {
+        .id          = id,
+        .pid         = 400 + i / 8,
+        .app         = i % 3 ? "Safari" : "kitty",
+        .title       = i % 2 ? "yabai/src/view.c - Neovim" : "GitHub - koekeishiya/yabai: A tiling window manager for macOS",
+        .frame       = { { (i % 4) * 640.0f, (i % 3) * 480.0f + 25.0f }, { 639.5f, 479.25f } },
+        .display     = 1 + i % 2,
+        .space       = 1 + i % 9,
+        .level       = 0,
+        .opacity     = 1.0f,
+        .stack_index = i % 5,
+        .has_focus   = i == 0,
+        .is_visible  = i % 9 == 0,
+        .is_floating = i % 7 == 0
+    };
+}
+
+static inline size_t test_serialize_window_records(char **buffer, struct test_window_record *records, int count, enum serializer_format format)
+{
+    size_t size = 0;
+    FILE *rsp = open_memstream(buffer, &size);
+
+    struct serializer s = serializer_create(rsp, format);
+    serializer_begin_array(&s, count);
+    for (int i = 0; i < count; ++i) {
+        test_window_record_serialize(&s, &records[i]);
+    }
+    serializer_end_array(&s);
+    serializer_end(&s);
+
+    fclose(rsp);
+    return size;
+}
+
+//
+// NOTE: The parse functions below only walk the documents and decode every
+// scalar, which is roughly the minimum any consumer has to pay before it can
+// look at the data.
+//
+
+static int test_json_walk(char *cursor, char *end, double *sum)
+{
+    int scalars = 0;
+
+    while (cursor < end) {
+        char c = *cursor;
+
+        if (c == '"') {
+            for (++cursor; *cursor != '"'; ++cursor) {
+                if (*cursor == '\\') ++cursor;
+            }
+            ++cursor;
+            ++scalars;
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            *sum += strtod(cursor, &cursor);
+            ++scalars;
+        } else if (c == 't' || c == 'n') {
+            cursor += 4;
+            ++scalars;
+        } else if (c == 'f') {
+            cursor += 5;
+            ++scalars;
+        } else {
+            ++cursor;
+        }
+    }
+
+    return scalars;
+}
+
+static inline uint32_t test_msgpack_read_be(uint8_t **cursor, int size)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < size; ++i) result = (result << 8) | *(*cursor)++;
+    return result;
+}
+
+static int test_msgpack_walk(uint8_t **cursor, double *sum)
+{
+    uint8_t c = *(*cursor)++;
+
+    if (c <= 0x7f) {
+        *sum += c;
+        return 1;
+    } else if (c >= 0xe0) {
+        *sum += (int8_t) c;
+        return 1;
+    } else if ((c & 0xf0) == 0x80 || c == 0xde) {
+        int count = c == 0xde ? test_msgpack_read_be(cursor, 2) : c & 0x0f;
+        int scalars = 0;
+        for (int i = 0; i < 2*count; ++i) scalars += test_msgpack_walk(cursor, sum);
+        return scalars;
+    } else if ((c & 0xf0) == 0x90 || c == 0xdc) {
+        int count = c == 0xdc ? test_msgpack_read_be(cursor, 2) : c & 0x0f;
+        int scalars = 0;
+        for (int i = 0; i < count; ++i) scalars += test_msgpack_walk(cursor, sum);
+        return scalars;
+    } else if ((c & 0xe0) == 0xa0 || c == 0xd9) {
+        *cursor += c == 0xd9 ? test_msgpack_read_be(cursor, 1) : c & 0x1f;
+        return 1;
+    } else if (c == 0xc2 || c == 0xc3) {
+        return 1;
+    } else if (c == 0xca) {
+        uint32_t bits = test_msgpack_read_be(cursor, 4);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        *sum += value;
+        return 1;
+    } else if (c == 0xcc || c == 0xcd || c == 0xce) {
+        *sum += test_msgpack_read_be(cursor, 1 << (c - 0xcc));
+        return 1;
+    } else if (c == 0xd0 || c == 0xd1 || c == 0xd2) {
+        int size = 1 << (c - 0xd0);
+        uint32_t value = test_msgpack_read_be(cursor, size);
+        *sum += size == 1 ? (int8_t) value : size == 2 ? (int16_t) value : (int32_t) value;
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint8_t test_msgpack_expected[] =
+{
+    0x82,
+    0xa2, 'i', 'd', 0xcd, 0x01, 0x2c,
+    0xa4, 'l', 'i', 's', 't', 0x93, 0xff, 0xd0, 0x9c, 0xc3
+};
+
+TEST_FUNC(serializer_msgpack_encoding,
+{
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *rsp = open_memstream(&buffer, &size);
+
+    struct serializer s = serializer_create(rsp, SERIALIZER_FORMAT_MSGPACK);
+    serializer_begin_object(&s, 2);
+    serializer_key(&s, "id");
+    serializer_int(&s, 300);
+    serializer_key(&s, "list");
+    serializer_begin_array(&s, 3);
+    serializer_int(&s, -1);
+    serializer_int(&s, -100);
+    serializer_bool(&s, true);
+    serializer_end_array(&s);
+    serializer_end_object(&s);
+    serializer_end(&s);
+    fclose(rsp);
+
+    TEST_CHECK((int) size, (int) sizeof(test_msgpack_expected));
+    TEST_CHECK(memcmp(buffer, test_msgpack_expected, min(size, sizeof(test_msgpack_expected))), 0);
+
+    free(buffer);
+});
+
+TEST_FUNC(serializer_json_matches_legacy_output,
+{
+    struct test_window_record record = test_window_record_make(42, 0);
+    record.frame = CGRectMake(10, 20, 300.5f, 400);
+
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *rsp = open_memstream(&buffer, &size);
+
+    struct serializer s = serializer_create(rsp, SERIALIZER_FORMAT_JSON);
+    serializer_begin_array(&s, 2);
+    for (int i = 0; i < 2; ++i) {
+        serializer_begin_object(&s, 3);
+        serializer_key(&s, "id");    serializer_int(&s, record.id);
+        serializer_key(&s, "app");   serializer_string(&s, "Finder");
+        serializer_key(&s, "frame"); serializer_frame(&s, record.frame);
+        serializer_end_object(&s);
+    }
+    serializer_end_array(&s);
+    serializer_end(&s);
+    fclose(rsp);
+
+    char *object = "{\n\t\"id\":42,\n\t\"app\":\"Finder\",\n\t\"frame\":{\n\t\t\"x\":10.0000,\n\t\t\"y\":20.0000,\n\t\t\"w\":300.5000,\n\t\t\"h\":400.0000\n\t}\n}";
+    char expected[512];
+    snprintf(expected, sizeof(expected), "[%s,%s]\n", object, object);
+
+    TEST_CHECK(strcmp(buffer, expected), 0);
+
+    free(buffer);
+});
+
+TEST_FUNC(serializer_benchmark_500_windows,
+{
+    int count = 500;
+    int iterations = 20;
+    struct test_window_record *records = malloc(count * sizeof(struct test_window_record));
+
+    for (int i = 0; i < count; ++i) {
+        records[i] = test_window_record_make(1000 + i, i);
+    }
+
+    uint64_t cpu_freq = read_cpu_freq();
+
+    for (int format = SERIALIZER_FORMAT_JSON; format <= SERIALIZER_FORMAT_MSGPACK; ++format) {
+        uint64_t serialize_tsc = 0;
+        uint64_t parse_tsc = 0;
+        size_t size = 0;
+        int scalars = 0;
+        double sum = 0;
+
+        for (int i = 0; i < iterations; ++i) {
+            char *buffer = NULL;
+
+            uint64_t begin_tsc = read_cpu_timer();
+            size = test_serialize_window_records(&buffer, records, count, format);
+            uint64_t middle_tsc = read_cpu_timer();
+
+            if (format == SERIALIZER_FORMAT_JSON) {
+                scalars = test_json_walk(buffer, buffer + size, &sum);
+            } else {
+                uint8_t *cursor = (uint8_t *) buffer;
+                scalars = test_msgpack_walk(&cursor, &sum);
+            }
+
+            uint64_t end_tsc = read_cpu_timer();
+
+            serialize_tsc += middle_tsc - begin_tsc;
+            parse_tsc += end_tsc - middle_tsc;
+
+            free(buffer);
+        }
+
+        printf("                   %-8s %7zu bytes, serialize %.4fms, parse %.4fms (%d scalars)\n",
+               serializer_format_str[format], size,
+               1000.0 * (double) serialize_tsc / (double) cpu_freq / iterations,
+               1000.0 * (double) parse_tsc / (double) cpu_freq / iterations,
+               scalars);
+
+        //
+        // NOTE: every window contributes 15 keys + 14 scalar values + 4 keys
+        // and 4 values for the nested frame object.
+        //
+
+        TEST_CHECK(scalars, count * (15 + 14 + 4 + 4));
+    }
+
+    free(records);
+});
@@ -4,6 +4,8 @@ unsigned char __src_osax_loader[1];
 unsigned int __src_osax_loader_len;
 
 #include "../../src/manifest.m"
+#include "../../src/animation_sim.h"
+#include "../../src/animation_sim.c"
 
 #define TEST_SIG(name) bool test_##name(void)
 typedef TEST_SIG(function);
@@ -12,11 +14,54 @@ typedef TEST_SIG(function);
 #define TEST_CHECK(r, e) if ((r) != (e)) { printf("                   \e[1;33m%s\e[m\e[1;31m#%d %s == %s\e[m \e[1;31m(%d == %d)\e[m\n", test_name, __LINE__, #r, #e, r, e); result = false; }
 
 #include "area.c"
+#include "serializer.c"
+#include "query_cache.c"
+#include "event_stream.c"
+#include "window.c"
+#include "query_predicate.c"
+#include "view.c"
+#include "worker_pool.c"
+#include "capture_cache.c"
+#include "animation.c"
+#include "animation_sim_golden.c"
+#include "animation_sim.c"
+#include "frame_telemetry.c"
 
 #define TEST_ENTRY(name) { #name, test_##name },
-#define TEST_LIST                                              \
-    TEST_ENTRY(display_area_is_in_direction)                   \
-    TEST_ENTRY(closest_display_in_direction)
+#define TEST_LIST                                                \
+    TEST_ENTRY(display_area_is_in_direction)                     \
+    TEST_ENTRY(closest_display_in_direction)                     \
+    TEST_ENTRY(area_index_matches_linear_search)                 \
+    TEST_ENTRY(serializer_msgpack_encoding)                      \
+    TEST_ENTRY(serializer_json_matches_legacy_output)            \
+    TEST_ENTRY(serializer_benchmark_500_windows)                 \
+    TEST_ENTRY(query_cache_reuses_fragments_until_invalidated)   \
+    TEST_ENTRY(event_stream_resyncs_and_drops_slow_subscribers)  \
+    TEST_ENTRY(window_query_plan_minimal_fetches)                \
+    TEST_ENTRY(window_manager_drops_already_applied_frames)      \
+    TEST_ENTRY(query_predicate_evaluates_expressions)            \
+    TEST_ENTRY(query_predicate_rejects_invalid_expressions)      \
+    TEST_ENTRY(view_node_pool_reuses_storage)                    \
+    TEST_ENTRY(view_stack_grows_beyond_inline_slots)             \
+    TEST_ENTRY(view_benchmark_traversal_4096_leaves)             \
+    TEST_ENTRY(view_benchmark_single_resize_64_leaves)           \
+    TEST_ENTRY(view_scroll_moves_visible_columns_only)           \
+    TEST_ENTRY(view_snapshot_shares_unchanged_subtrees)          \
+    TEST_ENTRY(view_snapshot_encoding_round_trips)               \
+    TEST_ENTRY(view_min_size_sums_along_split_axis)              \
+    TEST_ENTRY(worker_pool_runs_every_task_once)                 \
+    TEST_ENTRY(capture_cache_evicts_least_recently_used)         \
+    TEST_ENTRY(capture_cache_rejects_stale_entries)              \
+    TEST_ENTRY(animation_kernel_matches_scalar_reference)        \
+    TEST_ENTRY(animation_plan_anchors_at_common_edges)           \
+    TEST_ENTRY(animation_plan_falls_back_to_parent_split)        \
+    TEST_ENTRY(animation_plan_two_phase_and_fade)                \
+    TEST_ENTRY(animation_governor_steps_with_hysteresis)         \
+    TEST_ENTRY(animation_quality_tiers_only_turn_features_off)   \
+    TEST_ENTRY(animation_sim_matches_golden_trace)               \
+    TEST_ENTRY(animation_sim_runs_1_to_500_windows)              \
+    TEST_ENTRY(frame_histogram_percentiles_follow_buckets)       \
+    TEST_ENTRY(frame_telemetry_counts_missed_frames_per_profile)
 
 static struct {
     char *name;
@@ -0,0 +1,521 @@
+static struct window_node *test_view_build_tree(struct view *view, struct window_node *parent, int depth, bool pooled, void **junk, int *junk_count)
+{
+    struct window_node *node;
+
+    if (pooled) {
+        node = window_node_create(&view->pool, depth == 0);
+    } else {
+        //
+        // NOTE: Interleave unrelated allocations of varying size, the way the
+        // rest of the daemon would between window creations, so that the nodes
+        // of the heap tree do not happen to end up next to each other.
+        //
+
+        node = malloc(sizeof(struct window_node));
+        memset(node, 0, sizeof(struct window_node));
+        window_node_set_stack(node, depth == 0 ? calloc(1, sizeof(struct window_node_stack)) : NULL);
+        junk[*junk_count] = malloc(96 + (*junk_count % 7) * 64);
+        ++*junk_count;
+    }
+
+    node->parent = parent;
+
+    if (depth > 0) {
+        node->ratio = 0.5f;
+        node->left  = test_view_build_tree(view, node, depth - 1, pooled, junk, junk_count);
+        node->right = test_view_build_tree(view, node, depth - 1, pooled, junk, junk_count);
+    }
+
+    return node;
+}
+
+static void test_view_free_heap_tree(struct window_node *node)
+{
+    if (node->left)  test_view_free_heap_tree(node->left);
+    if (node->right) test_view_free_heap_tree(node->right);
+
+    free(node->stack);
+    free(node);
+}
+
+static double test_view_sum_leaf_area(struct window_node *root, int *leaf_count)
+{
+    double sum = 0;
+    *leaf_count = 0;
+
+    for (struct window_node *node = window_node_find_first_leaf(root); node; node = window_node_find_next_leaf(node)) {
+        sum += node->area.w * node->area.h;
+        ++*leaf_count;
+    }
+
+    return sum;
+}
+
+TEST_FUNC(view_node_pool_reuses_storage,
+{
+    struct object_pool pool;
+    object_pool_init(&pool, sizeof(struct window_node), 4);
+
+    struct window_node *first = object_pool_alloc(&pool);
+    struct window_node *second = object_pool_alloc(&pool);
+    TEST_CHECK(second == first + 1, true);
+
+    object_pool_free(&pool, second);
+    TEST_CHECK(object_pool_alloc(&pool) == second, true);
+
+    for (int i = 0; i < 10; ++i) {
+        struct window_node *node = object_pool_alloc(&pool);
+        TEST_CHECK(node->left == NULL && node->window_count == 0, true);
+        node->window_count = i + 1;
+    }
+
+    TEST_CHECK(pool.count, 12);
+
+    object_pool_reset(&pool);
+    TEST_CHECK(pool.count, 0);
+    TEST_CHECK(object_pool_alloc(&pool) == first, true);
+    TEST_CHECK(first->window_count, 0);
+
+    object_pool_destroy(&pool);
+    TEST_CHECK(pool.chunks == NULL, true);
+});
+
+TEST_FUNC(view_stack_grows_beyond_inline_slots,
+{
+    struct view view;
+    memset(&view, 0, sizeof(struct view));
+    layout_pool_init(&view.pool);
+
+    struct window_node *a_node = window_node_create(&view.pool, true);
+    struct window_node *b_node = window_node_create(&view.pool, true);
+
+    for (int i = 0; i < 300; ++i) {
+        window_node_reserve(a_node, a_node->window_count + 1);
+        a_node->window_list[a_node->window_count] = 1000 + i;
+        a_node->window_order[a_node->window_count] = 1299 - i;
+        ++a_node->window_count;
+    }
+
+    window_node_reserve(b_node, 2);
+    b_node->window_list[0] = b_node->window_order[1] = 1;
+    b_node->window_list[1] = b_node->window_order[0] = 2;
+    b_node->window_count = 2;
+
+    TEST_CHECK(a_node->stack->capacity, 512);
+    TEST_CHECK(b_node->stack->heap == NULL, true);
+    TEST_CHECK(window_node_index_of_window(a_node, 1299), 299);
+
+    window_node_swap_window_list(a_node, b_node);
+
+    TEST_CHECK(a_node->window_count, 2);
+    TEST_CHECK(a_node->window_list[1], 2);
+    TEST_CHECK(a_node->window_order[0], 2);
+    TEST_CHECK(b_node->window_count, 300);
+    TEST_CHECK(b_node->window_list[299], 1299);
+    TEST_CHECK(b_node->window_order[299], 1000);
+    TEST_CHECK(window_node_contains_window(b_node, 1150), true);
+    TEST_CHECK(window_node_contains_window(a_node, 1150), false);
+
+    window_node_release(&view.pool, a_node);
+    window_node_release(&view.pool, b_node);
+    TEST_CHECK(view.pool.stack_pool.count, 0);
+
+    layout_pool_destroy(&view.pool);
+});
+
+TEST_FUNC(view_benchmark_traversal_4096_leaves,
+{
+    int depth = 12;
+    int iterations = 50;
+    int node_count = (1 << (depth + 1)) - 1;
+
+    struct view view;
+    memset(&view, 0, sizeof(struct view));
+    view.split_type = SPLIT_AUTO;
+    layout_pool_init(&view.pool);
+
+    int junk_count = 0;
+    void **junk = malloc(node_count * sizeof(void *));
+
+    struct window_node *trees[2];
+    trees[0] = test_view_build_tree(&view, NULL, depth, true, junk, &junk_count);
+    trees[1] = test_view_build_tree(&view, NULL, depth, false, junk, &junk_count);
+
+    TEST_CHECK(view.pool.node_pool.count, node_count);
+    TEST_CHECK(view.pool.stack_pool.count, 1 << depth);
+
+    uint64_t cpu_freq = read_cpu_freq();
+    double area[2];
+    char *name[2];
+    name[0] = "pool";
+    name[1] = "heap";
+
+    for (int i = 0; i < 2; ++i) {
+        uint64_t update_tsc = 0;
+        uint64_t traverse_tsc = 0;
+        int leaf_count = 0;
+
+        for (int j = 0; j < iterations; ++j) {
+            trees[i]->area = area_from_cgrect(CGRectMake(0, 0, 2560 + j, 1440));
+
+            uint64_t begin_tsc = read_cpu_timer();
+            window_node_update(&view, trees[i]);
+            uint64_t middle_tsc = read_cpu_timer();
+            area[i] = test_view_sum_leaf_area(trees[i], &leaf_count);
+            uint64_t end_tsc = read_cpu_timer();
+
+            update_tsc += middle_tsc - begin_tsc;
+            traverse_tsc += end_tsc - middle_tsc;
+        }
+
+        printf("                   %-8s %5d nodes, update %.4fms, traverse %.4fms\n",
+               name[i], node_count,
+               1000.0 * (double) update_tsc / (double) cpu_freq / iterations,
+               1000.0 * (double) traverse_tsc / (double) cpu_freq / iterations);
+
+        TEST_CHECK(leaf_count, 1 << depth);
+    }
+
+    TEST_CHECK(area[0] == area[1], true);
+
+    test_view_free_heap_tree(trees[1]);
+    for (int i = 0; i < junk_count; ++i) free(junk[i]);
+    free(junk);
+
+    layout_pool_destroy(&view.pool);
+});
+
+static int test_view_count_frame_leaves(struct window_node *root)
+{
+    int count = 0;
+
+    for (struct window_node *node = window_node_find_first_leaf(root); node; node = window_node_find_next_leaf(node)) {
+        if (node->dirty & NODE_DIRTY_FRAME) ++count;
+    }
+
+    return count;
+}
+
+TEST_FUNC(view_benchmark_single_resize_64_leaves,
+{
+    int depth = 6;
+    int iterations = 1000;
+
+    struct view view;
+    memset(&view, 0, sizeof(struct view));
+    view.split_type = SPLIT_AUTO;
+    layout_pool_init(&view.pool);
+
+    struct window_node *root = test_view_build_tree(&view, NULL, depth, true, NULL, NULL);
+    root->area = area_from_cgrect(CGRectMake(0, 0, 2560, 1440));
+
+    struct window_capture *window_list = NULL;
+    window_node_update(&view, root);
+    TEST_CHECK(test_view_count_frame_leaves(root), 1 << depth);
+
+    window_node_capture_dirty_windows(root, &window_list);
+    TEST_CHECK(root->dirty, 0);
+
+    struct window_node *fence = window_node_find_last_leaf(root)->parent;
+    uint64_t cpu_freq = read_cpu_freq();
+    char *name[2];
+    name[0] = "full";
+    name[1] = "dirty";
+
+    for (int i = 0; i < 2; ++i) {
+        uint64_t update_tsc = 0;
+        int frame_count = 0;
+
+        for (int j = 0; j < iterations; ++j) {
+            fence->ratio = j % 2 ? 0.4f : 0.6f;
+
+            uint64_t begin_tsc = read_cpu_timer();
+            if (i == 0) {
+                window_node_update(&view, root);
+            } else {
+                window_node_mark_dirty(fence, NODE_DIRTY_LAYOUT);
+                window_node_update_dirty(&view, root);
+            }
+            uint64_t end_tsc = read_cpu_timer();
+            update_tsc += end_tsc - begin_tsc;
+
+            frame_count = test_view_count_frame_leaves(root);
+            window_node_capture_dirty_windows(root, &window_list);
+        }
+
+        printf("                   %-8s %5d leaves, update %.6fms\n",
+               name[i], 1 << depth,
+               1000.0 * (double) update_tsc / (double) cpu_freq / iterations);
+
+        TEST_CHECK(frame_count, 2);
+        TEST_CHECK(root->dirty, 0);
+    }
+
+    layout_pool_destroy(&view.pool);
+});
+
+TEST_FUNC(view_scroll_moves_visible_columns_only,
+{
+    struct view view;
+    memset(&view, 0, sizeof(struct view));
+    view.layout = VIEW_SCROLL;
+    layout_pool_init(&view.pool);
+    g_space_manager.scroll_column_width = 0.5f;
+
+    struct layout_config config = view_layout_config(&view);
+    struct window_node *root = view.root = window_node_create(&view.pool, true);
+    root->area = area_from_cgrect(CGRectMake(0, 0, 1000, 500));
+
+    for (int i = 1; i < 12; ++i) {
+        window_node_split(&view.pool, &config, window_node_find_last_leaf(root), i, NULL);
+    }
+
+    struct window_capture *window_list = NULL;
+    window_node_update(&view, root);
+    window_node_capture_visible_windows(root, &root->area, &window_list);
+    TEST_CHECK(root->dirty, 0);
+
+    struct window_node *second = window_node_find_next_leaf(window_node_find_first_leaf(root));
+    TEST_CHECK((int) second->area.x, 500);
+    TEST_CHECK((int) second->area.w, 500);
+    TEST_CHECK(window_node_find_next_leaf(second)->is_offscreen, true);
+
+    view.scroll_offset = 500.0f;
+    window_node_update(&view, root);
+    TEST_CHECK(test_view_count_frame_leaves(root), 12);
+
+    window_node_capture_visible_windows(root, &root->area, &window_list);
+    TEST_CHECK(test_view_count_frame_leaves(root), 9);
+    TEST_CHECK(second->is_offscreen, false);
+    TEST_CHECK(window_node_find_first_leaf(root)->is_offscreen, true);
+
+    view.scroll_offset = 100000.0f;
+    window_node_update(&view, root);
+    TEST_CHECK((int) view.scroll_offset, 5000);
+    TEST_CHECK((int) window_node_find_last_leaf(root)->area.x, 500);
+
+    layout_pool_destroy(&view.pool);
+});
+
+static bool test_view_window_is_odd_or_small(void *context, uint32_t window_id)
+{
+    return window_id % 2 || window_id < *(uint32_t *) context;
+}
+
+TEST_FUNC(view_snapshot_shares_unchanged_subtrees,
+{
+    struct layout_pool pool;
+    layout_pool_init(&pool);
+
+    struct layout_config config;
+    memset(&config, 0, sizeof(struct layout_config));
+    config.split_type  = SPLIT_AUTO;
+    config.child       = CHILD_SECOND;
+    config.split_ratio = 0.5f;
+
+    struct window_node *root = window_node_create(&pool, true);
+    root->area = area_from_cgrect(CGRectMake(0, 0, 2560, 1440));
+    root->window_list[0] = root->window_order[0] = 1;
+    root->window_count = 1;
+
+    for (uint32_t i = 2; i <= 8; ++i) {
+        window_node_split(&pool, &config, window_node_find_last_leaf(root), i, NULL);
+    }
+
+    struct layout_history history;
+    memset(&history, 0, sizeof(struct layout_history));
+
+    TEST_CHECK(layout_history_record(&history, root), true);
+    TEST_CHECK(layout_history_record(&history, root), false);
+
+    struct layout_snapshot *first = history.entry_list[0];
+    window_node_find_last_leaf(root)->parent->ratio = 0.3f;
+
+    TEST_CHECK(layout_history_record(&history, root), true);
+    struct layout_snapshot *second = history.entry_list[1];
+    TEST_CHECK(second != first, true);
+    TEST_CHECK(second->left == first->left, true);
+    TEST_CHECK(second->right != first->right, true);
+    TEST_CHECK(first->left->reference_count, 2);
+
+    TEST_CHECK(layout_history_undo(&history) == first, true);
+    TEST_CHECK(layout_history_undo(&history) == NULL, true);
+    TEST_CHECK(layout_history_redo(&history) == second, true);
+    TEST_CHECK(layout_history_redo(&history) == NULL, true);
+
+    uint32_t limit = UINT32_MAX;
+    struct window_node *restored = layout_snapshot_restore(&pool, second, test_view_window_is_odd_or_small, &limit);
+    struct layout_snapshot *retaken = layout_snapshot_take(second, restored);
+    TEST_CHECK(retaken == second, true);
+    layout_snapshot_release(retaken);
+
+    limit = 4;
+    struct window_node *pruned = layout_snapshot_restore(&pool, second, test_view_window_is_odd_or_small, &limit);
+    int leaf_count = 0;
+    uint32_t window_sum = 0;
+
+    for (struct window_node *node = window_node_find_first_leaf(pruned); node; node = window_node_find_next_leaf(node)) {
+        window_sum += node->window_list[0];
+        ++leaf_count;
+    }
+
+    TEST_CHECK(leaf_count, 5);
+    TEST_CHECK(window_sum, 1 + 2 + 3 + 5 + 7);
+
+    for (int i = 0; i < LAYOUT_HISTORY_SIZE + 4; ++i) {
+        window_node_find_first_leaf(root)->parent->ratio = 0.1f + 0.01f * i;
+        layout_history_record(&history, root);
+    }
+
+    TEST_CHECK(history.count, LAYOUT_HISTORY_SIZE);
+    TEST_CHECK(history.cursor, LAYOUT_HISTORY_SIZE - 1);
+
+    layout_history_clear(&history);
+    layout_pool_destroy(&pool);
+});
+
+TEST_FUNC(view_snapshot_encoding_round_trips,
+{
+    struct layout_pool pool;
+    layout_pool_init(&pool);
+
+    struct layout_config config;
+    memset(&config, 0, sizeof(struct layout_config));
+    config.split_type  = SPLIT_AUTO;
+    config.child       = CHILD_SECOND;
+    config.split_ratio = 0.5f;
+
+    struct window_node *root = window_node_create(&pool, true);
+    root->area = area_from_cgrect(CGRectMake(0, 0, 2560, 1440));
+    root->window_list[0] = root->window_order[0] = 1;
+    root->window_count = 1;
+
+    for (uint32_t i = 2; i <= 6; ++i) {
+        window_node_split(&pool, &config, window_node_find_last_leaf(root), i, NULL);
+    }
+
+    struct window_node *leaf = window_node_find_first_leaf(root);
+    window_node_reserve(leaf, 2);
+    leaf->window_list[1] = leaf->window_order[1] = 7;
+    leaf->window_count = 2;
+    leaf->parent->ratio = 0.3f;
+    leaf->zoom = leaf->parent;
+
+    struct layout_snapshot *snapshot = layout_snapshot_take(NULL, root);
+    struct layout_buffer buffer;
+    memset(&buffer, 0, sizeof(struct layout_buffer));
+    layout_snapshot_encode(&buffer, snapshot);
+
+    uint8_t *cursor = buffer.data;
+    struct layout_snapshot *decoded = layout_snapshot_decode(&cursor, buffer.data + buffer.length);
+    TEST_CHECK(decoded != NULL, true);
+    TEST_CHECK(cursor == buffer.data + buffer.length, true);
+
+    uint32_t limit = UINT32_MAX;
+    struct window_node *restored = layout_snapshot_restore(&pool, decoded, test_view_window_is_odd_or_small, &limit);
+    struct layout_snapshot *retaken = layout_snapshot_take(snapshot, restored);
+    TEST_CHECK(retaken == snapshot, true);
+    TEST_CHECK(window_node_find_first_leaf(restored)->zoom == window_node_find_first_leaf(restored)->parent, true);
+
+    for (int length = 0; length < buffer.length; ++length) {
+        cursor = buffer.data;
+        struct layout_snapshot *truncated = layout_snapshot_decode(&cursor, buffer.data + length);
+        TEST_CHECK(truncated == NULL, true);
+    }
+
+    layout_snapshot_release(retaken);
+    layout_snapshot_release(snapshot);
+    layout_snapshot_release(decoded);
+    free(buffer.data);
+    layout_pool_destroy(&pool);
+});
+
+static uint32_t test_view_min_size_table[2][8];
+
+static uint32_t test_view_min_width(void *context, uint32_t window_id)
+{
+    return test_view_min_size_table[0][window_id];
+}
+
+static uint32_t test_view_min_height(void *context, uint32_t window_id)
+{
+    return test_view_min_size_table[1][window_id];
+}
+
+TEST_FUNC(view_min_size_sums_along_split_axis,
+{
+    struct layout_pool pool;
+    layout_pool_init(&pool);
+
+    struct layout_config config;
+    memset(&config, 0, sizeof(struct layout_config));
+    config.split_type  = SPLIT_AUTO;
+    config.child       = CHILD_SECOND;
+    config.split_ratio = 0.5f;
+    config.min_width   = test_view_min_width;
+    config.min_height  = test_view_min_height;
+
+    memset(test_view_min_size_table, 0, sizeof(test_view_min_size_table));
+    test_view_min_size_table[0][3] = 400;
+    test_view_min_size_table[0][4] = 500;
+    test_view_min_size_table[1][2] = 1000;
+    test_view_min_size_table[1][3] = 600;
+
+    struct window_node *root = window_node_create(&pool, true);
+    root->area = area_from_cgrect(CGRectMake(0, 0, 2560, 1440));
+    root->window_list[0] = root->window_order[0] = 1;
+    root->window_count = 1;
+
+    for (uint32_t i = 2; i <= 4; ++i) {
+        window_node_split(&pool, &config, window_node_find_last_leaf(root), i, NULL);
+    }
+
+    root->ratio = 0.9f;
+    layout_enforce_min_size(&config, root);
+
+    TEST_CHECK(root->split, SPLIT_Y);
+    TEST_CHECK(root->right->split, SPLIT_X);
+    TEST_CHECK(root->right->right->min_width, 900);
+    TEST_CHECK(root->right->min_width, 900);
+    TEST_CHECK(root->right->min_height, 1600);
+    TEST_CHECK(root->ratio > 0.64f && root->ratio < 0.65f, true);
+    TEST_CHECK(root->right->ratio == 0.625f, true);
+    TEST_CHECK(root->dirty & NODE_DIRTY_LAYOUT, NODE_DIRTY_LAYOUT);
+
+    test_view_min_size_table[0][4] = 0;
+    window_node_invalidate_min_size(window_node_find_last_leaf(root));
+    TEST_CHECK(root->is_min_size_valid, false);
+    TEST_CHECK(root->left->is_min_size_valid, true);
+    TEST_CHECK(root->right->left->is_min_size_valid, true);
+
+    layout_enforce_min_size(&config, root);
+    TEST_CHECK(root->right->right->min_width, 400 + NODE_DEFAULT_MIN_WIDTH);
+    TEST_CHECK(root->right->min_width, 400 + NODE_DEFAULT_MIN_WIDTH);
+    TEST_CHECK(root->is_min_size_valid, true);
+
+    test_view_min_size_table[0][3] = 0;
+    window_node_invalidate_min_size(root->right->right->left);
+    layout_enforce_min_size(&config, root);
+    TEST_CHECK(root->right->right->min_width, 2 * NODE_DEFAULT_MIN_WIDTH);
+    TEST_CHECK(root->left->min_width, NODE_DEFAULT_MIN_WIDTH);
+
+    //
+    // NOTE: Toggling the split of a fence sums its minimums along the other
+    // axis, and every node above it has to be solved again.
+    //
+
+    window_node_toggle_split(root->right->right);
+    TEST_CHECK(root->right->right->split, SPLIT_X);
+    TEST_CHECK(root->right->right->is_min_size_valid, false);
+    TEST_CHECK(root->right->is_min_size_valid, false);
+    TEST_CHECK(root->is_min_size_valid, false);
+    TEST_CHECK(root->left->is_min_size_valid, true);
+
+    layout_enforce_min_size(&config, root);
+    TEST_CHECK(root->right->right->min_width, NODE_DEFAULT_MIN_WIDTH);
+    TEST_CHECK(root->right->right->min_height, 600);
+    TEST_CHECK(root->right->min_width, NODE_DEFAULT_MIN_WIDTH);
+    TEST_CHECK(root->right->min_height, 1600);
+
+    layout_pool_destroy(&pool);
+});
@@ -0,0 +1,57 @@
+TEST_FUNC(window_query_plan_minimal_fetches,
+{
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_ID | WINDOW_PROPERTY_TITLE | WINDOW_PROPERTY_FRAME, true), 0);
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_ID | WINDOW_PROPERTY_APP, true), 0);
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_ID | WINDOW_PROPERTY_APP, false), WINDOW_FETCH_OWNER);
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_SPACE | WINDOW_PROPERTY_IS_STICKY, true), WINDOW_FETCH_SPACE);
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_LEVEL | WINDOW_PROPERTY_HAS_SHADOW | WINDOW_PROPERTY_TAGS, true), WINDOW_FETCH_ITERATOR);
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_ROOT_WINDOW, true), 0);
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_ROOT_WINDOW, false), WINDOW_FETCH_ITERATOR);
+    TEST_CHECK(window_query_plan(WINDOW_PROPERTY_SUB_LAYER, true), WINDOW_FETCH_SUB_LEVEL);
+    TEST_CHECK(window_query_plan(0, false), WINDOW_FETCH_OWNER | WINDOW_FETCH_SPACE | WINDOW_FETCH_ITERATOR | WINDOW_FETCH_SUB_LEVEL);
+});
+
+static struct window_capture test_window_capture(struct window *window, uint32_t id, CGRect applied, CGRect reported)
+{
+    memset(window, 0, sizeof(struct window));
+    window->id = id;
+    window->applied_frame = applied;
+    window->frame = reported;
+    return (struct window_capture) { window, 100, 200, 800, 600 };
+}
+
+TEST_FUNC(window_manager_drops_already_applied_frames,
+{
+    table_init(&g_window_manager.window_animations_table, 150, hash_wm, compare_wm);
+    pthread_mutex_init(&g_window_manager.window_animations_lock, NULL);
+    g_window_manager.frame_apply_count = 0;
+    g_window_manager.frame_skip_count = 0;
+
+    CGRect target = CGRectMake(100, 200, 800, 600);
+    CGRect other = CGRectMake(100, 200, 810, 600);
+
+    struct window window_list[5];
+    struct window_capture capture_list[5];
+    capture_list[0] = test_window_capture(&window_list[0], 1, target, target);
+    capture_list[1] = test_window_capture(&window_list[1], 2, other, target);
+    capture_list[2] = test_window_capture(&window_list[2], 3, target, other);
+    capture_list[3] = test_window_capture(&window_list[3], 4, target, CGRectMake(100.5f, 199.5f, 800, 600));
+    capture_list[4] = test_window_capture(&window_list[4], 5, target, target);
+    table_add(&g_window_manager.window_animations_table, &window_list[4].id, &window_list[4]);
+
+    int count = window_manager_drop_applied_frames(capture_list, 5);
+    TEST_CHECK(count, 3);
+    TEST_CHECK(capture_list[0].window->id, 2);
+    TEST_CHECK(capture_list[1].window->id, 3);
+    TEST_CHECK(capture_list[2].window->id, 5);
+    TEST_CHECK(g_window_manager.frame_apply_count, 3);
+    TEST_CHECK(g_window_manager.frame_skip_count, 2);
+
+    table_remove(&g_window_manager.window_animations_table, &window_list[4].id);
+    capture_list[0] = test_window_capture(&window_list[4], 5, target, target);
+    TEST_CHECK(window_manager_drop_applied_frames(capture_list, 1), 0);
+    TEST_CHECK(g_window_manager.frame_skip_count, 3);
+
+    table_free(&g_window_manager.window_animations_table);
+    pthread_mutex_destroy(&g_window_manager.window_animations_lock);
+});
@@ -0,0 +1,41 @@
+static void *test_worker_pool_increment(void *data)
+{
+    __atomic_add_fetch((int *) data, 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+TEST_FUNC(worker_pool_runs_every_task_once,
+{
+    struct worker_pool pool;
+    worker_pool_init(&pool, 3);
+    TEST_CHECK(pool.thread_count, 3);
+
+    int counter_list[512];
+    struct worker_task task_list[512];
+
+    for (int batch = 0; batch < 8; ++batch) {
+        int task_count = 1 + batch * 73;
+
+        memset(counter_list, 0, sizeof(counter_list));
+        for (int i = 0; i < task_count; ++i) {
+            task_list[i].proc = test_worker_pool_increment;
+            task_list[i].data = &counter_list[i];
+            task_list[i].elapsed_ns = UINT64_MAX;
+        }
+
+        worker_pool_run(&pool, task_list, task_count);
+
+        int mismatch = 0;
+        for (int i = 0; i < 512; ++i) {
+            mismatch += counter_list[i] != (i < task_count);
+            if (i < task_count) mismatch += task_list[i].elapsed_ns == UINT64_MAX;
+        }
+        TEST_CHECK(mismatch, 0);
+    }
+
+    TEST_CHECK(pool.completed_count, 8 + 73 * 28);
+    TEST_CHECK(pool.pending_count, 0);
+
+    worker_pool_destroy(&pool);
+    TEST_CHECK(pool.thread_count, 0);
+});